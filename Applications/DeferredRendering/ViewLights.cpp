@@ -23,6 +23,7 @@
 #include "BlendStateConfigDX11.h"
 #include "AppSettings.h"
 #include "RasterizerStateConfigDX11.h"
+#include "ShaderFactoryDX11.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
@@ -129,6 +130,44 @@ ViewLights::ViewLights( RendererDX11& Renderer)
     GeometryGeneratorDX11::GenerateCone( m_ConeGeometry, 8, 2, 1.0f, 1.0f );
     m_ConeGeometry->LoadToBuffers();
 
+    // Compile all of the shader permutations up front, so that the ones which
+    // aren't in the shader cache yet are compiled in parallel.  The loads below
+    // then find them in the cache.
+    std::vector<ShaderCompileRequestDX11> requests;
+    const char* lightTypes[] = { "POINTLIGHT", "SPOTLIGHT", "DIRECTIONALLIGHT" };
+
+    for ( int gBufferOptMode = 0; gBufferOptMode < GBufferOptMode::NumSettings; ++gBufferOptMode )
+    {
+        for ( int lightOptMode = 0; lightOptMode < LightOptMode::NumSettings; ++lightOptMode )
+        {
+            for ( int aaMode = 0; aaMode < AAMode::NumSettings; ++aaMode )
+            {
+                for ( int lightType = 0; lightType < 3; ++lightType )
+                {
+                    D3D_SHADER_MACRO defines[7];
+                    for ( int i = 0; i < 3; ++i )
+                    {
+                        defines[i].Name = lightTypes[i];
+                        defines[i].Definition = i == lightType ? "1" : "0";
+                    }
+                    defines[3].Name = "GBUFFEROPTIMIZATIONS";
+                    defines[3].Definition = gBufferOptMode == GBufferOptMode::OptEnabled ? "1" : "0";
+                    defines[4].Name = "LIGHTVOLUMES";
+                    defines[4].Definition = lightOptMode == LightOptMode::Volumes ? "1" : "0";
+                    defines[5].Name = "MSAA";
+                    defines[5].Definition = aaMode == AAMode::MSAA ? "1" : "0";
+                    defines[6].Name = NULL;
+                    defines[6].Definition = NULL;
+
+                    requests.push_back( ShaderFactoryDX11::CreateRequest( L"Lights.hlsl", L"VSMain", L"vs_5_0", defines ) );
+                    requests.push_back( ShaderFactoryDX11::CreateRequest( L"Lights.hlsl", L"PSMain", L"ps_5_0", defines ) );
+                }
+            }
+        }
+    }
+
+    Renderer.PrecompileShaders( requests );
+
     for ( int gBufferOptMode = 0; gBufferOptMode < GBufferOptMode::NumSettings; ++gBufferOptMode )
     {
         for ( int lightOptMode = 0; lightOptMode < LightOptMode::NumSettings; ++lightOptMode )
@@ -132,8 +132,8 @@ void App::Initialize()
 	// Load an STL file and configure an actor to use it.
 
 	FileSystem fs;
-	STL::MeshSTL stl( fs.GetModelsFolder() + L"MeshedReconstruction.stl" );
-	OBJ::MeshOBJ obj( fs.GetModelsFolder() + L"Capsule.obj" );
+	STL::MeshSTL stl( fs.GetModelsFolder() + L"MeshedReconstruction.stl", m_pRenderer11->GetJobScheduler() );
+	OBJ::MeshOBJ obj( fs.GetModelsFolder() + L"Capsule.obj", m_pRenderer11->GetJobScheduler() );
 
 	m_pMeshActor = new Actor();
 	m_pScene->AddActor( m_pMeshActor );
@@ -178,7 +178,7 @@ void App::Initialize()
 	auto pOBJExecutor = std::make_shared<DrawExecutorDX11<BasicVertexDX11::Vertex>>();
 	pOBJExecutor->SetLayoutElements( BasicVertexDX11::GetElementCount(), BasicVertexDX11::Elements );
 	pOBJExecutor->SetPrimitiveType( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
-	pOBJExecutor->SetMaxVertexCount( obj.positions.size() );
+	pOBJExecutor->SetMaxVertexCount( obj.indices.size() );
 	m_pOBJMesh->GetBody()->Visual.SetGeometry( pOBJExecutor );
 
 
@@ -192,12 +192,13 @@ void App::Initialize()
 			for ( auto& face : subobject.faces )
 			{
 				// Only grab faces with 3 vertices - i.e. triangles!
-				if ( face.positionIndices.size() == 3 )
+				if ( face.count == 3 )
 				{
 					for ( size_t i = 0; i < 3; ++i ) {
-						v.position = obj.positions[face.positionIndices[i]];
-						v.normal = obj.normals[face.normalIndices[i]];
-						v.texcoords = obj.coords[face.coordIndices[i]];
+						unsigned int index = obj.indices[face.start + i];
+						v.position = obj.positions[index];
+						v.normal = obj.normals[index];
+						v.texcoords = obj.coords[index];
 						pOBJExecutor->AddVertex( v );
 					}
 				}
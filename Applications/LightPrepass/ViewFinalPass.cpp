@@ -74,8 +74,8 @@ void ViewFinalPass::ExecuteTask( PipelineManagerDX11* pPipelineManager, IParamet
         // Set this view's render parameters
         SetRenderParams( pParamManager );
 
-        // Run through the graph and render each of the entities
-        m_pScene->GetRoot()->Render( pPipelineManager, pParamManager, VT_FINALPASS );
+        // Render the visible entities, sorted by their pipeline state
+        RenderVisibleEntities( pPipelineManager, pParamManager, VT_FINALPASS );
     }
 }
 //--------------------------------------------------------------------------------
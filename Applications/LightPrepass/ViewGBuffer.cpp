@@ -126,8 +126,8 @@ void ViewGBuffer::ExecuteTask( PipelineManagerDX11* pPipelineManager, IParameter
 		// Set this view's render parameters
 		SetRenderParams( pParamManager );
 
-		// Run through the graph and render each of the entities
-		m_pScene->GetRoot()->Render( pPipelineManager, pParamManager, VT_GBUFFER );
+		// Render the visible entities, sorted by their pipeline state
+		RenderVisibleEntities( pPipelineManager, pParamManager, VT_GBUFFER );
 
         // Now that we've filled the G-Buffer, we'll generate a stencil mask
         // that masks out all pixels where the individual sub-samples aren't
@@ -0,0 +1,217 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TestFramework.h"
+#include "AssetCacheDX11.h"
+#include "TestGeometry.h"
+#include <atomic>
+#include <thread>
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	// The cache is a singleton, so each test works on a fresh instance of its
+	// own instead.  Only geometry is cached here, since the textures need a
+	// renderer to be loaded.
+
+	class TestAssetCache : public AssetCacheDX11
+	{
+	public:
+		TestAssetCache() {}
+	};
+
+	GeometryPtr CreateFlatGrid( int size )
+	{
+		return( CreateGrid( size, false, []( int x, int y, GridVertex& vertex ) {
+			vertex.Position = Vector3f( static_cast<float>( x ), static_cast<float>( y ), 0.0f );
+		} ) );
+	}
+
+	// A loader that counts how often it runs, so that the tests can tell hits
+	// from misses without relying on the cache's own counters.
+
+	struct CountingLoader
+	{
+		CountingLoader( int size ) : Size( size ), Calls( 0 ) {}
+
+		AssetCacheDX11::GeometryLoader operator()()
+		{
+			return( [this]() {
+				Calls++;
+				return( CreateFlatGrid( Size ) );
+			} );
+		}
+
+		int Size;
+		std::atomic<int> Calls;
+	};
+};
+//--------------------------------------------------------------------------------
+TEST_CASE( AssetCacheHitsAndMisses )
+{
+	TestAssetCache cache;
+	CountingLoader loader( 4 );
+
+	GeometryPtr pFirst = cache.GetGeometry( L"Models\\Grid.ms3d", "", loader() );
+	GeometryPtr pSecond = cache.GetGeometry( L"models/grid.MS3D", "", loader() );
+
+	// The filename is normalized, so both requests are for the same asset.
+
+	CHECK( pFirst != nullptr && pFirst == pSecond );
+	CHECK( loader.Calls == 1 );
+	CHECK( cache.GetHitCount() == 1 && cache.GetMissCount() == 1 );
+
+	// Different options make a different asset.
+
+	GeometryPtr pOther = cache.GetGeometry( L"Models\\Grid.ms3d", "buffers", loader() );
+
+	CHECK( pOther != pFirst );
+	CHECK( loader.Calls == 2 );
+	CHECK( cache.GetMissCount() == 2 && cache.GetAssetCount() == 2 );
+
+	// Failed loads aren't cached, and are tried again on the next request.
+
+	int failures = 0;
+	auto failing = [&failures]() { failures++; return( GeometryPtr() ); };
+
+	CHECK( cache.GetGeometry( L"Missing.ms3d", "", failing ) == nullptr );
+	CHECK( cache.GetGeometry( L"Missing.ms3d", "", failing ) == nullptr );
+	CHECK( failures == 2 );
+	CHECK( cache.GetMissCount() == 4 && cache.GetAssetCount() == 2 );
+
+	// A loader that throws doesn't leave a pending load behind.
+
+	bool thrown = false;
+
+	try {
+		cache.GetGeometry( L"Broken.ms3d", "", []() -> GeometryPtr { throw std::runtime_error( "broken" ); } );
+	} catch ( std::runtime_error& ) {
+		thrown = true;
+	}
+
+	CHECK( thrown );
+	CHECK( cache.GetGeometry( L"Broken.ms3d", "", loader() ) != nullptr );
+	CHECK( loader.Calls == 3 );
+
+	// Clearing the cache makes the next request load the file again, even
+	// though the old asset is still in use.
+
+	cache.Clear();
+	CHECK( cache.GetAssetCount() == 0 && cache.GetMemoryUsage() == 0 );
+
+	GeometryPtr pReloaded = cache.GetGeometry( L"Models\\Grid.ms3d", "", loader() );
+	CHECK( pReloaded != pFirst && pFirst != nullptr );
+	CHECK( loader.Calls == 4 );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( AssetCacheSharesPendingLoads )
+{
+	// All of the threads request the same asset while the first request is
+	// still loading it.  The others wait for that load instead of starting
+	// their own, and all of them get the same geometry.
+
+	TestAssetCache cache;
+
+	const int threadCount = 8;
+	std::atomic<int> calls( 0 );
+	std::atomic<int> started( 0 );
+	std::vector<GeometryPtr> results( threadCount );
+	std::vector<std::thread> threads;
+
+	auto slow = [&]() {
+		calls++;
+		std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+		return( CreateFlatGrid( 8 ) );
+	};
+
+	for ( int i = 0; i < threadCount; i++ )
+	{
+		threads.push_back( std::thread( [&,i]() {
+			started++;
+			while ( started < threadCount ) { std::this_thread::yield(); }
+			results[i] = cache.GetGeometry( L"Shared.ms3d", "", slow );
+		} ) );
+	}
+
+	for ( auto& thread : threads )
+		thread.join();
+
+	bool same = true;
+
+	for ( auto& result : results )
+		same = same && result != nullptr && result == results[0];
+
+	CHECK( same );
+	CHECK( calls == 1 );
+	CHECK( cache.GetMissCount() == 1 && cache.GetHitCount() == threadCount - 1 );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( AssetCacheEvictsLeastRecentlyUsed )
+{
+	TestAssetCache cache;
+	CountingLoader a( 8 ), b( 8 ), c( 8 );
+
+	// The references are dropped right away, so all of the assets are only
+	// held by the cache and can be evicted.
+
+	cache.GetGeometry( L"A.ms3d", "", a() );
+	const unsigned long long size = cache.GetMemoryUsage();
+	cache.GetGeometry( L"B.ms3d", "", b() );
+	cache.GetGeometry( L"C.ms3d", "", c() );
+
+	CHECK( size > 0 && cache.GetMemoryUsage() == 3 * size );
+
+	// Using A again makes B the least recently used asset, which is evicted
+	// first when the budget shrinks.
+
+	cache.GetGeometry( L"A.ms3d", "", a() );
+	cache.SetMemoryBudget( 2 * size );
+
+	CHECK( cache.GetEvictionCount() == 1 && cache.GetAssetCount() == 2 );
+	CHECK( cache.GetMemoryUsage() == 2 * size );
+
+	cache.GetGeometry( L"A.ms3d", "", a() );
+	cache.GetGeometry( L"C.ms3d", "", c() );
+	CHECK( a.Calls == 1 && c.Calls == 1 );
+
+	// C is used before A, but it is still referenced when the budget shrinks
+	// again, so it is skipped and A is evicted instead.
+
+	GeometryPtr pInUse = cache.GetGeometry( L"C.ms3d", "", c() );
+	cache.GetGeometry( L"A.ms3d", "", a() );
+	cache.SetMemoryBudget( size );
+
+	CHECK( cache.GetAssetCount() == 1 );
+	CHECK( cache.GetGeometry( L"C.ms3d", "", c() ) == pInUse );
+	CHECK( c.Calls == 1 && a.Calls == 1 );
+
+	// A new asset is referenced by the request that loads it, so it isn't
+	// evicted right away, and the cache stays over its budget for now.
+
+	cache.GetGeometry( L"B.ms3d", "", b() );
+	CHECK( b.Calls == 2 );
+	CHECK( cache.GetAssetCount() == 2 && cache.GetMemoryUsage() == 2 * size );
+
+	// Trim ignores the budget, but still keeps the assets that are in use.
+
+	cache.SetMemoryBudget( 0 );
+	cache.GetGeometry( L"A.ms3d", "", a() );
+	CHECK( cache.GetAssetCount() == 3 );
+
+	cache.Trim();
+
+	CHECK( cache.GetAssetCount() == 1 && cache.GetMemoryUsage() == size );
+	CHECK( cache.GetGeometry( L"C.ms3d", "", c() ) == pInUse );
+	CHECK( a.Calls == 2 && c.Calls == 1 );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
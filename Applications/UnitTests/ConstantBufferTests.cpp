@@ -0,0 +1,281 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TestFramework.h"
+#include "ConstantBufferDX11.h"
+#include "ConstantBufferBatchDX11.h"
+#include "RecordingConstantBufferUploader.h"
+#include "ParameterManagerDX11.h"
+#include "VectorParameterDX11.h"
+#include "MatrixParameterDX11.h"
+#include "JobScheduler.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	// A buffer without a device, which holds a vector at offset 0 and a matrix
+	// at offset 16 like a typical per-object constant buffer.
+
+	ConstantBufferDX11* CreateBuffer( unsigned int size, IParameterManager& parameters )
+	{
+		ConstantBufferDX11* pBuffer = new ConstantBufferDX11( nullptr );
+
+		D3D11_BUFFER_DESC desc;
+		memset( &desc, 0, sizeof( desc ) );
+		desc.ByteWidth = size;
+		pBuffer->SetDesiredDescription( desc );
+
+		ConstantBufferMapping vector;
+		vector.pParameter = parameters.GetVectorParameterRef( L"TestColor" );
+		vector.offset = 0;
+		vector.size = sizeof( Vector4f );
+		vector.varclass = D3D_SVC_VECTOR;
+		vector.vartype = D3D_SVT_FLOAT;
+		vector.elements = 0;
+		vector.valueID = 0;
+		pBuffer->AddMapping( vector );
+
+		ConstantBufferMapping matrix = vector;
+		matrix.pParameter = parameters.GetMatrixParameterRef( L"TestTransform" );
+		matrix.offset = sizeof( Vector4f );
+		matrix.size = sizeof( Matrix4f );
+		matrix.varclass = D3D_SVC_MATRIX_COLUMNS;
+		pBuffer->AddMapping( matrix );
+
+		return( pBuffer );
+	}
+
+	bool HoldsValues( const std::vector<char>* pContents, const Vector4f& color, const Matrix4f& transform )
+	{
+		return( pContents != nullptr && pContents->size() >= sizeof( Vector4f ) + sizeof( Matrix4f )
+			&& memcmp( pContents->data(), &color, sizeof( Vector4f ) ) == 0
+			&& memcmp( pContents->data() + sizeof( Vector4f ), &transform, sizeof( Matrix4f ) ) == 0 );
+	}
+};
+//--------------------------------------------------------------------------------
+TEST_CASE( ConstantBufferSkipsUnchangedUploads )
+{
+	// The parameters are shared by all of the parameter managers, and are only
+	// released with the last one of them.
+
+	ParameterManagerDX11 parameters( 0 );
+	ConstantBufferDX11* pBuffer = CreateBuffer( 128, parameters );
+
+	Vector4f color( 1.0f, 0.5f, 0.25f, 1.0f );
+	Matrix4f transform = Matrix4f::RotationMatrixY( 0.5f );
+	parameters.SetVectorParameter( L"TestColor", &color );
+	parameters.SetMatrixParameter( L"TestTransform", &transform );
+
+	RecordingConstantBufferUploader uploader;
+
+	// The first evaluation always uploads the whole buffer, since its contents
+	// are undefined until then.
+
+	pBuffer->EvaluateMappings( &uploader, &parameters );
+	CHECK( uploader.GetTotalStatistics().maps == 1 );
+	CHECK( uploader.GetTotalStatistics().bytesUploaded == 128 );
+	CHECK( HoldsValues( uploader.GetContents( pBuffer ), color, transform ) );
+
+	// Nothing has changed, and setting the same values again doesn't change
+	// the contents either.
+
+	pBuffer->EvaluateMappings( &uploader, &parameters );
+	parameters.SetVectorParameter( L"TestColor", &color );
+	pBuffer->EvaluateMappings( &uploader, &parameters );
+	CHECK( uploader.GetTotalStatistics().maps == 1 );
+
+	// A new value uploads the buffer again, with only its bytes being dirty.
+
+	uploader.BeginFrame();
+	color.y = 0.75f;
+	parameters.SetVectorParameter( L"TestColor", &color );
+	pBuffer->EvaluateMappings( &uploader, &parameters );
+
+	CHECK( uploader.GetFrameStatistics().maps == 1 );
+	CHECK( uploader.GetFrameStatistics().bytesUploaded == 128 );
+	CHECK( uploader.GetFrameStatistics().bytesDirty == sizeof( Vector4f ) );
+	CHECK( HoldsValues( uploader.GetContents( pBuffer ), color, transform ) );
+	CHECK( HoldsValues( &pBuffer->GetShadowData(), color, transform ) );
+
+	// A new command list starts without any buffer contents, so the unchanged
+	// values have to be uploaded into it again.
+
+	uploader.BeginCommandList();
+	pBuffer->EvaluateMappings( &uploader, &parameters );
+	CHECK( uploader.GetTotalStatistics().maps == 3 );
+	CHECK( HoldsValues( uploader.GetContents( pBuffer ), color, transform ) );
+
+	// So does a different uploader, which records into another context.
+
+	RecordingConstantBufferUploader other;
+	pBuffer->EvaluateMappings( &other, &parameters );
+	pBuffer->EvaluateMappings( &uploader, &parameters );
+	CHECK( other.GetTotalStatistics().maps == 1 );
+	CHECK( uploader.GetTotalStatistics().maps == 4 );
+
+	delete pBuffer;
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( ConstantBufferCopiesPerThread )
+{
+	ParameterManagerDX11 immediate( 0 );
+	ConstantBufferDX11* pBuffer = CreateBuffer( 128, immediate );
+
+	const unsigned int threads = 4;
+
+	std::vector<ParameterManagerDX11*> managers;
+	std::vector<RecordingConstantBufferUploader*> uploaders;
+
+	for ( unsigned int i = 0; i < threads; i++ ) {
+		managers.push_back( new ParameterManagerDX11( i + 1 ) );
+		uploaders.push_back( new RecordingConstantBufferUploader() );
+	}
+
+	// Two threads with different values each keep their own copy, and
+	// alternating between them never leaves the values of one of them in the
+	// buffer of the other.
+
+	Vector4f red( 1.0f, 0.0f, 0.0f, 1.0f );
+	Vector4f blue( 0.0f, 0.0f, 1.0f, 1.0f );
+	Matrix4f identity = Matrix4f::Identity();
+
+	managers[0]->SetVectorParameter( L"TestColor", &red );
+	managers[0]->SetMatrixParameter( L"TestTransform", &identity );
+	managers[1]->SetVectorParameter( L"TestColor", &blue );
+	managers[1]->SetMatrixParameter( L"TestTransform", &identity );
+
+	pBuffer->EvaluateMappings( uploaders[0], managers[0] );
+	pBuffer->EvaluateMappings( uploaders[1], managers[1] );
+
+	CHECK( HoldsValues( uploaders[0]->GetContents( pBuffer ), red, identity ) );
+	CHECK( HoldsValues( uploaders[1]->GetContents( pBuffer ), blue, identity ) );
+	CHECK( HoldsValues( &pBuffer->GetShadowData( 1 ), red, identity ) );
+	CHECK( HoldsValues( &pBuffer->GetShadowData( 2 ), blue, identity ) );
+
+	// When both of them use the same context, the buffer is uploaded for each
+	// switch between the threads even though neither of the copies changed.
+
+	RecordingConstantBufferUploader shared;
+	pBuffer->EvaluateMappings( &shared, managers[0] );
+	pBuffer->EvaluateMappings( &shared, managers[1] );
+	CHECK( HoldsValues( shared.GetContents( pBuffer ), blue, identity ) );
+	pBuffer->EvaluateMappings( &shared, managers[0] );
+	CHECK( HoldsValues( shared.GetContents( pBuffer ), red, identity ) );
+	pBuffer->EvaluateMappings( &shared, managers[0] );
+	CHECK( shared.GetTotalStatistics().maps == 3 );
+
+	// Recording on several threads at once gives every context the values of
+	// its own thread.
+
+	JobScheduler scheduler;
+	scheduler.Initialize( threads );
+
+	const unsigned int frames = 200;
+
+	scheduler.ParallelFor( threads, 1, [&]( unsigned int begin, unsigned int end, unsigned int worker )
+	{
+		for ( unsigned int i = begin; i < end; i++ )
+		{
+			for ( unsigned int frame = 0; frame < frames; frame++ )
+			{
+				Vector4f color( static_cast<float>( i ), static_cast<float>( frame ), 0.0f, 1.0f );
+				Matrix4f transform = Matrix4f::RotationMatrixZ( 0.01f * frame );
+
+				uploaders[i]->BeginCommandList();
+				managers[i]->SetVectorParameter( L"TestColor", &color );
+				managers[i]->SetMatrixParameter( L"TestTransform", &transform );
+				pBuffer->EvaluateMappings( uploaders[i], managers[i] );
+			}
+		}
+	} );
+
+	scheduler.Shutdown();
+
+	bool matching = true;
+
+	for ( unsigned int i = 0; i < threads; i++ ) {
+		Vector4f color( static_cast<float>( i ), static_cast<float>( frames - 1 ), 0.0f, 1.0f );
+		Matrix4f transform = Matrix4f::RotationMatrixZ( 0.01f * ( frames - 1 ) );
+		matching = matching && HoldsValues( uploaders[i]->GetContents( pBuffer ), color, transform );
+	}
+
+	CHECK( matching );
+
+	for ( unsigned int i = 0; i < threads; i++ ) {
+		delete uploaders[i];
+		delete managers[i];
+	}
+
+	delete pBuffer;
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( ConstantBufferBatchUploads )
+{
+	ConstantBufferDX11 buffer( nullptr );
+
+	D3D11_BUFFER_DESC desc;
+	memset( &desc, 0, sizeof( desc ) );
+	desc.ByteWidth = 100 * ConstantBufferBatchDX11::BlockAlignment;
+	buffer.SetDesiredDescription( desc );
+
+	// A hundred draws with a world matrix each, which would otherwise map the
+	// per-object buffer once for every draw.
+
+	ConstantBufferBatchDX11 batch;
+	bool aligned = true;
+
+	for ( unsigned int draw = 0; draw < 100; draw++ ) {
+		Matrix4f world = Matrix4f::TranslationMatrix( static_cast<float>( draw ), 0.0f, 0.0f );
+		const unsigned int offset = batch.AddBlock( &world, sizeof( world ) );
+		aligned = aligned && offset == draw * ConstantBufferBatchDX11::BlockAlignment;
+	}
+
+	CHECK( aligned );
+	CHECK( batch.GetBlockCount() == 100 );
+	CHECK( ConstantBufferBatchDX11::GetFirstConstant( batch.GetBlockOffset( 99 ) ) == 99 * 16 );
+	CHECK( ConstantBufferBatchDX11::GetConstantCount( batch.GetBlockSize( 0 ) ) == 16 );
+
+	RecordingConstantBufferUploader uploader;
+	CHECK( batch.Upload( &buffer, &uploader ) );
+
+	printf( "  100 draws\n" );
+	printf( "  per draw: 100 maps, %u bytes\n", 100 * static_cast<unsigned int>( sizeof( Matrix4f ) ) );
+	printf( "  batched:  %u map, %u bytes\n", uploader.GetTotalStatistics().maps, uploader.GetTotalStatistics().bytesUploaded );
+
+	CHECK( uploader.GetTotalStatistics().maps == 1 );
+	CHECK( uploader.GetTotalStatistics().bytesUploaded == 100 * ConstantBufferBatchDX11::BlockAlignment );
+
+	const std::vector<char>* pContents = uploader.GetContents( &buffer );
+	Matrix4f last = Matrix4f::TranslationMatrix( 99.0f, 0.0f, 0.0f );
+	CHECK( pContents != nullptr && memcmp( pContents->data() + batch.GetBlockOffset( 99 ), &last, sizeof( last ) ) == 0 );
+
+	// The batch has to fit into the buffer, and each of its blocks into the
+	// 64 KB that a shader can access.
+
+	batch.AddBlock( &last, sizeof( last ) );
+	CHECK( !batch.Upload( &buffer, &uploader ) );
+	CHECK( !batch.Upload( nullptr, &uploader ) );
+
+	batch.Reset();
+	unsigned int offset = 0;
+	batch.AllocateBlock( 65536 + 16, offset );
+	desc.ByteWidth = batch.GetSize();
+	buffer.SetDesiredDescription( desc );
+	CHECK( !batch.Upload( &buffer, &uploader ) );
+
+	batch.Reset();
+	batch.AllocateBlock( 65536, offset );
+	CHECK( batch.Upload( &buffer, &uploader ) );
+	CHECK( uploader.GetTotalStatistics().maps == 2 );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,145 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TestFramework.h"
+#include "GeometryCacheDX11.h"
+#include "TestGeometry.h"
+#include <cstdio>
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	const char* CacheFile = "GeometryCacheTest.mesh";
+	const wchar_t* CacheFileW = L"GeometryCacheTest.mesh";
+
+	// A grid of quads in the XY plane, with positions, normals and texture
+	// coordinates like the loaders produce them.
+
+	GeometryPtr CreateSlopedGrid( int size )
+	{
+		return( CreateGrid( size, true, [size]( int x, int y, GridVertex& vertex ) {
+			vertex.Position = Vector3f( static_cast<float>( x ), static_cast<float>( y ), 0.5f * x );
+			vertex.TexCoord = Vector2f( static_cast<float>( x ) / size, static_cast<float>( y ) / size );
+		} ) );
+	}
+};
+//--------------------------------------------------------------------------------
+TEST_CASE( GeometryCacheRoundTrip )
+{
+	GeometryPtr pGeometry = CreateSlopedGrid( 8 );
+
+	std::vector<char> original;
+	pGeometry->InterleaveVertices( original );
+
+	CHECK( GeometryCacheDX11::Write( CacheFileW, *pGeometry, 1234 ) );
+
+	GeometryPtr pCached = GeometryCacheDX11::Read( CacheFileW, 1234 );
+	CHECK( pCached != nullptr );
+
+	if ( pCached == nullptr )
+		return;
+
+	// The cached geometry only holds the interleaved stream at first, which has
+	// to match the original vertices and indices exactly.
+
+	std::vector<char> restored;
+	pCached->InterleaveVertices( restored );
+
+	CHECK( pCached->m_vElements.size() == 0 );
+	CHECK( restored == original );
+	CHECK( pCached->m_vIndices == pGeometry->m_vIndices );
+	CHECK( pCached->GetPrimitiveType() == pGeometry->GetPrimitiveType() );
+	CHECK( pCached->GetVertexSize() == pGeometry->CalculateVertexSize() );
+
+	Sphere3f bounds;
+	CHECK( pCached->GetModelBounds( bounds ) );
+	CHECK( bounds.center == pGeometry->GetBounds().center );
+	CHECK( bounds.radius == pGeometry->GetBounds().radius );
+
+	std::vector<D3D11_INPUT_ELEMENT_DESC> layout;
+	pCached->GetInputElementDescs( layout );
+	CHECK( layout.size() == 3 );
+	CHECK( layout.size() == 3 && std::string( layout[1].SemanticName ) == VertexElementDX11::TexCoordSemantic );
+
+	// Getting the bounds and the layout doesn't need the elements, but asking
+	// for one rebuilds all of them from the stream.
+
+	CHECK( pCached->m_vElements.size() == 0 );
+
+	VertexElementDX11* pPositions = pCached->GetElement( VertexElementDX11::PositionSemantic );
+	CHECK( pPositions != nullptr );
+	CHECK( pCached->GetElementCount() == 3 );
+	CHECK( pCached->m_vVertexStream.size() == 0 );
+
+	if ( pPositions != nullptr )
+	{
+		VertexElementDX11* pExpected = pGeometry->GetElement( VertexElementDX11::PositionSemantic );
+
+		CHECK( pPositions->Tuple() == 3 && pPositions->Count() == pExpected->Count() );
+		CHECK( memcmp( pPositions->GetPtr( 0 ), pExpected->GetPtr( 0 ), pExpected->Count() * pExpected->SizeInBytes() ) == 0 );
+	}
+
+	pCached->InterleaveVertices( restored );
+	CHECK( restored == original );
+
+	// The element based processing works on cached geometry like on the
+	// original geometry.
+
+	CHECK( pCached->ComputeTangentFrame() );
+	CHECK( pGeometry->ComputeTangentFrame() );
+
+	VertexElementDX11* pTangents = pCached->GetElement( VertexElementDX11::TangentSemantic );
+	VertexElementDX11* pExpected = pGeometry->GetElement( VertexElementDX11::TangentSemantic );
+	CHECK( pTangents != nullptr && pExpected != nullptr );
+
+	if ( pTangents != nullptr && pExpected != nullptr )
+		CHECK( memcmp( pTangents->GetPtr( 0 ), pExpected->GetPtr( 0 ), pExpected->Count() * pExpected->SizeInBytes() ) == 0 );
+
+	std::remove( CacheFile );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( GeometryCacheRejectsStaleFiles )
+{
+	GeometryPtr pGeometry = CreateSlopedGrid( 4 );
+
+	CHECK( GeometryCacheDX11::Write( CacheFileW, *pGeometry, 1234 ) );
+	CHECK( GeometryCacheDX11::Read( CacheFileW, 1235 ) == nullptr );
+
+	// A file that was only partially written is a miss as well.
+
+	std::vector<char> image;
+	{
+		std::ifstream file( CacheFile, std::ios::in | std::ios::binary );
+		image.assign( std::istreambuf_iterator<char>( file ), std::istreambuf_iterator<char>() );
+	}
+	{
+		std::ofstream file( CacheFile, std::ios::out | std::ios::binary | std::ios::trunc );
+		file.write( image.data(), image.size() - 4 );
+	}
+
+	CHECK( image.size() > 4 );
+	CHECK( GeometryCacheDX11::Read( CacheFileW, 1234 ) == nullptr );
+
+	std::remove( CacheFile );
+
+	// The key changes with the options and with the version of the loader, so
+	// changing the output of a loader never reuses files that it cooked before.
+
+	const unsigned long long key = GeometryCacheDX11::GetKey( 42, "ms3d", 1 );
+
+	CHECK( key == GeometryCacheDX11::GetKey( 42, "ms3d", 1 ) );
+	CHECK( key != GeometryCacheDX11::GetKey( 43, "ms3d", 1 ) );
+	CHECK( key != GeometryCacheDX11::GetKey( 42, "ply", 1 ) );
+	CHECK( key != GeometryCacheDX11::GetKey( 42, "ms3d", 2 ) );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,534 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TestFramework.h"
+#include "GeometryLoaderDX11.h"
+#include "FileSystem.h"
+#include "MeshSTL.h"
+#include "JobScheduler.h"
+#include <cfloat>
+#include <cstdio>
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	// The loaders read from the models folder, so the test files are written
+	// there as well.  The tests are skipped if the folder can't be found from
+	// the working directory.
+
+	bool ModelsFolderExists()
+	{
+		FileSystem fs;
+		return( fs.FileExists( fs.GetModelsFolder() + L"box.ms3d" ) );
+	}
+
+	std::string ModelPath( const std::wstring& filename )
+	{
+		FileSystem fs;
+		std::wstring path = fs.GetModelsFolder() + filename;
+		return( std::string( path.begin(), path.end() ) );
+	}
+
+	// Appends a value in little or big endian byte order.
+
+	template <typename T>
+	void AppendBinary( std::string& data, T value, bool bigEndian )
+	{
+		char bytes[sizeof( T )];
+		memcpy( bytes, &value, sizeof( T ) );
+
+		if ( bigEndian )
+			std::reverse( bytes, bytes + sizeof( T ) );
+
+		data.append( bytes, sizeof( T ) );
+	}
+
+	// A PLY mesh of size by size quads with positions and normals, which also
+	// has a few properties and an element that the loader has to skip over.
+
+	struct PlyMesh
+	{
+		PlyMesh( int size )
+		{
+			for ( int y = 0; y <= size; y++ ) {
+				for ( int x = 0; x <= size; x++ ) {
+					Positions.push_back( Vector3f( x * 0.5f, y * 0.25f, ( x + y ) * 0.125f ) );
+					Normals.push_back( Vector3f( 0.0f, 0.0f, ( x % 2 ) ? 1.0f : -1.0f ) );
+				}
+			}
+
+			for ( int y = 0; y < size; y++ ) {
+				for ( int x = 0; x < size; x++ ) {
+					const int v = y * ( size + 1 ) + x;
+					const int triangles[6] = { v, v + size + 1, v + 1, v + 1, v + size + 1, v + size + 2 };
+					Indices.insert( Indices.end(), triangles, triangles + 6 );
+				}
+			}
+		}
+
+		std::string Write( const std::string& format ) const
+		{
+			const unsigned int faces = static_cast<unsigned int>( Indices.size() / 3 );
+
+			std::ostringstream header;
+			header << "ply\nformat " << format << " 1.0\ncomment written by the unit tests\n"
+				<< "element vertex " << Positions.size() << "\n"
+				<< "property float x\nproperty float32 y\nproperty float z\n"
+				<< "property uchar red\n"
+				<< "property float nx\nproperty float ny\nproperty float nz\n"
+				<< "element face " << faces << "\n"
+				<< "property int flags\n"
+				<< "property list uchar int vertex_indices\n"
+				<< "element edge 1\nproperty int vertex1\nproperty int vertex2\n"
+				<< "end_header\n";
+
+			std::string data = header.str();
+
+			if ( format == "ascii" )
+			{
+				std::ostringstream body;
+
+				for ( size_t i = 0; i < Positions.size(); i++ ) {
+					body << Positions[i].x << " " << Positions[i].y << " " << Positions[i].z << " 255 "
+						<< Normals[i].x << " " << Normals[i].y << " " << Normals[i].z << "\n";
+				}
+
+				for ( unsigned int f = 0; f < faces; f++ )
+					body << "7 3 " << Indices[f*3] << " " << Indices[f*3+1] << " " << Indices[f*3+2] << "\n";
+
+				body << "0 1\n";
+				data += body.str();
+			}
+			else
+			{
+				const bool bigEndian = format == "binary_big_endian";
+
+				for ( size_t i = 0; i < Positions.size(); i++ ) {
+					AppendBinary( data, Positions[i].x, bigEndian );
+					AppendBinary( data, Positions[i].y, bigEndian );
+					AppendBinary( data, Positions[i].z, bigEndian );
+					AppendBinary( data, static_cast<unsigned char>( 255 ), bigEndian );
+					AppendBinary( data, Normals[i].x, bigEndian );
+					AppendBinary( data, Normals[i].y, bigEndian );
+					AppendBinary( data, Normals[i].z, bigEndian );
+				}
+
+				for ( unsigned int f = 0; f < faces; f++ ) {
+					AppendBinary( data, 7, bigEndian );
+					AppendBinary( data, static_cast<unsigned char>( 3 ), bigEndian );
+					for ( int c = 0; c < 3; c++ )
+						AppendBinary( data, Indices[f*3+c], bigEndian );
+				}
+
+				AppendBinary( data, 0, bigEndian );
+				AppendBinary( data, 1, bigEndian );
+			}
+
+			return( data );
+		}
+
+		std::vector<Vector3f> Positions;
+		std::vector<Vector3f> Normals;
+		std::vector<int> Indices;
+	};
+
+	bool WriteTestFile( const std::string& path, const std::string& data )
+	{
+		std::ofstream file( path, std::ios::binary );
+		file.write( data.data(), data.size() );
+		return( file.good() );
+	}
+
+	bool MatchesPlyMesh( GeometryPtr pGeometry, const PlyMesh& mesh )
+	{
+		VertexElementDX11* pPositions = pGeometry->GetElement( VertexElementDX11::PositionSemantic );
+		VertexElementDX11* pNormals = pGeometry->GetElement( VertexElementDX11::NormalSemantic );
+
+		if ( pPositions == nullptr || pNormals == nullptr || pGeometry->GetElementCount() != 2 )
+			return( false );
+
+		if ( pPositions->Count() != static_cast<int>( mesh.Positions.size() ) || pGeometry->GetIndexCount() != mesh.Indices.size() )
+			return( false );
+
+		if ( pGeometry->GetPrimitiveType() != D3D11_PRIMITIVE_TOPOLOGY_3_CONTROL_POINT_PATCHLIST )
+			return( false );
+
+		for ( size_t i = 0; i < mesh.Positions.size(); i++ ) {
+			if ( *pPositions->Get3f( i ) != mesh.Positions[i] || *pNormals->Get3f( i ) != mesh.Normals[i] )
+				return( false );
+		}
+
+		for ( size_t i = 0; i < mesh.Indices.size(); i++ ) {
+			if ( pGeometry->GetIndex( i ) != static_cast<UINT>( mesh.Indices[i] ) )
+				return( false );
+		}
+
+		return( true );
+	}
+
+	// STL meshes are lists of separate triangles.  The box shares each corner
+	// between faces with three different normals, and the grid is a height
+	// field with round coordinates, which print exactly in ascii files.
+
+	std::vector<STL::MeshSTL::Face> CreateStlFaces( const std::vector<Vector3f>& positions, const std::vector<int>& indices )
+	{
+		std::vector<STL::MeshSTL::Face> faces( indices.size() / 3 );
+
+		for ( size_t f = 0; f < faces.size(); f++ ) {
+			faces[f].v0 = positions[indices[f*3]];
+			faces[f].v1 = positions[indices[f*3+1]];
+			faces[f].v2 = positions[indices[f*3+2]];
+			faces[f].normal = Vector3f::Cross( faces[f].v1 - faces[f].v0, faces[f].v2 - faces[f].v0 );
+			faces[f].normal.Normalize();
+		}
+
+		return( faces );
+	}
+
+	std::vector<STL::MeshSTL::Face> CreateStlBox()
+	{
+		std::vector<Vector3f> corners;
+
+		for ( int i = 0; i < 8; i++ )
+			corners.push_back( Vector3f( ( i & 1 ) ? 1.0f : -1.0f, ( i & 2 ) ? 1.0f : -1.0f, ( i & 4 ) ? 1.0f : -1.0f ) );
+
+		const int indices[36] = {
+			0, 2, 1, 1, 2, 3,	4, 5, 6, 5, 7, 6,
+			0, 1, 4, 1, 5, 4,	2, 6, 3, 3, 6, 7,
+			0, 4, 2, 2, 4, 6,	1, 3, 5, 3, 7, 5 };
+
+		return( CreateStlFaces( corners, std::vector<int>( indices, indices + 36 ) ) );
+	}
+
+	std::vector<STL::MeshSTL::Face> CreateStlGrid( int size )
+	{
+		PlyMesh mesh( size );
+
+		for ( size_t i = 0; i < mesh.Positions.size(); i++ )
+			mesh.Positions[i].z = static_cast<float>( i % 7 ) * 0.125f;
+
+		return( CreateStlFaces( mesh.Positions, mesh.Indices ) );
+	}
+
+	std::string WriteBinaryStl( const std::vector<STL::MeshSTL::Face>& faces )
+	{
+		// The header starts with 'solid' on purpose, which some exporters do
+		// for binary files as well.
+
+		std::string data( "solid binary file written by the unit tests" );
+		data.resize( 80, ' ' );
+		AppendBinary( data, static_cast<unsigned int>( faces.size() ), false );
+
+		for ( auto& face : faces ) {
+			data.append( reinterpret_cast<const char*>( &face ), sizeof( face ) );
+			AppendBinary( data, static_cast<unsigned short>( 0 ), false );
+		}
+
+		return( data );
+	}
+
+	std::string WriteAsciiStl( const std::vector<STL::MeshSTL::Face>& faces )
+	{
+		std::ostringstream body;
+		body.precision( 9 );
+		body << "solid test\n";
+
+		for ( auto& face : faces ) {
+			body << "  facet normal " << face.normal.x << " " << face.normal.y << " " << face.normal.z << "\n"
+				<< "    outer loop\n"
+				<< "      vertex " << face.v0.x << " " << face.v0.y << " " << face.v0.z << "\n"
+				<< "      vertex " << face.v1.x << " " << face.v1.y << " " << face.v1.z << "\n"
+				<< "      vertex " << face.v2.x << " " << face.v2.y << " " << face.v2.z << "\n"
+				<< "    endloop\n"
+				<< "  endfacet\n";
+		}
+
+		body << "endsolid test\n";
+
+		return( body.str() );
+	}
+
+	float LargestDifference( const std::vector<Vector3f>& a, const std::vector<Vector3f>& b )
+	{
+		if ( a.size() != b.size() )
+			return( FLT_MAX );
+
+		float difference = 0.0f;
+
+		for ( size_t i = 0; i < a.size(); i++ ) {
+			difference = max( difference, fabs( a[i].x - b[i].x ) );
+			difference = max( difference, fabs( a[i].y - b[i].y ) );
+			difference = max( difference, fabs( a[i].z - b[i].z ) );
+		}
+
+		return( difference );
+	}
+
+	std::vector<Vector3f> FacePositions( const std::vector<STL::MeshSTL::Face>& faces )
+	{
+		std::vector<Vector3f> positions;
+
+		for ( auto& face : faces ) {
+			positions.push_back( face.v0 );
+			positions.push_back( face.v1 );
+			positions.push_back( face.v2 );
+		}
+
+		return( positions );
+	}
+
+	// The largest difference between the corners of the triangles of two
+	// indexed triangle lists, over all of the elements of the first one.
+
+	float LargestCornerDifference( GeometryPtr pGeometry, GeometryPtr pReference )
+	{
+		if ( pGeometry->GetIndexCount() != pReference->GetIndexCount() || pGeometry->GetElementCount() != pReference->GetElementCount() )
+			return( FLT_MAX );
+
+		float difference = 0.0f;
+
+		for ( int e = 0; e < pGeometry->GetElementCount(); e++ )
+		{
+			VertexElementDX11* pElement = pGeometry->GetElement( e );
+			VertexElementDX11* pOther = pReference->GetElement( pElement->m_SemanticName );
+
+			if ( pOther == nullptr || pOther->m_Format != pElement->m_Format )
+				return( FLT_MAX );
+
+			for ( UINT i = 0; i < pGeometry->GetIndexCount(); i++ )
+			{
+				const float* pA = ( *pElement )[pGeometry->GetIndex( i )];
+				const float* pB = ( *pOther )[pReference->GetIndex( i )];
+
+				// Integer elements (i.e. bone IDs) have to match exactly.
+
+				for ( int c = 0; c < pElement->Tuple(); c++ )
+				{
+					if ( pElement->m_Format == DXGI_FORMAT_R32_SINT ) {
+						if ( memcmp( &pA[c], &pB[c], sizeof( int ) ) != 0 )
+							return( FLT_MAX );
+					} else {
+						difference = max( difference, fabs( pA[c] - pB[c] ) );
+					}
+				}
+			}
+		}
+
+		return( difference );
+	}
+};
+//--------------------------------------------------------------------------------
+TEST_CASE( PlyLoaderFormats )
+{
+	if ( !ModelsFolderExists() )
+		return;
+
+	// The same mesh has to come out of all three encodings, with the extra
+	// properties and elements skipped.
+
+	PlyMesh mesh( 6 );
+	const char* formats[] = { "ascii", "binary_little_endian", "binary_big_endian" };
+
+	for ( auto format : formats )
+	{
+		CHECK( WriteTestFile( ModelPath( L"PlyLoaderTest.ply" ), mesh.Write( format ) ) );
+
+		GeometryPtr pGeometry = GeometryLoaderDX11::loadStanfordPlyData( L"PlyLoaderTest.ply" );
+		CHECK( MatchesPlyMesh( pGeometry, mesh ) );
+
+		// The adjacency variant emits each triangle followed by the vertices
+		// across its edges.  The first two triangles share their second edge.
+
+		GeometryPtr pAdjacency = GeometryLoaderDX11::loadStanfordPlyData( L"PlyLoaderTest.ply", true );
+		CHECK( pAdjacency->GetIndexCount() == mesh.Indices.size() * 2 );
+		CHECK( pAdjacency->GetIndex( 6 ) == pGeometry->GetIndex( 3 ) && pAdjacency->GetIndex( 8 ) == pGeometry->GetIndex( 5 ) );
+		CHECK( pAdjacency->GetIndex( 4 ) == pGeometry->GetIndex( 5 ) );
+	}
+
+	std::remove( ModelPath( L"PlyLoaderTest.ply" ).c_str() );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( PlyLoaderBenchmark )
+{
+	if ( !ModelsFolderExists() )
+		return;
+
+	const wchar_t* models[] = { L"BoxWithBadNormals.ply", L"CPNAdaptiveTest.ply", L"CPNTest.ply", L"spaceship.ply", L"spaceship2.ply", L"suzanne.ply" };
+	const int iterations = 200;
+
+	for ( auto model : models )
+	{
+		TestTimer timer;
+		GeometryPtr pGeometry;
+
+		for ( int i = 0; i < iterations; i++ )
+			pGeometry = GeometryLoaderDX11::loadStanfordPlyData( model );
+
+		const double time = timer.Milliseconds() / iterations;
+		const std::wstring name( model );
+
+		CHECK( pGeometry->GetIndexCount() > 0 );
+
+		printf( "  %-22s %6d vertices, %6u indices, %.3f ms\n", std::string( name.begin(), name.end() ).c_str(),
+			pGeometry->GetElement( VertexElementDX11::PositionSemantic )->Count(), pGeometry->GetIndexCount(), time );
+	}
+
+	// The bundled models are small, so a larger grid is timed in each format
+	// to show the throughput of the readers.
+
+	PlyMesh mesh( 256 );
+	const char* formats[] = { "ascii", "binary_little_endian", "binary_big_endian" };
+
+	for ( auto format : formats )
+	{
+		const std::string data = mesh.Write( format );
+		CHECK( WriteTestFile( ModelPath( L"PlyLoaderTest.ply" ), data ) );
+
+		TestTimer timer;
+		GeometryPtr pGeometry;
+
+		for ( int i = 0; i < 10; i++ )
+			pGeometry = GeometryLoaderDX11::loadStanfordPlyData( L"PlyLoaderTest.ply" );
+
+		const double time = timer.Milliseconds() / 10;
+
+		CHECK( MatchesPlyMesh( pGeometry, mesh ) );
+
+		printf( "  %-22s %6u vertices, %6u indices, %.3f ms, %.1f MB/s\n", format, static_cast<unsigned int>( mesh.Positions.size() ),
+			pGeometry->GetIndexCount(), time, data.size() / ( time * 1000.0 ) );
+	}
+
+	std::remove( ModelPath( L"PlyLoaderTest.ply" ).c_str() );
+}
+//
+//--------------------------------------------------------------------------------
+TEST_CASE( StlLoaderFormats )
+{
+	if ( !ModelsFolderExists() )
+		return;
+
+	// The binary and the ascii file of the same mesh have to load to the same
+	// faces, and weld to the same indexed mesh.  The box has eight corners,
+	// which are split into four vertices per side when the normals are kept
+	// faceted.
+
+	FileSystem fs;
+	const std::wstring path = fs.GetModelsFolder() + L"StlLoaderTest.stl";
+
+	const std::vector<STL::MeshSTL::Face> box = CreateStlBox();
+	const std::vector<STL::MeshSTL::Face> grid = CreateStlGrid( 16 );
+
+	for ( int binary = 0; binary < 2; binary++ )
+	{
+		CHECK( WriteTestFile( ModelPath( L"StlLoaderTest.stl" ), binary ? WriteBinaryStl( box ) : WriteAsciiStl( box ) ) );
+
+		STL::MeshSTL stl( path );
+		CHECK( stl.faces.size() == box.size() );
+		CHECK( LargestDifference( FacePositions( stl.faces ), FacePositions( box ) ) < 1e-6f );
+
+		stl.Weld( true );
+		CHECK( stl.positions.size() == 8 && stl.normals.size() == 8 && stl.indices.size() == 36 );
+
+		stl.Weld( false );
+		CHECK( stl.positions.size() == 24 && stl.normals.size() == 24 && stl.indices.size() == 36 );
+
+		// Every vertex of the height field is shared by its neighbouring faces.
+
+		CHECK( WriteTestFile( ModelPath( L"StlLoaderTest.stl" ), binary ? WriteBinaryStl( grid ) : WriteAsciiStl( grid ) ) );
+
+		STL::MeshSTL surface( path );
+		CHECK( LargestDifference( FacePositions( surface.faces ), FacePositions( grid ) ) < 1e-6f );
+
+		surface.Weld( true );
+		CHECK( surface.positions.size() == 17 * 17 && surface.indices.size() == grid.size() * 3 );
+	}
+
+	std::remove( ModelPath( L"StlLoaderTest.stl" ).c_str() );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( StlLoaderBenchmark )
+{
+	if ( !ModelsFolderExists() )
+		return;
+
+	FileSystem fs;
+	const std::wstring path = fs.GetModelsFolder() + L"StlLoaderTest.stl";
+
+	const int size = 256;
+	const std::vector<STL::MeshSTL::Face> grid = CreateStlGrid( size );
+
+	JobScheduler scheduler;
+	scheduler.Initialize( 4 );
+
+	printf( "  %u faces\n", static_cast<unsigned int>( grid.size() ) );
+
+	for ( int binary = 1; binary >= 0; binary-- )
+	{
+		const std::string data = binary ? WriteBinaryStl( grid ) : WriteAsciiStl( grid );
+		CHECK( WriteTestFile( ModelPath( L"StlLoaderTest.stl" ), data ) );
+
+		for ( int threads = 0; threads < 2; threads++ )
+		{
+			TestTimer timer;
+			STL::MeshSTL stl( path, threads ? &scheduler : nullptr );
+			const double loadTime = timer.Milliseconds();
+
+			timer.Reset();
+			stl.Weld( true );
+			const double weldTime = timer.Milliseconds();
+
+			CHECK( stl.faces.size() == grid.size() );
+			CHECK( stl.positions.size() == ( size + 1 ) * ( size + 1 ) && stl.indices.size() == grid.size() * 3 );
+
+			printf( "  %-6s %-9s load %.3f ms (%.1f MB/s), weld %.3f ms\n", binary ? "binary" : "ascii", threads ? "4 threads" : "1 thread",
+				loadTime, data.size() / ( loadTime * 1000.0 ), weldTime );
+		}
+	}
+
+	std::remove( ModelPath( L"StlLoaderTest.stl" ).c_str() );
+}
+//
+//--------------------------------------------------------------------------------
+TEST_CASE( MS3DLoaderWelding )
+{
+	if ( !ModelsFolderExists() )
+		return;
+
+	// Welding may only merge corners that are identical, so expanding the
+	// indexed triangles again has to give back the triangles of the file.
+
+	const wchar_t* models[] = { L"Sample_Scene.ms3d", L"Screen.ms3d", L"ScreenFrame.ms3d", L"TBone.ms3d", L"UnitSphere2.ms3d",
+		L"Walker.ms3d", L"bowl.ms3d", L"box.ms3d", L"hedra.ms3d", L"small_box.ms3d", L"spring.ms3d" };
+
+	for ( auto model : models )
+	{
+		GeometryPtr pWelded = GeometryLoaderDX11::loadMS3DFile2( model );
+		GeometryPtr pSoup = GeometryLoaderDX11::loadMS3DFile2( model, false );
+
+		CHECK( pWelded != nullptr && pSoup != nullptr );
+
+		if ( pWelded == nullptr || pSoup == nullptr )
+			continue;
+
+		const int soupVertices = pSoup->GetElement( VertexElementDX11::PositionSemantic )->Count();
+		const int weldedVertices = pWelded->GetElement( VertexElementDX11::PositionSemantic )->Count();
+
+		CHECK( soupVertices == static_cast<int>( pSoup->GetIndexCount() ) );
+		CHECK( weldedVertices <= soupVertices );
+		CHECK( LargestCornerDifference( pWelded, pSoup ) < 1e-6f );
+
+		const std::wstring name( model );
+		printf( "  %-18s %6d corners, %6d welded vertices\n", std::string( name.begin(), name.end() ).c_str(), soupVertices, weldedVertices );
+	}
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
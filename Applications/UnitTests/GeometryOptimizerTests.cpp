@@ -0,0 +1,208 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TestFramework.h"
+#include "GeometryOptimizerDX11.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	const unsigned int GridSize = 64;
+	const unsigned int GridVertices = ( GridSize + 1 ) * ( GridSize + 1 );
+
+	// A regular grid of quads, with its triangles in a shuffled order so that
+	// the vertex cache starts out being used badly.
+
+	void CreateShuffledGrid( std::vector<UINT>& indices, std::vector<Vector3f>& positions )
+	{
+		positions.clear();
+		indices.clear();
+
+		for ( unsigned int y = 0; y <= GridSize; y++ ) {
+			for ( unsigned int x = 0; x <= GridSize; x++ ) {
+				positions.push_back( Vector3f( static_cast<float>( x ), static_cast<float>( y ), 0.0f ) );
+			}
+		}
+
+		std::vector<UINT> triangles;
+
+		for ( unsigned int y = 0; y < GridSize; y++ ) {
+			for ( unsigned int x = 0; x < GridSize; x++ ) {
+				const UINT v = y * ( GridSize + 1 ) + x;
+				const UINT quad[6] = { v, v + GridSize + 1, v + 1, v + 1, v + GridSize + 1, v + GridSize + 2 };
+				triangles.insert( triangles.end(), quad, quad + 6 );
+			}
+		}
+
+		const unsigned int triangleCount = static_cast<unsigned int>( triangles.size() / 3 );
+		std::vector<unsigned int> order( triangleCount );
+
+		for ( unsigned int t = 0; t < triangleCount; t++ ) {
+			order[t] = t;
+		}
+
+		unsigned int seed = 12345;
+
+		for ( unsigned int t = triangleCount - 1; t > 0; t-- ) {
+			seed = seed * 1664525 + 1013904223;
+			std::swap( order[t], order[( seed >> 8 ) % ( t + 1 )] );
+		}
+
+		for ( auto t : order ) {
+			indices.insert( indices.end(), triangles.begin() + t * 3, triangles.begin() + t * 3 + 3 );
+		}
+	}
+
+	// The triangles as a sorted list, with each of them rotated so that their
+	// smallest index comes first.  This keeps the winding of each triangle, so
+	// two lists only compare equal if the same triangles are drawn.
+
+	std::vector<std::vector<UINT>> SortedTriangles( const std::vector<UINT>& indices )
+	{
+		std::vector<std::vector<UINT>> triangles;
+
+		for ( size_t i = 0; i + 2 < indices.size(); i += 3 )
+		{
+			std::vector<UINT> triangle( indices.begin() + i, indices.begin() + i + 3 );
+			std::rotate( triangle.begin(), std::min_element( triangle.begin(), triangle.end() ), triangle.end() );
+			triangles.push_back( triangle );
+		}
+
+		std::sort( triangles.begin(), triangles.end() );
+
+		return( triangles );
+	}
+};
+//--------------------------------------------------------------------------------
+TEST_CASE( GeometryOptimizerCachePasses )
+{
+	std::vector<UINT> indices;
+	std::vector<Vector3f> positions;
+	CreateShuffledGrid( indices, positions );
+
+	const std::vector<UINT> original = indices;
+	const VertexCacheStatistics before = GeometryOptimizerDX11::SimulateVertexCache( indices, GridVertices );
+
+	TestTimer timer;
+	CHECK( GeometryOptimizerDX11::OptimizeVertexCache( indices, GridVertices ) );
+	const double cacheTime = timer.Milliseconds();
+
+	const VertexCacheStatistics cache = GeometryOptimizerDX11::SimulateVertexCache( indices, GridVertices );
+
+	CHECK( SortedTriangles( indices ) == SortedTriangles( original ) );
+
+	timer.Reset();
+	CHECK( GeometryOptimizerDX11::OptimizeOverdraw( indices, positions.data(), GridVertices ) );
+	const double overdrawTime = timer.Milliseconds();
+
+	const VertexCacheStatistics overdraw = GeometryOptimizerDX11::SimulateVertexCache( indices, GridVertices );
+
+	CHECK( SortedTriangles( indices ) == SortedTriangles( original ) );
+
+	printf( "  %u triangles, %u vertices\n", before.triangles, before.vertices );
+	printf( "  shuffled:     ACMR %.3f, ATVR %.3f\n", before.acmr, before.atvr );
+	printf( "  vertex cache: ACMR %.3f, ATVR %.3f, %.3f ms\n", cache.acmr, cache.atvr, cacheTime );
+	printf( "  overdraw:     ACMR %.3f, ATVR %.3f, %.3f ms\n", overdraw.acmr, overdraw.atvr, overdrawTime );
+
+	// A grid can't go below an ACMR of 0.5, and a shuffled one is close to the
+	// worst case of 3.0.
+
+	CHECK( before.acmr > 2.0f );
+	CHECK( cache.acmr < 0.8f );
+	CHECK( overdraw.acmr < cache.acmr * 1.1f );
+
+	// The vertex fetch remap is a permutation, which numbers the vertices in
+	// the order of their first use.
+
+	std::vector<UINT> remap;
+	CHECK( GeometryOptimizerDX11::GenerateVertexFetchRemap( indices, GridVertices, remap ) );
+	CHECK( remap.size() == GridVertices );
+	CHECK( remap.size() > 0 && remap[indices[0]] == 0 );
+
+	std::vector<UINT> sorted = remap;
+	std::sort( sorted.begin(), sorted.end() );
+
+	bool permutation = true;
+	for ( UINT v = 0; v < sorted.size(); v++ ) {
+		permutation = permutation && sorted[v] == v;
+	}
+	CHECK( permutation );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( GeometryOptimizerKeepsGeometry )
+{
+	std::vector<UINT> indices;
+	std::vector<Vector3f> positions;
+	CreateShuffledGrid( indices, positions );
+
+	GeometryPtr pGeometry = GeometryPtr( new GeometryDX11() );
+	pGeometry->SetPrimitiveType( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+	pGeometry->m_vIndices = indices;
+
+	VertexElementDX11* pPositions = new VertexElementDX11( 3, GridVertices );
+	pPositions->m_SemanticName = VertexElementDX11::PositionSemantic;
+	pPositions->m_uiSemanticIndex = 0;
+	pPositions->m_Format = DXGI_FORMAT_R32G32B32_FLOAT;
+
+	for ( unsigned int v = 0; v < GridVertices; v++ ) {
+		*pPositions->Get3f( v ) = positions[v];
+	}
+
+	pGeometry->AddElement( pPositions );
+
+	CHECK( GeometryOptimizerDX11::Optimize( pGeometry ) );
+
+	// The vertices have moved, so the triangles are compared by the positions
+	// of their corners instead of by their indices.
+
+	std::vector<UINT> expected;
+	std::vector<UINT> optimized;
+
+	for ( auto index : indices ) {
+		const Vector3f& p = positions[index];
+		expected.push_back( static_cast<UINT>( p.y ) * ( GridSize + 1 ) + static_cast<UINT>( p.x ) );
+	}
+
+	for ( auto index : pGeometry->m_vIndices ) {
+		const Vector3f& p = *pPositions->Get3f( index );
+		optimized.push_back( static_cast<UINT>( p.y ) * ( GridSize + 1 ) + static_cast<UINT>( p.x ) );
+	}
+
+	CHECK( SortedTriangles( optimized ) == SortedTriangles( expected ) );
+	CHECK( GeometryOptimizerDX11::SimulateVertexCache( pGeometry ).acmr < 0.8f );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( GeometryOptimizerRejectsInvalidIndices )
+{
+	std::vector<UINT> indices;
+	std::vector<Vector3f> positions;
+	CreateShuffledGrid( indices, positions );
+
+	indices[7] = GridVertices;
+	const std::vector<UINT> original = indices;
+
+	std::vector<UINT> remap;
+
+	CHECK( !GeometryOptimizerDX11::OptimizeVertexCache( indices, GridVertices ) );
+	CHECK( !GeometryOptimizerDX11::OptimizeOverdraw( indices, positions.data(), GridVertices ) );
+	CHECK( !GeometryOptimizerDX11::GenerateVertexFetchRemap( indices, GridVertices, remap ) );
+	CHECK( indices == original );
+	CHECK( remap.empty() );
+
+	// Empty index lists are valid, and there is nothing to do for them.
+
+	std::vector<UINT> empty;
+	CHECK( GeometryOptimizerDX11::OptimizeVertexCache( empty, 0 ) );
+	CHECK( GeometryOptimizerDX11::OptimizeOverdraw( empty, nullptr, 0 ) );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
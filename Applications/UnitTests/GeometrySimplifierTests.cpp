@@ -0,0 +1,245 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TestFramework.h"
+#include "GeometrySimplifierDX11.h"
+#include "GeometryLoaderDX11.h"
+#include "FileSystem.h"
+#include "Entity3D.h"
+#include "TestGeometry.h"
+#include <cfloat>
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	// A gently curved grid with positions and texture coordinates, which can be
+	// simplified a lot before the surface moves by any noticeable amount.
+
+	GeometryPtr CreateCurvedGrid( int size )
+	{
+		GeometryPtr pGeometry = CreateGrid( size, false, [size]( int x, int y, GridVertex& vertex ) {
+			const float u = static_cast<float>( x ) / size;
+			vertex.Position = Vector3f( static_cast<float>( x ), static_cast<float>( y ), 2.0f * u * u );
+			vertex.TexCoord = Vector2f( u, static_cast<float>( y ) / size );
+		} );
+
+		pGeometry->CalculateBounds();
+
+		return( pGeometry );
+	}
+
+	// Loads one of the bundled models without creating any buffers for it, or
+	// returns null if the data folder can't be found from here.
+
+	GeometryPtr LoadModel( const std::wstring& filename )
+	{
+		FileSystem fs;
+
+		if ( !fs.FileExists( fs.GetModelsFolder() + filename ) )
+			return( nullptr );
+
+		GeometryPtr pGeometry;
+
+		if ( filename.find( L".ply" ) != std::wstring::npos )
+		{
+			// The PLY models are loaded as patches for the tessellation samples,
+			// but their three control point patches are just triangles.
+
+			pGeometry = GeometryLoaderDX11::loadStanfordPlyData( filename );
+
+			if ( pGeometry->GetPrimitiveType() == D3D11_PRIMITIVE_TOPOLOGY_3_CONTROL_POINT_PATCHLIST )
+				pGeometry->SetPrimitiveType( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+		}
+		else
+		{
+			pGeometry = GeometryLoaderDX11::loadMS3DFile2( filename );
+		}
+
+		if ( pGeometry != nullptr )
+			pGeometry->CalculateVertexCount();
+
+		return( pGeometry );
+	}
+};
+//--------------------------------------------------------------------------------
+TEST_CASE( EntityLODFromGeometryBounds )
+{
+	// The entity has no shapes, so its screen size can only come from the
+	// bounds of its geometry.
+
+	GeometryPtr pGeometry = CreateCurvedGrid( 16 );
+	std::vector<GeometryPtr> chain = GeometrySimplifierDX11::GenerateLODChain( pGeometry, 2, 0.25f, 0.05f );
+	CHECK( chain.size() == 2 );
+
+	Entity3D entity;
+	entity.Visual.Executor = pGeometry;
+	entity.SetExecutorBounds( true );
+
+	for ( unsigned int level = 0; level < chain.size(); level++ )
+		entity.Visual.AddLOD( chain[level], level == 0 ? 0.5f : 0.1f );
+
+	Vector3f center = pGeometry->GetBounds().center;
+	const float radius = pGeometry->GetBounds().radius;
+
+	Matrix4f proj = Matrix4f::PerspectiveFovLHMatrix( GLYPH_PI / 4.0f, 16.0f / 9.0f, 0.1f, 1000.0f );
+	Vector3f up( 0.0f, 1.0f, 0.0f );
+
+	float sizes[3];
+	unsigned int levels[3];
+	const float distances[3] = { 2.0f, 10.0f, 100.0f };
+
+	entity.Update( 0.0f );
+	CHECK( entity.IsBounded() );
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		Vector3f eye = center - Vector3f( 0.0f, 0.0f, distances[i] * radius );
+		Matrix4f view = Matrix4f::LookAtLHMatrix( eye, center, up );
+
+		sizes[i] = entity.GetScreenSize( view, proj );
+		levels[i] = entity.SelectLOD( view, proj );
+
+		printf( "  distance %6.1f: screen size %.4f, level %u\n", distances[i] * radius, sizes[i], levels[i] );
+
+		// The projected size of the bounding sphere is its radius over the
+		// depth, scaled by the vertical term of the projection.
+
+		CHECK( fabs( sizes[i] - proj(1,1) / distances[i] ) < 1e-3f );
+	}
+
+	CHECK( levels[0] == 0 );
+	CHECK( levels[1] == 1 );
+	CHECK( levels[2] == 2 );
+	CHECK( entity.Visual.GetLOD( levels[2] ) == chain[1] );
+
+	// A camera inside the bounds always gets the full detail, and so does an
+	// entity without any bounds at all.
+
+	Vector3f ahead = center + Vector3f( 0.0f, 0.0f, 1.0f );
+	Matrix4f inside = Matrix4f::LookAtLHMatrix( center, ahead, up );
+	CHECK( entity.GetScreenSize( inside, proj ) == FLT_MAX );
+	CHECK( entity.SelectLOD( inside, proj ) == 0 );
+
+	Entity3D empty;
+	empty.Visual.AddLOD( chain[0], 0.5f );
+	empty.Update( 0.0f );
+
+	Vector3f origin( 0.0f, 0.0f, 0.0f );
+	Vector3f away( 0.0f, 0.0f, -1000.0f );
+	Matrix4f distant = Matrix4f::LookAtLHMatrix( away, origin, up );
+	CHECK( !empty.IsBounded() );
+	CHECK( empty.SelectLOD( distant, proj ) == 0 );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( GeometrySimplifierGrid )
+{
+	GeometryPtr pGeometry = CreateCurvedGrid( 32 );
+	const unsigned int triangles = pGeometry->GetIndexCount() / 3;
+	const unsigned int vertices = pGeometry->CalculateVertexCount();
+
+	SimplificationReport report;
+	GeometryPtr pSimple = GeometrySimplifierDX11::Simplify( pGeometry, triangles / 8, 0.01f, &report );
+	CHECK( pSimple != nullptr );
+
+	if ( pSimple == nullptr )
+		return;
+
+	printf( "  %u triangles to %u, %u vertices, error %.5f\n", report.sourceTriangles, report.triangles, report.vertices, report.error );
+
+	CHECK( report.sourceTriangles == triangles );
+	CHECK( report.triangles == pSimple->GetIndexCount() / 3 );
+	CHECK( report.triangles <= triangles / 4 );
+	CHECK( report.error <= 0.01f );
+	CHECK( pSimple->CalculateVertexCount() == report.vertices && report.vertices < vertices );
+
+	// The remaining vertices are a subset of the original ones, so all of the
+	// positions are still on the original grid.
+
+	VertexElementDX11* pPositions = pSimple->GetElement( VertexElementDX11::PositionSemantic );
+	CHECK( pPositions != nullptr );
+
+	bool onGrid = true;
+	for ( int v = 0; pPositions != nullptr && v < pPositions->Count(); v++ ) {
+		const Vector3f p = *pPositions->Get3f( v );
+		onGrid = onGrid && p.x == floorf( p.x ) && p.y == floorf( p.y );
+	}
+	CHECK( onGrid );
+
+	// The same input always produces the same output.
+
+	GeometryPtr pAgain = GeometrySimplifierDX11::Simplify( pGeometry, triangles / 8, 0.01f );
+	CHECK( pAgain != nullptr && pAgain->m_vIndices == pSimple->m_vIndices );
+
+	// Geometry that can't be simplified is rejected without a result.
+
+	GeometryPtr pBroken = CreateCurvedGrid( 2 );
+	pBroken->m_vIndices[4] = pBroken->CalculateVertexCount();
+	CHECK( GeometrySimplifierDX11::Simplify( pBroken, 2 ) == nullptr );
+	CHECK( GeometrySimplifierDX11::Simplify( nullptr, 2 ) == nullptr );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( GeometrySimplifierModelReports )
+{
+	const wchar_t* models[] = {
+		L"Sample_Scene.ms3d", L"Screen.ms3d", L"ScreenFrame.ms3d", L"TBone.ms3d",
+		L"UnitSphere2.ms3d", L"Walker.ms3d", L"bowl.ms3d", L"box.ms3d", L"hedra.ms3d",
+		L"small_box.ms3d", L"spring.ms3d", L"BoxWithBadNormals.ply", L"CPNAdaptiveTest.ply",
+		L"CPNTest.ply", L"spaceship.ply", L"spaceship2.ply", L"suzanne.ply"
+	};
+
+	const unsigned int levels = 4;
+	const float maxError = 0.05f;
+
+	unsigned int loaded = 0;
+
+	// Each model gets the chain of levels that an application would generate
+	// for it, which reports how far every level could be taken.
+
+	for ( auto filename : models )
+	{
+		GeometryPtr pGeometry = LoadModel( filename );
+
+		if ( pGeometry == nullptr )
+			continue;
+
+		loaded++;
+
+		std::vector<SimplificationReport> reports;
+		TestTimer timer;
+		std::vector<GeometryPtr> chain = GeometrySimplifierDX11::GenerateLODChain( pGeometry, levels, 0.5f, maxError, &reports );
+		const double time = timer.Milliseconds();
+
+		printf( "  %-22ls %6u triangles, %6u vertices, %8.3f ms:", filename,
+			pGeometry->GetIndexCount() / 3, pGeometry->GetVertexCount(), time );
+
+		for ( auto& report : reports )
+			printf( " %u (%.4f)", report.triangles, report.error );
+
+		printf( "\n" );
+
+		CHECK( chain.size() == reports.size() && chain.size() <= levels );
+
+		unsigned int previous = pGeometry->GetIndexCount() / 3;
+
+		for ( unsigned int level = 0; level < reports.size(); level++ )
+		{
+			CHECK( reports[level].triangles < previous );
+			CHECK( reports[level].error <= maxError );
+			CHECK( chain[level]->GetIndexCount() / 3 == reports[level].triangles );
+			previous = reports[level].triangles;
+		}
+	}
+
+	printf( "  %u of %u models found\n", loaded, static_cast<unsigned int>( sizeof( models ) / sizeof( models[0] ) ) );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,239 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TestFramework.h"
+#include "TGrowableBufferDX11.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	// A growable buffer whose resource is a system memory array, so that the
+	// growth policy and the ring offsets can be checked without a device.  The
+	// upload mirrors the one of the vertex buffer.
+
+	class RecordingBuffer : public TGrowableBufferDX11<Vector4f>
+	{
+	public:
+		RecordingBuffer() : Creations( 0 ), Deletions( 0 ) {}
+		virtual ~RecordingBuffer() {}
+
+		virtual void UploadData( PipelineManagerDX11* pPipeline )
+		{
+			EnsureResource( );
+
+			if ( m_uiElementCount > 0 && m_bUploadNeeded == true ) {
+
+				m_bUploadNeeded = false;
+
+				Modes.push_back( AdvanceRing( ) );
+				std::copy( m_pDataArray, m_pDataArray + m_uiElementCount, Resource.begin() + m_uiUploadOffset );
+			}
+		}
+
+		virtual ResourcePtr GetBuffer()
+		{
+			return( nullptr );
+		}
+
+		std::vector<Vector4f> Resource;
+		std::vector<D3D11_MAP> Modes;
+		unsigned int Creations;
+		unsigned int Deletions;
+
+	protected:
+		virtual void CreateResource( unsigned int elements )
+		{
+			Resource.assign( elements, Vector4f( -1.0f, -1.0f, -1.0f, -1.0f ) );
+			Creations++;
+		}
+
+		virtual void DeleteResource( )
+		{
+			if ( !Resource.empty() ) {
+				Resource.clear();
+				Deletions++;
+			}
+		}
+	};
+
+	void AddFrame( RecordingBuffer& buffer, unsigned int count, float value )
+	{
+		for ( unsigned int i = 0; i < count; i++ )
+			buffer.AddElement( Vector4f( value, static_cast<float>( i ), 0.0f, 1.0f ) );
+	}
+};
+//--------------------------------------------------------------------------------
+TEST_CASE( GrowableBufferGrowth )
+{
+	// Adding the elements one at a time doubles the array from its minimum
+	// size, so the number of reallocations grows with the logarithm of the
+	// element count, and the bytes copied stay below twice the bytes added.
+
+	const unsigned int counts[] = { 1000, 10000, 100000, 1000000 };
+
+	for ( auto count : counts )
+	{
+		RecordingBuffer buffer;
+		AddFrame( buffer, count, 1.0f );
+
+		unsigned int doublings = 0;
+		for ( unsigned int capacity = 128; capacity < count; capacity *= 2 )
+			doublings++;
+
+		const unsigned long long added = static_cast<unsigned long long>( count ) * sizeof( Vector4f );
+
+		CHECK( buffer.GetElementCount() == count );
+		CHECK( buffer.GetReallocationCount() == doublings + 1 );
+		CHECK( buffer.GetBytesCopied() < 2 * added );
+
+		// The resource is only created once, at the upload after the growth.
+
+		buffer.UploadData( nullptr );
+
+		CHECK( buffer.Creations == 1 && buffer.Resource.size() == buffer.GetMaxElementCount() );
+		CHECK( buffer.Resource[count-1].y == static_cast<float>( count - 1 ) );
+
+		printf( "  %7u elements: %2u reallocations, %.2f bytes copied per byte added\n", count,
+			buffer.GetReallocationCount(), static_cast<double>( buffer.GetBytesCopied() ) / added );
+	}
+
+	// Reserving up front grows the array once, and adding an array of
+	// elements doesn't grow it any further.
+
+	RecordingBuffer reserved;
+	std::vector<Vector4f> elements( 100000, Vector4f( 1.0f, 2.0f, 3.0f, 4.0f ) );
+
+	reserved.Reserve( 100000 );
+	reserved.AddElements( elements.data(), 50000 );
+	reserved.AddElements( elements.data() + 50000, 50000 );
+
+	CHECK( reserved.GetReallocationCount() == 1 && reserved.GetBytesCopied() == 0 );
+	CHECK( reserved.GetElementCount() == 100000 && reserved.GetMaxElementCount() >= 100000 );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( GrowableBufferShrinks )
+{
+	RecordingBuffer buffer;
+	buffer.SetShrinkInterval( 4 );
+
+	// A single large frame grows the array, and the array keeps its size for
+	// the rest of the interval that the large frame was part of.
+
+	AddFrame( buffer, 10000, 0.0f );
+	buffer.UploadData( nullptr );
+	buffer.ResetData();
+
+	const unsigned int grown = buffer.GetMaxElementCount();
+	bool kept = true;
+
+	for ( int frame = 1; frame < 8; frame++ )
+	{
+		AddFrame( buffer, 100, static_cast<float>( frame ) );
+		buffer.UploadData( nullptr );
+		buffer.ResetData();
+
+		if ( frame < 7 )
+			kept = kept && buffer.GetMaxElementCount() == grown;
+	}
+
+	// The second interval only used 100 elements, so the array is shrunk to
+	// twice that at its last reset, and the resource follows at the next
+	// upload.
+
+	CHECK( grown >= 10000 );
+	CHECK( kept );
+	CHECK( buffer.GetMaxElementCount() == 200 );
+	CHECK( buffer.Creations == 1 );
+
+	AddFrame( buffer, 100, 8.0f );
+	buffer.UploadData( nullptr );
+
+	CHECK( buffer.Creations == 2 && buffer.Deletions == 1 && buffer.Resource.size() == 200 );
+	CHECK( buffer.Resource[99].x == 8.0f );
+
+	// Without a shrink interval, the array never shrinks.
+
+	RecordingBuffer unlimited;
+	AddFrame( unlimited, 10000, 0.0f );
+	unlimited.ResetData();
+
+	for ( int frame = 0; frame < 100; frame++ ) {
+		AddFrame( unlimited, 10, 0.0f );
+		unlimited.ResetData();
+	}
+
+	CHECK( unlimited.GetMaxElementCount() >= 10000 );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( GrowableBufferRingOffsets )
+{
+	RecordingBuffer buffer;
+	buffer.SetRingMode( true, 3 );
+
+	// The ring holds three frames of the 128 element array.  Frames of 100
+	// elements are appended until the fourth doesn't fit anymore, and then
+	// the ring wraps around to the start of a discarded resource.
+
+	const unsigned int offsets[] = { 0, 100, 200, 0, 100, 200, 0 };
+	bool placed = true;
+	bool preserved = true;
+
+	for ( unsigned int frame = 0; frame < 7; frame++ )
+	{
+		AddFrame( buffer, 100, static_cast<float>( frame ) );
+		buffer.UploadData( nullptr );
+
+		const unsigned int offset = buffer.GetUploadOffset();
+		const D3D11_MAP expected = ( offset == 0 ) ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+
+		placed = placed && offset == offsets[frame] && buffer.Modes.back() == expected;
+		placed = placed && buffer.Resource[offset].x == frame && buffer.Resource[offset + 99].y == 99.0f;
+
+		// Appending must not touch the data of the previous frame.
+
+		if ( offset > 0 )
+			preserved = preserved && buffer.Resource[offset - 100].x == frame - 1 && buffer.Resource[offset - 1].y == 99.0f;
+
+		buffer.ResetData();
+	}
+
+	CHECK( placed );
+	CHECK( preserved );
+	CHECK( buffer.Creations == 1 && buffer.Resource.size() == 3 * 128 );
+
+	// Growing the array recreates the ring, which starts over.
+
+	AddFrame( buffer, 200, 7.0f );
+	buffer.UploadData( nullptr );
+
+	CHECK( buffer.Creations == 2 && buffer.Resource.size() == 3 * 256 );
+	CHECK( buffer.GetUploadOffset() == 0 && buffer.Modes.back() == D3D11_MAP_WRITE_DISCARD );
+
+	buffer.ResetData();
+	AddFrame( buffer, 200, 8.0f );
+	buffer.UploadData( nullptr );
+
+	CHECK( buffer.GetUploadOffset() == 200 && buffer.Modes.back() == D3D11_MAP_WRITE_NO_OVERWRITE );
+
+	// Outside of ring mode, every upload discards the resource and starts at
+	// the beginning.
+
+	buffer.ResetData();
+	buffer.SetRingMode( false );
+	AddFrame( buffer, 200, 9.0f );
+	buffer.UploadData( nullptr );
+
+	CHECK( buffer.Creations == 3 && buffer.Resource.size() == 256 );
+	CHECK( buffer.GetUploadOffset() == 0 && buffer.Modes.back() == D3D11_MAP_WRITE_DISCARD );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
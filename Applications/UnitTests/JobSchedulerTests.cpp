@@ -0,0 +1,234 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TestFramework.h"
+#include "JobScheduler.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	const unsigned int ThreadCount = 4;
+
+	// Counts how many times each element was processed, and whether every job
+	// ran with the index of the thread that executed it.
+
+	struct ExecutionLog
+	{
+		ExecutionLog( unsigned int count ) : Counts( count ), IndexMismatches( 0 )
+		{
+			for ( auto& c : Counts ) c = 0;
+		}
+
+		bool AllExactlyOnce() const
+		{
+			for ( auto& c : Counts ) {
+				if ( c.load() != 1 ) return( false );
+			}
+
+			return( true );
+		}
+
+		std::vector<std::atomic<unsigned int>> Counts;
+		std::atomic<unsigned int> IndexMismatches;
+	};
+
+	// Busy work that the compiler can't remove, with a cost proportional to
+	// the number of iterations.
+
+	float Spin( unsigned int iterations )
+	{
+		volatile float x = 1.0f;
+		for ( unsigned int i = 0; i < iterations; i++ )
+			x = x * 1.0000001f + 0.5f;
+		return( x );
+	}
+};
+//--------------------------------------------------------------------------------
+TEST_CASE( JobSchedulerEmptyJobs )
+{
+	JobScheduler scheduler;
+	scheduler.Initialize( ThreadCount );
+
+	unsigned int calls = 0;
+	scheduler.ParallelFor( 0, 16, [&calls]( unsigned int begin, unsigned int end, unsigned int worker ) { calls++; } );
+	CHECK( calls == 0 );
+
+	// A counter without any jobs is complete, and waiting on it returns.
+
+	JobCounter counter;
+	CHECK( counter.IsComplete() );
+	scheduler.Wait( counter );
+	CHECK( counter.IsComplete() );
+
+	// A range that fits into one job is run directly on the calling thread.
+
+	unsigned int worker = ThreadCount;
+	scheduler.ParallelFor( 5, 16, [&]( unsigned int begin, unsigned int end, unsigned int thread ) {
+		calls++;
+		worker = thread;
+		CHECK( begin == 0 && end == 5 );
+	} );
+
+	CHECK( calls == 1 );
+	CHECK( worker == 0 );
+
+	// Without being initialized, the scheduler runs everything on the waiting
+	// thread.
+
+	JobScheduler inactive;
+	ExecutionLog log( 100 );
+	inactive.ParallelFor( 100, 7, [&log]( unsigned int begin, unsigned int end, unsigned int thread ) {
+		for ( unsigned int i = begin; i < end; i++ ) log.Counts[i]++;
+		if ( thread != 0 ) log.IndexMismatches++;
+	} );
+
+	CHECK( log.AllExactlyOnce() );
+	CHECK( log.IndexMismatches == 0 );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( JobSchedulerWaitRunsEveryJobOnce )
+{
+	JobScheduler scheduler;
+	scheduler.Initialize( ThreadCount );
+
+	// All of the jobs are queued on the calling thread, so the other threads
+	// only get to them by stealing.  Each job also queues a second job on the
+	// queue of the thread that runs it.
+
+	const unsigned int jobs = 2000;
+	ExecutionLog log( 2 * jobs );
+	JobCounter counter;
+
+	for ( unsigned int i = 0; i < jobs; i++ )
+	{
+		scheduler.Submit( [&,i]( unsigned int worker ) {
+			log.Counts[i]++;
+			if ( worker != scheduler.GetWorkerIndex() ) log.IndexMismatches++;
+
+			scheduler.Submit( [&,i]( unsigned int thread ) {
+				log.Counts[jobs + i]++;
+				if ( thread != scheduler.GetWorkerIndex() ) log.IndexMismatches++;
+			}, counter, worker );
+		}, counter );
+	}
+
+	scheduler.Wait( counter );
+
+	CHECK( counter.IsComplete() );
+	CHECK( log.AllExactlyOnce() );
+	CHECK( log.IndexMismatches == 0 );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( JobSchedulerNestedParallelFor )
+{
+	JobScheduler scheduler;
+	scheduler.Initialize( ThreadCount );
+
+	// Each outer range runs an inner loop of its own, which has to wait on
+	// its inner jobs without picking up the outer ones.
+
+	const unsigned int outer = 32;
+	const unsigned int inner = 500;
+	ExecutionLog log( outer * inner );
+
+	scheduler.ParallelFor( outer, 1, [&]( unsigned int begin, unsigned int end, unsigned int worker ) {
+		for ( unsigned int o = begin; o < end; o++ ) {
+			scheduler.ParallelFor( inner, 16, [&,o]( unsigned int first, unsigned int last, unsigned int thread ) {
+				for ( unsigned int i = first; i < last; i++ ) log.Counts[o * inner + i]++;
+				if ( thread != scheduler.GetWorkerIndex() ) log.IndexMismatches++;
+			}, worker );
+		}
+	} );
+
+	CHECK( log.AllExactlyOnce() );
+	CHECK( log.IndexMismatches == 0 );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( JobSchedulerUnevenJobCosts )
+{
+	JobScheduler scheduler;
+	scheduler.Initialize( ThreadCount );
+
+	// A few of the jobs are a hundred times more expensive than the others,
+	// and they are all at the start of the range.
+
+	const unsigned int count = 256;
+	ExecutionLog log( count );
+	std::vector<unsigned int> jobsPerWorker( ThreadCount, 0 );
+	std::mutex lock;
+
+	scheduler.ParallelFor( count, 1, [&]( unsigned int begin, unsigned int end, unsigned int worker ) {
+		for ( unsigned int i = begin; i < end; i++ ) {
+			Spin( i < 8 ? 200000 : 2000 );
+			log.Counts[i]++;
+		}
+
+		std::lock_guard<std::mutex> guard( lock );
+		if ( worker < ThreadCount ) jobsPerWorker[worker]++;
+		else log.IndexMismatches++;
+	} );
+
+	unsigned int total = 0;
+	for ( auto jobs : jobsPerWorker ) total += jobs;
+
+	CHECK( log.AllExactlyOnce() );
+	CHECK( log.IndexMismatches == 0 );
+	CHECK( total == count );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( JobSchedulerBenchmark )
+{
+	// Measures the scheduling overhead without a device, by running the same
+	// small jobs serially, and through the scheduler with different grains.
+
+	const unsigned int count = 100000;
+	const unsigned int work = 200;
+	std::vector<float> results( count );
+
+	JobScheduler scheduler;
+	scheduler.Initialize( ThreadCount );
+
+	TestTimer timer;
+
+	for ( unsigned int i = 0; i < count; i++ )
+		results[i] = Spin( work );
+
+	const double serialTime = timer.Milliseconds();
+
+	printf( "  %u jobs of %u iterations on %u threads (%u hardware threads)\n", count, work, ThreadCount, JobScheduler::GetHardwareThreadCount() );
+	printf( "  serial:           %.3f ms\n", serialTime );
+
+	const unsigned int grains[] = { 1, 16, 256 };
+	bool complete = true;
+
+	for ( auto grain : grains )
+	{
+		std::fill( results.begin(), results.end(), 0.0f );
+		timer.Reset();
+
+		scheduler.ParallelFor( count, grain, [&]( unsigned int begin, unsigned int end, unsigned int worker ) {
+			for ( unsigned int i = begin; i < end; i++ )
+				results[i] = Spin( work );
+		} );
+
+		const double time = timer.Milliseconds();
+
+		for ( auto result : results )
+			complete = complete && result != 0.0f;
+
+		printf( "  grain %4u:       %.3f ms\n", grain, time );
+	}
+
+	CHECK( complete );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,214 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TestFramework.h"
+#include "Matrix4f.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	float RandomFloat( unsigned int& seed, float range )
+	{
+		seed = seed * 1664525 + 1013904223;
+		return( ( ( seed >> 8 ) / 16777216.0f * 2.0f - 1.0f ) * range );
+	}
+
+	// Random rigid transforms with a scale, which is what the scene graph
+	// multiplies all of the time.
+
+	Matrix4f RandomTransform( unsigned int& seed )
+	{
+		Matrix4f m = Matrix4f::RotationMatrixXYZ( RandomFloat( seed, 3.0f ), RandomFloat( seed, 3.0f ), RandomFloat( seed, 3.0f ) );
+		m = Matrix4f::ScaleMatrix( 1.5f + RandomFloat( seed, 1.0f ) ) * m;
+		m.SetTranslation( Vector3f( RandomFloat( seed, 100.0f ), RandomFloat( seed, 100.0f ), RandomFloat( seed, 100.0f ) ) );
+		return( m );
+	}
+
+	// The difference of two matrices, relative to the largest element of the
+	// reference.
+
+	float RelativeError( const Matrix4f& a, const Matrix4f& reference )
+	{
+		float error = 0.0f;
+		float largest = 0.0f;
+
+		for ( int i = 0; i < 16; i++ ) {
+			error = max( error, fabs( a[i] - reference[i] ) );
+			largest = max( largest, fabs( reference[i] ) );
+		}
+
+		return( error / max( largest, 1.0f ) );
+	}
+
+	float LargestElement( const Matrix4f& m )
+	{
+		float largest = 0.0f;
+
+		for ( int i = 0; i < 16; i++ )
+			largest = max( largest, fabs( m[i] ) );
+
+		return( largest );
+	}
+};
+//--------------------------------------------------------------------------------
+TEST_CASE( Matrix4fMatchesScalar )
+{
+	unsigned int seed = 97;
+	float multiply = 0.0f;
+	float transform = 0.0f;
+	float transpose = 0.0f;
+	float inverse = 0.0f;
+
+	for ( int test = 0; test < 1000; test++ )
+	{
+		Matrix4f a = RandomTransform( seed );
+		Matrix4f b = RandomTransform( seed );
+
+		if ( test % 2 ) {
+			for ( int i = 0; i < 16; i++ ) a[i] = RandomFloat( seed, 10.0f );
+		}
+
+		Matrix4f product;
+		Matrix4f reference;
+		Matrix4f::Multiply( a, b, product );
+		Matrix4f::MultiplyScalar( a, b, reference );
+		multiply = max( multiply, RelativeError( product, reference ) );
+
+		// The output may alias either of the inputs.
+
+		Matrix4f aliased = a;
+		Matrix4f::Multiply( aliased, b, aliased );
+		multiply = max( multiply, RelativeError( aliased, reference ) );
+
+		Vector4f v( RandomFloat( seed, 10.0f ), RandomFloat( seed, 10.0f ), RandomFloat( seed, 10.0f ), 1.0f );
+		Vector4f p = a * v;
+		Vector4f q = Matrix4f::TransformScalar( a, v );
+
+		for ( int i = 0; i < 4; i++ )
+			transform = max( transform, fabs( p[i] - q[i] ) / max( fabs( q[i] ), 1.0f ) );
+
+		Matrix4f transposed = a;
+		Matrix4f scalarTransposed = a;
+		transposed.MakeTranspose();
+		scalarTransposed.MakeTransposeScalar();
+		transpose = max( transpose, RelativeError( transposed, scalarTransposed ) );
+
+		inverse = max( inverse, RelativeError( b.Inverse(), b.InverseScalar() ) );
+	}
+
+	CHECK( multiply < 1e-6f );
+	CHECK( transform < 1e-6f );
+	CHECK( transpose == 0.0f );
+	CHECK( inverse < 1e-5f );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( Matrix4fInverseNearSingular )
+{
+	// The two paths round differently, so for badly conditioned matrices they
+	// are only compared relative to the size of the inverse.  Both have to
+	// still produce an inverse that takes the matrix back to the identity, up
+	// to the rounding that the size of the matrix and its inverse allow.
+
+	unsigned int seed = 1234;
+	float difference = 0.0f;
+	float identity = 0.0f;
+
+	for ( int test = 0; test < 1000; test++ )
+	{
+		Matrix4f m = RandomTransform( seed );
+
+		// Flatten one axis down to a thousandth of the others, or shear two of
+		// the rows until they are almost parallel.
+
+		const float epsilon = 1e-3f;
+
+		if ( test % 2 ) {
+			m.SetRow( test % 3, m.GetRow( test % 3 ) * epsilon );
+		} else {
+			Vector4f row = m.GetRow( 0 );
+			m.SetRow( 1, row + ( m.GetRow( 1 ) - row ) * epsilon );
+		}
+
+		Matrix4f inverse = m.Inverse();
+		Matrix4f scalar = m.InverseScalar();
+		difference = max( difference, RelativeError( inverse, scalar ) );
+
+		const float scale = LargestElement( m ) * LargestElement( scalar );
+		identity = max( identity, RelativeError( m * inverse, Matrix4f::Identity() ) / scale );
+		identity = max( identity, RelativeError( m * scalar, Matrix4f::Identity() ) / scale );
+	}
+
+	CHECK( difference < 1e-4f );
+	CHECK( identity < 1e-5f );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( Matrix4fBenchmark )
+{
+	const int count = 4096;
+	const int iterations = 100;
+
+	unsigned int seed = 5;
+	std::vector<Matrix4f> locals( count );
+	std::vector<Matrix4f> worlds( count );
+
+	for ( auto& m : locals )
+		m = RandomTransform( seed );
+
+	Matrix4f parent = RandomTransform( seed );
+	float checksum[2] = { 0.0f, 0.0f };
+	double times[2][3];
+
+	for ( int path = 0; path < 2; path++ )
+	{
+		TestTimer timer;
+
+		for ( int i = 0; i < iterations; i++ ) {
+			for ( int j = 0; j < count; j++ ) {
+				if ( path == 0 ) Matrix4f::Multiply( locals[j], parent, worlds[j] );
+				else Matrix4f::MultiplyScalar( locals[j], parent, worlds[j] );
+			}
+		}
+
+		times[path][0] = timer.Milliseconds();
+		timer.Reset();
+
+		for ( int i = 0; i < iterations; i++ ) {
+			for ( int j = 0; j < count; j++ )
+				worlds[j] = path == 0 ? locals[j].Inverse() : locals[j].InverseScalar();
+		}
+
+		times[path][1] = timer.Milliseconds();
+		timer.Reset();
+
+		Vector4f sum( 0.0f, 0.0f, 0.0f, 0.0f );
+
+		for ( int i = 0; i < iterations; i++ ) {
+			Vector4f v( 1.0f, 2.0f, 3.0f, 1.0f );
+			for ( int j = 0; j < count; j++ )
+				sum += path == 0 ? locals[j] * v : Matrix4f::TransformScalar( locals[j], v );
+		}
+
+		times[path][2] = timer.Milliseconds();
+		checksum[path] = worlds[count-1][0] + sum.x;
+	}
+
+	const unsigned int operations = count * iterations;
+
+	printf( "  %u operations each\n", operations );
+	printf( "  multiply:  scalar %.3f ms, simd %.3f ms\n", times[1][0], times[0][0] );
+	printf( "  inverse:   scalar %.3f ms, simd %.3f ms\n", times[1][1], times[0][1] );
+	printf( "  transform: scalar %.3f ms, simd %.3f ms\n", times[1][2], times[0][2] );
+
+	CHECK( fabs( checksum[0] - checksum[1] ) < 1e-3f * max( fabs( checksum[1] ), 1.0f ) );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,188 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TestFramework.h"
+#include "ResourceTableDX11.h"
+#include "RendererDX11.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	// The table never dereferences its resources, so the tests store distinct
+	// addresses in it instead of creating them on a device.
+
+	class FakeResources
+	{
+	public:
+		FakeResources( unsigned int count ) : m_Storage( count ) {}
+
+		ResourceDX11* operator[]( unsigned int i )
+		{
+			return( reinterpret_cast<ResourceDX11*>( &m_Storage[i] ) );
+		}
+
+	private:
+		std::vector<char> m_Storage;
+	};
+
+	// A small deterministic generator for picking the resources to delete.
+
+	unsigned int NextRandom( unsigned int& state )
+	{
+		state = state * 1664525u + 1013904223u;
+		return( state >> 8 );
+	}
+};
+//--------------------------------------------------------------------------------
+TEST_CASE( ResourceTableReusesSlots )
+{
+	ResourceTableDX11 table;
+	FakeResources resources( 4 );
+
+	int first = table.Add( resources[0], RT_VERTEXBUFFER );
+	int second = table.Add( resources[1], RT_TEXTURE2D );
+
+	CHECK( first >= 0 && second >= 0 && first != second );
+	CHECK( table.Get( first ) == resources[0] && table.GetType( first ) == RT_VERTEXBUFFER );
+	CHECK( table.Get( second ) == resources[1] && table.GetType( second ) == RT_TEXTURE2D );
+	CHECK( table.GetCount() == 2 && table.GetSlotCount() == 2 );
+
+	// Removing the resource returns it once, and then the handle is stale.
+
+	CHECK( table.Remove( first ) == resources[0] );
+	CHECK( table.Remove( first ) == nullptr );
+	CHECK( !table.IsValid( first ) && table.Get( first ) == nullptr && table.GetType( first ) == 0 );
+	CHECK( table.GetCount() == 1 && table.GetSlot( 0 ) == nullptr );
+
+	// The next resource reuses the slot with a new generation, so the old
+	// handle still doesn't find anything, and can't remove the new resource.
+
+	int reused = table.Add( resources[2], RT_INDEXBUFFER );
+
+	CHECK( ( reused & ResourceTableDX11::IndexMask ) == ( first & ResourceTableDX11::IndexMask ) );
+	CHECK( reused != first && table.GetSlotCount() == 2 );
+	CHECK( table.Get( reused ) == resources[2] && table.GetType( reused ) == RT_INDEXBUFFER );
+	CHECK( table.Get( first ) == nullptr && table.Remove( first ) == nullptr );
+	CHECK( table.Get( reused ) == resources[2] && table.GetCount() == 2 );
+
+	// The handles that were never handed out are rejected as well.
+
+	CHECK( !table.IsValid( -1 ) && table.Get( -1 ) == nullptr );
+	CHECK( !table.IsValid( 1000 ) && table.Remove( 1000 ) == nullptr );
+	CHECK( !table.IsValid( second + ( 1 << ResourceTableDX11::IndexBits ) ) );
+	CHECK( table.Get( second ) == resources[1] );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( ResourceTableFreeListOrder )
+{
+	// The freed slots are reused in the order that they were freed, so the
+	// slot that was freed last is the last one to be reused.
+
+	ResourceTableDX11 table;
+	FakeResources resources( 8 );
+	std::vector<int> handles;
+
+	for ( unsigned int i = 0; i < 4; i++ )
+		handles.push_back( table.Add( resources[i], RT_CONSTANTBUFFER ) );
+
+	table.Remove( handles[2] );
+	table.Remove( handles[0] );
+	table.Remove( handles[3] );
+
+	const unsigned int expected[] = { 2, 0, 3, 4 };
+	bool ordered = true;
+
+	for ( unsigned int i = 0; i < 4; i++ ) {
+		int handle = table.Add( resources[4 + i], RT_CONSTANTBUFFER );
+		ordered = ordered && ( handle & ResourceTableDX11::IndexMask ) == static_cast<int>( expected[i] );
+	}
+
+	CHECK( ordered );
+	CHECK( table.GetCount() == 5 && table.GetSlotCount() == 5 );
+
+	// Churning through a single free slot keeps every old handle stale until
+	// the generation wraps around.
+
+	int handle = table.Add( resources[0], RT_CONSTANTBUFFER );
+	const int original = handle;
+	bool stale = true;
+
+	for ( unsigned int i = 0; i < ResourceTableDX11::GenerationMask; i++ ) {
+		table.Remove( handle );
+		handle = table.Add( resources[0], RT_CONSTANTBUFFER );
+		stale = stale && !table.IsValid( original ) && handle >= 0;
+	}
+
+	CHECK( stale );
+	CHECK( table.GetSlotCount() == 6 );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( ResourceTableBenchmark )
+{
+	// Creating and destroying resources with a null device comes down to the
+	// table, so this compares it with the linear scan for a free slot that the
+	// renderer used before.
+
+	const unsigned int live = 200000;
+	const unsigned int pairs = 1000000;
+
+	FakeResources resources( live );
+	ResourceTableDX11 table;
+	std::vector<int> handles( live );
+	unsigned int state = 1;
+
+	TestTimer timer;
+
+	for ( unsigned int i = 0; i < live; i++ )
+		handles[i] = table.Add( resources[i], RT_VERTEXBUFFER );
+
+	bool found = true;
+
+	for ( unsigned int i = 0; i < pairs; i++ ) {
+		unsigned int victim = NextRandom( state ) % live;
+		found = found && table.Remove( handles[victim] ) == resources[victim];
+		handles[victim] = table.Add( resources[victim], RT_VERTEXBUFFER );
+	}
+
+	const double tableTime = timer.Milliseconds();
+
+	CHECK( found );
+	CHECK( table.GetCount() == live && table.GetSlotCount() == live );
+
+	const unsigned int scanLive = 60000;
+	const unsigned int scanPairs = 20000;
+
+	std::vector<ResourceDX11*> scanned;
+
+	timer.Reset();
+
+	for ( unsigned int i = 0; i < scanLive; i++ )
+		scanned.push_back( resources[i] );
+
+	for ( unsigned int i = 0; i < scanPairs; i++ ) {
+		unsigned int victim = NextRandom( state ) % scanLive;
+		scanned[victim] = nullptr;
+
+		unsigned int index = 0;
+		while ( index < scanned.size() && scanned[index] != nullptr )
+			index++;
+
+		scanned[index] = resources[victim];
+	}
+
+	const double scanTime = timer.Milliseconds();
+
+	printf( "  table:       %u pairs with %u live resources, %.3f ms (%.1f ns per pair)\n", pairs, live, tableTime, tableTime * 1.0e6 / pairs );
+	printf( "  linear scan: %u pairs with %u live resources, %.3f ms (%.1f ns per pair)\n", scanPairs, scanLive, scanTime, scanTime * 1.0e6 / scanPairs );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
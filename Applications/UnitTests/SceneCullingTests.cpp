@@ -0,0 +1,200 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TestFramework.h"
+#include "SceneGraph.h"
+#include "GeometryDX11.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	// The benchmark scene is a square grid of entities on the XZ plane, which
+	// are grouped into square cells of one node each.
+
+	const unsigned int GridSize = 128;
+	const unsigned int CellSize = 8;
+	const float Spacing = 4.0f;
+
+	GeometryPtr CreateCube( float size )
+	{
+		GeometryPtr pGeometry = GeometryPtr( new GeometryDX11() );
+
+		VertexElementDX11* pPositions = new VertexElementDX11( 3, 8 );
+		pPositions->m_SemanticName = VertexElementDX11::PositionSemantic;
+		pPositions->m_uiSemanticIndex = 0;
+		pPositions->m_Format = DXGI_FORMAT_R32G32B32_FLOAT;
+		pPositions->m_uiInputSlot = 0;
+		pPositions->m_uiAlignedByteOffset = 0;
+		pPositions->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+		pPositions->m_uiInstanceDataStepRate = 0;
+
+		for ( int i = 0; i < 8; i++ ) {
+			*pPositions->Get3f( i ) = Vector3f( ( i & 1 ) ? size : -size, ( i & 2 ) ? size : -size, ( i & 4 ) ? size : -size );
+		}
+
+		pGeometry->AddElement( pPositions );
+		pGeometry->CalculateBounds();
+
+		return( pGeometry );
+	}
+
+	struct CullingScene
+	{
+		CullingScene( GeometryPtr pGeometry )
+		{
+			const unsigned int cells = GridSize / CellSize;
+
+			for ( unsigned int cz = 0; cz < cells; cz++ ) {
+				for ( unsigned int cx = 0; cx < cells; cx++ ) {
+
+					Node3D* pNode = new Node3D();
+					pNode->Transform.Position() = Vector3f( cx * CellSize * Spacing, 0.0f, cz * CellSize * Spacing );
+					Root.AttachChild( pNode );
+					Nodes.push_back( pNode );
+
+					for ( unsigned int z = 0; z < CellSize; z++ ) {
+						for ( unsigned int x = 0; x < CellSize; x++ ) {
+							Entity3D* pEntity = new Entity3D();
+							pEntity->Transform.Position() = Vector3f( x * Spacing, 0.0f, z * Spacing );
+							pEntity->Visual.Executor = pGeometry;
+							pEntity->SetExecutorBounds( true );
+							pNode->AttachChild( pEntity );
+							Entities.push_back( pEntity );
+						}
+					}
+				}
+			}
+
+			Root.Update( 0.0f );
+		}
+
+		~CullingScene()
+		{
+			for ( auto pEntity : Entities ) delete pEntity;
+			for ( auto pNode : Nodes ) delete pNode;
+		}
+
+		Node3D Root;
+		std::vector<Node3D*> Nodes;
+		std::vector<Entity3D*> Entities;
+	};
+};
+//--------------------------------------------------------------------------------
+TEST_CASE( EntityBoundsFromGeometry )
+{
+	GeometryPtr pGeometry = CreateCube( 1.0f );
+
+	Sphere3f bounds;
+	CHECK( pGeometry->GetModelBounds( bounds ) );
+	CHECK( fabs( bounds.radius - sqrtf( 3.0f ) ) < 1e-5f );
+
+	// An entity without shapes stays unbounded until it opts in to the bounds
+	// of its geometry, since the geometry could be displaced on the GPU.
+
+	Entity3D entity;
+	entity.Visual.Executor = pGeometry;
+	entity.Transform.Position() = Vector3f( 10.0f, 0.0f, 0.0f );
+	entity.Transform.Scale() = Vector3f( 2.0f, 1.0f, 1.0f );
+	entity.Update( 0.0f );
+
+	CHECK( !entity.IsBounded() );
+
+	// With the opt in, it picks up the scaled and translated bounds of its
+	// geometry, and still stays unbounded without any geometry.
+
+	entity.SetExecutorBounds( true );
+	entity.Update( 0.0f );
+
+	CHECK( entity.IsBounded() );
+	CHECK( fabs( entity.GetWorldBounds().center.x - 10.0f ) < 1e-5f );
+	CHECK( fabs( entity.GetWorldBounds().radius - 2.0f * sqrtf( 3.0f ) ) < 1e-5f );
+
+	Entity3D empty;
+	empty.SetExecutorBounds( true );
+	empty.Update( 0.0f );
+	CHECK( !empty.IsBounded() );
+
+	// Skinned geometry is deformed on the GPU, so its bind pose is no bounds.
+
+	VertexElementDX11* pBones = new VertexElementDX11( 4, 8 );
+	pBones->m_SemanticName = VertexElementDX11::BoneIDSemantic;
+	pGeometry->AddElement( pBones );
+
+	CHECK( !pGeometry->GetModelBounds( bounds ) );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( SceneCullingBenchmark )
+{
+	CullingScene scene( CreateCube( 1.0f ) );
+
+	Vector3f eye( GridSize * Spacing * 0.5f, 10.0f, -10.0f );
+	Vector3f at( GridSize * Spacing * 0.5f, 0.0f, 40.0f );
+	Vector3f up( 0.0f, 1.0f, 0.0f );
+
+	Matrix4f view = Matrix4f::LookAtLHMatrix( eye, at, up );
+	Matrix4f proj = Matrix4f::PerspectiveFovLHMatrix( GLYPH_PI / 4.0f, 16.0f / 9.0f, 0.1f, 150.0f );
+	Frustum3f frustum( view * proj );
+
+	const int iterations = 100;
+
+	// The reference is what the views did before the hierarchy was available,
+	// which is to flatten the graph and test every single entity.
+
+	std::vector<Entity3D*> reference;
+	TestTimer timer;
+
+	for ( int i = 0; i < iterations; i++ )
+	{
+		std::vector<Entity3D*> all;
+		GetAllEntities( &scene.Root, all );
+
+		reference.clear();
+		for ( auto pEntity : all ) {
+			if ( frustum.Intersects( pEntity->GetWorldBounds() ) )
+				reference.push_back( pEntity );
+		}
+	}
+
+	double flatTime = timer.Milliseconds() / iterations;
+
+	std::vector<Entity3D*> visible;
+	CullingStats stats;
+	timer.Reset();
+
+	for ( int i = 0; i < iterations; i++ )
+	{
+		visible.clear();
+		stats = CullingStats();
+		GetIntersectingEntities( &scene.Root, visible, frustum, &stats );
+	}
+
+	double cullTime = timer.Milliseconds() / iterations;
+
+	printf( "  %u entities in %u nodes\n", static_cast<unsigned int>( scene.Entities.size() ), static_cast<unsigned int>( scene.Nodes.size() ) );
+	printf( "  flat:      %u entities tested, %u submitted, %.3f ms\n",
+		static_cast<unsigned int>( scene.Entities.size() ), static_cast<unsigned int>( reference.size() ), flatTime );
+	printf( "  hierarchy: %u nodes and %u entities tested, %u submitted, %.3f ms\n",
+		stats.NodesTested, stats.EntitiesTested, stats.EntitiesVisible, cullTime );
+
+	// Both have to produce the same visible set, the hierarchy just tests fewer
+	// of the entities to get there.
+
+	std::sort( reference.begin(), reference.end() );
+	std::sort( visible.begin(), visible.end() );
+
+	CHECK( visible == reference );
+	CHECK( stats.EntitiesVisible == visible.size() );
+	CHECK( visible.size() > 0 && visible.size() < scene.Entities.size() / 4 );
+	CHECK( stats.EntitiesTested < scene.Entities.size() / 4 );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
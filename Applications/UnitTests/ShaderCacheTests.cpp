@@ -0,0 +1,208 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TestFramework.h"
+#include "ShaderCacheDX11.h"
+#include "StubShaderCompiler.h"
+#include "JobScheduler.h"
+#include <cstdio>
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	ShaderCompileRequestDX11 CreateRequest( const std::wstring& filename, const std::string& function )
+	{
+		ShaderCompileRequestDX11 request;
+		request.FileName = filename;
+		request.Function = function;
+		request.ShaderModel = "vs_5_0";
+
+		return( request );
+	}
+
+	// The cache files are named after the key of the preprocessed source, so
+	// the test finds the files that it wrote the same way that the cache does.
+
+	std::string GetCacheFile( StubShaderCompiler& compiler, const ShaderCompileRequestDX11& request )
+	{
+		std::string source;
+		std::string errors;
+		std::vector<std::wstring> includes;
+
+		compiler.Preprocess( request.FileName, request.Defines, source, includes, errors );
+
+		const unsigned long long key = ShaderCacheDX11::GetCacheKey( compiler.GetIdentifier(), request, source, includes );
+		const std::wstring filename = ShaderCacheDX11::GetCacheFilename( key );
+
+		return( std::string( filename.begin(), filename.end() ) );
+	}
+};
+//--------------------------------------------------------------------------------
+TEST_CASE( ShaderCacheHitsAndMisses )
+{
+	std::shared_ptr<StubShaderCompiler> pCompiler( new StubShaderCompiler() );
+	pCompiler->SetFile( L"Test.hlsl", "#include \"Common.hlsli\"\nfloat4 VSMAIN() : SV_Position { return( Scale ); }\n" );
+	pCompiler->SetFile( L"Common.hlsli", "static const float4 Scale = 1.0f;\n" );
+	pCompiler->SetFile( L"Broken.hlsl", "#error not a shader\n" );
+
+	ShaderCacheDX11 cache;
+	cache.SetCompiler( pCompiler );
+
+	ShaderCompileRequestDX11 request = CreateRequest( L"Test.hlsl", "VSMAIN" );
+	std::vector<std::string> files;
+	files.push_back( GetCacheFile( *pCompiler, request ) );
+	std::remove( files.back().c_str() );
+
+	// The first request is compiled and written to disk, and repeating it is
+	// answered from memory.
+
+	ShaderBytecodePtr pFirst = cache.GetBytecode( request );
+	ShaderBytecodePtr pSecond = cache.GetBytecode( request );
+
+	CHECK( pFirst != nullptr && pFirst == pSecond );
+	CHECK( pCompiler->GetCompileCount() == 1 );
+	CHECK( cache.GetStatistics().compilations == 1 );
+	CHECK( cache.GetStatistics().memoryHits == 1 );
+
+	// Without the memory cache, the bytecode is read back from the disk.
+
+	cache.ClearMemoryCache();
+	ShaderBytecodePtr pCached = cache.GetBytecode( request );
+
+	CHECK( pCached != nullptr && pFirst != nullptr && *pCached == *pFirst );
+	CHECK( pCompiler->GetCompileCount() == 1 );
+	CHECK( cache.GetStatistics().diskHits == 1 );
+
+	// A different define set is a different shader.
+
+	ShaderCompileRequestDX11 defined = request;
+	ShaderMacroDX11 macro = { "SKINNED", "1" };
+	defined.Defines.push_back( macro );
+	files.push_back( GetCacheFile( *pCompiler, defined ) );
+	std::remove( files.back().c_str() );
+
+	CHECK( cache.GetBytecode( defined ) != nullptr );
+	CHECK( pCompiler->GetCompileCount() == 2 );
+
+	// Editing an include changes the preprocessed source, so the stale file on
+	// disk isn't used anymore.
+
+	pCompiler->SetFile( L"Common.hlsli", "static const float4 Scale = 2.0f;\n" );
+	files.push_back( GetCacheFile( *pCompiler, request ) );
+	std::remove( files.back().c_str() );
+
+	cache.ClearMemoryCache();
+	ShaderBytecodePtr pEdited = cache.GetBytecode( request );
+
+	CHECK( pEdited != nullptr && pFirst != nullptr && *pEdited != *pFirst );
+	CHECK( pCompiler->GetCompileCount() == 3 );
+
+	// A damaged cache file is a miss, and is replaced by a compiled one.
+
+	{
+		std::ofstream file( files.back().c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+		file.write( "HGSC", 4 );
+	}
+
+	cache.ClearMemoryCache();
+	CHECK( cache.GetBytecode( request ) != nullptr );
+	CHECK( pCompiler->GetCompileCount() == 4 );
+
+	cache.ClearMemoryCache();
+	CHECK( cache.GetBytecode( request ) != nullptr );
+	CHECK( pCompiler->GetCompileCount() == 4 );
+
+	// Failures report the errors of the compiler, and aren't cached.
+
+	std::string errors;
+	ShaderCompileRequestDX11 broken = CreateRequest( L"Broken.hlsl", "VSMAIN" );
+
+	CHECK( cache.GetBytecode( broken, &errors ) == nullptr );
+	CHECK( !errors.empty() );
+	CHECK( cache.GetBytecode( broken ) == nullptr );
+	CHECK( cache.GetStatistics().failures == 2 );
+	CHECK( pCompiler->GetCompileCount() == 6 );
+
+	// Without the disk cache, everything that isn't in memory is compiled.
+
+	cache.SetDiskCacheEnabled( false );
+	cache.ClearMemoryCache();
+	CHECK( cache.GetBytecode( request ) != nullptr );
+	CHECK( pCompiler->GetCompileCount() == 7 );
+
+	for ( auto& file : files )
+		std::remove( file.c_str() );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( ShaderCacheParallelCompilation )
+{
+	std::shared_ptr<StubShaderCompiler> pCompiler( new StubShaderCompiler() );
+	pCompiler->SetFile( L"Test.hlsl", "float4 MAIN() : SV_Position { return( 0.0f ); }\n" );
+	pCompiler->SetCompileTime( 5 );
+
+	ShaderCacheDX11 cache;
+	cache.SetCompiler( pCompiler );
+	cache.SetDiskCacheEnabled( false );
+
+	// Sixteen permutations, each of them requested twice.
+
+	std::vector<ShaderCompileRequestDX11> requests;
+
+	for ( int i = 0; i < 32; i++ )
+	{
+		ShaderCompileRequestDX11 request = CreateRequest( L"Test.hlsl", "MAIN" );
+		ShaderMacroDX11 macro = { "PERMUTATION", std::to_string( i % 16 ) };
+		request.Defines.push_back( macro );
+		requests.push_back( request );
+	}
+
+	std::vector<ShaderBytecodePtr> results;
+
+	TestTimer timer;
+	cache.GetBytecode( requests, results );
+	const double serialTime = timer.Milliseconds();
+
+	CHECK( pCompiler->GetCompileCount() == 16 );
+
+	JobScheduler scheduler;
+	scheduler.Initialize( 4 );
+
+	cache.ClearMemoryCache();
+	std::vector<ShaderBytecodePtr> parallel;
+
+	timer.Reset();
+	cache.GetBytecode( requests, parallel, &scheduler );
+	const double parallelTime = timer.Milliseconds();
+
+	scheduler.Shutdown();
+
+	printf( "  %u requests, 16 permutations, 5 ms per compile\n", static_cast<unsigned int>( requests.size() ) );
+	printf( "  serial:    %.3f ms\n", serialTime );
+	printf( "  4 threads: %.3f ms\n", parallelTime );
+
+	CHECK( pCompiler->GetCompileCount() == 32 );
+	CHECK( parallel.size() == requests.size() );
+
+	// The duplicates share the bytecode of the first request, and each of the
+	// permutations matches the serial result.
+
+	bool matching = true;
+
+	for ( unsigned int i = 0; i < parallel.size(); i++ ) {
+		matching = matching && parallel[i] != nullptr && results[i] != nullptr && *parallel[i] == *results[i];
+		matching = matching && parallel[i] == parallel[i % 16];
+	}
+
+	CHECK( matching );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,158 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TestFramework.h"
+#include "TStateCacheDX11.h"
+#include "BlendStateConfigDX11.h"
+#include "DepthStencilStateConfigDX11.h"
+#include "RasterizerStateConfigDX11.h"
+#include "SamplerStateConfigDX11.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	// Fills the whole configuration, including the padding bytes between its
+	// members, before setting the members to their defaults.  Two configs with
+	// different fill bytes then only differ in their padding.
+
+	template <class TConfig>
+	void FillConfig( TConfig& config, unsigned char fill )
+	{
+		memset( &config, fill, sizeof( config ) );
+		config.SetDefaults();
+	}
+
+	// A configuration is found under a key that compares equal to it, but
+	// whose bytes differ from it.
+
+	template <class TConfig>
+	bool FindsEquivalent( const TConfig& stored, const TConfig& requested )
+	{
+		TStateCacheDX11<TConfig> cache;
+		cache.Insert( stored, 7 );
+
+		return( memcmp( &stored, &requested, sizeof( TConfig ) ) != 0 &&
+			stored == requested &&
+			HashState( stored ) == HashState( requested ) &&
+			cache.Find( requested ) == 7 &&
+			cache.GetHits() == 1 && cache.GetMisses() == 0 );
+	}
+};
+//--------------------------------------------------------------------------------
+TEST_CASE( StateCacheHitsAndMisses )
+{
+	TStateCacheDX11<BlendStateConfigDX11> cache;
+
+	BlendStateConfigDX11 opaque;
+	BlendStateConfigDX11 additive;
+	additive.RenderTarget[0].BlendEnable = true;
+	additive.RenderTarget[0].DestBlend = D3D11_BLEND_ONE;
+
+	CHECK( cache.Find( opaque ) == -1 );
+
+	cache.Insert( opaque, 0 );
+	cache.Insert( additive, 1 );
+
+	CHECK( cache.Find( opaque ) == 0 );
+	CHECK( cache.Find( additive ) == 1 );
+	CHECK( cache.Find( opaque ) == 0 );
+
+	// A config that only differs in a single member is still a miss.
+
+	BlendStateConfigDX11 masked;
+	masked.RenderTarget[7].RenderTargetWriteMask = 0;
+
+	CHECK( cache.Find( masked ) == -1 );
+	CHECK( cache.GetCount() == 2 );
+	CHECK( cache.GetHits() == 3 && cache.GetMisses() == 2 );
+
+	cache.ResetStatistics();
+	CHECK( cache.GetHits() == 0 && cache.GetMisses() == 0 );
+
+	// The table grows past its initial size without losing any entries.
+
+	TStateCacheDX11<RasterizerStateConfigDX11> rasterizers;
+	RasterizerStateConfigDX11 config;
+
+	for ( int i = 0; i < 1000; i++ ) {
+		config.DepthBias = i;
+		rasterizers.Insert( config, i );
+	}
+
+	bool found = true;
+
+	for ( int i = 0; i < 1000; i++ ) {
+		config.DepthBias = i;
+		found = found && rasterizers.Find( config ) == i;
+	}
+
+	config.DepthBias = 1000;
+
+	CHECK( found );
+	CHECK( rasterizers.Find( config ) == -1 );
+	CHECK( rasterizers.GetCount() == 1000 );
+	CHECK( rasterizers.GetHits() == 1000 && rasterizers.GetMisses() == 1 );
+
+	rasterizers.Clear();
+	config.DepthBias = 0;
+
+	CHECK( rasterizers.GetCount() == 0 && rasterizers.Find( config ) == -1 );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( StateCacheIgnoresPadding )
+{
+	// The blend and depth stencil descriptions have padding after their 8 bit
+	// members, which must not influence the lookups.
+
+	BlendStateConfigDX11 blend, blendPadded;
+	FillConfig( blend, 0x00 );
+	FillConfig( blendPadded, 0xcd );
+
+	CHECK( FindsEquivalent( blend, blendPadded ) );
+
+	DepthStencilStateConfigDX11 depth, depthPadded;
+	FillConfig( depth, 0x00 );
+	FillConfig( depthPadded, 0xcd );
+
+	CHECK( FindsEquivalent( depth, depthPadded ) );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( StateCacheSignedZeros )
+{
+	// Positive and negative zero are the same value for the device, so they
+	// have to map to the same state object.
+
+	RasterizerStateConfigDX11 rasterizer, negative;
+	negative.DepthBiasClamp = -0.0f;
+	negative.SlopeScaledDepthBias = -0.0f;
+
+	CHECK( FindsEquivalent( rasterizer, negative ) );
+
+	SamplerStateConfigDX11 sampler, negativeSampler;
+	negativeSampler.MipLODBias = -0.0f;
+	negativeSampler.BorderColor[2] = -0.0f;
+	negativeSampler.MinLOD = -0.0f;
+
+	CHECK( FindsEquivalent( sampler, negativeSampler ) );
+
+	// Other values of the same members are still told apart.
+
+	TStateCacheDX11<SamplerStateConfigDX11> cache;
+	cache.Insert( sampler, 0 );
+
+	SamplerStateConfigDX11 biased;
+	biased.MipLODBias = -1.0f;
+
+	CHECK( cache.Find( biased ) == -1 );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
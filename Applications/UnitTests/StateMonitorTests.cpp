@@ -0,0 +1,251 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TestFramework.h"
+#include "TStateArrayMonitor.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	const unsigned int SlotCount = 128;
+
+	// The array monitor as it was before the changed slots were tracked with a
+	// bitmask.  It keeps the start and end of the changed range, and searches
+	// for the new end points when one of them is set back to the sister state.
+
+	template <class T, unsigned int N>
+	class SpanStateArrayMonitor
+	{
+	public:
+		SpanStateArrayMonitor( T initialState ) :
+			m_uiStartSlot( 0 ), m_uiEndSlot( 0 ), m_bUploadNeeded( false ), m_pSister( nullptr )
+		{
+			for ( unsigned int i = 0; i < N; i++ )
+				m_States[i] = initialState;
+		}
+
+		void SetSister( SpanStateArrayMonitor<T,N>* pSister ) { m_pSister = pSister; }
+		bool SameAsSister( unsigned int slot ) { return( m_States[slot] == m_pSister->m_States[slot] ); }
+
+		void SetState( unsigned int slot, T state )
+		{
+			m_States[slot] = state;
+
+			if ( m_pSister == nullptr ) {
+				m_bUploadNeeded = true;
+				m_uiStartSlot = 0;
+				m_uiEndSlot = N-1;
+				return;
+			}
+
+			const bool bSameAsSister = SameAsSister( slot );
+
+			if ( !m_bUploadNeeded && !bSameAsSister ) {
+				m_bUploadNeeded = true;
+				m_uiStartSlot = slot;
+				m_uiEndSlot = slot;
+			}
+
+			if ( m_bUploadNeeded ) {
+				if ( slot < m_uiStartSlot ) {
+					if ( !bSameAsSister )
+						m_uiStartSlot = slot;
+				} else if ( slot == m_uiStartSlot ) {
+					if ( bSameAsSister )
+						SearchFromBelow();
+				} else if ( slot == m_uiEndSlot ) {
+					if ( bSameAsSister )
+						SearchFromAbove();
+				} else if ( m_uiEndSlot < slot ) {
+					if ( !bSameAsSister )
+						m_uiEndSlot = slot;
+				}
+			}
+		}
+
+		bool IsUpdateNeeded() { return( m_bUploadNeeded ); }
+		unsigned int GetStartSlot() { return( m_uiStartSlot ); }
+		unsigned int GetRange() { return( m_uiEndSlot - m_uiStartSlot + 1 ); }
+		T GetState( unsigned int slot ) const { return( m_States[slot] ); }
+		T* GetFirstSlotLocation() { return( &m_States[m_uiStartSlot] ); }
+		void ResetTracking() { m_uiStartSlot = 0; m_uiEndSlot = 0; m_bUploadNeeded = false; }
+
+	private:
+		void SearchFromBelow()
+		{
+			for ( ; m_uiStartSlot < m_uiEndSlot; m_uiStartSlot++ ) {
+				if ( !SameAsSister( m_uiStartSlot ) )
+					break;
+			}
+
+			if ( m_uiStartSlot == m_uiEndSlot && SameAsSister( m_uiStartSlot ) )
+				ResetTracking();
+		}
+
+		void SearchFromAbove()
+		{
+			for ( ; m_uiEndSlot > m_uiStartSlot; m_uiEndSlot-- ) {
+				if ( !SameAsSister( m_uiEndSlot ) )
+					break;
+			}
+
+			if ( m_uiStartSlot == m_uiEndSlot && SameAsSister( m_uiEndSlot ) )
+				ResetTracking();
+		}
+
+		unsigned int m_uiStartSlot;
+		unsigned int m_uiEndSlot;
+		bool m_bUploadNeeded;
+		T m_States[N];
+		SpanStateArrayMonitor<T,N>* m_pSister;
+	};
+
+	// A pipeline without a device, which only counts the binding calls and the
+	// slots that they set.
+
+	struct NullPipeline
+	{
+		int				slots[SlotCount];
+		unsigned int	calls;
+		unsigned int	bound;
+	};
+
+	// Records a sequence of draws the way a stage does: the desired state is
+	// set for each draw, the changed range is bound, and the current state
+	// then takes over the desired state.  The draws use a few material
+	// textures in the low slots, a shadow map, and occasionally an environment
+	// map and some per-object data higher up.
+
+	template <class M>
+	double RecordDraws( unsigned int draws, NullPipeline& pipeline, bool& matching )
+	{
+		M current( 0 );
+		M desired( 0 );
+		desired.SetSister( &current );
+		desired.ResetTracking();
+
+		memset( &pipeline, 0, sizeof( pipeline ) );
+		matching = true;
+
+		unsigned int seed = 12345;
+		auto random = [&seed]( unsigned int range ) { seed = seed * 1664525 + 1013904223; return( ( seed >> 8 ) % range ); };
+
+		TestTimer timer;
+
+		for ( unsigned int draw = 0; draw < draws; draw++ )
+		{
+			const int material = random( 16 );
+
+			for ( unsigned int slot = 0; slot < 4; slot++ )
+				desired.SetState( slot, material * 4 + slot + 1 );
+
+			if ( random( 8 ) == 0 )
+				desired.SetState( 8, random( 3 ) + 1 );
+			if ( random( 4 ) == 0 )
+				desired.SetState( 40, random( 5 ) + 1 );
+			if ( random( 2 ) == 0 )
+				desired.SetState( 100, random( 50 ) + 1 );
+
+			if ( desired.IsUpdateNeeded() ) {
+				const unsigned int range = desired.GetRange();
+				memcpy( pipeline.slots + desired.GetStartSlot(), desired.GetFirstSlotLocation(), range * sizeof( int ) );
+				pipeline.calls++;
+				pipeline.bound += range;
+			}
+
+			for ( unsigned int slot = 0; slot < SlotCount; slot++ ) {
+				matching = matching && pipeline.slots[slot] == desired.GetState( slot );
+				current.SetState( slot, desired.GetState( slot ) );
+			}
+
+			desired.ResetTracking();
+		}
+
+		return( timer.Milliseconds() );
+	}
+};
+//--------------------------------------------------------------------------------
+TEST_CASE( StateArrayMonitorTracksChangedRange )
+{
+	// The range always spans exactly the slots that differ from the sister,
+	// also when an end point is set back to the sister state.
+
+	unsigned int seed = 4321;
+	auto random = [&seed]( unsigned int range ) { seed = seed * 1664525 + 1013904223; return( ( seed >> 8 ) % range ); };
+
+	bool exact = true;
+
+	for ( unsigned int test = 0; test < 2000; test++ )
+	{
+		TStateArrayMonitor<int,70> current( 0 );
+		TStateArrayMonitor<int,70> desired( 0 );
+		desired.SetSister( &current );
+		desired.ResetTracking();
+
+		for ( unsigned int i = 0; i < 10; i++ )
+			desired.SetState( random( 70 ), random( 3 ) );
+
+		unsigned int first = 70;
+		unsigned int last = 0;
+
+		for ( unsigned int slot = 0; slot < 70; slot++ ) {
+			if ( desired.GetState( slot ) != 0 ) {
+				first = min( first, slot );
+				last = slot;
+			}
+		}
+
+		exact = exact && desired.IsUpdateNeeded() == ( first != 70 );
+
+		if ( first != 70 )
+			exact = exact && desired.GetStartSlot() == first && desired.GetEndSlot() == last
+				&& desired.GetRange() == last - first + 1 && desired.GetFirstSlotLocation() == desired.GetSlotLocation( first );
+	}
+
+	CHECK( exact );
+
+	// Without a sister, every slot has to be bound, and the range ends at the
+	// last slot even when the slot count isn't a multiple of the word size.
+
+	TStateArrayMonitor<int,70> single( 0 );
+	single.ResetTracking();
+	single.SetState( 5, 1 );
+	CHECK( single.GetStartSlot() == 0 && single.GetEndSlot() == 69 );
+}
+//--------------------------------------------------------------------------------
+TEST_CASE( StateArrayMonitorNullPipeline )
+{
+	const unsigned int draws = 200000;
+
+	NullPipeline span;
+	NullPipeline mask;
+	bool spanMatching = false;
+	bool maskMatching = false;
+
+	const double spanTime = RecordDraws< SpanStateArrayMonitor<int,SlotCount> >( draws, span, spanMatching );
+	const double maskTime = RecordDraws< TStateArrayMonitor<int,SlotCount> >( draws, mask, maskMatching );
+
+	printf( "  %u draws, %u slots\n", draws, SlotCount );
+	printf( "  start/end: %u calls, %u slots bound, %.3f ms\n", span.calls, span.bound, spanTime );
+	printf( "  bitmask:   %u calls, %u slots bound, %.3f ms\n", mask.calls, mask.bound, maskTime );
+
+	// Both monitors bind the same ranges, so the pipeline ends up with the
+	// desired state after every draw, with the same calls and slots.
+
+	CHECK( spanMatching );
+	CHECK( maskMatching );
+	CHECK( mask.calls == span.calls );
+	CHECK( mask.bound == span.bound );
+	CHECK( memcmp( mask.slots, span.slots, sizeof( mask.slots ) ) == 0 );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,193 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TestFramework.h"
+#include "TestGeometry.h"
+#include "JobScheduler.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	// A wavy grid, so that the tangents of neighbouring vertices differ and
+	// the summation order would show up in the results.
+
+	GeometryPtr CreateWavyGrid( int size )
+	{
+		return( CreateGrid( size, true, []( int x, int y, GridVertex& vertex ) {
+			const float height = 0.25f * sinf( 0.3f * x ) * cosf( 0.2f * y );
+
+			vertex.Position = Vector3f( static_cast<float>( x ), height, static_cast<float>( y ) );
+			vertex.Normal = Vector3f::Normalize( Vector3f( -height, 1.0f, height ) );
+			vertex.TexCoord = Vector2f( x * 0.1f + 0.01f * y * y, y * 0.1f );
+		} ) );
+	}
+
+	// The tangent frame computation as it was before it was vectorized, which
+	// accumulates the tangent directions one triangle at a time.
+
+	std::vector<float> ComputeReferenceTangents( GeometryPtr pGeometry )
+	{
+		VertexElementDX11* pPositionElement = pGeometry->GetElement( VertexElementDX11::PositionSemantic );
+		VertexElementDX11* pNormalElement = pGeometry->GetElement( VertexElementDX11::NormalSemantic );
+		VertexElementDX11* pTexCoordElement = pGeometry->GetElement( VertexElementDX11::TexCoordSemantic );
+
+		const int vertexCount = pPositionElement->Count();
+		std::vector<Vector3f> tangents( vertexCount, Vector3f( 0.0f, 0.0f, 0.0f ) );
+		std::vector<Vector3f> bitangents( vertexCount, Vector3f( 0.0f, 0.0f, 0.0f ) );
+
+		for ( UINT i = 0; i < pGeometry->GetIndexCount(); i += 3 )
+		{
+			UINT i1 = pGeometry->GetIndex( i + 0 );
+			UINT i2 = pGeometry->GetIndex( i + 1 );
+			UINT i3 = pGeometry->GetIndex( i + 2 );
+
+			const Vector3f& v1 = *pPositionElement->Get3f( i1 );
+			const Vector3f& v2 = *pPositionElement->Get3f( i2 );
+			const Vector3f& v3 = *pPositionElement->Get3f( i3 );
+
+			const Vector2f& w1 = *pTexCoordElement->Get2f( i1 );
+			const Vector2f& w2 = *pTexCoordElement->Get2f( i2 );
+			const Vector2f& w3 = *pTexCoordElement->Get2f( i3 );
+
+			float x1 = v2.x - v1.x;
+			float x2 = v3.x - v1.x;
+			float y1 = v2.y - v1.y;
+			float y2 = v3.y - v1.y;
+			float z1 = v2.z - v1.z;
+			float z2 = v3.z - v1.z;
+
+			float s1 = w2.x - w1.x;
+			float s2 = w3.x - w1.x;
+			float t1 = w2.y - w1.y;
+			float t2 = w3.y - w1.y;
+
+			float r = 1.0f / ( s1 * t2 - s2 * t1 );
+			Vector3f sDir( ( t2 * x1 - t1 * x2 ) * r, ( t2 * y1 - t1 * y2 ) * r, ( t2 * z1 - t1 * z2 ) * r );
+			Vector3f tDir( ( s1 * x2 - s2 * x1 ) * r, ( s1 * y2 - s2 * y1 ) * r, ( s1 * z2 - s2 * z1 ) * r );
+
+			tangents[i1] += sDir;
+			tangents[i2] += sDir;
+			tangents[i3] += sDir;
+
+			bitangents[i1] += tDir;
+			bitangents[i2] += tDir;
+			bitangents[i3] += tDir;
+		}
+
+		std::vector<float> result( vertexCount * 4 );
+
+		for ( int i = 0; i < vertexCount; ++i )
+		{
+			Vector3f& n = *pNormalElement->Get3f( i );
+			Vector3f& t = tangents[i];
+
+			// Gram-Schmidt orthogonalize
+			Vector3f tangent = Vector3f::Normalize( ( t - n * Vector3f::Dot( n, t ) ) );
+
+			// Calculate handedness
+			float sign = ( Vector3f::Dot( Vector3f::Cross( n, t ), bitangents[i] ) < 0.0f ) ? -1.0f : 1.0f;
+
+			result[i * 4 + 0] = tangent.x;
+			result[i * 4 + 1] = tangent.y;
+			result[i * 4 + 2] = tangent.z;
+			result[i * 4 + 3] = sign;
+		}
+
+		return( result );
+	}
+
+	std::vector<float> GetTangents( GeometryPtr pGeometry )
+	{
+		VertexElementDX11* pTangents = pGeometry->GetElement( VertexElementDX11::TangentSemantic );
+
+		if ( pTangents == nullptr )
+			return( std::vector<float>() );
+
+		return( std::vector<float>( ( *pTangents )[0], ( *pTangents )[0] + pTangents->Count() * pTangents->Tuple() ) );
+	}
+};
+//--------------------------------------------------------------------------------
+TEST_CASE( TangentFrameBenchmark )
+{
+	GeometryPtr pGeometry = CreateWavyGrid( 512 );
+
+	const int iterations = 10;
+
+	// The single threaded run is the reference, which every thread count has
+	// to reproduce exactly.  The first run isn't timed, since it allocates the
+	// tangent element for the first time.
+
+	CHECK( pGeometry->ComputeTangentFrame() );
+
+	TestTimer timer;
+
+	for ( int i = 0; i < iterations; i++ )
+		CHECK( pGeometry->ComputeTangentFrame() );
+
+	const double serialTime = timer.Milliseconds() / iterations;
+	const std::vector<float> reference = GetTangents( pGeometry );
+
+	CHECK( reference.size() == pGeometry->GetVertexCount() * 4 );
+
+	// The per triangle loop sums in a different order, so it only matches the
+	// new results within a tolerance, but the handedness has to be identical.
+
+	timer.Reset();
+
+	std::vector<float> scalar;
+
+	for ( int i = 0; i < iterations; i++ )
+		scalar = ComputeReferenceTangents( pGeometry );
+
+	const double scalarTime = timer.Milliseconds() / iterations;
+
+	float error = 0.0f;
+	bool handedness = scalar.size() == reference.size();
+
+	for ( size_t i = 0; handedness && i < reference.size(); i += 4 ) {
+		for ( size_t c = 0; c < 3; c++ )
+			error = max( error, fabs( scalar[i + c] - reference[i + c] ) );
+		handedness = scalar[i + 3] == reference[i + 3];
+	}
+
+	CHECK( handedness );
+	CHECK( error < 1e-4f );
+
+	printf( "  %d vertices, %u triangles, %u hardware threads\n", pGeometry->GetVertexCount(),
+		pGeometry->GetIndexCount() / 3, JobScheduler::GetHardwareThreadCount() );
+	printf( "  per triangle: %.3f ms\n", scalarTime );
+	printf( "  1 thread:  %.3f ms, %.2fx, largest difference %g\n", serialTime, scalarTime / serialTime, error );
+
+	const unsigned int threadCounts[] = { 2, 4, 8 };
+
+	for ( auto threads : threadCounts )
+	{
+		JobScheduler scheduler;
+		scheduler.Initialize( threads );
+
+		timer.Reset();
+
+		for ( int i = 0; i < iterations; i++ )
+			CHECK( pGeometry->ComputeTangentFrame( VertexElementDX11::PositionSemantic, VertexElementDX11::NormalSemantic,
+				VertexElementDX11::TexCoordSemantic, VertexElementDX11::TangentSemantic, &scheduler ) );
+
+		const double time = timer.Milliseconds() / iterations;
+
+		printf( "  %u threads: %.3f ms, %.2fx\n", threads, time, serialTime / time );
+
+		CHECK( GetTangents( pGeometry ) == reference );
+
+		scheduler.Shutdown();
+	}
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,76 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// TestFramework
+//
+// A minimal set of helpers for the unit tests, which run on the CPU only and
+// don't create a device.  Each TEST_CASE registers itself with the runner in
+// main.cpp, and a failing CHECK is reported without stopping the test.  The
+// benchmarks are tests as well, which print their measurements as they run.
+//--------------------------------------------------------------------------------
+#ifndef TestFramework_h
+#define TestFramework_h
+//--------------------------------------------------------------------------------
+#include <chrono>
+#include <cstdio>
+#include <vector>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	typedef void (*TestFunction)();
+
+	struct TestCase
+	{
+		const char*		name;
+		TestFunction	function;
+	};
+
+	std::vector<TestCase>& GetTestCases();
+	void ReportFailure( const char* file, int line, const char* expression );
+
+	struct TestRegistrar
+	{
+		TestRegistrar( const char* name, TestFunction function )
+		{
+			TestCase test = { name, function };
+			GetTestCases().push_back( test );
+		}
+	};
+
+	// The timer measures the wall clock time since it was created or reset.
+
+	class TestTimer
+	{
+	public:
+		TestTimer() { Reset(); }
+
+		void Reset() { m_Start = std::chrono::high_resolution_clock::now(); }
+
+		double Milliseconds() const
+		{
+			return( std::chrono::duration<double,std::milli>( std::chrono::high_resolution_clock::now() - m_Start ).count() );
+		}
+
+	private:
+		std::chrono::high_resolution_clock::time_point m_Start;
+	};
+};
+//--------------------------------------------------------------------------------
+#define TEST_CASE( name ) \
+	static void name(); \
+	static Glyph3::TestRegistrar name##Registrar( #name, name ); \
+	static void name()
+
+#define CHECK( expression ) \
+	( ( expression ) ? (void)0 : Glyph3::ReportFailure( __FILE__, __LINE__, #expression ) )
+//--------------------------------------------------------------------------------
+#endif // TestFramework_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,96 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// TestGeometry
+//
+// Builders for the synthetic geometry that the unit tests run on.  The vertex
+// elements are set up the way the loaders create them, and the geometry only
+// lives on the CPU, since no buffers are created for it.
+//--------------------------------------------------------------------------------
+#ifndef TestGeometry_h
+#define TestGeometry_h
+//--------------------------------------------------------------------------------
+#include "GeometryDX11.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	inline VertexElementDX11* CreateElement( const std::string& semantic, int tuple, DXGI_FORMAT format, int count )
+	{
+		VertexElementDX11* pElement = new VertexElementDX11( tuple, count );
+		pElement->m_SemanticName = semantic;
+		pElement->m_uiSemanticIndex = 0;
+		pElement->m_Format = format;
+		pElement->m_uiInputSlot = 0;
+		pElement->m_uiAlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+		pElement->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+		pElement->m_uiInstanceDataStepRate = 0;
+
+		return( pElement );
+	}
+
+	struct GridVertex
+	{
+		Vector3f	Position;
+		Vector3f	Normal;
+		Vector2f	TexCoord;
+	};
+
+	// A grid of size by size quads with two triangles each.  The shape is given
+	// by a function that fills in the vertex at each (x, y) grid coordinate.
+	// Every grid has positions and texture coordinates, and the normals are
+	// only added on request.
+
+	template <typename VertexFunction>
+	GeometryPtr CreateGrid( int size, bool normals, VertexFunction vertex )
+	{
+		const int count = ( size + 1 ) * ( size + 1 );
+
+		VertexElementDX11* pPositions = CreateElement( VertexElementDX11::PositionSemantic, 3, DXGI_FORMAT_R32G32B32_FLOAT, count );
+		VertexElementDX11* pTexCoords = CreateElement( VertexElementDX11::TexCoordSemantic, 2, DXGI_FORMAT_R32G32_FLOAT, count );
+		VertexElementDX11* pNormals = normals ? CreateElement( VertexElementDX11::NormalSemantic, 3, DXGI_FORMAT_R32G32B32_FLOAT, count ) : nullptr;
+		pPositions->m_uiAlignedByteOffset = 0;
+
+		for ( int y = 0; y <= size; y++ ) {
+			for ( int x = 0; x <= size; x++ ) {
+				const int v = y * ( size + 1 ) + x;
+
+				GridVertex grid;
+				grid.Normal = Vector3f( 0.0f, 0.0f, -1.0f );
+				vertex( x, y, grid );
+
+				*pPositions->Get3f( v ) = grid.Position;
+				*pTexCoords->Get2f( v ) = grid.TexCoord;
+				if ( pNormals ) *pNormals->Get3f( v ) = grid.Normal;
+			}
+		}
+
+		GeometryPtr pGeometry = GeometryPtr( new GeometryDX11() );
+		pGeometry->AddElement( pPositions );
+		pGeometry->AddElement( pTexCoords );
+		if ( pNormals ) pGeometry->AddElement( pNormals );
+		pGeometry->SetPrimitiveType( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+
+		for ( int y = 0; y < size; y++ ) {
+			for ( int x = 0; x < size; x++ ) {
+				const UINT v = y * ( size + 1 ) + x;
+				TriangleIndices first( v, v + size + 1, v + 1 );
+				TriangleIndices second( v + 1, v + size + 1, v + size + 2 );
+				pGeometry->AddFace( first );
+				pGeometry->AddFace( second );
+			}
+		}
+
+		return( pGeometry );
+	}
+};
+//--------------------------------------------------------------------------------
+#endif // TestGeometry_h
+//--------------------------------------------------------------------------------
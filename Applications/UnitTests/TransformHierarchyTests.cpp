@@ -0,0 +1,122 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TestFramework.h"
+#include "Scene.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	// Moves its node every frame, and re-parents a child node on a few of the
+	// frames, all from within the scene update.
+
+	class ReparentController : public IController<Node3D>
+	{
+	public:
+		ReparentController( Node3D* pChild, Node3D* pFirst, Node3D* pSecond ) :
+			m_pChild( pChild ), m_pFirst( pFirst ), m_pSecond( pSecond ), m_uiFrame( 0 )
+		{
+		}
+
+		virtual void Update( float fTime )
+		{
+			m_pEntity->Transform.Position() = Vector3f( 1.0f + m_uiFrame, 0.0f, 0.0f );
+
+			if ( m_uiFrame == 2 ) {
+				m_pFirst->AttachChild( m_pChild );
+			} else if ( m_uiFrame == 4 ) {
+				m_pFirst->DetachChild( m_pChild );
+				m_pSecond->AttachChild( m_pChild );
+			}
+
+			m_uiFrame++;
+		}
+
+	private:
+		Node3D* m_pChild;
+		Node3D* m_pFirst;
+		Node3D* m_pSecond;
+		unsigned int m_uiFrame;
+	};
+
+	// The nodes are declared before the scene, since they have to outlive the
+	// hierarchy that they are bound to.
+
+	struct ReparentScene
+	{
+		ReparentScene( bool batched )
+		{
+			Moving.Transform.Position() = Vector3f( 1.0f, 0.0f, 0.0f );
+			Other.Transform.Position() = Vector3f( 0.0f, 0.0f, 5.0f );
+			Child.Transform.Position() = Vector3f( 0.0f, 2.0f, 0.0f );
+			Leaf.Transform.Position() = Vector3f( 0.0f, 0.0f, 3.0f );
+
+			World.GetRoot()->AttachChild( &Moving );
+			World.GetRoot()->AttachChild( &Other );
+			Child.AttachChild( &Leaf );
+			Moving.Controllers.Attach( new ReparentController( &Child, &Moving, &Other ) );
+
+			World.SetBatchedTransformsEnabled( batched );
+		}
+
+		Node3D Moving;
+		Node3D Other;
+		Node3D Child;
+		Entity3D Leaf;
+		Scene World;
+	};
+
+	bool SameMatrix( const Matrix4f& a, const Matrix4f& b )
+	{
+		for ( int i = 0; i < 16; i++ ) {
+			if ( fabs( a[i] - b[i] ) > 1e-5f )
+				return( false );
+		}
+
+		return( true );
+	}
+};
+//--------------------------------------------------------------------------------
+TEST_CASE( TransformHierarchyMatchesGraphUpdate )
+{
+	// The batched scene has to produce the world matrices of the recursive
+	// update in the same frame, also on the frames where a controller moves
+	// its node and changes the graph structure below it.
+
+	ReparentScene graph( false );
+	ReparentScene batched( true );
+
+	bool matching = true;
+
+	for ( int frame = 0; frame < 8; frame++ )
+	{
+		graph.World.Update( 0.0f );
+		batched.World.Update( 0.0f );
+
+		matching = matching
+			&& SameMatrix( graph.Moving.Transform.WorldMatrix(), batched.Moving.Transform.WorldMatrix() )
+			&& SameMatrix( graph.Other.Transform.WorldMatrix(), batched.Other.Transform.WorldMatrix() )
+			&& SameMatrix( graph.Child.Transform.WorldMatrix(), batched.Child.Transform.WorldMatrix() )
+			&& SameMatrix( graph.Leaf.Transform.WorldMatrix(), batched.Leaf.Transform.WorldMatrix() );
+	}
+
+	CHECK( matching );
+	CHECK( batched.Leaf.Transform.IsBound() );
+	CHECK( !batched.World.GetRoot()->Transform.GetHierarchy()->IsStale() );
+
+	// The leaf ends up below the second node that its parent was moved to.
+
+	Vector3f position = batched.Leaf.Transform.WorldMatrix().GetTranslation();
+	CHECK( fabs( position.x ) < 1e-5f && fabs( position.y - 2.0f ) < 1e-5f && fabs( position.z - 8.0f ) < 1e-5f );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
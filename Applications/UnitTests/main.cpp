@@ -0,0 +1,70 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// The test runner executes all of the registered tests, or only those whose
+// names contain the first argument.  The exit code is the number of failed
+// tests, so that it can be used in scripts.
+//--------------------------------------------------------------------------------
+#include "TestFramework.h"
+#include <cstring>
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	unsigned int sFailures = 0;
+};
+//--------------------------------------------------------------------------------
+std::vector<TestCase>& Glyph3::GetTestCases()
+{
+	static std::vector<TestCase> tests;
+
+	return( tests );
+}
+//--------------------------------------------------------------------------------
+void Glyph3::ReportFailure( const char* file, int line, const char* expression )
+{
+	printf( "%s(%d): CHECK( %s ) failed\n", file, line, expression );
+	sFailures++;
+}
+//--------------------------------------------------------------------------------
+int main( int argc, char** argv )
+{
+	const char* filter = ( argc > 1 ) ? argv[1] : "";
+
+	int failed = 0;
+	int executed = 0;
+
+	for ( auto& test : GetTestCases() )
+	{
+		if ( strstr( test.name, filter ) == nullptr )
+			continue;
+
+		printf( "[ RUN  ] %s\n", test.name );
+
+		unsigned int failures = sFailures;
+		TestTimer timer;
+
+		test.function();
+
+		bool passed = ( sFailures == failures );
+		printf( "[ %s ] %s (%.1f ms)\n", passed ? " OK " : "FAIL", test.name, timer.Milliseconds() );
+
+		executed++;
+		if ( !passed )
+			failed++;
+	}
+
+	printf( "%d of %d tests passed\n", executed - failed, executed );
+
+	return( failed );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
@@ -186,8 +186,8 @@ void ViewRiftHighlight::ExecuteTask( PipelineManagerDX11* pPipelineManager, IPar
 			pPipelineManager->ApplyRenderTargets();
 			pPipelineManager->ClearBuffers( Vector4f( 0.0f, 0.0f, 0.0f, 0.0f ), 1.0f );
 
-			// Run through the graph and render each of the entities
-			m_pScene->GetRoot()->Render( pPipelineManager, pParamManager, VT_SILHOUETTE );
+			// Render the visible entities into the silhouette target
+			RenderVisibleEntities( pPipelineManager, pParamManager, VT_SILHOUETTE );
 
 
 
@@ -210,23 +210,9 @@ void ViewRiftHighlight::ExecuteTask( PipelineManagerDX11* pPipelineManager, IPar
 			pPipelineManager->ClearPipelineResources();
 
 
-			// Run through the graph and render each of the entities.  This will sort the entities 
-			// based on whether or not they are transparent.
-		
-			std::vector<Entity3D*> entity_list;
-			GetAllEntities( m_pScene->GetRoot(), entity_list );
-
-			auto const transparent_check = []( Entity3D* entity) { 
-				return entity->Visual.iPass != Renderable::ALPHA;
-			};
-
-			// We use stable partition to sort, and return the first transparent entity.
-			auto const iter_first_alpha = std::stable_partition(begin(entity_list), end(entity_list), transparent_check);
-
-			// Now we can render all entities in the sorted order.
-			for ( auto& entity : entity_list ) {
-				entity->Render( pPipelineManager, pParamManager, VT_PERSPECTIVE );
-			}
+			// Render the visible entities, sorted by their pipeline state with the
+			// transparent entities last.  The culling uses this eye's matrices.
+			RenderVisibleEntities( pPipelineManager, pParamManager, VT_PERSPECTIVE );
 
 
 			// Set the silhouette buffer as a shader resource, then draw the full screen
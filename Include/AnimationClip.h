@@ -0,0 +1,81 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// AnimationClip
+//
+// An animation clip stores the keyframes of many animation tracks in a single
+// structure of arrays - all of the key times are stored contiguously, as are
+// all of the key values, and each track refers to a range of these arrays.
+// This allows a whole skeleton to be sampled in one loop, without the per track
+// virtual calls and interpolation function objects of the AnimationStream.
+//
+// Sampling uses a cursor per track, which holds the key that was found in the
+// previous sample.  When the time moves forward steadily, the cursor only has
+// to advance by a key now and then, and a binary search is used otherwise.
+// The cursors are provided by the caller, so that a single clip can be shared
+// by many instances that are each at a different point in the animation.
+//--------------------------------------------------------------------------------
+#ifndef AnimationClip_h
+#define AnimationClip_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "AnimationStream.h"
+#include "Vector3f.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class AnimationClip
+	{
+	public:
+		AnimationClip();
+		~AnimationClip();
+
+		// Adds a track with a copy of the given keyframes, which must be sorted by
+		// their time stamps.  A track without any keyframes samples to zero.
+		// The index of the new track is returned.
+
+		unsigned int AddTrack( const std::vector<AnimationState<Vector3f>>& states );
+		void Clear();
+
+		unsigned int GetTrackCount() const;
+		unsigned int GetKeyCount( unsigned int track ) const;
+
+		// The time range that is covered by the keyframes of all tracks.
+
+		float GetStartTime() const;
+		float GetEndTime() const;
+
+		// Returns the index (within the track) of the last key at or before the
+		// given time, or the first key if the time precedes all of them.
+
+		unsigned int FindKey( unsigned int track, float time ) const;
+
+		// Samples all of the tracks at the given time, with the same quadratic
+		// easing as the default AnimationStream interpolation.  There must be one
+		// cursor and one result for each track, and cursors should be zero
+		// initialized before the first sample.
+
+		void Sample( float time, unsigned int* pCursors, Vector3f* pResults ) const;
+
+	protected:
+		unsigned int FindKeyInRange( unsigned int first, unsigned int end, float time ) const;
+
+		std::vector<unsigned int>		m_TrackOffsets;
+		std::vector<float>				m_Times;
+		std::vector<Vector3f>			m_Values;
+
+		float							m_fStartTime;
+		float							m_fEndTime;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // AnimationClip_h
+//--------------------------------------------------------------------------------
@@ -53,6 +53,12 @@ namespace Glyph3
 
 		void SetInterpolationMethod( std::function<T(const T&,const T&,float)> func );
 
+		// Read access to the keyframes and animations, i.e. for copying them into
+		// an AnimationClip for batched evaluation.
+
+		const std::vector<AnimationState<T>>& GetStates() const;
+		const std::vector<Animation>& GetAnimations() const;
+
 	protected:
 		std::vector<AnimationState<T>>					m_vStates;
 		T												m_kCurrState;
@@ -106,28 +106,26 @@ void AnimationStream<T>::Play( float fStartTime, float fEndTime )
 	m_EndFrame = 0;
 
 	// If there are more then one state, search to find where to start and end.  
-	// Note that the bounds on the for-loop restricts which indices are used to a
-	// valid range!
+	// The states are sorted by their time stamps, so a binary search is used to
+	// find the last state at or before the start time, and the first state at or
+	// after the end time.  Times outside of the keyframes are clamped to the 
+	// first and last states.
 
 	if ( m_vStates.size() > 1 ) 
 	{
-		// Find the starting frame
-		for ( m_CurrFrame = 0; m_CurrFrame < m_vStates.size() - 1; m_CurrFrame++ )
-		{
-			if ( m_vStates[m_CurrFrame].m_fTimeStamp <= fStartTime && fStartTime < m_vStates[m_CurrFrame+1].m_fTimeStamp )
-			{
-				break;
-			}
-		}
+		auto const compare_time = []( float time, const AnimationState<T>& state ) {
+			return( time < state.m_fTimeStamp );
+		};
 
-		// Find the ending frame
-		for ( m_EndFrame = m_vStates.size()-1; m_EndFrame > 0; m_EndFrame-- )
-		{
-			if ( m_vStates[m_EndFrame-1].m_fTimeStamp < fEndTime && fEndTime <= m_vStates[m_EndFrame].m_fTimeStamp )
-			{
-				break;
-			}
-		}
+		auto const compare_state = []( const AnimationState<T>& state, float time ) {
+			return( state.m_fTimeStamp < time );
+		};
+
+		auto start = std::upper_bound( m_vStates.begin(), m_vStates.end(), fStartTime, compare_time );
+		m_CurrFrame = ( start == m_vStates.begin() ) ? 0 : ( start - m_vStates.begin() ) - 1;
+
+		auto end = std::lower_bound( m_vStates.begin(), m_vStates.end(), fEndTime, compare_state );
+		m_EndFrame = ( end == m_vStates.end() ) ? m_vStates.size() - 1 : end - m_vStates.begin();
 	}
 
 	m_fAnimationTime = fStartTime;
@@ -182,4 +180,16 @@ void AnimationStream<T>::SetInterpolationMethod( std::function<T(const T&,const
 {
 	m_tweenFunc = func;
 }
+//--------------------------------------------------------------------------------
+template < class T >
+const std::vector<AnimationState<T>>& AnimationStream<T>::GetStates() const
+{
+	return( m_vStates );
+}
+//--------------------------------------------------------------------------------
+template < class T >
+const std::vector<Animation>& AnimationStream<T>::GetAnimations() const
+{
+	return( m_vAnimations );
+}
 //--------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,127 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// AssetCacheDX11
+//
+// The asset cache is a singleton that shares loaded geometry and textures across
+// the whole process.  Assets are identified by their filename together with the
+// options that they are loaded with, so that the same file loaded in two
+// different ways results in two different assets.  The first request for an
+// asset runs its loader, and every following request returns the same shared
+// pointer instead of loading the file again.  If several threads request the
+// same asset at once, only one of them loads it and the others wait for it.
+//
+// The shared pointers are the reference counts of the assets - an asset that
+// is only referenced by the cache is not used anywhere else.  When a memory
+// budget is set, such unused assets are evicted in least recently used order
+// until the cache fits into the budget again.  Assets that are still in use
+// are never evicted, since their memory couldn't be released anyway.
+//
+// Since the assets are shared, they should be treated as read only by their
+// users.  Anything that is modified per instance must be loaded without the
+// cache instead.
+//--------------------------------------------------------------------------------
+#ifndef AssetCacheDX11_h
+#define AssetCacheDX11_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "GeometryDX11.h"
+#include "ResourceProxyDX11.h"
+#include <functional>
+#include <future>
+#include <mutex>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class AssetCacheDX11
+	{
+	public:
+		typedef std::function<GeometryPtr()> GeometryLoader;
+		typedef std::function<ResourcePtr()> TextureLoader;
+
+		static AssetCacheDX11& Get( );
+
+		GeometryPtr GetGeometry( const std::wstring& filename, const std::string& options, const GeometryLoader& loader );
+
+		ResourcePtr GetTexture( const std::wstring& filename, bool sRGB = false );
+		ResourcePtr GetTexture( const std::wstring& filename, const std::string& options, const TextureLoader& loader );
+
+		// The memory budget is given in bytes, and a budget of zero disables the
+		// eviction of assets.  Trim evicts all of the unused assets regardless of
+		// the budget, and Clear removes all assets from the cache.  The textures
+		// of evicted assets are deleted from the renderer.
+
+		void SetMemoryBudget( unsigned long long bytes );
+		unsigned long long GetMemoryBudget( );
+		unsigned long long GetMemoryUsage( );
+
+		void Trim( );
+		void Clear( );
+
+		// A request that waits for an asset that is already being loaded counts
+		// as a hit, since the file is only loaded once.
+
+		unsigned int GetHitCount( );
+		unsigned int GetMissCount( );
+		unsigned int GetEvictionCount( );
+		unsigned int GetAssetCount( );
+		void ResetCounters( );
+		void LogStatistics( );
+
+	protected:
+		AssetCacheDX11();
+
+		struct Asset
+		{
+			GeometryPtr			geometry;
+			ResourcePtr			texture;
+			unsigned long long	size;
+
+			bool IsValid() const;
+			bool IsShared() const;
+			void Release();
+		};
+
+		struct Entry
+		{
+			Asset								asset;
+			std::list<std::wstring>::iterator	lru;
+		};
+
+		Asset Acquire( const std::wstring& key, const std::function<Asset()>& loader );
+		void Evict( unsigned long long budget );
+
+		static std::wstring MakeKey( const wchar_t* type, const std::wstring& filename, const std::string& options );
+		static unsigned long long GeometrySize( GeometryPtr geometry );
+		static unsigned long long TextureSize( ResourcePtr texture );
+
+		std::mutex											m_Lock;
+		std::map<std::wstring,Entry>						m_Entries;
+		std::map<std::wstring,std::shared_future<Asset>>	m_Pending;
+
+		// The most recently used assets are at the front of the list.
+		std::list<std::wstring>								m_LRU;
+
+		unsigned long long	m_ullBudget;
+		unsigned long long	m_ullUsage;
+
+		unsigned int		m_uiHits;
+		unsigned int		m_uiMisses;
+		unsigned int		m_uiEvictions;
+
+	private:
+		AssetCacheDX11( const AssetCacheDX11& );
+		AssetCacheDX11& operator=( const AssetCacheDX11& );
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // AssetCacheDX11_h
+//--------------------------------------------------------------------------------
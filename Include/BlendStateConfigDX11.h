@@ -36,7 +36,7 @@ namespace Glyph3
 
 	inline bool operator==(const BlendStateConfigDX11& lhs, const BlendStateConfigDX11& rhs)
 	{
-		bool result = false;
+		bool result = true;
 
 		for ( size_t index = 0; index < 8; index++ )
 		{
@@ -58,29 +58,30 @@ namespace Glyph3
 		return result;
 	}
 
-	inline bool operator<(const BlendStateConfigDX11& lhs, const BlendStateConfigDX11& rhs)
+	// Hash function for the state caches
+
+	inline unsigned int HashState( const BlendStateConfigDX11& config )
 	{
-		return memcmp( &lhs, &rhs, sizeof(lhs) ) < 0;
-		//bool result = false;
-
-		//for ( size_t index = 0; index < 8; index++ )
-		//{
-		//	result = result ||
-		//		lhs.RenderTarget[index].BlendEnable < rhs.RenderTarget[index].BlendEnable ||
-		//		lhs.RenderTarget[index].BlendOp < rhs.RenderTarget[index].BlendOp ||
-		//		lhs.RenderTarget[index].BlendOpAlpha < rhs.RenderTarget[index].BlendOpAlpha ||
-		//		lhs.RenderTarget[index].DestBlend < rhs.RenderTarget[index].DestBlend ||
-		//		lhs.RenderTarget[index].DestBlendAlpha < rhs.RenderTarget[index].DestBlendAlpha ||
-		//		lhs.RenderTarget[index].RenderTargetWriteMask < rhs.RenderTarget[index].RenderTargetWriteMask ||
-		//		lhs.RenderTarget[index].SrcBlend < rhs.RenderTarget[index].SrcBlend ||
-		//		lhs.RenderTarget[index].SrcBlendAlpha < rhs.RenderTarget[index].SrcBlendAlpha;
-		//}
-
-		//result = result ||
-		//	lhs.AlphaToCoverageEnable < rhs.AlphaToCoverageEnable ||
-		//	lhs.IndependentBlendEnable < rhs.IndependentBlendEnable;
-
-		//return result;
+		unsigned int hash = StateHashSeed;
+
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.AlphaToCoverageEnable ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.IndependentBlendEnable ) );
+
+		for ( size_t index = 0; index < 8; index++ )
+		{
+			const D3D11_RENDER_TARGET_BLEND_DESC& target = config.RenderTarget[index];
+
+			hash = HashStateValue( hash, static_cast<unsigned int>( target.BlendEnable ) );
+			hash = HashStateValue( hash, static_cast<unsigned int>( target.SrcBlend ) );
+			hash = HashStateValue( hash, static_cast<unsigned int>( target.DestBlend ) );
+			hash = HashStateValue( hash, static_cast<unsigned int>( target.BlendOp ) );
+			hash = HashStateValue( hash, static_cast<unsigned int>( target.SrcBlendAlpha ) );
+			hash = HashStateValue( hash, static_cast<unsigned int>( target.DestBlendAlpha ) );
+			hash = HashStateValue( hash, static_cast<unsigned int>( target.BlendOpAlpha ) );
+			hash = HashStateValue( hash, static_cast<unsigned int>( target.RenderTargetWriteMask ) );
+		}
+
+		return hash;
 	}
 };
 //--------------------------------------------------------------------------------
@@ -0,0 +1,82 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// ConstantBufferBatchDX11
+//
+// The batch packs the per-draw constant data of many draws into one large
+// constant buffer, so that all of it is uploaded with a single map instead of
+// mapping a small buffer once for each draw.  The blocks are added while the
+// draws are being prepared, and each one is placed at a multiple of 256 bytes.
+// This is the granularity at which a range of a constant buffer can be bound
+// with the D3D11.1 *SSetConstantBuffers1 methods, and the offsets are also
+// available in units of constants (16 bytes) for indexing the packed data from
+// a shader.
+//
+// The constant buffer that the batch is uploaded to must be large enough for
+// all of the blocks, and should be created for dynamic updates.
+//--------------------------------------------------------------------------------
+#ifndef ConstantBufferBatchDX11_h
+#define ConstantBufferBatchDX11_h
+//--------------------------------------------------------------------------------
+#include "IConstantBufferUploader.h"
+#include <vector>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class ConstantBufferBatchDX11
+	{
+	public:
+		ConstantBufferBatchDX11();
+		~ConstantBufferBatchDX11();
+
+		enum { BlockAlignment = 256, ConstantSize = 16 };
+
+		void Reset();
+
+		// Adds a block of data, and returns its offset in bytes.  The block can
+		// also be written directly through the pointer from AllocateBlock.
+
+		unsigned int AddBlock( const void* pData, unsigned int size );
+		char* AllocateBlock( unsigned int size, unsigned int& offset );
+
+		unsigned int GetBlockCount() const;
+		unsigned int GetBlockOffset( unsigned int block ) const;
+		unsigned int GetBlockSize( unsigned int block ) const;
+
+		unsigned int GetSize() const;
+		const char* GetData() const;
+
+		// Uploads all of the blocks to the buffer at once.  This fails when the
+		// blocks don't fit into the buffer, or when one of them is larger than
+		// the 64 KB that a shader can access.
+
+		bool Upload( ConstantBufferDX11* pBuffer, IConstantBufferUploader* pUploader );
+
+		// The offsets and sizes in units of constants, as they are used when a
+		// block is bound on its own.  The count is rounded up to the alignment.
+
+		static unsigned int GetFirstConstant( unsigned int offset );
+		static unsigned int GetConstantCount( unsigned int size );
+
+	private:
+		struct Block
+		{
+			unsigned int	offset;
+			unsigned int	size;
+		};
+
+		std::vector<char>		m_Data;
+		std::vector<Block>		m_Blocks;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // ConstantBufferBatchDX11_h
+//--------------------------------------------------------------------------------
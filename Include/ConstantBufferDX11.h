@@ -11,11 +11,22 @@
 //--------------------------------------------------------------------------------
 // ConstantBufferDX11 
 //
+// The constant buffer keeps a CPU side copy of its contents.  When the mappings
+// are evaluated, only the variables whose parameters have a new value ID are
+// written into the copy, and the buffer is only mapped and uploaded when this
+// has actually changed some of the bytes.  The uploads go through the
+// IConstantBufferUploader interface, which is normally the pipeline manager.
+//
+// Like the parameter values, the copy is kept for each parameter manager ID,
+// so that several threads can evaluate the same buffer for their own deferred
+// contexts at the same time.
 //--------------------------------------------------------------------------------
 #ifndef ConstantBufferDX11_h
 #define ConstantBufferDX11_h
 //--------------------------------------------------------------------------------
 #include "BufferDX11.h"
+#include "IConstantBufferUploader.h"
+#include <atomic>
 //--------------------------------------------------------------------------------
 namespace Glyph3
 {
@@ -25,6 +36,7 @@ namespace Glyph3
 		unsigned int				offset;
 		unsigned int				size;
 		D3D_SHADER_VARIABLE_CLASS	varclass;
+		D3D_SHADER_VARIABLE_TYPE	vartype;
 		unsigned int				elements;
 		unsigned int				valueID;
 	};
@@ -42,15 +54,43 @@ namespace Glyph3
 		void						AddMapping( ConstantBufferMapping& mapping );
 		void						EmptyMappings( );
 		void						EvaluateMappings( PipelineManagerDX11* pPipeline, IParameterManager* pParamManager );
+		void						EvaluateMappings( IConstantBufferUploader* pUploader, IParameterManager* pParamManager );
 		bool						ContainsMapping( int index, const ConstantBufferMapping& mapping );
 
 		void						SetAutoUpdate( bool enable );
 		bool						GetAutoUpdate( );
 
+		const std::vector<char>&	GetShadowData( unsigned int threadID = 0 );
+
 	protected:
+		// A CPU side copy of the buffer contents, with the value IDs that its
+		// variables were written with and the range of it that has changed since
+		// its last upload.  The uploader and its generation at that upload tell
+		// whether the buffer still holds the copy, since the initial contents of
+		// the buffer are undefined.
+
+		struct ShadowCopy
+		{
+			std::vector<char>			Data;
+			std::vector<unsigned int>	ValueIDs;
+			unsigned int				DirtyStart;
+			unsigned int				DirtyEnd;
+			IConstantBufferUploader*	pUploader;
+			unsigned int				Generation;
+		};
+
+		bool						WriteMapping( ShadowCopy& copy, const ConstantBufferMapping& mapping, IParameterManager* pParamManager );
+		bool						WriteBytes( ShadowCopy& copy, unsigned int offset, const void* pData, unsigned int size );
+
 		bool									m_bAutoUpdate;
 		std::vector< ConstantBufferMapping >	m_Mappings;
 
+		// The copies are indexed by the parameter manager ID, and the last ID
+		// whose copy was uploaded detects when two of them share one context.
+
+		ShadowCopy								m_Shadows[NUM_THREADS+1];
+		std::atomic<unsigned int>				m_uiLastThreadID;
+
 		friend RendererDX11;
 	};
 };
@@ -0,0 +1,38 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// CullingStats
+//
+// The culling statistics are optionally filled in by the scene graph visibility
+// queries.  They indicate how many bounding volume tests were needed to produce
+// the visible set, and how many entities ended up in it.  Comparing the number
+// of entities tested against the number of entities in the scene gives a direct
+// measure of how much work the hierarchy is saving.
+//--------------------------------------------------------------------------------
+#ifndef CullingStats_h
+#define CullingStats_h
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	struct CullingStats
+	{
+		CullingStats() : NodesTested( 0 ), EntitiesTested( 0 ), EntitiesVisible( 0 ) {}
+
+		unsigned int	NodesTested;
+		unsigned int	EntitiesTested;
+		unsigned int	EntitiesVisible;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // CullingStats_h
+//--------------------------------------------------------------------------------
@@ -55,28 +55,32 @@ namespace Glyph3
 			lhs.StencilWriteMask == rhs.StencilWriteMask;
 	}
 
-	inline bool operator<( const D3D11_DEPTH_STENCILOP_DESC& lhs, const D3D11_DEPTH_STENCILOP_DESC& rhs )
+	// Hash function for the state caches
+
+	inline unsigned int HashState( const D3D11_DEPTH_STENCILOP_DESC& desc, unsigned int hash )
 	{
-		return memcmp(&lhs, &rhs, sizeof(lhs)) < 0;
-		//return 
-		//	lhs.StencilDepthFailOp < rhs.StencilDepthFailOp ||
-		//	lhs.StencilFailOp < rhs.StencilFailOp ||
-		//	lhs.StencilFunc < rhs.StencilFunc ||
-		//	lhs.StencilPassOp < rhs.StencilPassOp;
+		hash = HashStateValue( hash, static_cast<unsigned int>( desc.StencilFailOp ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( desc.StencilDepthFailOp ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( desc.StencilPassOp ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( desc.StencilFunc ) );
+
+		return hash;
 	}
 
-	inline bool operator<(const DepthStencilStateConfigDX11& lhs, const DepthStencilStateConfigDX11& rhs)
+	inline unsigned int HashState( const DepthStencilStateConfigDX11& config )
 	{
-		return memcmp(&lhs, &rhs, sizeof(lhs)) < 0;
-		//return
-		//	lhs.BackFace < rhs.BackFace ||
-		//	lhs.DepthEnable < rhs.DepthEnable ||
-		//	lhs.DepthFunc < rhs.DepthFunc ||
-		//	lhs.DepthWriteMask < rhs.DepthWriteMask ||
-		//	lhs.FrontFace < rhs.FrontFace ||
-		//	lhs.StencilEnable < rhs.StencilEnable ||
-		//	lhs.StencilReadMask < rhs.StencilReadMask ||
-		//	lhs.StencilWriteMask < rhs.StencilWriteMask;
+		unsigned int hash = StateHashSeed;
+
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.DepthEnable ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.DepthWriteMask ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.DepthFunc ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.StencilEnable ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.StencilReadMask ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.StencilWriteMask ) );
+		hash = HashState( config.FrontFace, hash );
+		hash = HashState( config.BackFace, hash );
+
+		return hash;
 	}
 
 };
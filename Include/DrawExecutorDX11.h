@@ -61,6 +61,11 @@ namespace Glyph3
 
 		void SetMaxVertexCount( unsigned int count );
 
+		// Ring mode appends the geometry of each frame to persistent buffers
+		// instead of discarding them (see TGrowableBufferDX11).
+
+		virtual void SetRingMode( bool enable, unsigned int frames = 3 );
+
 	protected:
 
 		// The type of primitives listed in the index buffer
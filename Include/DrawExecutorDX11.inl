@@ -40,7 +40,7 @@ void DrawExecutorDX11<TVertex>::Execute( PipelineManagerDX11* pPipeline, IParame
 		pPipeline->InputAssemblerStage.DesiredState.PrimitiveTopology.SetState( m_ePrimType );
 		pPipeline->InputAssemblerStage.DesiredState.VertexBuffers.SetState( 0, VertexBuffer.GetBuffer()->m_iResource );
 		pPipeline->InputAssemblerStage.DesiredState.VertexBufferStrides.SetState( 0, sizeof( TVertex ) );
-		pPipeline->InputAssemblerStage.DesiredState.VertexBufferOffsets.SetState( 0, 0 );
+		pPipeline->InputAssemblerStage.DesiredState.VertexBufferOffsets.SetState( 0, VertexBuffer.GetUploadOffset() * sizeof( TVertex ) );
 	
 		pPipeline->ApplyInputResources();
 
@@ -190,3 +190,9 @@ void DrawExecutorDX11<TVertex>::SetMaxVertexCount( unsigned int count )
 	VertexBuffer.SetMaxElementCount( count );
 }
 //--------------------------------------------------------------------------------
+template <class TVertex>
+void DrawExecutorDX11<TVertex>::SetRingMode( bool enable, unsigned int frames )
+{
+	VertexBuffer.SetRingMode( enable, frames );
+}
+//--------------------------------------------------------------------------------
@@ -54,6 +54,8 @@ namespace Glyph3
 
 		void SetMaxIndexCount( unsigned int count );
 
+		virtual void SetRingMode( bool enable, unsigned int frames = 3 );
+
 	protected:
 		
 		TGrowableIndexBufferDX11<unsigned int> IndexBuffer;
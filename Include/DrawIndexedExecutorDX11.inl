@@ -39,7 +39,7 @@ void DrawIndexedExecutorDX11<TVertex>::Execute( PipelineManagerDX11* pPipeline,
 		pPipeline->InputAssemblerStage.DesiredState.PrimitiveTopology.SetState( m_ePrimType );
 		pPipeline->InputAssemblerStage.DesiredState.VertexBuffers.SetState( 0, VertexBuffer.GetBuffer()->m_iResource );
 		pPipeline->InputAssemblerStage.DesiredState.VertexBufferStrides.SetState( 0, sizeof( TVertex ) );
-		pPipeline->InputAssemblerStage.DesiredState.VertexBufferOffsets.SetState( 0, 0 );
+		pPipeline->InputAssemblerStage.DesiredState.VertexBufferOffsets.SetState( 0, VertexBuffer.GetUploadOffset() * sizeof( TVertex ) );
 		pPipeline->InputAssemblerStage.DesiredState.IndexBuffer.SetState( IndexBuffer.GetBuffer()->m_iResource );
 
 		pPipeline->ApplyInputResources();
@@ -47,7 +47,8 @@ void DrawIndexedExecutorDX11<TVertex>::Execute( PipelineManagerDX11* pPipeline,
 		// Perform the indexed draw call, which only depends on the number of 
 		// indices that are available.  The number of primitives generated will be
 		// a function of how many indices and the primitive topology set above.
-		pPipeline->DrawIndexed( IndexBuffer.GetElementCount(), 0, 0 );
+		// The indices start wherever they were last uploaded to.
+		pPipeline->DrawIndexed( IndexBuffer.GetElementCount(), IndexBuffer.GetUploadOffset(), 0 );
 	}
 }
 //--------------------------------------------------------------------------------
@@ -201,3 +202,10 @@ void DrawIndexedExecutorDX11<TVertex>::SetMaxIndexCount( unsigned int count )
 	IndexBuffer.SetMaxElementCount( count );
 }
 //--------------------------------------------------------------------------------
+template <class TVertex>
+void DrawIndexedExecutorDX11<TVertex>::SetRingMode( bool enable, unsigned int frames )
+{
+	IndexBuffer.SetRingMode( enable, frames );
+	DrawExecutorDX11<TVertex>::SetRingMode( enable, frames );
+}
+//--------------------------------------------------------------------------------
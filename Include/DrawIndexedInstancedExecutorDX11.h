@@ -41,6 +41,8 @@ namespace Glyph3
 
 		void SetInstanceRange( unsigned int start, unsigned int end );
 
+		virtual void SetRingMode( bool enable, unsigned int frames = 3 );
+
 	protected:
 		
 		TGrowableVertexBufferDX11<TInstance> InstanceBuffer;
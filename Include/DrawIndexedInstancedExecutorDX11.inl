@@ -45,11 +45,11 @@ void DrawIndexedInstancedExecutorDX11<TVertex,TInstance>::Execute( PipelineManag
 
 		pPipeline->InputAssemblerStage.DesiredState.VertexBuffers.SetState( 0, VertexBuffer.GetBuffer()->m_iResource );
 		pPipeline->InputAssemblerStage.DesiredState.VertexBufferStrides.SetState( 0, sizeof( TVertex ) );
-		pPipeline->InputAssemblerStage.DesiredState.VertexBufferOffsets.SetState( 0, 0 );
+		pPipeline->InputAssemblerStage.DesiredState.VertexBufferOffsets.SetState( 0, VertexBuffer.GetUploadOffset() * sizeof( TVertex ) );
 
 		pPipeline->InputAssemblerStage.DesiredState.VertexBuffers.SetState( 1, InstanceBuffer.GetBuffer()->m_iResource );
 		pPipeline->InputAssemblerStage.DesiredState.VertexBufferStrides.SetState( 1, sizeof( TInstance ) );
-		pPipeline->InputAssemblerStage.DesiredState.VertexBufferOffsets.SetState( 1, 0 );
+		pPipeline->InputAssemblerStage.DesiredState.VertexBufferOffsets.SetState( 1, InstanceBuffer.GetUploadOffset() * sizeof( TInstance ) );
 
 		pPipeline->InputAssemblerStage.DesiredState.IndexBuffer.SetState( IndexBuffer.GetBuffer()->m_iResource );
 		pPipeline->InputAssemblerStage.DesiredState.IndexBufferFormat.SetState( DXGI_FORMAT_R32_UINT );
@@ -59,9 +59,9 @@ void DrawIndexedInstancedExecutorDX11<TVertex,TInstance>::Execute( PipelineManag
 		// Here we provide an index count and an instance count to the indexed 
 		// instanced draw call.
 		if ( m_uiCount == 0 ) {
-			pPipeline->DrawIndexedInstanced( IndexBuffer.GetElementCount(), InstanceBuffer.GetElementCount(), 0, 0, 0 );
+			pPipeline->DrawIndexedInstanced( IndexBuffer.GetElementCount(), InstanceBuffer.GetElementCount(), IndexBuffer.GetUploadOffset(), 0, 0 );
 		} else {
-			pPipeline->DrawIndexedInstanced( IndexBuffer.GetElementCount(), m_uiCount, 0, 0, m_uiStart );
+			pPipeline->DrawIndexedInstanced( IndexBuffer.GetElementCount(), m_uiCount, IndexBuffer.GetUploadOffset(), 0, m_uiStart );
 		}
 	}
 }
@@ -112,3 +112,10 @@ void DrawIndexedInstancedExecutorDX11<TVertex,TInstance>::SetInstanceRange( unsi
 	}
 }
 //--------------------------------------------------------------------------------
+template <class TVertex, class TInstance>
+void DrawIndexedInstancedExecutorDX11<TVertex,TInstance>::SetRingMode( bool enable, unsigned int frames )
+{
+	InstanceBuffer.SetRingMode( enable, frames );
+	DrawIndexedExecutorDX11<TVertex>::SetRingMode( enable, frames );
+}
+//--------------------------------------------------------------------------------
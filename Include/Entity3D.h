@@ -51,7 +51,15 @@ namespace Glyph3
 		// Rendering related data and functionality
 		void SetRenderParams( IParameterManager* pParamManager );
 		void PreRender( RendererDX11* pRenderer, VIEWTYPE view );
-		void Render( PipelineManagerDX11* pPipelineManager, IParameterManager* pParamManager, VIEWTYPE view );
+		void Render( PipelineManagerDX11* pPipelineManager, IParameterManager* pParamManager, VIEWTYPE view, unsigned int lod = 0 );
+
+		// The level of detail is selected from the fraction of the viewport height
+		// that the world bounds cover with the given matrices.  The scale is
+		// applied to that size, so that values below one prefer coarser levels.
+		// Unbounded entities and entities around the camera always use level zero.
+
+		float GetScreenSize( const Matrix4f& ViewMatrix, const Matrix4f& ProjMatrix ) const;
+		unsigned int SelectLOD( const Matrix4f& ViewMatrix, const Matrix4f& ProjMatrix, float scale = 1.0f ) const;
 
 		std::wstring toString( );
 
@@ -75,11 +83,29 @@ namespace Glyph3
 		void SetUserData( void* pData );
 		void* GetUserData() const;
 
+		// The world space bounds are generated from the spheres in the composite 
+		// shape during the world update.  An entity without any shapes is 
+		// considered to be unbounded, and will never be culled by a visibility test.
+		// Such an entity can opt in to using the model bounds of its executor 
+		// instead, which is only correct if the vertices aren't moved beyond them
+		// on the GPU (i.e. by tessellation, skinning or particle simulation).
+
+		void UpdateWorldBounds( );
+		const Sphere3f& GetWorldBounds() const;
+		bool IsBounded() const;
+
+		void SetExecutorBounds( bool enable );
+		bool GetExecutorBounds() const;
+
 	protected:
 
 		Node3D* m_pParent;
 		std::wstring m_Name;
 
+		Sphere3f m_WorldBounds;
+		bool m_bBounded;
+		bool m_bExecutorBounds;
+
 	public:
 		Transform3D					Transform;
 		ControllerPack<Entity3D>	Controllers;
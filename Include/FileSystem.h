@@ -45,16 +45,23 @@ namespace Glyph3
 		std::wstring GetScriptsFolder();
 		std::wstring GetShaderFolder();
 		std::wstring GetTextureFolder();
+		std::wstring GetCacheFolder();
 
 		void SetDataFolder( const std::wstring& folder );
 		void SetModelsFolder( const std::wstring& folder );
 		void SetScriptsFolder( const std::wstring& folder );
 		void SetShaderFolder( const std::wstring& folder );
 		void SetTextureFolder( const std::wstring& folder );
+		void SetCacheFolder( const std::wstring& folder );
 
 		bool FileExists( const std::wstring& file );
 		bool FileIsNewer( const std::wstring& file1, const std::wstring& file2 );
 
+		// Creates the folder if it doesn't exist yet, i.e. the cache folder
+		// before the first cache file is written.  The parent folder has to exist.
+
+		bool CreateFolder( const std::wstring& folder );
+
 	private:
 
 		static std::wstring sDataFolder;
@@ -62,6 +69,7 @@ namespace Glyph3
 		static std::wstring sScriptsSubFolder;
 		static std::wstring sShaderSubFolder;
 		static std::wstring sTextureSubFolder;
+		static std::wstring sCacheSubFolder;
 	};
 };
 //--------------------------------------------------------------------------------
@@ -0,0 +1,78 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// GeometryCacheDX11
+//
+// The geometry cache stores loaded geometry in a versioned binary file, which
+// holds the interleaved vertex stream, the indices, the input layout and the
+// bounds of the geometry.  Reading the file back only needs a few bulk copies
+// out of a memory mapped view, instead of parsing the source file again and
+// interleaving its vertex elements one vertex at a time.
+//
+// The cache files are keyed by a hash of the contents of the source file, of
+// the loader options and of the version of the loader, so a cached file is
+// never used for a modified source file, with different options or after the
+// output of the loader has changed.  The files are written to the cache folder
+// of the FileSystem.  Reading and writing the cache doesn't need a device.
+//
+// Cached geometry only holds the interleaved vertex stream at first.  The
+// vertex elements are rebuilt from the stream the first time that they are
+// accessed (see GeometryDX11::DeinterleaveVertices), so geometry that is only
+// drawn never pays for them.
+//--------------------------------------------------------------------------------
+#ifndef GeometryCacheDX11_h
+#define GeometryCacheDX11_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "GeometryDX11.h"
+#include <functional>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class GeometryCacheDX11
+	{
+	public:
+		typedef std::function<GeometryPtr()> LoaderFunction;
+
+		// Returns the cached geometry for the source file, loader options and
+		// loader version if there is one, and otherwise runs the loader and
+		// caches its result.  In both cases the geometry holds an interleaved
+		// vertex stream instead of separate vertex elements, and its buffers have
+		// not been created yet.
+
+		static GeometryPtr Load( const std::wstring& filename, const std::string& options, unsigned int version, const LoaderFunction& loader );
+		static unsigned long long GetKey( unsigned long long fileHash, const std::string& options, unsigned int version );
+
+		// Writes and reads a single cache file, which must match the given key.
+
+		static bool Write( const std::wstring& cacheFile, GeometryDX11& geometry, unsigned long long key );
+		static GeometryPtr Read( const std::wstring& cacheFile, unsigned long long key );
+
+		static bool HashFile( const std::wstring& filename, unsigned long long& hash );
+
+		static std::wstring GetCacheFilename( unsigned long long key );
+
+		static void SetEnabled( bool enabled );
+		static bool IsEnabled( );
+
+	private:
+		GeometryCacheDX11();
+
+		static void Serialize( GeometryDX11& geometry, unsigned long long key, std::vector<char>& image );
+		static GeometryPtr Deserialize( const char* pData, size_t size, unsigned long long key );
+		static bool WriteImage( const std::wstring& cacheFile, const std::vector<char>& image );
+
+		static bool sEnabled;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // GeometryCacheDX11_h
+//--------------------------------------------------------------------------------
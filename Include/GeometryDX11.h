@@ -24,11 +24,13 @@
 #include "PointIndices.h"
 #include "PipelineExecutorDX11.h"
 #include "InputAssemblerStateDX11.h"
+#include "Sphere3f.h"
 //--------------------------------------------------------------------------------
 namespace Glyph3
 {
 	class VertexBufferDX11;
 	class IndexBufferDX11;
+	class JobScheduler;
 
 	class GeometryDX11 : public PipelineExecutorDX11
 	{
@@ -67,13 +69,51 @@ namespace Glyph3
 
 		void LoadToBuffers( );
 
+		// The vertices can either be stored as separate elements, or as a single
+		// stream of already interleaved vertices together with the description
+		// of their layout (i.e. when loaded from a mesh cache).  The elements are
+		// used whenever there are any, and the interleaved stream otherwise.
+		// Accessing or adding elements rebuilds the elements from the stream
+		// first, so everything that works on elements works on streams as well.
+		// The stream is released once its elements have been rebuilt.
+
+		void InterleaveVertices( std::vector<char>& vertices );
+		void SetInterleavedVertices( const char* pVertices, int vertexSize, int vertexCount, const std::vector<D3D11_INPUT_ELEMENT_DESC>& layout );
+		bool DeinterleaveVertices( );
+		void GetInputElementDescs( std::vector<D3D11_INPUT_ELEMENT_DESC>& elements );
+
+		// The bounding sphere of the vertex positions, which is either calculated
+		// from the position element or restored from a mesh cache.  It is updated
+		// when the geometry is loaded to its buffers, and entities that opt in can
+		// be culled with it.  Skinned geometry is deformed on the GPU, so it
+		// doesn't report any model bounds.
+
+		void CalculateBounds( );
+		const Sphere3f& GetBounds( );
+		virtual bool GetModelBounds( Sphere3f& bounds );
+
+		// The tangent frames are computed on the threads of the job scheduler,
+		// which defaults to the one of the renderer.  The results don't depend
+		// on the number of threads.
+
         bool ComputeTangentFrame( std::string positionSemantic = VertexElementDX11::PositionSemantic,
                                   std::string normalSemantic = VertexElementDX11::NormalSemantic,
                                   std::string texCoordSemantic = VertexElementDX11::TexCoordSemantic, 
-                                  std::string tangentSemantic = VertexElementDX11::TangentSemantic );
+                                  std::string tangentSemantic = VertexElementDX11::TangentSemantic,
+                                  JobScheduler* pScheduler = nullptr );
 
+	protected:
+		VertexElementDX11* FindElement( const std::string& name );
+
+	public:
 		std::vector<VertexElementDX11*>		m_vElements;
 		std::vector<UINT>					m_vIndices;
+
+		std::vector<char>						m_vVertexStream;
+		std::vector<D3D11_INPUT_ELEMENT_DESC>	m_vStreamLayout;
+		std::vector<std::string>				m_vStreamSemantics;
+
+		Sphere3f m_Bounds;
 		
 		ResourcePtr m_VB;
 		ResourcePtr m_IB;
@@ -26,7 +26,13 @@ namespace Glyph3
 	public:
 		//static GeometryDX11* loadPlyFile( std::wstring filename );
 		//static GeometryDX11* loadMS3DFile( std::wstring filename );		
-		static GeometryPtr loadMS3DFile2( std::wstring filename );		
+
+		// The MS3D loaders weld the identical corners of the triangles into an
+		// indexed triangle list.  Without welding, every corner keeps its own
+		// vertex, as the triangles are stored in the file.  The animated loader
+		// always welds, but keeps corners with different bones apart.
+
+		static GeometryPtr loadMS3DFile2( std::wstring filename, bool weld = true );		
 		static GeometryPtr loadMS3DFileWithAnimationAndWeights( std::wstring filename, SkinnedActor* pActor = 0 );
 		static GeometryPtr loadMS3DFileWithAnimation( std::wstring filename, SkinnedActor* pActor = 0 );	
 		
@@ -34,45 +40,25 @@ namespace Glyph3
 		//static void removeWhiteSpace( std::wstring& s );
 		//static std::wstring getElementName( int usage, int index );
 
-		static GeometryPtr loadStanfordPlyFile( std::wstring filename, bool withAdjacency = false );
+		// Stanford PLY files are read from a memory mapped view of the file, and
+		// can be stored in ASCII or in little or big endian binary format.  The
+		// data variant only decodes the file into the geometry's vertex elements
+		// and indices, without creating the buffers, and doesn't need a device.
 
-	private:
-		GeometryLoaderDX11();
-
-		struct PlyElementPropertyDeclaration
-		{
-			std::string name;
-			bool isList;
-			std::string type;
-			std::string listLengthType;
-		};
+		static GeometryPtr loadStanfordPlyFile( std::wstring filename, bool withAdjacency = false );
+		static GeometryPtr loadStanfordPlyData( std::wstring filename, bool withAdjacency = false );
 
-		struct PlyElementDesc
-		{
-			std::string name;
-			int elementCount;
-			std::vector< PlyElementPropertyDeclaration > dataFormat;
-			std::vector< void** > data;
-		};
+		// The cached variants read the geometry from the GeometryCacheDX11 while
+		// the source file is unchanged, and otherwise load it and add it to the
+		// cache.  Their geometry only has an interleaved vertex stream without
+		// separate vertex elements, so it can't be processed any further (i.e.
+		// with ComputeTangentFrame) before it is loaded to buffers.
 
-		template<typename T>
-		struct PlyDataArray
-		{
-			unsigned int length;
-			T* data;
-		};
+		static GeometryPtr loadMS3DFileCached( std::wstring filename );
+		static GeometryPtr loadStanfordPlyFileCached( std::wstring filename, bool withAdjacency = false );
 
-		static int FindAdjacentIndex( int edgeStart, int edgeEnd, int triV, int* pRaw, int rawLen);
-		static PlyElementDesc ParsePLYElementHeader(std::string headerLine, std::ifstream& input);
-		static PlyElementPropertyDeclaration ParsePLYElementProperty(std::string desc);
-		static PlyElementPropertyDeclaration ParsePLYElementPropertyList(std::string desc);
-		static std::vector<void**> ReadPLYElementData(std::ifstream& input, const PlyElementDesc& desc);
-		static void** ParsePLYElementData(std::string text, const std::vector<PlyElementPropertyDeclaration>& desc);
-		template<typename T> static T* ExtractDataPtr(std::string input);
-		template<typename T> static T ExtractDataVal(std::string input);
-		template<typename T> static PlyDataArray<T>* ExtractDataPtrArray(int length, std::vector<std::string>::iterator iterator);
-		static int FindPlyElementIndex(std::vector<PlyElementDesc> elems, std::string name);
-		static int FindPlyElementPropertyIndex(std::vector<PlyElementPropertyDeclaration> elems, std::string name);
+	private:
+		GeometryLoaderDX11();
 	};
 };
 #endif // GeometryLoaderDX11_h
@@ -0,0 +1,85 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// GeometryOptimizerDX11
+//
+// The geometry optimizer reorders the triangles and vertices of indexed triangle
+// list geometry, so that the GPU has to do less work when rendering it.  There
+// are three passes, which are normally run in this order:
+//
+// 1. The triangles are reordered for the post-transform vertex cache with the
+//    Tipsify algorithm from Sander et al., "Fast Triangle Reordering for Vertex
+//    Locality and Reduced Overdraw".
+// 2. Optionally, the cache optimized triangles are split into clusters which
+//    are sorted so that the outward facing ones are drawn first, which reduces
+//    overdraw without losing much of the cache efficiency.  The threshold gives
+//    the allowed increase of the ACMR of each cluster (i.e. 1.05 allows 5%).
+// 3. The vertices are reordered in the order in which the triangles first use
+//    them, which improves the locality of the vertex fetches.  Every vertex
+//    element (or the interleaved vertex stream) and the indices are remapped.
+//
+// The cache simulator models a FIFO post-transform cache, and reports the
+// average number of transformed vertices per triangle (ACMR) and per vertex
+// (ATVR), so that the effect of the passes can be measured without a GPU.  An
+// ATVR of 1.0 is optimal, while the best achievable ACMR depends on the mesh
+// and is around 0.5 - 0.7 for typical closed meshes.
+//
+// The passes must be run before the buffers are created with LoadToBuffers,
+// and they leave geometry with other primitive types unchanged.
+//--------------------------------------------------------------------------------
+#ifndef GeometryOptimizerDX11_h
+#define GeometryOptimizerDX11_h
+//--------------------------------------------------------------------------------
+#include "GeometryDX11.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	struct VertexCacheStatistics
+	{
+		unsigned int	triangles;
+		unsigned int	vertices;
+		unsigned int	transforms;
+		float			acmr;
+		float			atvr;
+	};
+
+	class GeometryOptimizerDX11
+	{
+	public:
+		// Runs all of the passes on the geometry.  A threshold of zero skips the
+		// overdraw pass.
+
+		static bool Optimize( GeometryPtr pGeometry, unsigned int cacheSize = 16, float overdrawThreshold = 1.05f );
+
+		static bool OptimizeVertexCache( GeometryPtr pGeometry, unsigned int cacheSize = 16 );
+		static bool OptimizeOverdraw( GeometryPtr pGeometry, unsigned int cacheSize = 16, float threshold = 1.05f );
+		static bool OptimizeVertexFetch( GeometryPtr pGeometry );
+
+		static VertexCacheStatistics SimulateVertexCache( GeometryPtr pGeometry, unsigned int cacheSize = 16 );
+
+		// The index based versions of the passes can be used on any triangle
+		// list, independently of a geometry object.  The remap table lists the
+		// new index of each of the old vertices.  They fail without changing the
+		// indices if any of them is not below the vertex count.
+
+		static bool OptimizeVertexCache( std::vector<UINT>& indices, unsigned int vertexCount, unsigned int cacheSize = 16 );
+		static bool OptimizeOverdraw( std::vector<UINT>& indices, const Vector3f* pPositions, unsigned int vertexCount, unsigned int cacheSize = 16, float threshold = 1.05f );
+		static bool GenerateVertexFetchRemap( const std::vector<UINT>& indices, unsigned int vertexCount, std::vector<UINT>& remap );
+
+		static VertexCacheStatistics SimulateVertexCache( const std::vector<UINT>& indices, unsigned int vertexCount, unsigned int cacheSize = 16 );
+
+	private:
+		GeometryOptimizerDX11();
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // GeometryOptimizerDX11_h
+//--------------------------------------------------------------------------------
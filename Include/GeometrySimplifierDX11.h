@@ -0,0 +1,78 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// GeometrySimplifierDX11
+//
+// The geometry simplifier reduces the triangle count of indexed triangle list
+// geometry with quadric error metric edge collapses, as described by Garland
+// and Heckbert in "Surface Simplification Using Quadric Error Metrics".  Each
+// collapse moves one vertex onto a neighbouring vertex, so the simplified
+// geometry only uses a subset of the original vertices.  This means that the
+// normals, texture coordinates and bone weights are never interpolated, and
+// every remaining vertex keeps a valid set of skinning influences.
+//
+// Vertices that share a position but differ in any of their attributes form a
+// seam.  Seam and border vertices are only collapsed along their seam or border
+// (both sides of a seam at once), and vertices with a more complex topology are
+// never moved, so the texture and normal discontinuities stay intact.
+//
+// The error is the distance that the surface has moved, relative to the extent
+// of the mesh (i.e. 0.01 is 1% of the size of the mesh).  Simplification stops
+// when either the target triangle count or the error limit is reached, and the
+// report contains the triangle count and error that were actually achieved.
+// The results only depend on the input geometry, so the same input always
+// produces the same output.
+//--------------------------------------------------------------------------------
+#ifndef GeometrySimplifierDX11_h
+#define GeometrySimplifierDX11_h
+//--------------------------------------------------------------------------------
+#include "GeometryDX11.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	struct SimplificationReport
+	{
+		unsigned int	sourceTriangles;
+		unsigned int	triangles;
+		unsigned int	vertices;
+		float			error;
+	};
+
+	class GeometrySimplifierDX11
+	{
+	public:
+		// Returns a new, simplified copy of the geometry, or nullptr if the
+		// geometry is not an indexed triangle list with a float position.
+
+		static GeometryPtr Simplify( GeometryPtr pGeometry, unsigned int targetTriangles, float maxError = 0.01f, SimplificationReport* pReport = nullptr );
+
+		// Generates a chain of levels of detail, where each level has the given
+		// fraction of the triangles of the previous one.  Every level is
+		// simplified from the source geometry and optimized for the vertex cache.
+		// The chain ends early when a level can't be reduced any further within
+		// the error limit, and the source geometry itself is not included.
+
+		static std::vector<GeometryPtr> GenerateLODChain( GeometryPtr pGeometry, unsigned int levels, float reduction = 0.5f, float maxError = 0.05f, std::vector<SimplificationReport>* pReports = nullptr );
+
+		// The index based version works on any triangle list.  The wedges list
+		// links each vertex to the next vertex at the same position in a circular
+		// list (each vertex links to itself if there are no seams).  The indices
+		// are simplified in place, and the achieved relative error is returned.
+
+		static float Simplify( std::vector<UINT>& indices, const Vector3f* pPositions, const UINT* pWedges, unsigned int vertexCount, unsigned int targetTriangles, float maxError );
+
+	private:
+		GeometrySimplifierDX11();
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // GeometrySimplifierDX11_h
+//--------------------------------------------------------------------------------
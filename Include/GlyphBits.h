@@ -0,0 +1,50 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// GlyphBits
+//
+// Bit scanning helpers, which map to the compiler intrinsics for finding the
+// lowest and highest set bit of a word.  The argument must not be zero.
+//--------------------------------------------------------------------------------
+#ifndef GlyphBits_h
+#define GlyphBits_h
+//--------------------------------------------------------------------------------
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	inline unsigned int GlyphLowestBit( unsigned int bits )
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward( &index, bits );
+		return( index );
+#else
+		return( __builtin_ctz( bits ) );
+#endif
+	}
+
+	inline unsigned int GlyphHighestBit( unsigned int bits )
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse( &index, bits );
+		return( index );
+#else
+		return( 31 - __builtin_clz( bits ) );
+#endif
+	}
+};
+//--------------------------------------------------------------------------------
+#endif // GlyphBits_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,37 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// GlyphHash
+//
+// A fast 64 bit hash for cache keys and checksums, which is shared by the
+// geometry and shader caches and the geometry simplifier.  Hashes can be
+// chained by passing the previous hash as the seed.  The results are the same
+// on every platform, so they can be stored in files.
+//--------------------------------------------------------------------------------
+#ifndef GlyphHash_h
+#define GlyphHash_h
+//--------------------------------------------------------------------------------
+#include <cstddef>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class GlyphHash
+	{
+	public:
+		static unsigned long long HashData( const void* pData, size_t size, unsigned long long seed = 0 );
+
+	private:
+		GlyphHash();
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // GlyphHash_h
+//--------------------------------------------------------------------------------
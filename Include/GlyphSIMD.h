@@ -0,0 +1,43 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// GlyphSIMD
+//
+// Selects the instruction sets that the math library kernels are compiled for.
+// SSE is used on every x86 and x64 target that supports it, and the AVX paths
+// are enabled when the compiler is targeting AVX (i.e. /arch:AVX).  Defining
+// GLYPH_NO_SIMD before this header is included forces the scalar fallbacks,
+// which is useful for comparing the results and timings of the two paths.
+//--------------------------------------------------------------------------------
+#ifndef GlyphSIMD_h
+#define GlyphSIMD_h
+//--------------------------------------------------------------------------------
+#if !defined(GLYPH_NO_SIMD)
+	#if defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 1 ) || defined(__SSE__)
+		#define GLYPH_SIMD_SSE
+		#include <xmmintrin.h>
+	#endif
+	#if defined(GLYPH_SIMD_SSE) && defined(__AVX__)
+		#define GLYPH_SIMD_AVX
+		#include <immintrin.h>
+	#endif
+#endif
+//--------------------------------------------------------------------------------
+// Shuffle helpers, with the lanes listed in memory order rather than in the
+// reversed order used by _MM_SHUFFLE.
+
+#if defined(GLYPH_SIMD_SSE)
+	#define GLYPH_SHUFFLE( a, b, x, y, z, w ) _mm_shuffle_ps( a, b, _MM_SHUFFLE( w, z, y, x ) )
+	#define GLYPH_SWIZZLE( a, x, y, z, w ) GLYPH_SHUFFLE( a, a, x, y, z, w )
+#endif
+//--------------------------------------------------------------------------------
+#endif // GlyphSIMD_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,49 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// IConstantBufferUploader
+//
+// This interface is used by the constant buffers to upload their contents.  The
+// PipelineManagerDX11 implements it by mapping the buffer on its context, while
+// the RecordingConstantBufferUploader records the uploads instead, so that the
+// constant buffer updates can be examined without a device.
+//
+// Each upload replaces the entire contents of the buffer.  The dirty range is
+// the part of the data that has changed since the previous upload, which the
+// implementation may use to limit the amount of data it transfers.
+//
+// The upload generation changes whenever the uploaded contents stop being
+// valid.  A deferred context starts every command list with undefined buffer
+// contents, and executing a command list replaces the contents that the
+// immediate context had uploaded.  The buffers upload their whole contents
+// again after the generation has changed.
+//--------------------------------------------------------------------------------
+#ifndef IConstantBufferUploader_h
+#define IConstantBufferUploader_h
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class ConstantBufferDX11;
+
+	class IConstantBufferUploader
+	{
+	public:
+		virtual ~IConstantBufferUploader() {};
+
+		virtual bool UploadConstantData( ConstantBufferDX11* pBuffer, const char* pData, unsigned int size,
+			unsigned int dirtyOffset, unsigned int dirtySize ) = 0;
+
+		virtual unsigned int GetUploadGeneration() = 0;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // IConstantBufferUploader_h
+//--------------------------------------------------------------------------------
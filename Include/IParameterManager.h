@@ -57,6 +57,7 @@ namespace Glyph3
 		virtual void SetMatrixArrayParameter( RenderParameterDX11* pParameter, int count, Matrix4f* pMatrices ) = 0;
 
 		virtual RenderParameterDX11* GetParameterRef( const std::wstring& name ) = 0;
+		virtual RenderParameterDX11* GetParameterRef( unsigned int ID ) = 0;
 		virtual VectorParameterDX11* GetVectorParameterRef( const std::wstring& name ) = 0;
 		virtual MatrixParameterDX11* GetMatrixParameterRef( const std::wstring& name ) = 0;
 		virtual ShaderResourceParameterDX11* GetShaderResourceParameterRef( const std::wstring& name ) = 0;
@@ -91,6 +92,13 @@ namespace Glyph3
 		virtual void SetViewMatrixParameter( Matrix4f* pMatrix ) = 0;
 		virtual void SetProjMatrixParameter( Matrix4f* pMatrix ) = 0;
 
+		// The concatenated matrices are only calculated when they are needed.
+		// Anything that reads parameter values directly (i.e. constant buffers
+		// checking value IDs) should first give the manager a chance to bring
+		// the parameter up to date.
+
+		virtual void UpdateDerivedParameter( RenderParameterDX11* pParameter ) = 0;
+
 		// Allow the connection of multiple parameter managers for subsets of the 
 		// complete parameter space to be isolated from the other regions if needed.
 		// This can be helpful in distributed processing as seen in multithreaded
@@ -0,0 +1,64 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// IShaderCompiler
+//
+// The shader compiler interface separates the shader cache from the compiler
+// that it uses.  Compilation is split into preprocessing, which expands the
+// includes and macros of a shader file, and compiling the preprocessed source.
+// The cache keys the compiled bytecode on the preprocessed source, so the
+// preprocessing step is all that it needs to detect a modified shader or
+// include file.
+//
+// Both methods are called from several threads at once when shaders are
+// compiled in parallel, so implementations must be thread safe.
+//--------------------------------------------------------------------------------
+#ifndef IShaderCompiler_h
+#define IShaderCompiler_h
+//--------------------------------------------------------------------------------
+#include <string>
+#include <vector>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	struct ShaderMacroDX11
+	{
+		std::string		Name;
+		std::string		Definition;
+	};
+
+	class IShaderCompiler
+	{
+	public:
+		virtual ~IShaderCompiler() {};
+
+		// Expands the includes and macros of the shader file.  The names of all
+		// of the included files are returned in the order in which they were
+		// first opened, including the nested includes.
+
+		virtual bool Preprocess( const std::wstring& filename, const std::vector<ShaderMacroDX11>& defines,
+			std::string& source, std::vector<std::wstring>& includes, std::string& errors ) = 0;
+
+		// Compiles preprocessed source, where the file name is only used in the
+		// error messages.
+
+		virtual bool Compile( const std::string& source, const std::wstring& filename, const std::string& function,
+			const std::string& model, unsigned int flags, std::vector<char>& bytecode, std::string& errors ) = 0;
+
+		// The identifier names the compiler and its version, and is part of the
+		// cache key so that an updated compiler doesn't use stale bytecode.
+
+		virtual std::string GetIdentifier() = 0;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // IShaderCompiler_h
+//--------------------------------------------------------------------------------
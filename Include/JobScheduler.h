@@ -0,0 +1,144 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// JobScheduler
+//
+// The job scheduler runs small units of work on a pool of worker threads that
+// is sized to the hardware at runtime.  Each participating thread owns a queue
+// of jobs - it pushes and pops jobs at the back of its own queue, and when that
+// runs dry it steals from the front of the other threads' queues.  This keeps
+// all of the threads busy when the jobs have uneven costs, instead of waiting
+// for the slowest job of a fixed batch.
+//
+// The thread that initializes the scheduler is a participant as well, with a
+// worker index of zero, and the pool threads use the indices 1 to N-1.  Every
+// job receives the index of the thread that executes it, which can be used to
+// select per-thread resources such as deferred contexts.  Jobs can submit and
+// wait for their own sub-jobs, but they must pass along the worker index that
+// they were given since it identifies the queue of the calling thread.
+//
+// Waiting on a counter doesn't block the calling thread - it continues to
+// execute the queued jobs of that counter until all of them are done.  Only
+// the counter's own jobs are picked up while waiting, so a job that holds some
+// per-thread resources is never re-entered by an unrelated job on its thread.
+//
+// The scheduler only depends on the standard library, so it can also be used
+// without a rendering device (i.e. to measure the scheduling overhead).
+//--------------------------------------------------------------------------------
+#ifndef JobScheduler_h
+#define JobScheduler_h
+//--------------------------------------------------------------------------------
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	typedef std::function<void( unsigned int worker )> JobFunction;
+	typedef std::function<void( unsigned int begin, unsigned int end, unsigned int worker )> JobRangeFunction;
+
+	// A job counter tracks the number of unfinished jobs that were submitted
+	// with it.  Counters can't be copied, since the jobs keep a pointer to them.
+
+	class JobCounter
+	{
+	public:
+		JobCounter();
+
+		bool IsComplete() const;
+
+	private:
+		JobCounter( const JobCounter& );
+		JobCounter& operator=( const JobCounter& );
+
+		std::atomic<unsigned int> m_uiPending;
+
+		friend class JobScheduler;
+	};
+
+	class JobScheduler
+	{
+	public:
+		JobScheduler();
+		~JobScheduler();
+
+		// Starts the worker threads.  A thread count of zero uses one thread for
+		// each hardware thread, including the calling thread.
+
+		void Initialize( unsigned int threads = 0 );
+		void Shutdown();
+
+		// The number of threads that execute jobs, including the calling thread.
+
+		unsigned int GetThreadCount() const;
+
+		static unsigned int GetHardwareThreadCount();
+
+		// Returns the worker index of the calling thread.  Threads that aren't
+		// part of the pool are treated as the initializing thread.
+
+		unsigned int GetWorkerIndex() const;
+
+		// Queues a job for execution, from the thread with the given index.
+
+		void Submit( const JobFunction& job, JobCounter& counter, unsigned int worker = 0 );
+
+		// Executes the counter's jobs until all of them are done.
+
+		void Wait( JobCounter& counter, unsigned int worker = 0 );
+
+		// Splits the range [0, count) into jobs of at most 'grain' elements, runs
+		// them in parallel and waits for all of them to finish.
+
+		void ParallelFor( unsigned int count, unsigned int grain, const JobRangeFunction& function, unsigned int worker = 0 );
+
+	protected:
+
+		struct Job
+		{
+			JobFunction		Function;
+			JobCounter*		pCounter;
+		};
+
+		struct WorkerQueue
+		{
+			std::mutex			Lock;
+			std::deque<Job>		Jobs;
+		};
+
+		// When a counter is given, only the jobs that belong to it are taken.
+
+		bool Pop( unsigned int worker, Job& job, JobCounter* pCounter );
+		bool Steal( unsigned int worker, Job& job, JobCounter* pCounter );
+		bool Acquire( unsigned int worker, Job& job, JobCounter* pCounter = nullptr );
+		void Execute( Job& job, unsigned int worker );
+
+		void WorkerThreadProc( unsigned int worker );
+
+		std::vector<std::unique_ptr<WorkerQueue>>	m_Queues;
+		std::vector<std::thread>					m_Threads;
+
+		// Idle workers sleep on the condition variable until new jobs arrive.
+
+		std::mutex						m_SleepLock;
+		std::condition_variable			m_WakeCondition;
+		std::atomic<unsigned int>		m_uiQueuedJobs;
+		bool							m_bRunning;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // JobScheduler_h
+//--------------------------------------------------------------------------------
@@ -47,9 +47,17 @@ namespace Glyph3
 		// to be used with them.
 		void GetAllVertexShaderIDs( std::vector<int>& idlist );
 
+		// Each material receives a unique ID when it is created, which is used to
+		// group the draws that share a material when sorting the render queue.
+		unsigned int GetMaterialID() const;
+
 	public:
 		MaterialParams				Params[VT_NUM_VIEW_TYPES];
 		ParameterContainer			Parameters;
+
+	protected:
+		unsigned int				m_uiMaterialID;
+		static unsigned int			s_uiNextMaterialID;
 	};
 	typedef std::shared_ptr<MaterialDX11> MaterialPtr;
 };
@@ -18,6 +18,7 @@
 //----------------------------------------------------------------------------------------------------
 #include "Matrix3f.h"
 #include "Vector4f.h"
+#include "GlyphSIMD.h"
 //----------------------------------------------------------------------------------------------------
 
 //----------------------------------------------------------------------------------------------------
@@ -109,6 +110,19 @@ namespace Glyph3
 		// matrix - vector operations
 		Vector4f operator* ( const Vector4f& V ) const;  // M * v
 
+		// Out = A * B, where Out may be the same matrix as A or B.  This is the
+		// kernel behind the multiplication operators, and allows callers to
+		// write the product directly into its destination.
+		static void Multiply( const Matrix4f& A, const Matrix4f& B, Matrix4f& Out );
+
+		// The scalar versions of the kernels above.  They are what the kernels
+		// run when GLYPH_NO_SIMD is defined, and are always available so that the
+		// SIMD results can be checked against them.
+		static void MultiplyScalar( const Matrix4f& A, const Matrix4f& B, Matrix4f& Out );
+		static Vector4f TransformScalar( const Matrix4f& M, const Vector4f& V );
+		void MakeTransposeScalar( );
+		Matrix4f InverseScalar( ) const;
+
 		static const int m11 = 0;
 		static const int m12 = 1;
 		static const int m13 = 2;
@@ -135,6 +149,8 @@ namespace Glyph3
 
 		static int I(int iRow, int iCol); // iRow*N + iCol
 	};
+
+	#include "Matrix4f.inl"
 };
 //----------------------------------------------------------------------------------------------------
 #endif // Matrix4f_h
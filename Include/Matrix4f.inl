@@ -0,0 +1,354 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+inline Matrix4f::Matrix4f()
+{
+}
+//----------------------------------------------------------------------------------------------------
+inline Matrix4f::Matrix4f( const Matrix4f& Matrix )
+{
+    memcpy( m_afEntry, (void*)&Matrix, 16*sizeof(float) );
+}
+//----------------------------------------------------------------------------------------------------
+inline Matrix4f& Matrix4f::operator= ( const Matrix4f& Matrix )
+{
+    memcpy( m_afEntry, Matrix.m_afEntry, 16*sizeof(float) );
+    return( *this );
+}
+//----------------------------------------------------------------------------------------------------
+inline float Matrix4f::operator[] ( int iPos ) const
+{
+    return( m_afEntry[iPos] );
+}
+//----------------------------------------------------------------------------------------------------
+inline float& Matrix4f::operator[] ( int iPos )
+{
+    return( m_afEntry[iPos] );
+}
+//----------------------------------------------------------------------------------------------------
+inline float Matrix4f::operator() ( int iRow, int iCol ) const
+{
+    return( m_afEntry[I(iRow,iCol)] );
+}
+//----------------------------------------------------------------------------------------------------
+inline float& Matrix4f::operator() ( int iRow, int iCol )
+{
+    return( m_afEntry[I(iRow,iCol)] );
+}
+//----------------------------------------------------------------------------------------------------
+inline bool Matrix4f::operator== ( const Matrix4f& Matrix ) const
+{
+    return( memcmp( m_afEntry, Matrix.m_afEntry, 4*4*sizeof(float) ) == 0 );
+}
+//----------------------------------------------------------------------------------------------------
+inline bool Matrix4f::operator!= ( const Matrix4f& Matrix ) const
+{
+    return( memcmp( m_afEntry, Matrix.m_afEntry, 4*4*sizeof(float) ) != 0 );
+}
+//----------------------------------------------------------------------------------------------------
+inline int Matrix4f::I( int iRow, int iCol )
+{
+    return( 4*iRow + iCol );
+}
+//----------------------------------------------------------------------------------------------------
+inline void Matrix4f::Multiply( const Matrix4f& A, const Matrix4f& B, Matrix4f& Out )
+{
+	// Each row of the product is a linear combination of the rows of B,
+	// weighted by the elements of the corresponding row of A.  All of B is
+	// loaded before anything is written, and each row of A is consumed before
+	// the matching row of the output is stored, so Out may alias A or B.
+
+#if defined(GLYPH_SIMD_SSE)
+	const float* a = A.m_afEntry;
+	const float* b = B.m_afEntry;
+	float* out = Out.m_afEntry;
+#endif
+
+#if defined(GLYPH_SIMD_AVX)
+	// With AVX two result rows are produced at once, with the rows of B
+	// duplicated into both 128-bit lanes.
+	__m256 b01 = _mm256_loadu_ps( b );
+	__m256 b23 = _mm256_loadu_ps( b + 8 );
+	__m256 b0 = _mm256_permute2f128_ps( b01, b01, 0x00 );
+	__m256 b1 = _mm256_permute2f128_ps( b01, b01, 0x11 );
+	__m256 b2 = _mm256_permute2f128_ps( b23, b23, 0x00 );
+	__m256 b3 = _mm256_permute2f128_ps( b23, b23, 0x11 );
+
+	for ( int i = 0; i < 16; i += 8 )
+	{
+		__m256 r = _mm256_loadu_ps( a + i );
+		__m256 p = _mm256_mul_ps( _mm256_shuffle_ps( r, r, 0x00 ), b0 );
+		p = _mm256_add_ps( p, _mm256_mul_ps( _mm256_shuffle_ps( r, r, 0x55 ), b1 ) );
+		p = _mm256_add_ps( p, _mm256_mul_ps( _mm256_shuffle_ps( r, r, 0xAA ), b2 ) );
+		p = _mm256_add_ps( p, _mm256_mul_ps( _mm256_shuffle_ps( r, r, 0xFF ), b3 ) );
+		_mm256_storeu_ps( out + i, p );
+	}
+#elif defined(GLYPH_SIMD_SSE)
+	__m128 b0 = _mm_loadu_ps( b );
+	__m128 b1 = _mm_loadu_ps( b + 4 );
+	__m128 b2 = _mm_loadu_ps( b + 8 );
+	__m128 b3 = _mm_loadu_ps( b + 12 );
+
+	for ( int i = 0; i < 16; i += 4 )
+	{
+		__m128 r = _mm_loadu_ps( a + i );
+		__m128 p = _mm_mul_ps( GLYPH_SWIZZLE( r, 0, 0, 0, 0 ), b0 );
+		p = _mm_add_ps( p, _mm_mul_ps( GLYPH_SWIZZLE( r, 1, 1, 1, 1 ), b1 ) );
+		p = _mm_add_ps( p, _mm_mul_ps( GLYPH_SWIZZLE( r, 2, 2, 2, 2 ), b2 ) );
+		p = _mm_add_ps( p, _mm_mul_ps( GLYPH_SWIZZLE( r, 3, 3, 3, 3 ), b3 ) );
+		_mm_storeu_ps( out + i, p );
+	}
+#else
+	MultiplyScalar( A, B, Out );
+#endif
+}
+//----------------------------------------------------------------------------------------------------
+inline Matrix4f Matrix4f::operator* ( const Matrix4f& Matrix ) const
+{
+	Matrix4f mProd;
+	Multiply( *this, Matrix, mProd );
+	return( mProd );
+}
+//----------------------------------------------------------------------------------------------------
+inline Matrix4f& Matrix4f::operator*= ( const Matrix4f& Matrix )
+{
+	Multiply( *this, Matrix, *this );
+	return( *this );
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector4f Matrix4f::operator* ( const Vector4f& Vector ) const
+{
+	Vector4f vProd;
+
+#if defined(GLYPH_SIMD_SSE)
+	// The vector is treated as a row vector, so the result is a linear
+	// combination of the matrix rows weighted by the vector components.
+	__m128 p = _mm_mul_ps( _mm_set1_ps( Vector.x ), _mm_loadu_ps( m_afEntry ) );
+	p = _mm_add_ps( p, _mm_mul_ps( _mm_set1_ps( Vector.y ), _mm_loadu_ps( m_afEntry + 4 ) ) );
+	p = _mm_add_ps( p, _mm_mul_ps( _mm_set1_ps( Vector.z ), _mm_loadu_ps( m_afEntry + 8 ) ) );
+	p = _mm_add_ps( p, _mm_mul_ps( _mm_set1_ps( Vector.w ), _mm_loadu_ps( m_afEntry + 12 ) ) );
+	_mm_storeu_ps( &vProd.x, p );
+#else
+	vProd = TransformScalar( *this, Vector );
+#endif
+
+	return( vProd );
+}
+//----------------------------------------------------------------------------------------------------
+inline Matrix4f Matrix4f::Transpose()
+{
+	Matrix4f mTranspose = *this;
+	mTranspose.MakeTranspose();
+	return( mTranspose );
+}
+//----------------------------------------------------------------------------------------------------
+inline void Matrix4f::MakeTranspose()
+{
+#if defined(GLYPH_SIMD_SSE)
+	__m128 r0 = _mm_loadu_ps( m_afEntry );
+	__m128 r1 = _mm_loadu_ps( m_afEntry + 4 );
+	__m128 r2 = _mm_loadu_ps( m_afEntry + 8 );
+	__m128 r3 = _mm_loadu_ps( m_afEntry + 12 );
+
+	_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+
+	_mm_storeu_ps( m_afEntry, r0 );
+	_mm_storeu_ps( m_afEntry + 4, r1 );
+	_mm_storeu_ps( m_afEntry + 8, r2 );
+	_mm_storeu_ps( m_afEntry + 12, r3 );
+#else
+	MakeTransposeScalar();
+#endif
+}
+//----------------------------------------------------------------------------------------------------
+inline Matrix4f Matrix4f::Inverse() const
+{
+#if defined(GLYPH_SIMD_SSE)
+	// The matrix is inverted block wise, treating it as four 2x2 sub-matrices
+	//
+	//     | A B |
+	//     | C D |
+	//
+	// with each sub-matrix held in one register as (m00, m01, m10, m11).  The
+	// inverse is assembled from the adjugates (written as X#) of the blocks.
+
+	auto Mat2Mul = []( const __m128& a, const __m128& b ) -> __m128
+	{
+		// a * b
+		return( _mm_add_ps( _mm_mul_ps( a, GLYPH_SWIZZLE( b, 0, 3, 0, 3 ) ),
+			_mm_mul_ps( GLYPH_SWIZZLE( a, 1, 0, 3, 2 ), GLYPH_SWIZZLE( b, 2, 1, 2, 1 ) ) ) );
+	};
+
+	auto Mat2AdjMul = []( const __m128& a, const __m128& b ) -> __m128
+	{
+		// a# * b
+		return( _mm_sub_ps( _mm_mul_ps( GLYPH_SWIZZLE( a, 3, 3, 0, 0 ), b ),
+			_mm_mul_ps( GLYPH_SWIZZLE( a, 1, 1, 2, 2 ), GLYPH_SWIZZLE( b, 2, 3, 0, 1 ) ) ) );
+	};
+
+	auto Mat2MulAdj = []( const __m128& a, const __m128& b ) -> __m128
+	{
+		// a * b#
+		return( _mm_sub_ps( _mm_mul_ps( a, GLYPH_SWIZZLE( b, 3, 0, 3, 0 ) ),
+			_mm_mul_ps( GLYPH_SWIZZLE( a, 1, 0, 3, 2 ), GLYPH_SWIZZLE( b, 2, 1, 2, 1 ) ) ) );
+	};
+
+	__m128 r0 = _mm_loadu_ps( m_afEntry );
+	__m128 r1 = _mm_loadu_ps( m_afEntry + 4 );
+	__m128 r2 = _mm_loadu_ps( m_afEntry + 8 );
+	__m128 r3 = _mm_loadu_ps( m_afEntry + 12 );
+
+	__m128 A = _mm_movelh_ps( r0, r1 );
+	__m128 B = _mm_movehl_ps( r1, r0 );
+	__m128 C = _mm_movelh_ps( r2, r3 );
+	__m128 D = _mm_movehl_ps( r3, r2 );
+
+	// The determinants of the four blocks, as ( |A|, |B|, |C|, |D| ).
+	__m128 fDetSub = _mm_sub_ps(
+		_mm_mul_ps( GLYPH_SHUFFLE( r0, r2, 0, 2, 0, 2 ), GLYPH_SHUFFLE( r1, r3, 1, 3, 1, 3 ) ),
+		_mm_mul_ps( GLYPH_SHUFFLE( r0, r2, 1, 3, 1, 3 ), GLYPH_SHUFFLE( r1, r3, 0, 2, 0, 2 ) ) );
+	__m128 fDetA = GLYPH_SWIZZLE( fDetSub, 0, 0, 0, 0 );
+	__m128 fDetB = GLYPH_SWIZZLE( fDetSub, 1, 1, 1, 1 );
+	__m128 fDetC = GLYPH_SWIZZLE( fDetSub, 2, 2, 2, 2 );
+	__m128 fDetD = GLYPH_SWIZZLE( fDetSub, 3, 3, 3, 3 );
+
+	__m128 D_C = Mat2AdjMul( D, C );
+	__m128 A_B = Mat2AdjMul( A, B );
+
+	// The adjugates of the blocks of the inverse, which is 1/|M| * | X Y |
+	//                                                               | Z W |
+	__m128 X_ = _mm_sub_ps( _mm_mul_ps( fDetD, A ), Mat2Mul( B, D_C ) );
+	__m128 W_ = _mm_sub_ps( _mm_mul_ps( fDetA, D ), Mat2Mul( C, A_B ) );
+	__m128 Y_ = _mm_sub_ps( _mm_mul_ps( fDetB, C ), Mat2MulAdj( D, A_B ) );
+	__m128 Z_ = _mm_sub_ps( _mm_mul_ps( fDetC, B ), Mat2MulAdj( A, D_C ) );
+
+	// |M| = |A|*|D| + |B|*|C| - tr( (A#B)(D#C) )
+	__m128 fTrace = _mm_mul_ps( A_B, GLYPH_SWIZZLE( D_C, 0, 2, 1, 3 ) );
+	fTrace = _mm_add_ps( fTrace, GLYPH_SWIZZLE( fTrace, 2, 3, 0, 1 ) );
+	fTrace = _mm_add_ps( fTrace, GLYPH_SWIZZLE( fTrace, 1, 0, 3, 2 ) );
+
+	__m128 fDet = _mm_add_ps( _mm_mul_ps( fDetA, fDetD ), _mm_mul_ps( fDetB, fDetC ) );
+	fDet = _mm_sub_ps( fDet, fTrace );
+
+	// The sign pattern of the adjugate is folded into the reciprocal.
+	__m128 fInvDet = _mm_div_ps( _mm_setr_ps( 1.0f, -1.0f, -1.0f, 1.0f ), fDet );
+
+	X_ = _mm_mul_ps( X_, fInvDet );
+	Y_ = _mm_mul_ps( Y_, fInvDet );
+	Z_ = _mm_mul_ps( Z_, fInvDet );
+	W_ = _mm_mul_ps( W_, fInvDet );
+
+	Matrix4f kInv;
+	_mm_storeu_ps( kInv.m_afEntry,      GLYPH_SHUFFLE( X_, Y_, 3, 1, 3, 1 ) );
+	_mm_storeu_ps( kInv.m_afEntry + 4,  GLYPH_SHUFFLE( X_, Y_, 2, 0, 2, 0 ) );
+	_mm_storeu_ps( kInv.m_afEntry + 8,  GLYPH_SHUFFLE( Z_, W_, 3, 1, 3, 1 ) );
+	_mm_storeu_ps( kInv.m_afEntry + 12, GLYPH_SHUFFLE( Z_, W_, 2, 0, 2, 0 ) );
+
+	return( kInv );
+#else
+	return( InverseScalar() );
+#endif
+}
+//----------------------------------------------------------------------------------------------------
+inline void Matrix4f::MultiplyScalar( const Matrix4f& A, const Matrix4f& B, Matrix4f& Out )
+{
+	float afProd[4*4];
+
+	for ( int iRow = 0; iRow < 4; iRow++ )
+	{
+		for ( int iCol = 0; iCol < 4; iCol++ )
+		{
+			int i = I(iRow, iCol);
+			afProd[i] = 0.0f;
+			for ( int iMid = 0; iMid < 4; iMid++ )
+			{
+				afProd[i] += A.m_afEntry[I(iRow, iMid)] * B.m_afEntry[I(iMid, iCol)];
+			}
+		}
+	}
+
+	memcpy( Out.m_afEntry, afProd, 4*4*sizeof(float) );
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector4f Matrix4f::TransformScalar( const Matrix4f& M, const Vector4f& Vector )
+{
+	Vector4f vProd;
+
+	for ( int iCol = 0; iCol < 4; iCol++ )
+	{
+		vProd[iCol] = 0.0f;
+		for ( int iRow = 0; iRow < 4; iRow++ )
+			vProd[iCol] += M.m_afEntry[I(iRow,iCol)] * Vector[iRow];
+	}
+
+	return( vProd );
+}
+//----------------------------------------------------------------------------------------------------
+inline void Matrix4f::MakeTransposeScalar()
+{
+	Matrix4f mTranspose;
+
+	for ( int iRow = 0; iRow < 4; iRow++ )
+	{
+		for ( int iCol = 0; iCol < 4; iCol++ )
+			mTranspose.m_afEntry[I(iRow,iCol)] = m_afEntry[I(iCol,iRow)];
+	}
+    
+	memcpy( m_afEntry, mTranspose.m_afEntry, 4*4*sizeof(float) );
+}
+//----------------------------------------------------------------------------------------------------
+inline Matrix4f Matrix4f::InverseScalar() const
+{
+    float fA0 = m_afEntry[ 0]*m_afEntry[ 5] - m_afEntry[ 1]*m_afEntry[ 4];
+    float fA1 = m_afEntry[ 0]*m_afEntry[ 6] - m_afEntry[ 2]*m_afEntry[ 4];
+    float fA2 = m_afEntry[ 0]*m_afEntry[ 7] - m_afEntry[ 3]*m_afEntry[ 4];
+    float fA3 = m_afEntry[ 1]*m_afEntry[ 6] - m_afEntry[ 2]*m_afEntry[ 5];
+    float fA4 = m_afEntry[ 1]*m_afEntry[ 7] - m_afEntry[ 3]*m_afEntry[ 5];
+    float fA5 = m_afEntry[ 2]*m_afEntry[ 7] - m_afEntry[ 3]*m_afEntry[ 6];
+    float fB0 = m_afEntry[ 8]*m_afEntry[13] - m_afEntry[ 9]*m_afEntry[12];
+    float fB1 = m_afEntry[ 8]*m_afEntry[14] - m_afEntry[10]*m_afEntry[12];
+    float fB2 = m_afEntry[ 8]*m_afEntry[15] - m_afEntry[11]*m_afEntry[12];
+    float fB3 = m_afEntry[ 9]*m_afEntry[14] - m_afEntry[10]*m_afEntry[13];
+    float fB4 = m_afEntry[ 9]*m_afEntry[15] - m_afEntry[11]*m_afEntry[13];
+    float fB5 = m_afEntry[10]*m_afEntry[15] - m_afEntry[11]*m_afEntry[14];
+
+    float fDet = fA0*fB5 - fA1*fB4 + fA2*fB3 + fA3*fB2 - fA4*fB1 + fA5*fB0;
+    //if ( Math<Real>::FAbs(fDet) <= Math<Real>::EPSILON )
+    //    return Matrix4::ZERO;
+
+    Matrix4f kInv;
+    kInv(0,0) = + m_afEntry[ 5]*fB5 - m_afEntry[ 6]*fB4 + m_afEntry[ 7]*fB3;
+    kInv(1,0) = - m_afEntry[ 4]*fB5 + m_afEntry[ 6]*fB2 - m_afEntry[ 7]*fB1;
+    kInv(2,0) = + m_afEntry[ 4]*fB4 - m_afEntry[ 5]*fB2 + m_afEntry[ 7]*fB0;
+    kInv(3,0) = - m_afEntry[ 4]*fB3 + m_afEntry[ 5]*fB1 - m_afEntry[ 6]*fB0;
+    kInv(0,1) = - m_afEntry[ 1]*fB5 + m_afEntry[ 2]*fB4 - m_afEntry[ 3]*fB3;
+    kInv(1,1) = + m_afEntry[ 0]*fB5 - m_afEntry[ 2]*fB2 + m_afEntry[ 3]*fB1;
+    kInv(2,1) = - m_afEntry[ 0]*fB4 + m_afEntry[ 1]*fB2 - m_afEntry[ 3]*fB0;
+    kInv(3,1) = + m_afEntry[ 0]*fB3 - m_afEntry[ 1]*fB1 + m_afEntry[ 2]*fB0;
+    kInv(0,2) = + m_afEntry[13]*fA5 - m_afEntry[14]*fA4 + m_afEntry[15]*fA3;
+    kInv(1,2) = - m_afEntry[12]*fA5 + m_afEntry[14]*fA2 - m_afEntry[15]*fA1;
+    kInv(2,2) = + m_afEntry[12]*fA4 - m_afEntry[13]*fA2 + m_afEntry[15]*fA0;
+    kInv(3,2) = - m_afEntry[12]*fA3 + m_afEntry[13]*fA1 - m_afEntry[14]*fA0;
+    kInv(0,3) = - m_afEntry[ 9]*fA5 + m_afEntry[10]*fA4 - m_afEntry[11]*fA3;
+    kInv(1,3) = + m_afEntry[ 8]*fA5 - m_afEntry[10]*fA2 + m_afEntry[11]*fA1;
+    kInv(2,3) = - m_afEntry[ 8]*fA4 + m_afEntry[ 9]*fA2 - m_afEntry[11]*fA0;
+    kInv(3,3) = + m_afEntry[ 8]*fA3 - m_afEntry[ 9]*fA1 + m_afEntry[10]*fA0;
+
+    float fInvDet = ((float)1.0)/fDet;
+    for (int iRow = 0; iRow < 4; iRow++)
+    {
+        for (int iCol = 0; iCol < 4; iCol++)
+            kInv(iRow,iCol) *= fInvDet;
+    }
+
+    return( kInv );
+}
+//----------------------------------------------------------------------------------------------------
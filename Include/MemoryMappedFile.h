@@ -0,0 +1,56 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// MemoryMappedFile
+//
+// The MemoryMappedFile class provides read only access to the contents of a file
+// by mapping it into the address space of the process, instead of reading it
+// into an allocated buffer like the FileLoader does.  The operating system pages
+// the data in as it is accessed, so large files can be parsed directly from the
+// mapped view without an extra copy.
+//
+// The mapped data is not null terminated, so parsers must always check against
+// the size of the data.  Like the FileLoader, an instance is intended to be
+// declared on the stack, and the file is unmapped when it goes out of scope.
+//--------------------------------------------------------------------------------
+#ifndef MemoryMappedFile_h
+#define MemoryMappedFile_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class MemoryMappedFile
+	{
+	public:
+		MemoryMappedFile();
+		~MemoryMappedFile();
+
+		bool Open( const std::wstring& filename );
+		bool Close( );
+
+		const char* GetDataPtr() const;
+		size_t GetDataSize() const;
+
+	protected:
+		HANDLE			m_hFile;
+		HANDLE			m_hMapping;
+		const char*		m_pData;
+		size_t			m_uiSize;
+
+	private:
+		MemoryMappedFile( const MemoryMappedFile& );
+		MemoryMappedFile& operator=( const MemoryMappedFile& );
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // MemoryMappedFile_h
+//--------------------------------------------------------------------------------
@@ -19,6 +19,15 @@
 // information about OBJ and MTL files on their wikipedia pages:
 // http://en.wikipedia.org/wiki/Wavefront_.obj_file
 // http://paulbourke.net/dataformats/obj/.
+//
+// The file is memory mapped and scanned in place, without copying the lines or
+// tokens into strings.  When a job scheduler is provided, the file is split into
+// line aligned chunks which are parsed in parallel, and the chunks are then
+// merged in file order.  The position/texture/normal index triples of the faces
+// are welded into a single set of vertices, so that the positions, normals and
+// coords arrays all have one entry per unique vertex.  The faces then refer to
+// a range of the indices array, which index into these vertex arrays.  Vertex
+// components that are not given in the file are set to zero.
 //--------------------------------------------------------------------------------
 
 
@@ -34,18 +43,19 @@
 #include "Vector2f.h"
 #include "Vector3f.h"
 //--------------------------------------------------------------------------------
+namespace Glyph3 { class JobScheduler; }
+//--------------------------------------------------------------------------------
 namespace Glyph3 { namespace OBJ {
 //--------------------------------------------------------------------------------
 class MeshOBJ
 {
 public:
-	MeshOBJ(const std::wstring& filename);
+	MeshOBJ(const std::wstring& filename, JobScheduler* pScheduler = nullptr);
 
 	typedef struct
 	{
-		std::vector<int> positionIndices;
-		std::vector<int> normalIndices;
-		std::vector<int> coordIndices;
+		unsigned int start;
+		unsigned int count;
 	} face_t;
 
 	typedef struct
@@ -62,6 +72,7 @@ public:
 	std::vector<Vector3f> positions;
 	std::vector<Vector3f> normals;
 	std::vector<Vector2f> coords;
+	std::vector<unsigned int> indices;
 	std::vector<object_t> objects;
 	std::vector<std::string> material_libs;
 };
@@ -43,6 +43,9 @@ namespace Glyph3
 		void UpdateLocal( float time );
 		void UpdateWorld( );
 
+		// Indicates if any transform in this subtree changed during the last update.
+		bool SubtreeChanged( ) const;
+
 		void AttachChild( Entity3D* Child );
 		void AttachChild( Node3D* Child );
 		void DetachChild( Entity3D* Child );
@@ -61,6 +64,15 @@ namespace Glyph3
 		const std::vector<Entity3D*>& Leafs();
 		const std::vector<Node3D*>& Nodes();
 
+		// The world bounds of a node enclose the world bounds of its complete 
+		// subtree, and are refreshed after the children have been updated.  If any
+		// entity below the node is unbounded, then the node is unbounded too.
+
+		void UpdateWorldBounds( );
+		const Sphere3f& GetWorldBounds() const;
+		bool IsBounded() const;
+		bool IsEmpty() const;
+
 		Transform3D Transform;
 		ControllerPack<Node3D> Controllers;
 	
@@ -71,6 +83,11 @@ namespace Glyph3
 		std::vector< Node3D* > m_Nodes;
 
 		Node3D* m_pParent;
+
+		Sphere3f m_WorldBounds;
+		bool m_bBounded;
+		bool m_bEmpty;
+		bool m_bSubtreeChanged;
 	};
 };
 //--------------------------------------------------------------------------------
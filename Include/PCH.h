@@ -25,6 +25,7 @@
 #include <fstream>
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <list>
 #include <sstream>
 #include <algorithm>
@@ -49,8 +50,11 @@
 #define SAFE_DELETE( x ) {if(x){delete (x);(x)=NULL;}}
 #define SAFE_DELETE_ARRAY( x ) {if(x){delete[] (x);(x)=NULL;}}
 
-// Define the number of threads to use for 
-#define NUM_THREADS 4
+// Define the maximum number of threads that can record tasks at the same time.
+// Each one uses its own slot in the render parameters, in addition to the main
+// thread's slot.  The number of worker threads is chosen at runtime to match
+// the hardware, up to this limit.
+#define NUM_THREADS 8
 
 #define GLYPH_PI 3.14159265f
 
@@ -42,6 +42,7 @@ namespace Glyph3
 		//       new writer instead of returning nullptr, as there is no alternative - 
 		//       you have no choice but to create a new writer.
 		ParameterWriter* GetRenderParameter( const std::wstring& name );
+		ParameterWriter* GetRenderParameter( unsigned int ID );
 		ConstantBufferParameterWriterDX11* GetConstantBufferParameterWriter( const std::wstring& name );
 		MatrixArrayParameterWriterDX11* GetMatrixArrayParameterWriter( const std::wstring& name );
 		MatrixParameterWriterDX11* GetMatrixParameterWriter( const std::wstring& name );
@@ -93,11 +93,19 @@ namespace Glyph3
 		void SetViewMatrixParameter( Matrix4f* pMatrix );
 		void SetProjMatrixParameter( Matrix4f* pMatrix );
 
-		// All rendering parameters are stored in a map and are accessed by name.  This may
-		// be modified to allow faster random access in the future, possibly using a hash 
-		// table to reference an array.
+		// The concatenated matrices are not calculated when their inputs are set.
+		// Instead they are calculated here, on demand, when a parameter that is
+		// actually referenced (i.e. by a constant buffer) is one of them.
 
-		static std::map< std::wstring, RenderParameterDX11* >	m_Parameters;
+		void UpdateDerivedParameter( RenderParameterDX11* pParameter );
+
+		// Each parameter name is interned to a dense integer ID when the parameter is
+		// first registered.  Looking up a name costs one hash, and the resulting ID
+		// (also available from RenderParameterDX11::GetParameterID) gives direct
+		// access to the parameter without any further searching.
+
+		unsigned int GetParameterID( const std::wstring& name );
+		virtual RenderParameterDX11* GetParameterRef( unsigned int ID );
 
 		void AttachParent( IParameterManager* pParent );
 		void DetachParent( );
@@ -109,6 +117,15 @@ namespace Glyph3
 
 	protected:
 
+		// All rendering parameters are stored in a flat array indexed by their ID,
+		// with a hash table mapping the names to the IDs.
+
+		static std::unordered_map< std::wstring, unsigned int >	m_ParameterIDs;
+		static std::vector< RenderParameterDX11* >				m_Parameters;
+
+		RenderParameterDX11* FindParameter( const std::wstring& name );
+		void RegisterParameter( RenderParameterDX11* pParameter );
+
 		IParameterManager*	m_pParent;
 		unsigned int m_ID;
 
@@ -119,6 +136,26 @@ namespace Glyph3
 		MatrixParameterDX11* m_pWorldProjMatrix;
 		MatrixParameterDX11* m_pViewProjMatrix;
 		MatrixParameterDX11* m_pWorldViewProjMatrix;
+
+		// Each concatenated matrix is the product of two other matrix parameters,
+		// and remembers the value IDs of its inputs from the last time it was
+		// calculated.  It is only recalculated when one of those IDs changes.
+
+		struct DerivedMatrix
+		{
+			MatrixParameterDX11* pMatrix;
+			MatrixParameterDX11* pLeft;
+			MatrixParameterDX11* pRight;
+			unsigned int uiLeftID;
+			unsigned int uiRightID;
+		};
+
+		static const int DERIVED_MATRIX_COUNT = 4;
+		DerivedMatrix m_DerivedMatrices[DERIVED_MATRIX_COUNT];
+
+		void InitializeDerivedMatrix( int index, MatrixParameterDX11* pMatrix,
+			MatrixParameterDX11* pLeft, MatrixParameterDX11* pRight );
+		void UpdateDerivedMatrix( DerivedMatrix& derived );
 	};
 };
 
@@ -21,6 +21,7 @@ namespace Glyph3
 {
 	class PipelineManagerDX11;
 	class IParameterManager;
+	class Sphere3f;
 
 	// This simple structure provides the mapping between a vertex shader program
 	// and the corresponding input layout.
@@ -43,6 +44,12 @@ namespace Glyph3
 		virtual void GenerateInputLayout( int ShaderID );
 		virtual int GetInputLayout( int ShaderID );
 
+		// Executors that know the extent of what they draw can provide a model
+		// space bounding sphere, which entities without any shapes use for their
+		// visibility tests.  The default executor is unbounded.
+
+		virtual bool GetModelBounds( Sphere3f& bounds );
+
 	protected:
 
 		// A description of our vertex elements
@@ -29,6 +29,7 @@
 #include "RenderEffectDX11.h"
 #include "ResourceProxyDX11.h"
 #include "ResourceDX11.h"
+#include "IConstantBufferUploader.h"
 //--------------------------------------------------------------------------------
 namespace Glyph3
 {
@@ -37,7 +38,7 @@ namespace Glyph3
 
 	typedef Microsoft::WRL::ComPtr<ID3DUserDefinedAnnotation> UserDefinedAnnotationComPtr;
 
-	class PipelineManagerDX11
+	class PipelineManagerDX11 : public IConstantBufferUploader
 	{
 	public:
 		PipelineManagerDX11();
@@ -161,6 +162,13 @@ namespace Glyph3
 		D3D11_MAPPED_SUBRESOURCE	MapResource( ResourceDX11* pGlyphResource, UINT subresource, D3D11_MAP actions, UINT flags );
 		void						UnMapResource( ResourceDX11* pGlyphResource, UINT subresource );
 
+		// Constant buffers upload their contents through this method, which maps
+		// the buffer with the discard flag and copies the data into it.
+
+		virtual bool UploadConstantData( ConstantBufferDX11* pBuffer, const char* pData, unsigned int size,
+			unsigned int dirtyOffset, unsigned int dirtySize );
+		virtual unsigned int GetUploadGeneration();
+
 
 		// This is an alternative method to mapping for updating resources.  In certain 
 		// situations one method may or may not be more efficient than the other, so it is
@@ -223,6 +231,9 @@ namespace Glyph3
         QueryComPtr					            m_Queries[NumQueries];
 		D3D11_QUERY_DATA_PIPELINE_STATISTICS	m_PipelineStatsData;
 
+		// Incremented for every command list that is finished or executed.
+		unsigned int							m_uiUploadGeneration;
+
 		// The shader stage resources are managed by these classes.
 
 		VertexStageDX11		VertexShaderStage;
@@ -47,20 +47,24 @@ namespace Glyph3
 			lhs.SlopeScaledDepthBias == rhs.SlopeScaledDepthBias;
 	}
 
-	inline bool operator<(const RasterizerStateConfigDX11& lhs, const RasterizerStateConfigDX11& rhs)
+	// Hash function for the state caches
+
+	inline unsigned int HashState( const RasterizerStateConfigDX11& config )
 	{
-		return memcmp(&lhs, &rhs, sizeof(lhs) ) < 0;
-		//return
-		//	lhs.AntialiasedLineEnable < rhs.AntialiasedLineEnable ||
-		//	lhs.CullMode < rhs.CullMode ||
-		//	lhs.DepthBias < rhs.DepthBias ||
-		//	lhs.DepthBiasClamp < rhs.DepthBiasClamp ||
-		//	lhs.DepthClipEnable < rhs.DepthClipEnable ||
-		//	lhs.FillMode < rhs.FillMode ||
-		//	lhs.FrontCounterClockwise < rhs.FrontCounterClockwise ||
-		//	lhs.MultisampleEnable < rhs.MultisampleEnable ||
-		//	lhs.ScissorEnable < rhs.ScissorEnable ||
-		//	lhs.SlopeScaledDepthBias < rhs.SlopeScaledDepthBias;
+		unsigned int hash = StateHashSeed;
+
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.FillMode ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.CullMode ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.FrontCounterClockwise ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.DepthBias ) );
+		hash = HashStateValue( hash, config.DepthBiasClamp );
+		hash = HashStateValue( hash, config.SlopeScaledDepthBias );
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.DepthClipEnable ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.ScissorEnable ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.MultisampleEnable ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.AntialiasedLineEnable ) );
+
+		return hash;
 	}
 };
 //--------------------------------------------------------------------------------
@@ -0,0 +1,66 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// RecordingConstantBufferUploader
+//
+// The recording uploader stands in for the pipeline manager when constant
+// buffers are updated without a device (i.e. in automated tests).  Instead of
+// mapping the buffers, it keeps a copy of the last contents uploaded to each
+// buffer, and counts the uploads and the uploaded bytes both in total and for
+// the current frame.  The dirty bytes are the part of the uploads that had
+// actually changed.  Starting a command list simulates a deferred context,
+// which forgets the contents of all of the buffers.
+//--------------------------------------------------------------------------------
+#ifndef RecordingConstantBufferUploader_h
+#define RecordingConstantBufferUploader_h
+//--------------------------------------------------------------------------------
+#include "IConstantBufferUploader.h"
+#include <map>
+#include <vector>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	struct ConstantBufferUploadStatistics
+	{
+		unsigned int	maps;
+		unsigned int	bytesUploaded;
+		unsigned int	bytesDirty;
+	};
+
+	class RecordingConstantBufferUploader : public IConstantBufferUploader
+	{
+	public:
+		RecordingConstantBufferUploader();
+		virtual ~RecordingConstantBufferUploader();
+
+		void BeginFrame();
+		void BeginCommandList();
+		void Reset();
+
+		ConstantBufferUploadStatistics GetFrameStatistics() const;
+		ConstantBufferUploadStatistics GetTotalStatistics() const;
+
+		const std::vector<char>* GetContents( ConstantBufferDX11* pBuffer ) const;
+
+		virtual bool UploadConstantData( ConstantBufferDX11* pBuffer, const char* pData, unsigned int size,
+			unsigned int dirtyOffset, unsigned int dirtySize );
+		virtual unsigned int GetUploadGeneration();
+
+	private:
+		ConstantBufferUploadStatistics							m_Frame;
+		ConstantBufferUploadStatistics							m_Total;
+		unsigned int											m_uiGeneration;
+		std::map<ConstantBufferDX11*,std::vector<char>>			m_Contents;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // RecordingConstantBufferUploader_h
+//--------------------------------------------------------------------------------
@@ -80,8 +80,19 @@ namespace Glyph3
 
 		unsigned int GetValueID( unsigned int threadID = 0 );
 
+		// When a parameter is registered with the parameter manager, its name is
+		// interned to a dense integer ID.  The ID indexes the manager's parameter
+		// array directly, and is much cheaper to compare than the name.  Unregistered
+		// parameters report INVALID_PARAMETER_ID.
+
+		static const unsigned int INVALID_PARAMETER_ID = 0xffffffff;
+
+		unsigned int GetParameterID() const;
+		void SetParameterID( unsigned int ID );
+
 	protected:
 		std::wstring	m_sParameterName;
+		unsigned int	m_uiParameterID;
 		unsigned int	m_auiValueID[NUM_THREADS+1];
 	};
 };
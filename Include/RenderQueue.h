@@ -0,0 +1,77 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// RenderQueue
+//
+// The render queue orders a list of entities for submission to the pipeline.
+// Each entity is given a 64-bit sort key built from its render pass, the
+// shaders and material that it will be drawn with, and its view space depth.
+// The keys are radix sorted, so that consecutive draws share as much pipeline
+// state as possible.  Opaque entities are grouped by state and then drawn front
+// to back, while alpha entities are drawn back to front after everything else.
+//
+// The sort is stable, so entities with identical keys keep the order in which
+// they were added to the queue.
+//--------------------------------------------------------------------------------
+#ifndef RenderQueue_h
+#define RenderQueue_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "SceneRenderTask.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class Entity3D;
+	class PipelineManagerDX11;
+	class IParameterManager;
+
+	class RenderQueue
+	{
+	public:
+		RenderQueue();
+		~RenderQueue();
+
+		// Builds the sorted queue from a list of entities, as seen with the given
+		// view matrix.  Entities that don't render in the view type are skipped.
+		// The level of detail of each entity is selected with the view and
+		// projection matrices, and is rendered with the entity.
+
+		void Build( const std::vector<Entity3D*>& entities, VIEWTYPE view, const Matrix4f& ViewMatrix, const Matrix4f& ProjMatrix, float lodScale = 1.0f );
+		void Clear();
+
+		// Renders the queued entities in their sorted order.  A range of the queue
+		// can be rendered on its own, which allows splitting it across threads.
+
+		void Render( PipelineManagerDX11* pPipelineManager, IParameterManager* pParamManager, VIEWTYPE view );
+		void Render( PipelineManagerDX11* pPipelineManager, IParameterManager* pParamManager, VIEWTYPE view, unsigned int begin, unsigned int end );
+
+		unsigned int GetCount() const;
+		Entity3D* GetEntity( unsigned int index ) const;
+
+	protected:
+
+		struct RenderQueueItem
+		{
+			unsigned long long	key;
+			Entity3D*			pEntity;
+			unsigned int		lod;
+		};
+
+		static unsigned long long MakeKey( Entity3D* pEntity, VIEWTYPE view, const Matrix4f& ViewMatrix );
+		void Sort();
+
+		std::vector<RenderQueueItem>	m_Items;
+		std::vector<RenderQueueItem>	m_Scratch;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // RenderQueue_h
+//--------------------------------------------------------------------------------
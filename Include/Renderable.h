@@ -21,6 +21,11 @@
 // render view to sort the objects according to these types if there
 // is a need.  For example, a skybox could be rendered before or after
 // normal geometry for a particular effect.
+//
+// Additional levels of detail can be added as alternative executors, each with
+// the projected screen size below which it is used.  The screen size is the
+// fraction of the viewport height that the entity's bounds cover, and level
+// zero is always the Executor itself.
 //--------------------------------------------------------------------------------
 #ifndef Renderable_h
 #define Renderable_h
@@ -56,10 +61,24 @@ namespace Glyph3
 		void SetGeometry( ExecutorPtr pExecutor );
 		ExecutorPtr GetGeometry( );
 
+		void AddLOD( ExecutorPtr pExecutor, float screenSize );
+		void ClearLODs( );
+		unsigned int GetLODCount( ) const;
+		const ExecutorPtr& GetLOD( unsigned int level ) const;
+		unsigned int SelectLOD( float screenSize ) const;
+
+		struct LevelOfDetail
+		{
+			ExecutorPtr		Executor;
+			float			ScreenSize;
+		};
 
 		ENTITYTYPE				iPass;
 		ExecutorPtr				Executor;
 		MaterialPtr				Material;
+
+		// The levels of detail after level zero, ordered by decreasing size.
+		std::vector<LevelOfDetail>	LODs;
 	};
 };
 //--------------------------------------------------------------------------------
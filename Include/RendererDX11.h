@@ -18,6 +18,7 @@
 #include "PCH.h"
 
 #include "TConfiguration.h"
+#include "JobScheduler.h"
 
 #include "Vector2f.h"
 #include "Vector3f.h"
@@ -25,6 +26,9 @@
 #include "Matrix4f.h"
 
 #include "ResourceProxyDX11.h"
+#include "ResourceTableDX11.h"
+#include "TStateCacheDX11.h"
+#include "ShaderCacheDX11.h"
 #include "ShaderDX11.h"
 //--------------------------------------------------------------------------------
 namespace Glyph3
@@ -60,6 +64,7 @@ namespace Glyph3
 	class BlendStateConfigDX11;
 	class DepthStencilStateConfigDX11;
 	class RasterizerStateConfigDX11;
+	class SamplerStateConfigDX11;
 
 	class RenderEffectDX11;
 
@@ -99,14 +104,17 @@ namespace Glyph3
 		RT_TEXTURE2D = 0x080000,
 		RT_TEXTURE3D = 0x090000
 	};
+	// A thread payload holds the objects needed to record a task on a thread
+	// other than the main thread - a pipeline with a deferred context, and a
+	// parameter manager with its own set of parameter values.  The payloads are
+	// shared by all of the worker threads, and each job that records commands
+	// acquires one for as long as it runs.
+
 	struct ThreadPayLoad
 	{
 		int id;
-		bool bComplete;
 		PipelineManagerDX11* pPipeline;
 		IParameterManager* pParamManager;
-		Task* pTask;
-		CommandListDX11* pList;
 	};
 
 
@@ -203,6 +211,15 @@ namespace Glyph3
 		int CreateSamplerState( D3D11_SAMPLER_DESC* pDesc );
 		int CreateViewPort( D3D11_VIEWPORT viewport );
 
+		// Each distinct state is only created once, so the states can be requested
+		// as often as needed.  The caches count how many of the requests were
+		// answered with an existing state.
+
+		const TStateCacheDX11<BlendStateConfigDX11>& GetBlendStateCache() const;
+		const TStateCacheDX11<DepthStencilStateConfigDX11>& GetDepthStencilStateCache() const;
+		const TStateCacheDX11<RasterizerStateConfigDX11>& GetRasterizerStateCache() const;
+		const TStateCacheDX11<SamplerStateConfigDX11>& GetSamplerStateCache() const;
+
 
 		// Each programmable shader stage can be loaded from file, and stored in a list for
 		// later use.  Either an application can directly set these values or a render effect
@@ -213,6 +230,14 @@ namespace Glyph3
 
         int LoadShader( ShaderType type, std::wstring& filename, std::wstring& function,
             std::wstring& model, const D3D_SHADER_MACRO* pDefines, bool enablelogging = true );
+
+		// The compiled shaders are kept in the shader cache, in memory and on disk.
+		// Precompiling a set of shaders (i.e. all of the permutations of an effect)
+		// compiles the ones that aren't cached yet in parallel on the job scheduler,
+		// so that loading them afterwards doesn't have to wait for the compiler.
+
+		ShaderCacheDX11* GetShaderCache();
+		void PrecompileShaders( const std::vector<ShaderCompileRequestDX11>& requests );
 		
 		ResourcePtr GetSwapChainResource( int ID );
 
@@ -255,6 +280,18 @@ namespace Glyph3
 		void QueueTask( Task* pTask );
 		void ProcessTaskQueue( );
 
+		// The job scheduler is used to record the queued tasks in parallel, and
+		// is available for other work that can be split into jobs.  Jobs that
+		// record commands must acquire a thread payload, and release it again
+		// once their command list has been generated.  Acquiring waits for a
+		// payload to become available, while the 'try' version returns null
+		// when all of them are in use.
+
+		JobScheduler*				GetJobScheduler();
+		ThreadPayLoad*				AcquireThreadPayload();
+		ThreadPayLoad*				TryAcquireThreadPayload();
+		void						ReleaseThreadPayload( ThreadPayLoad* pPayload );
+
 		// This method is here for allowing easy integration with other libraries
 		// which require access to the device.  Do not use this interface to create 
 		// objects unless those objects are then registered with this renderer class!!!
@@ -280,10 +317,10 @@ namespace Glyph3
 
 		std::vector<SwapChainDX11*>				m_vSwapChains;
 
-		// Resource allocation containers are stored in an expandable array, which
-		// provides fast random access with indices.
+		// Resource allocation containers are stored in a table of slots, which
+		// provides fast random access with generational handles.
 
-		std::vector<ResourceDX11*>				m_vResources;
+		ResourceTableDX11						m_Resources;
 
 		// Resource view containers.  These are indexed by the application for
 		// the various pipeline binding operations.
@@ -296,6 +333,8 @@ namespace Glyph3
 		// The shader programs are stored in an expandable array of their base classes.
 
 		std::vector<ShaderDX11*>				m_vShaders;
+		std::unordered_map<unsigned long long,int>	m_ShaderLookup;
+		ShaderCacheDX11							m_ShaderCache;
 		
 		// These states are stored as shared pointers to the object.  This is the direction
 		// that the renderer is heading in - eventually references to the objects will be
@@ -303,17 +342,18 @@ namespace Glyph3
 		// destroying many resources, and allow the renderer clients to have greater access
 		// the objects without querying the renderer.
 
-		std::vector<BlendStateComPtr>				m_BlendStates;
-		std::map<BlendStateConfigDX11,int>			m_BlendStateLookup;
+		std::vector<BlendStateComPtr>					m_BlendStates;
+		TStateCacheDX11<BlendStateConfigDX11>			m_BlendStateLookup;
 
-		std::vector<DepthStencilStateComPtr>		m_DepthStencilStates;
-		std::map<DepthStencilStateConfigDX11,int>	m_DepthStencilStateLookup;
+		std::vector<DepthStencilStateComPtr>			m_DepthStencilStates;
+		TStateCacheDX11<DepthStencilStateConfigDX11>	m_DepthStencilStateLookup;
 
-		std::vector<RasterizerStateComPtr>			m_RasterizerStates;
-		std::map<RasterizerStateConfigDX11,int>		m_RasterizerStateLookup;
+		std::vector<RasterizerStateComPtr>				m_RasterizerStates;
+		TStateCacheDX11<RasterizerStateConfigDX11>		m_RasterizerStateLookup;
 
-		std::vector<InputLayoutComPtr>				m_vInputLayouts;
-		std::vector<SamplerStateComPtr>				m_vSamplerStates;
+		std::vector<InputLayoutComPtr>					m_vInputLayouts;
+		std::vector<SamplerStateComPtr>					m_vSamplerStates;
+		TStateCacheDX11<SamplerStateConfigDX11>			m_SamplerStateLookup;
 		std::vector<ViewPortDX11>					m_vViewPorts;
 
 	public:
@@ -350,25 +390,28 @@ namespace Glyph3
 
 	protected:
 
-		int							GetUnusedResourceIndex();
 		int							StoreNewResource( ResourceDX11* pResource );
 
 		D3D_FEATURE_LEVEL			m_FeatureLevel;
 
 		std::vector<Task*>			m_vQueuedTasks;
 
+		// Multithreading support objects.  Each queued task is recorded into its
+		// own command list, so that the lists can be executed in queue order no
+		// matter which thread recorded them.
+
+		JobScheduler					m_JobScheduler;
+		std::vector<ThreadPayLoad>		m_vThreadPayloads;
+		std::vector<ThreadPayLoad*>		m_vFreeThreadPayloads;
+		std::mutex						m_ThreadPayloadLock;
+		std::vector<CommandListDX11*>	m_vCommandLists;
+
+		void ExecuteTaskJob( Task* pTask, CommandListDX11* pList );
+
 		friend GeometryDX11;
 	};
 };
 
-unsigned int WINAPI _TaskThreadProc( void* lpParameter );
-
-// Multithreading support objects
-extern HANDLE						g_aThreadHandles[NUM_THREADS];
-extern Glyph3::ThreadPayLoad		g_aPayload[NUM_THREADS];
-extern HANDLE						g_aBeginEventHandle[NUM_THREADS];
-extern HANDLE						g_aEndEventHandle[NUM_THREADS];
-
 template <class T>
 void LogObjectVector( std::vector<T> objects );
 template <class T>
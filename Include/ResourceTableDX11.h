@@ -0,0 +1,98 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// ResourceTableDX11
+//
+// The resource table stores the resources of the renderer in slots, and hands
+// out integer handles for them.  The lower bits of a handle are the slot index,
+// and the upper bits are the generation of the slot, which is incremented each
+// time that a resource is removed from it.  A handle to a deleted resource is
+// therefore detected as stale in constant time, even after its slot has been
+// reused for another resource.
+//
+// The free slots are kept in a FIFO list, so adding and removing are constant
+// time operations, and a freed slot is only reused after all of the other free
+// slots.  This keeps the generations from wrapping around quickly when many
+// resources are created and destroyed each frame.
+//
+// The type of each resource is stored next to it in the table, which allows the
+// typed accessors to validate a handle without touching the resource itself.
+// Handles are always positive, so -1 can still be used as an invalid handle.
+//--------------------------------------------------------------------------------
+#ifndef ResourceTableDX11_h
+#define ResourceTableDX11_h
+//--------------------------------------------------------------------------------
+#include <vector>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class ResourceDX11;
+
+	class ResourceTableDX11
+	{
+	public:
+		ResourceTableDX11();
+		~ResourceTableDX11();
+
+		// Returns the handle of the new resource, or -1 if the table is full.
+
+		int Add( ResourceDX11* pResource, int type );
+
+		// Removes the resource from the table and returns it (the table doesn't
+		// own the resources, so deleting it is left to the caller).  A stale or
+		// invalid handle returns nullptr.
+
+		ResourceDX11* Remove( int handle );
+
+		ResourceDX11* Get( int handle ) const;
+		int GetType( int handle ) const;
+		bool IsValid( int handle ) const;
+
+		unsigned int GetCount() const;
+
+		// The slots can be iterated directly, where unused slots are nullptr.
+
+		unsigned int GetSlotCount() const;
+		ResourceDX11* GetSlot( unsigned int slot ) const;
+
+		void Clear();
+
+		enum
+		{
+			IndexBits = 20,
+			GenerationBits = 11,
+			MaxSlots = 1 << IndexBits,
+			IndexMask = MaxSlots - 1,
+			GenerationMask = ( 1 << GenerationBits ) - 1
+		};
+
+	private:
+		struct Slot
+		{
+			ResourceDX11*	pResource;
+			int				type;
+			unsigned int	generation;
+			unsigned int	nextFree;
+		};
+
+		enum { EndOfList = 0xffffffff };
+
+		const Slot* Find( int handle ) const;
+
+		std::vector<Slot>	m_Slots;
+		unsigned int		m_uiFirstFree;
+		unsigned int		m_uiLastFree;
+		unsigned int		m_uiCount;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // ResourceTableDX11_h
+//--------------------------------------------------------------------------------
@@ -31,6 +31,50 @@ namespace Glyph3
 
 		friend RendererDX11;
 	};
+
+	// Global comparison operators
+
+	inline bool operator==(const SamplerStateConfigDX11& lhs, const SamplerStateConfigDX11& rhs)
+	{
+		return
+			lhs.Filter == rhs.Filter &&
+			lhs.AddressU == rhs.AddressU &&
+			lhs.AddressV == rhs.AddressV &&
+			lhs.AddressW == rhs.AddressW &&
+			lhs.MipLODBias == rhs.MipLODBias &&
+			lhs.MaxAnisotropy == rhs.MaxAnisotropy &&
+			lhs.ComparisonFunc == rhs.ComparisonFunc &&
+			lhs.BorderColor[0] == rhs.BorderColor[0] &&
+			lhs.BorderColor[1] == rhs.BorderColor[1] &&
+			lhs.BorderColor[2] == rhs.BorderColor[2] &&
+			lhs.BorderColor[3] == rhs.BorderColor[3] &&
+			lhs.MinLOD == rhs.MinLOD &&
+			lhs.MaxLOD == rhs.MaxLOD;
+	}
+
+	// Hash function for the state caches
+
+	inline unsigned int HashState( const SamplerStateConfigDX11& config )
+	{
+		unsigned int hash = StateHashSeed;
+
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.Filter ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.AddressU ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.AddressV ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.AddressW ) );
+		hash = HashStateValue( hash, config.MipLODBias );
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.MaxAnisotropy ) );
+		hash = HashStateValue( hash, static_cast<unsigned int>( config.ComparisonFunc ) );
+
+		for ( int i = 0; i < 4; i++ ) {
+			hash = HashStateValue( hash, config.BorderColor[i] );
+		}
+
+		hash = HashStateValue( hash, config.MinLOD );
+		hash = HashStateValue( hash, config.MaxLOD );
+
+		return hash;
+	}
 };
 //--------------------------------------------------------------------------------
 #endif // SamplerStateConfigDX11_h
@@ -21,6 +21,7 @@
 #include "Camera.h"
 #include "Light.h"
 #include "ParameterContainer.h"
+#include "TransformHierarchy.h"
 //--------------------------------------------------------------------------------
 namespace Glyph3
 {
@@ -50,6 +51,13 @@ namespace Glyph3
 
 		Node3D* GetRoot();
 
+		// Batched transforms store the scene's matrices in a TransformHierarchy,
+		// which performs all of the world matrix updates in one linear sweep.
+		// This is intended for scenes with large numbers of animated nodes.
+
+		void SetBatchedTransformsEnabled( bool enable );
+		bool IsBatchedTransformsEnabled() const;
+
 	public:
 		ParameterContainer Parameters;
 
@@ -58,6 +66,8 @@ namespace Glyph3
 		std::vector< Camera* > m_vCameras;
 		std::vector< Light* > m_vLights;
 		std::vector< Actor* > m_vActors;
+
+		TransformHierarchy* m_pTransforms;
 	};
 };
 //--------------------------------------------------------------------------------
@@ -18,6 +18,7 @@
 #include "PCH.h"
 #include "Entity3D.h"
 #include "Node3D.h"
+#include "CullingStats.h"
 //--------------------------------------------------------------------------------
 namespace Glyph3
 {
@@ -63,14 +64,29 @@ namespace Glyph3
 
 	void GetAllEntities( Node3D* node, std::vector< Entity3D* >& set );
 
+	// Collects the entities whose world transform changed during the most recent
+	// update.  Subtrees that didn't change at all are skipped entirely.
+
+	void GetChangedEntities( Node3D* node, std::vector< Entity3D* >& set );
+
+	// Refreshes the world bounds of a complete subtree, children first.  This is
+	// only needed when the world matrices were updated outside of the normal
+	// graph traversal, i.e. by a TransformHierarchy.
+
+	void UpdateWorldBounds( Node3D* node );
+
 	// The pick record is the correct way to build a list of the entities that are 
 	// intersecting the ray.  The other two methods are just as valid, but perform
 	// a different type of query than the pick record.
 
 	void BuildPickRecord( Node3D* node, const Ray3f& ray, std::vector<PickRecord>& record );
 	bool EntityInSubTree( Node3D* node, Entity3D* entity );
-	void GetIntersectingEntities( Node3D* node, std::vector< Entity3D* >& set, Sphere3f& bounds );
-	void GetIntersectingEntities( Node3D* node, std::vector< Entity3D* >& set, Frustum3f& bounds );
+
+	// The intersection queries use the node bounds to reject or accept complete
+	// subtrees at once.  Unbounded entities are always considered intersecting.
+
+	void GetIntersectingEntities( Node3D* node, std::vector< Entity3D* >& set, const Sphere3f& bounds, CullingStats* pStats = nullptr );
+	void GetIntersectingEntities( Node3D* node, std::vector< Entity3D* >& set, const Frustum3f& bounds, CullingStats* pStats = nullptr );
 };
 //--------------------------------------------------------------------------------
 #endif // SceneGraph_h
@@ -27,12 +27,15 @@
 #define SceneRenderTask_h
 //--------------------------------------------------------------------------------
 #include "Task.h"
+#include "CullingStats.h"
 //--------------------------------------------------------------------------------
 namespace Glyph3
 {
 	class Entity3D;
 	class Scene;
 	class BoundsVisualizerActor;
+	class RenderQueue;
+	class CommandListDX11;
 
 	// The view type is used to allow a view to identify what type of
 	// view it is.  This identifier is also used by objects to specify
@@ -104,8 +107,63 @@ namespace Glyph3
 		void SetDebugViewEnabled( bool debug );
 		bool IsDebugViewEnabled();
 
+		// Frustum culling uses the world bounds of the scene graph to skip any
+		// subtrees that are not visible with the current view and projection
+		// matrices.  The statistics from the most recent culling pass are kept
+		// for profiling purposes.
+
+		void SetFrustumCullingEnabled( bool enable );
+		bool IsFrustumCullingEnabled();
+		const CullingStats& GetCullingStats() const;
+
+		// State sorting orders the visible entities with a render queue, so that
+		// draws sharing the same shaders and materials are submitted together.
+		// When disabled, the entities are only partitioned into opaque and alpha
+		// groups in scene graph order.
+
+		void SetStateSortingEnabled( bool enable );
+		bool IsStateSortingEnabled();
+
+		// Parallel recording splits the ordered entity list of this view into
+		// chunks of at least the given size.  Each chunk is recorded into its own
+		// command list on a separate thread, and the lists are then executed in
+		// order on this view's pipeline.  The number of chunks is limited by the
+		// number of threads and by the free thread payloads.
+
+		void SetParallelRecordingEnabled( bool enable );
+		bool IsParallelRecordingEnabled();
+		void SetParallelRecordingChunkSize( unsigned int size );
+		unsigned int GetParallelRecordingChunkSize();
+
+		// Entities with levels of detail are rendered with the level that
+		// matches their projected size in this view.  The scale multiplies the
+		// projected sizes, so values below one switch to coarser levels sooner.
+
+		void SetLODScale( float scale );
+		float GetLODScale();
+
 	protected:
 
+		// Collects the entities of the scene that should be rendered by this 
+		// view, culled against the view frustum if culling is enabled.
+
+		void GetVisibleEntities( std::vector<Entity3D*>& set );
+
+		// Renders the visible entities of the scene with the given view type,
+		// using the render queue when state sorting is enabled.
+
+		void RenderVisibleEntities( PipelineManagerDX11* pPipelineManager, IParameterManager* pParamManager, VIEWTYPE view );
+
+		// Sets the parameters that the view's entities depend on into the
+		// parameter manager of a recording thread.  By default these are the
+		// view's render parameters and the first light of the scene, which
+		// should be extended by views that set anything else before rendering.
+
+		virtual void SetRecordingParams( IParameterManager* pParamManager );
+
+		void RenderEntityRange( PipelineManagerDX11* pPipelineManager, IParameterManager* pParamManager, VIEWTYPE view, unsigned int begin, unsigned int end );
+		void RecordEntitiesInParallel( PipelineManagerDX11* pPipelineManager, IParameterManager* pParamManager, VIEWTYPE view, unsigned int count );
+
 		Entity3D* m_pEntity;
 		Scene* m_pScene;
 
@@ -124,6 +182,20 @@ namespace Glyph3
 		Matrix4f ProjMatrix;
 
 		bool m_bDebugViewEnabled;
+
+		bool m_bFrustumCullingEnabled;
+		CullingStats m_CullingStats;
+
+		bool m_bStateSortingEnabled;
+		RenderQueue* m_pRenderQueue;
+		std::vector<Entity3D*> m_VisibleEntities;
+		std::vector<unsigned int> m_VisibleLODs;
+		float m_fLODScale;
+
+		bool m_bParallelRecordingEnabled;
+		unsigned int m_uiRecordingChunkSize;
+		std::vector<ThreadPayLoad*> m_RecordingPayloads;
+		std::vector<CommandListDX11*> m_RecordingLists;
 	};
 };
 //--------------------------------------------------------------------------------
@@ -0,0 +1,128 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// ShaderCacheDX11
+//
+// The shader cache keeps compiled shader bytecode in memory and on disk, so
+// that each shader permutation is only compiled once instead of at every launch.
+//
+// The memory cache is a hash map keyed on the request itself (the file name,
+// entry point, profile, flags and the define set).  It answers repeated
+// requests within a process without touching the source files.  Otherwise the
+// source is preprocessed, and the disk cache is keyed on a hash of the
+// preprocessed source, the define set, the names of the included files, the
+// entry point, the profile, the flags and the compiler identifier.  Editing a
+// shader or any of its includes changes the preprocessed source, so stale
+// bytecode is never used.  The cache files are written to the cache folder of
+// the FileSystem, and a file with an unexpected version, key or checksum is
+// treated as a miss.
+//
+// The compiler is pluggable (see IShaderCompiler), and the cache doesn't need
+// a device, so it can be tested with the StubShaderCompiler.  Several requests
+// can be compiled in parallel on a job scheduler, and the cache can be used
+// from several threads at once.  Threads that miss on the same request at the
+// same time may each compile it, but they all receive the same bytecode.
+//--------------------------------------------------------------------------------
+#ifndef ShaderCacheDX11_h
+#define ShaderCacheDX11_h
+//--------------------------------------------------------------------------------
+#include "IShaderCompiler.h"
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class JobScheduler;
+
+	struct ShaderCompileRequestDX11
+	{
+		ShaderCompileRequestDX11();
+
+		std::wstring					FileName;
+		std::string						Function;
+		std::string						ShaderModel;
+		std::vector<ShaderMacroDX11>	Defines;
+		unsigned int					Flags;
+	};
+
+	struct ShaderCacheStatistics
+	{
+		unsigned int	memoryHits;
+		unsigned int	diskHits;
+		unsigned int	compilations;
+		unsigned int	failures;
+	};
+
+	typedef std::shared_ptr<const std::vector<char>> ShaderBytecodePtr;
+
+	class ShaderCacheDX11
+	{
+	public:
+		ShaderCacheDX11();
+		~ShaderCacheDX11();
+
+		void SetCompiler( std::shared_ptr<IShaderCompiler> pCompiler );
+		std::shared_ptr<IShaderCompiler> GetCompiler();
+
+		// Returns the bytecode for the request from one of the caches, or by
+		// compiling it.  When preprocessing or compilation fails, nullptr is
+		// returned and the errors of the compiler are passed back.
+
+		ShaderBytecodePtr GetBytecode( const ShaderCompileRequestDX11& request, std::string* pErrors = nullptr );
+
+		// Loads or compiles all of the requests in parallel, and returns their
+		// bytecode in the same order.  Without a scheduler the requests are
+		// compiled one after the other.
+
+		void GetBytecode( const std::vector<ShaderCompileRequestDX11>& requests, std::vector<ShaderBytecodePtr>& results,
+			JobScheduler* pScheduler = nullptr );
+
+		// The disk cache can be disabled, i.e. to force every shader to be
+		// compiled once while working on the compiler settings.
+
+		void SetDiskCacheEnabled( bool enabled );
+		bool IsDiskCacheEnabled();
+
+		void ClearMemoryCache();
+
+		ShaderCacheStatistics GetStatistics();
+		void ResetStatistics();
+
+		// The request key identifies a request in the memory cache, and the cache
+		// key identifies the bytecode of the preprocessed request on disk.
+
+		static unsigned long long GetRequestKey( const ShaderCompileRequestDX11& request );
+		static unsigned long long GetCacheKey( const std::string& compiler, const ShaderCompileRequestDX11& request,
+			const std::string& source, const std::vector<std::wstring>& includes );
+		static std::wstring GetCacheFilename( unsigned long long key );
+
+	private:
+		ShaderCacheDX11( const ShaderCacheDX11& );
+		ShaderCacheDX11& operator=( const ShaderCacheDX11& );
+
+		ShaderBytecodePtr ReadCacheFile( const std::wstring& cacheFile, unsigned long long key );
+		bool WriteCacheFile( const std::wstring& cacheFile, unsigned long long key, const std::vector<char>& bytecode );
+
+		std::shared_ptr<IShaderCompiler>						m_pCompiler;
+		bool													m_bDiskCacheEnabled;
+
+		// The lock protects the memory cache and the statistics.  The compiler
+		// is called without holding it.
+
+		std::mutex												m_Lock;
+		std::unordered_map<unsigned long long,ShaderBytecodePtr>	m_MemoryCache;
+		ShaderCacheStatistics									m_Statistics;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // ShaderCacheDX11_h
+//--------------------------------------------------------------------------------
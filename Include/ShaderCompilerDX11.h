@@ -0,0 +1,44 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// ShaderCompilerDX11
+//
+// This is the shader compiler that is normally used by the shader cache, which
+// runs the D3D compiler on the files of the shader folder.  The included files
+// are also loaded from the shader folder, and the include handler records their
+// names for the cache key.
+//--------------------------------------------------------------------------------
+#ifndef ShaderCompilerDX11_h
+#define ShaderCompilerDX11_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "IShaderCompiler.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class ShaderCompilerDX11 : public IShaderCompiler
+	{
+	public:
+		ShaderCompilerDX11();
+		virtual ~ShaderCompilerDX11();
+
+		virtual bool Preprocess( const std::wstring& filename, const std::vector<ShaderMacroDX11>& defines,
+			std::string& source, std::vector<std::wstring>& includes, std::string& errors );
+
+		virtual bool Compile( const std::string& source, const std::wstring& filename, const std::string& function,
+			const std::string& model, unsigned int flags, std::vector<char>& bytecode, std::string& errors );
+
+		virtual std::string GetIdentifier();
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // ShaderCompilerDX11_h
+//--------------------------------------------------------------------------------
@@ -17,6 +17,7 @@
 //--------------------------------------------------------------------------------
 #include "PCH.h"
 #include "ShaderDX11.h"
+#include "ShaderCacheDX11.h"
 //--------------------------------------------------------------------------------
 namespace Glyph3
 {
@@ -31,6 +32,13 @@ namespace Glyph3
 		static ID3DBlob* GeneratePrecompiledShader( std::wstring& filename, std::wstring& function,
             std::wstring& model );
 
+		// The compile request that GenerateShader uses for a shader, with the
+		// engine's compiler flags.  Requests built with it can be given to the
+		// shader cache ahead of time to compile the shaders in parallel.
+
+		static ShaderCompileRequestDX11 CreateRequest( const std::wstring& filename, const std::wstring& function,
+			const std::wstring& model, const D3D_SHADER_MACRO* pDefines );
+
 	private:
 		ShaderFactoryDX11();
 	};
@@ -11,6 +11,12 @@
 //--------------------------------------------------------------------------------
 // SkinnedActor
 //
+// By default each bone is animated by its own SkinnedBoneController, which
+// updates the bone's node in the scene graph.  With batched animation enabled,
+// the keyframes of all bones are copied into a single AnimationClip when the
+// bind pose is set, and the actor samples the whole skeleton in one pass and
+// builds the skinning matrices directly from the samples.  The bone nodes then
+// remain in their bind pose, and all bones share a single animation timeline.
 //--------------------------------------------------------------------------------
 #ifndef SkinnedActor_h
 #define SkinnedActor_h
@@ -18,6 +24,7 @@
 #include "Actor.h"
 #include "SkinnedBoneController.h"
 #include "AnimationStream.h"
+#include "AnimationClip.h"
 #include "MatrixArrayParameterWriterDX11.h"
 //--------------------------------------------------------------------------------
 namespace Glyph3
@@ -41,9 +48,16 @@ namespace Glyph3
 		void PlayAnimation( std::wstring& name );
 		void PlayAllAnimations( );
 
+		void SetBatchedAnimationEnabled( bool enabled );
+		bool IsBatchedAnimationEnabled( ) const;
+		void UpdateAnimation( float fTime );
+
 		Entity3D* GetGeometryEntity();
 
 	protected:
+		void BuildAnimationClip( );
+		void PlayBatched( float fStartTime, float fEndTime );
+
 		std::vector<SkinnedBoneController<Node3D>*>		m_Bones;
 		Matrix4f*										m_pMatrices;
 		Matrix4f*										m_pNormalMatrices;
@@ -51,6 +65,23 @@ namespace Glyph3
 
 		MatrixArrayParameterWriterDX11*					m_pSkinMatrixWriter;
 		MatrixArrayParameterWriterDX11*					m_pNormalMatrixWriter;
+
+		// The batched animation data.  The clip holds a position track and a
+		// rotation track for each bone, and the bones are evaluated in an order
+		// where each parent comes before its children.
+
+		bool											m_bBatchedAnimation;
+		bool											m_bBatchedPlaying;
+		float											m_fAnimationTime;
+		float											m_fAnimationEndTime;
+		AnimationClip									m_Clip;
+		std::vector<Animation>							m_Animations;
+		std::vector<int>								m_BoneParents;
+		std::vector<unsigned int>						m_BoneOrder;
+		std::vector<unsigned int>						m_Cursors;
+		std::vector<Vector3f>							m_Samples;
+		std::vector<Matrix4f>							m_LocalMatrices;
+		std::vector<Matrix4f>							m_WorldMatrices;
 	};
 };
 //--------------------------------------------------------------------------------
@@ -0,0 +1,42 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// SkinnedAnimationController
+//
+// This controller advances the batched animation of a skinned actor during the
+// scene graph update.  It is attached to the actor's root node, so that the
+// whole skeleton is sampled once per update instead of with one controller per
+// bone.  When the actor doesn't use batched animation, the update does nothing.
+//--------------------------------------------------------------------------------
+#ifndef SkinnedAnimationController_h
+#define SkinnedAnimationController_h
+//--------------------------------------------------------------------------------
+#include "IController.h"
+#include "SkinnedActor.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	template <typename T>
+	class SkinnedAnimationController : public IController<T>
+	{
+	public:
+		SkinnedAnimationController( SkinnedActor* pActor );
+		virtual ~SkinnedAnimationController( );
+		virtual void Update( float fTime );
+
+	protected:
+		SkinnedActor*	m_pActor;
+	};
+
+	#include "SkinnedAnimationController.inl"
+};
+//--------------------------------------------------------------------------------
+#endif // SkinnedAnimationController_h
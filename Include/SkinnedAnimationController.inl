@@ -0,0 +1,31 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+template <typename T>
+SkinnedAnimationController<T>::SkinnedAnimationController( SkinnedActor* pActor )
+{
+	m_pActor = pActor;
+}
+//--------------------------------------------------------------------------------
+template <typename T>
+SkinnedAnimationController<T>::~SkinnedAnimationController()
+{
+}
+//--------------------------------------------------------------------------------
+template <typename T>
+void SkinnedAnimationController<T>::Update( float fTime )
+{
+	if ( m_pActor && m_pActor->IsBatchedAnimationEnabled() )
+	{
+		m_pActor->UpdateAnimation( fTime );
+	}
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
@@ -48,6 +48,13 @@ namespace Glyph3
 		
 		void SetParentBone( SkinnedBoneController* pParent );
 
+		// A disabled controller leaves its bone untouched, i.e. while the actor
+		// evaluates the animation of all bones in a single batch.
+
+		void SetEnabled( bool enabled );
+		bool IsEnabled( ) const;
+		const Matrix4f& GetInverseBindPose( ) const;
+
 		
 	protected:
 		Matrix4f m_LocalSkeleton;
@@ -60,6 +67,7 @@ namespace Glyph3
 		Vector3f					m_kBindPosition;
 		Vector3f					m_kBindRotation;
 		bool						m_bActivate;
+		bool						m_bEnabled;
 	};
 
 	#include "SkinnedBoneController.inl"
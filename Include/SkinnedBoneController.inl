@@ -22,6 +22,7 @@ SkinnedBoneController<T>::SkinnedBoneController()
 	m_GlobalSkeleton.MakeIdentity();
 
 	m_bActivate = false;
+	m_bEnabled = true;
 }
 //--------------------------------------------------------------------------------
 template <typename T>
@@ -34,6 +35,9 @@ SkinnedBoneController<T>::~SkinnedBoneController()
 template <typename T>
 void SkinnedBoneController<T>::Update( float fTime )
 {
+	if ( !m_bEnabled )
+		return;
+
 	// Skip the first update to allow the bind pose to be read.
 	if ( !m_bActivate )
 	{
@@ -174,4 +178,22 @@ void SkinnedBoneController<T>::SetParentBone( SkinnedBoneController* pParent )
 {
 	this->m_pParentBone = pParent;
 }
+//--------------------------------------------------------------------------------
+template <typename T>
+void SkinnedBoneController<T>::SetEnabled( bool enabled )
+{
+	m_bEnabled = enabled;
+}
+//--------------------------------------------------------------------------------
+template <typename T>
+bool SkinnedBoneController<T>::IsEnabled( ) const
+{
+	return( m_bEnabled );
+}
+//--------------------------------------------------------------------------------
+template <typename T>
+const Matrix4f& SkinnedBoneController<T>::GetInverseBindPose( ) const
+{
+	return( m_InvBindPose );
+}
 //--------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,67 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// StubShaderCompiler
+//
+// The stub compiler stands in for the D3D compiler, so that the shader cache can
+// be exercised without D3D (i.e. on other platforms or in automated tests).  Its
+// source files are held in memory, and modifying them is how a changed shader
+// or include file is simulated.
+//
+// Preprocessing prepends the defines and expands the #include "file" lines, and
+// compiling just copies the preprocessed source into the bytecode.  Source that
+// contains an #error line fails to compile.  The compile calls are counted, and
+// can be given an artificial duration to measure the parallel compilation.
+//--------------------------------------------------------------------------------
+#ifndef StubShaderCompiler_h
+#define StubShaderCompiler_h
+//--------------------------------------------------------------------------------
+#include "IShaderCompiler.h"
+#include <atomic>
+#include <map>
+#include <mutex>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class StubShaderCompiler : public IShaderCompiler
+	{
+	public:
+		StubShaderCompiler();
+		virtual ~StubShaderCompiler();
+
+		void SetFile( const std::wstring& filename, const std::string& contents );
+		void SetIdentifier( const std::string& identifier );
+		void SetCompileTime( unsigned int milliseconds );
+
+		unsigned int GetCompileCount();
+
+		virtual bool Preprocess( const std::wstring& filename, const std::vector<ShaderMacroDX11>& defines,
+			std::string& source, std::vector<std::wstring>& includes, std::string& errors );
+
+		virtual bool Compile( const std::string& source, const std::wstring& filename, const std::string& function,
+			const std::string& model, unsigned int flags, std::vector<char>& bytecode, std::string& errors );
+
+		virtual std::string GetIdentifier();
+
+	private:
+		bool Expand( const std::wstring& filename, std::string& source, std::vector<std::wstring>& includes,
+			std::string& errors, unsigned int depth );
+
+		std::mutex							m_Lock;
+		std::map<std::wstring,std::string>	m_Files;
+		std::string							m_Identifier;
+		unsigned int						m_uiCompileTime;
+		std::atomic<unsigned int>			m_uiCompileCount;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // StubShaderCompiler_h
+//--------------------------------------------------------------------------------
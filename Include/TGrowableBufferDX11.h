@@ -11,7 +11,23 @@
 //--------------------------------------------------------------------------------
 // TGrowableBufferDX11
 //
-// This template class provides 
+// This template class provides a system memory array of elements that grows as
+// elements are added to it, together with a buffer resource that the elements
+// are uploaded to.  The array grows geometrically, so adding n elements one at a
+// time only copies O(n) elements in total, and the resource is only recreated
+// at the next upload after the array has grown.  When a shrink interval is set,
+// the array is shrunk again if its peak usage between resets has stayed well
+// below its size for that many resets.
+//
+// In ring mode, each upload is appended after the previous one in a persistent
+// dynamic resource that holds several frames worth of elements.  Appending maps
+// the resource with D3D11_MAP_WRITE_NO_OVERWRITE, since the GPU may still be
+// reading the earlier data, and only wrapping around to the start discards the
+// resource.  The offset of the most recent upload is then used when binding the
+// resource for drawing, so ring mode is only used with vertex and index buffers.
+//
+// The reallocation and copy counters allow measuring the cost of the growth
+// policy without a device.
 //--------------------------------------------------------------------------------
 #ifndef TGrowableBufferDX11_h
 #define TGrowableBufferDX11_h
@@ -36,10 +52,16 @@ namespace Glyph3
 		unsigned int GetMaxElementCount();
 		unsigned int GetElementCount();
 
-		
-		// Elements are added one at a time, with a template method.
+		// Reserving grows the array to hold at least the given number of
+		// elements, which avoids any intermediate growth steps.
+
+		void Reserve( unsigned int count );
+
+		// Elements are added one at a time, with a template method, or as a
+		// whole array at once.
 
 		void AddElement( const T& element );
+		void AddElements( const T* pElements, unsigned int count );
 		
 
 		// These methods allow the user to either upload the data to
@@ -54,6 +76,25 @@ namespace Glyph3
 
 		virtual ResourcePtr GetBuffer() = 0;
 
+		// The shrink interval is the number of resets after which an oversized
+		// array is shrunk, and an interval of zero never shrinks the array.
+
+		void SetShrinkInterval( unsigned int resets );
+		unsigned int GetShrinkInterval();
+
+		// The ring holds the given number of frames of the largest element count,
+		// and the offset is the first element of the most recent upload within
+		// the resource (which is always zero outside of ring mode).
+
+		void SetRingMode( bool enable, unsigned int frames = 3 );
+		bool IsRingMode();
+		unsigned int GetUploadOffset();
+
+		unsigned int GetReallocationCount();
+		unsigned long long GetBytesCopied();
+		unsigned int GetResourceCreationCount();
+		void ResetCounters();
+
         // These methods are used internally by the growable buffer to allocate 
 		// and deallocate the resources to be used.  This lets each subclass
 		// determine the type and number of resources to use, giving very good 
@@ -65,16 +106,45 @@ namespace Glyph3
         virtual void CreateResource( unsigned int elements ) = 0;
         virtual void DeleteResource( ) = 0;
 
-		void EnsureCapacity( );
+		void EnsureCapacity( unsigned int count = 1 );
+
+		// Creates the resource if the array has been resized since the last
+		// upload, and then maps the resource and copies the elements into it.
+		// AdvanceRing places the next upload within the resource, and returns
+		// the mode that the resource has to be mapped with for it.
+
+		void EnsureResource( );
+		D3D11_MAP AdvanceRing( );
+		void UploadElements( PipelineManagerDX11* pPipeline, ResourcePtr resource );
+
+		// The arrays are never shrunk below this size.
+		enum { MinimumElementCount = 128 };
 
 		// The sizes
 		unsigned int m_uiMaxElementCount;
 		unsigned int m_uiElementCount;
+		unsigned int m_uiResourceElementCount;
 
 		bool m_bUploadNeeded;
 
 		// The pointer to our array of vertex data
 		T* m_pDataArray;
+
+		// Shrinking policy
+		unsigned int m_uiShrinkInterval;
+		unsigned int m_uiResetCount;
+		unsigned int m_uiPeakElementCount;
+
+		// Ring mode state
+		bool m_bRingMode;
+		unsigned int m_uiRingFrames;
+		unsigned int m_uiRingPosition;
+		unsigned int m_uiUploadOffset;
+
+		// Statistics
+		unsigned int m_uiReallocations;
+		unsigned long long m_ullBytesCopied;
+		unsigned int m_uiResourceCreations;
 	};
 
 #include "TGrowableBufferDX11.inl"
@@ -15,8 +15,19 @@ template <class T>
 TGrowableBufferDX11<T>::TGrowableBufferDX11() :
 	m_uiMaxElementCount( 0 ),
 	m_uiElementCount( 0 ),
+	m_uiResourceElementCount( 0 ),
 	m_bUploadNeeded( false ),
-	m_pDataArray( nullptr )
+	m_pDataArray( nullptr ),
+	m_uiShrinkInterval( 0 ),
+	m_uiResetCount( 0 ),
+	m_uiPeakElementCount( 0 ),
+	m_bRingMode( false ),
+	m_uiRingFrames( 3 ),
+	m_uiRingPosition( 0 ),
+	m_uiUploadOffset( 0 ),
+	m_uiReallocations( 0 ),
+	m_ullBytesCopied( 0 ),
+	m_uiResourceCreations( 0 )
 {
 	// Initialize our buffer to a reasonable size
 //	SetMaxElementCount( 128 );
@@ -48,28 +59,20 @@ void TGrowableBufferDX11<T>::SetMaxElementCount( unsigned int max )
 		// Copy the existing vertex data over, if any has been added.
 		if ( m_uiElementCount > 0 ) {
 			memcpy( pNewArray, m_pDataArray, m_uiElementCount * sizeof( T ) );
+			m_ullBytesCopied += m_uiElementCount * sizeof( T );
 		}
 
 		// Remember the maximum number of vertices to allow, and the 
 		// current count of vertices is left as it is.
 		m_uiMaxElementCount = max;
+		m_uiReallocations++;
 
 		// Release system memory for the old array so that we can set a new one
 		SAFE_DELETE_ARRAY( m_pDataArray );
 		m_pDataArray = pNewArray;
 
-		// Delete the existing resource if it already existed
-		DeleteResource( );
-//		if ( nullptr != m_Buffer ) {
-//			RendererDX11::Get()->DeleteResource( m_Buffer );
-//			m_Buffer = nullptr;
-//		}
-
-		// Create the new vertex buffer, with the dynamic flag set to true
-		CreateResource( m_uiMaxElementCount );
-//		BufferConfigDX11 vbuffer;
-//		vbuffer.SetDefaultVertexBuffer( m_uiMaxElementCount * sizeof( T ), true );
-//		m_Buffer = RendererDX11::Get()->CreateVertexBuffer( &vbuffer, nullptr );
+		// The resource is recreated to match at the next upload, so that an
+		// array which grows several times between uploads only creates it once.
 
 		m_bUploadNeeded = true;
 	}
@@ -88,6 +91,14 @@ unsigned int TGrowableBufferDX11<T>::GetElementCount()
 }
 //--------------------------------------------------------------------------------
 template <class T>
+void TGrowableBufferDX11<T>::Reserve( unsigned int count )
+{
+	if ( count > m_uiElementCount ) {
+		EnsureCapacity( count - m_uiElementCount );
+	}
+}
+//--------------------------------------------------------------------------------
+template <class T>
 void TGrowableBufferDX11<T>::AddElement( const T& element )
 {
 	EnsureCapacity( );
@@ -98,6 +109,21 @@ void TGrowableBufferDX11<T>::AddElement( const T& element )
 	m_bUploadNeeded = true;
 }
 //--------------------------------------------------------------------------------
+template <class T>
+void TGrowableBufferDX11<T>::AddElements( const T* pElements, unsigned int count )
+{
+	if ( count == 0 ) {
+		return;
+	}
+
+	EnsureCapacity( count );
+
+	memcpy( m_pDataArray + m_uiElementCount, pElements, count * sizeof( T ) );
+	m_uiElementCount += count;
+
+	m_bUploadNeeded = true;
+}
+//--------------------------------------------------------------------------------
 //template <class T>
 //void TGrowableBufferDX11<T>::UploadData( PipelineManagerDX11* pPipeline )
 //{
@@ -123,6 +149,25 @@ void TGrowableBufferDX11<T>::AddElement( const T& element )
 template <class T>
 void TGrowableBufferDX11<T>::ResetData()
 {
+	// The peak usage is tracked across the resets of each shrink interval, and
+	// an array that stayed below a quarter of its size is halved or more (but
+	// still left with room for twice the peak).
+
+	m_uiPeakElementCount = max( m_uiPeakElementCount, m_uiElementCount );
+
+	if ( m_uiShrinkInterval > 0 && ++m_uiResetCount >= m_uiShrinkInterval ) {
+
+		unsigned int target = max( m_uiPeakElementCount * 2, MinimumElementCount );
+
+		if ( m_uiPeakElementCount * 4 <= m_uiMaxElementCount && target < m_uiMaxElementCount ) {
+			m_uiElementCount = 0;
+			SetMaxElementCount( target );
+		}
+
+		m_uiResetCount = 0;
+		m_uiPeakElementCount = 0;
+	}
+
 	// Reset the vertex count here to prepare for the next drawing pass.
 	m_uiElementCount = 0;
 
@@ -130,14 +175,150 @@ void TGrowableBufferDX11<T>::ResetData()
 }
 //--------------------------------------------------------------------------------
 template <class T>
-void TGrowableBufferDX11<T>::EnsureCapacity( )
+void TGrowableBufferDX11<T>::EnsureCapacity( unsigned int count )
+{
+	// If the new elements would put us over the limit, then the array is
+	// doubled until they fit.  This keeps the total amount of copying linear in
+	// the number of elements that are added.
+
+	const unsigned long long required = static_cast<unsigned long long>( m_uiElementCount ) + count;
+
+	if ( required > m_uiMaxElementCount ) {
+
+		unsigned long long capacity = max( m_uiMaxElementCount, MinimumElementCount );
+
+		while ( capacity < required ) {
+			capacity *= 2;
+		}
+
+		SetMaxElementCount( static_cast<unsigned int>( min( capacity, 0xffffffffull ) ) );
+	}
+}
+//--------------------------------------------------------------------------------
+template <class T>
+void TGrowableBufferDX11<T>::EnsureResource( )
 {
-	// If the next vertex would put us over the limit, then resize the array.
-	if ( m_uiElementCount + 1 >= m_uiMaxElementCount ) {
-		SetMaxElementCount( m_uiMaxElementCount + 1024 );
+	const unsigned long long size = static_cast<unsigned long long>( m_uiMaxElementCount ) * ( m_bRingMode ? m_uiRingFrames : 1 );
+	const unsigned int elements = static_cast<unsigned int>( min( size, 0xffffffffull ) );
+
+	if ( elements != m_uiResourceElementCount ) {
+
+		DeleteResource( );
+		CreateResource( elements );
+
+		m_uiResourceElementCount = elements;
+		m_uiResourceCreations++;
+
+		// A new resource has nothing in it, so the ring starts over and the
+		// current elements have to be uploaded again.
+
+		m_uiRingPosition = 0;
+		m_uiUploadOffset = 0;
+		m_bUploadNeeded = true;
 	}
 }
 //--------------------------------------------------------------------------------
+template <class T>
+D3D11_MAP TGrowableBufferDX11<T>::AdvanceRing( )
+{
+	// Outside of ring mode the whole resource is discarded for every upload.
+	// In ring mode the elements are appended without overwriting anything the
+	// GPU could still be reading, until they don't fit anymore and the ring
+	// wraps around to a discarded resource.
+
+	D3D11_MAP mode = D3D11_MAP_WRITE_DISCARD;
+	unsigned int offset = 0;
+
+	if ( m_bRingMode ) {
+
+		if ( m_uiRingPosition > 0 && m_uiRingPosition + m_uiElementCount <= m_uiResourceElementCount ) {
+			mode = D3D11_MAP_WRITE_NO_OVERWRITE;
+			offset = m_uiRingPosition;
+		}
+
+		m_uiRingPosition = offset + m_uiElementCount;
+	}
+
+	m_uiUploadOffset = offset;
+
+	return( mode );
+}
+//--------------------------------------------------------------------------------
+template <class T>
+void TGrowableBufferDX11<T>::UploadElements( PipelineManagerDX11* pPipeline, ResourcePtr resource )
+{
+	D3D11_MAP mode = AdvanceRing( );
+
+	D3D11_MAPPED_SUBRESOURCE mapped = pPipeline->MapResource( resource, 0, mode, 0 );
+
+	// Only copy as much of the data as you actually have filled up
+
+	memcpy( static_cast<T*>( mapped.pData ) + m_uiUploadOffset, m_pDataArray, m_uiElementCount * sizeof( T ) );
+
+	pPipeline->UnMapResource( resource, 0 );
+}
+//--------------------------------------------------------------------------------
+template <class T>
+void TGrowableBufferDX11<T>::SetShrinkInterval( unsigned int resets )
+{
+	m_uiShrinkInterval = resets;
+	m_uiResetCount = 0;
+	m_uiPeakElementCount = 0;
+}
+//--------------------------------------------------------------------------------
+template <class T>
+unsigned int TGrowableBufferDX11<T>::GetShrinkInterval()
+{
+	return( m_uiShrinkInterval );
+}
+//--------------------------------------------------------------------------------
+template <class T>
+void TGrowableBufferDX11<T>::SetRingMode( bool enable, unsigned int frames )
+{
+	// The resource is resized for the new mode at the next upload.
+
+	m_bRingMode = enable;
+	m_uiRingFrames = frames > 0 ? frames : 1;
+}
+//--------------------------------------------------------------------------------
+template <class T>
+bool TGrowableBufferDX11<T>::IsRingMode()
+{
+	return( m_bRingMode );
+}
+//--------------------------------------------------------------------------------
+template <class T>
+unsigned int TGrowableBufferDX11<T>::GetUploadOffset()
+{
+	return( m_uiUploadOffset );
+}
+//--------------------------------------------------------------------------------
+template <class T>
+unsigned int TGrowableBufferDX11<T>::GetReallocationCount()
+{
+	return( m_uiReallocations );
+}
+//--------------------------------------------------------------------------------
+template <class T>
+unsigned long long TGrowableBufferDX11<T>::GetBytesCopied()
+{
+	return( m_ullBytesCopied );
+}
+//--------------------------------------------------------------------------------
+template <class T>
+unsigned int TGrowableBufferDX11<T>::GetResourceCreationCount()
+{
+	return( m_uiResourceCreations );
+}
+//--------------------------------------------------------------------------------
+template <class T>
+void TGrowableBufferDX11<T>::ResetCounters()
+{
+	m_uiReallocations = 0;
+	m_ullBytesCopied = 0;
+	m_uiResourceCreations = 0;
+}
+//--------------------------------------------------------------------------------
 //template <class T>
 //ResourcePtr TGrowableBufferDX11<T>::GetBuffer()
 //{
@@ -25,22 +25,15 @@ TGrowableIndexBufferDX11<T>::~TGrowableIndexBufferDX11()
 template <class T>
 void TGrowableIndexBufferDX11<T>::UploadData( PipelineManagerDX11* pPipeline )
 {
+	EnsureResource( );
+
 	if ( m_uiElementCount > 0 && m_bUploadNeeded == true ) {
 
 		m_bUploadNeeded = false;
 
-		// Map the index buffer for writing
-
-		D3D11_MAPPED_SUBRESOURCE resource = 
-			pPipeline->MapResource( m_IB, 0, D3D11_MAP_WRITE_DISCARD, 0 );
-
-		// Only copy as much of the data as you actually have filled up
-	
-		memcpy( resource.pData, m_pDataArray, m_uiElementCount * sizeof( T ) );
-
-		// Unmap the index buffer
+		// Map the index buffer for writing, and copy the data into it
 
-		pPipeline->UnMapResource( m_IB, 0 );
+		UploadElements( pPipeline, m_IB );
 	}
 }
 //--------------------------------------------------------------------------------
@@ -26,6 +26,8 @@ TGrowableStructuredBufferDX11<T>::~TGrowableStructuredBufferDX11()
 template <class T>
 void TGrowableStructuredBufferDX11<T>::UploadData( PipelineManagerDX11* pPipeline )
 {
+	EnsureResource( );
+
 	if ( m_uiElementCount > 0 && m_bUploadNeeded == true ) {
 
 		m_bUploadNeeded = false;
@@ -61,13 +63,13 @@ void TGrowableStructuredBufferDX11<T>::CreateResource( unsigned int elements )
 	// Create the new structured buffers according to the new size.
 
 	BufferConfigDX11 sbuffer;
-	sbuffer.SetDefaultStructuredBuffer( m_uiMaxElementCount * sizeof( T ), true );
+	sbuffer.SetDefaultStructuredBuffer( elements * sizeof( T ), true );
 	sbuffer.SetUsage( D3D11_USAGE_STAGING );
 	sbuffer.SetBindFlags( 0 );
 	sbuffer.SetCPUAccessFlags( D3D11_CPU_ACCESS_WRITE );
 	m_CPUBuffer = RendererDX11::Get()->CreateStructuredBuffer( &sbuffer, nullptr );
 
-	sbuffer.SetDefaultStructuredBuffer( m_uiMaxElementCount * sizeof( T ), true );
+	sbuffer.SetDefaultStructuredBuffer( elements * sizeof( T ), true );
 	sbuffer.SetBindFlags( D3D11_BIND_SHADER_RESOURCE );
 	m_GPUBuffer = RendererDX11::Get()->CreateStructuredBuffer( &sbuffer, nullptr );
 }
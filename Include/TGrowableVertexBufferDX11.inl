@@ -25,22 +25,15 @@ TGrowableVertexBufferDX11<T>::~TGrowableVertexBufferDX11()
 template <class T>
 void TGrowableVertexBufferDX11<T>::UploadData( PipelineManagerDX11* pPipeline )
 {
+	EnsureResource( );
+
 	if ( m_uiElementCount > 0 && m_bUploadNeeded == true ) {
 
 		m_bUploadNeeded = false;
 
-		// Map the vertex buffer for writing
-
-		D3D11_MAPPED_SUBRESOURCE resource = 
-			pPipeline->MapResource( m_VB, 0, D3D11_MAP_WRITE_DISCARD, 0 );
-
-		// Only copy as much of the data as you actually have filled up
-	
-		memcpy( resource.pData, m_pDataArray, m_uiElementCount * sizeof( T ) );
-
-		// Unmap the vertex buffer
+		// Map the vertex buffer for writing, and copy the data into it
 
-		pPipeline->UnMapResource( m_VB, 0 );
+		UploadElements( pPipeline, m_VB );
 	}
 }
 //--------------------------------------------------------------------------------
@@ -11,11 +11,17 @@
 //--------------------------------------------------------------------------------
 // TStateArrayMonitor
 //
+// The array monitor keeps a bitmask of the slots that differ from the sister
+// state, which is updated as each slot is set.  The range of changed slots is
+// found by scanning for the lowest and highest set bits of the mask, without
+// comparing the slots against the sister again.  The runs of changed slots are
+// coalesced into this one range, so that a stage binds them with a single
+// call, and the unchanged slots in between are bound along with them.
 //--------------------------------------------------------------------------------
 #ifndef TStateArrayMonitor_h
 #define TStateArrayMonitor_h
 //--------------------------------------------------------------------------------
-
+#include "GlyphBits.h"
 //--------------------------------------------------------------------------------
 namespace Glyph3
 {
@@ -45,13 +51,13 @@ namespace Glyph3
 
 	private:
 
-		void SearchFromBelow();
-		void SearchFromAbove();
+		enum { WordBits = 32, WordCount = ( N + WordBits - 1 ) / WordBits };
+
+		void SetChanged( unsigned int slot, bool changed );
+		void SetAllChanged();
 
-		// The monitoring varaibles
-		unsigned int m_uiStartSlot;
-		unsigned int m_uiEndSlot;
-		bool m_bUploadNeeded;
+		// The monitoring variables, with one bit for each slot
+		unsigned int m_auiChanged[WordCount];
 
 		// The state data
 		T m_InitialState;
@@ -11,9 +11,6 @@
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
 TStateArrayMonitor<T,N>::TStateArrayMonitor( T initialState ) : 
-	m_uiStartSlot( 0 ),
-	m_uiEndSlot( 0 ),
-	m_bUploadNeeded( false ),
 	m_InitialState( initialState ),
 	m_pSister( nullptr )
 {
@@ -47,135 +44,38 @@ void TStateArrayMonitor<T,N>::SetState( unsigned int slot, T state )
 
 	if ( m_pSister == nullptr )
 	{
-		m_bUploadNeeded = true;
-		m_uiStartSlot = 0;
-		m_uiEndSlot = N-1;
-
+		SetAllChanged();
 		return;
 	}
 
-	// Our actions will depend on if this new state matches the sister state or not.
-
-	bool bSameAsSister = SameAsSister( slot );
-
-
-	// Begin by checking if any states changes are already pending.  If not, then if
-	// the current state change differs from the sister state, then we have a new 
-	// start and end slot.
-
-	if ( !m_bUploadNeeded && !bSameAsSister )
-	{
-		m_bUploadNeeded = true;
-		m_uiStartSlot = slot;
-		m_uiEndSlot = slot;
-	}
+	// Each slot has its own bit, so only the slot that was set needs to be
+	// compared.  Setting a slot back to the sister's state clears its bit.
 
-
-	// If there is already an upload needed, then we need to update the status of
-	// our list.
-
-	if ( m_bUploadNeeded )
-	{
-		// Updating slot below the current range
-		if ( slot < m_uiStartSlot )
-		{
-			// If the slot is lower than our current start slot, then if the state is
-			// different we should consider this the new start state.
-			if ( !bSameAsSister ) {
-				m_uiStartSlot = slot;
-			}
-		}
-		// Updating slot at the lower end point
-		else if ( slot == m_uiStartSlot )
-		{
-			// If the states don't match, then we retain the same starting slot.
-			// Otherwise, we search toward the end state and see if we can reduce
-			// the range of the states that need to be set.
-			if ( bSameAsSister ) {
-				SearchFromBelow();
-			}
-		}
-		// Updating slot inside the current range
-		else if ( m_uiStartSlot < slot && slot < m_uiEndSlot ) 
-		{
-			// If the change is between our two endpoints, it doesn't matter.  
-			// Regardless of if they are the same or not, we still have to bind
-			// the same number of states anyways.
-		}
-		// Updating slot at the upper end point
-		else if ( slot == m_uiEndSlot )
-		{
-			// If the states don't match, then we retain the same ending slot.
-			// Otherwise, we search toward the start slot and see if we can reduce
-			// the range of the states that need to be set.
-			if ( bSameAsSister ) {
-				SearchFromAbove();
-			}
-		}
-		// Updating slot above the current range
-		else if ( m_uiEndSlot < slot )
-		{
-			// If the slot is lower than our current start slot, then if the state is
-			// different we should consider this the new start state.
-			if ( !bSameAsSister ) {
-				m_uiEndSlot = slot;
-			}
-		}
-	}
+	SetChanged( slot, !SameAsSister( slot ) );
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
-void TStateArrayMonitor<T,N>::SearchFromBelow()
+void TStateArrayMonitor<T,N>::SetChanged( unsigned int slot, bool changed )
 {
-	// Here we start from the current start slot location, and iterate upward
-	// until we encounter the end slot.  As soon as we find a difference, we
-	// terminate the iteration, which will automatically make the start slot update
-	// to the appropriate location.
-	//
-	// Note that the iteration will not allow the StartSlot and EndSlot to go past
-	// eachother.  Instead, they can end at the same location, and then the final
-	// check is made after the loop to see if that last slot is the same or not.
+	const unsigned int bit = 1u << ( slot % WordBits );
 
-	for ( ; m_uiStartSlot < m_uiEndSlot; m_uiStartSlot++ )
-	{
-		if ( !SameAsSister( m_uiStartSlot ) )
-			break;
-	}
-
-	// If no differences have been found, we compare the last available slot.  If
-	// they are the same, we update the status to reflect that.  This means 
-	// resetting the update flag and the slot markers.
-	
-	if ( m_uiStartSlot == m_uiEndSlot && SameAsSister( m_uiStartSlot ) ) {
-		ResetTracking();
-	}
+	if ( changed )
+		m_auiChanged[slot / WordBits] |= bit;
+	else
+		m_auiChanged[slot / WordBits] &= ~bit;
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
-void TStateArrayMonitor<T,N>::SearchFromAbove()
+void TStateArrayMonitor<T,N>::SetAllChanged()
 {
-	// Here we start from the current end slot location, and iterate downward
-	// until we encounter the start slot.  As soon as we find a difference, we
-	// terminate the iteration, which will automatically make the end slot update
-	// to the appropriate location.
-	//
-	// Note that the iteration will not allow the StartSlot and EndSlot to go past
-	// eachother.  Instead, they can end at the same location, and then the final
-	// check is made after the loop to see if that last slot is the same or not.
+	// The bits past the last slot are kept clear, so that the range never ends
+	// past the last slot.
 
-	for ( ; m_uiEndSlot > m_uiStartSlot; m_uiEndSlot-- )
-	{
-		if ( !SameAsSister( m_uiEndSlot ) )
-			break;
-	}
+	for ( unsigned int i = 0; i < WordCount; i++ )
+		m_auiChanged[i] = 0xffffffff;
 
-	// If no differences have been found, we compare the last available slot.  If
-	// they are the same, we update the status to reflect that.  This means 
-	// resetting the update flag and the slot markers.
-	
-	if ( m_uiStartSlot == m_uiEndSlot && SameAsSister( m_uiEndSlot ) ) {
-		ResetTracking();
-	}
+	if ( N % WordBits != 0 )
+		m_auiChanged[WordCount-1] = ( 1u << ( N % WordBits ) ) - 1;
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
@@ -189,25 +89,43 @@ bool TStateArrayMonitor<T,N>::SameAsSister( unsigned int slot )
 template <class T, unsigned int N>
 bool TStateArrayMonitor<T,N>::IsUpdateNeeded()
 {
-	return( m_bUploadNeeded );
+	for ( unsigned int i = 0; i < WordCount; i++ ) {
+		if ( m_auiChanged[i] != 0 )
+			return( true );
+	}
+
+	return( false );
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
 unsigned int TStateArrayMonitor<T,N>::GetStartSlot()
 {
-	return( m_uiStartSlot );
+	// Without any changes, the range is the first slot (as it was before the
+	// changes were tracked with the bitmask).
+
+	for ( unsigned int i = 0; i < WordCount; i++ ) {
+		if ( m_auiChanged[i] != 0 )
+			return( i * WordBits + GlyphLowestBit( m_auiChanged[i] ) );
+	}
+
+	return( 0 );
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
 unsigned int TStateArrayMonitor<T,N>::GetEndSlot()
 {
-	return( m_uiEndSlot );
+	for ( unsigned int i = WordCount; i > 0; i-- ) {
+		if ( m_auiChanged[i-1] != 0 )
+			return( ( i - 1 ) * WordBits + GlyphHighestBit( m_auiChanged[i-1] ) );
+	}
+
+	return( 0 );
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
 unsigned int TStateArrayMonitor<T,N>::GetRange()
 {
-	return( m_uiEndSlot - m_uiStartSlot + 1 );
+	return( GetEndSlot() - GetStartSlot() + 1 );
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
@@ -220,9 +138,8 @@ void TStateArrayMonitor<T,N>::InitializeStates()
 template <class T, unsigned int N>
 void TStateArrayMonitor<T,N>::ResetTracking()
 {
-	m_uiStartSlot = 0;
-	m_uiEndSlot = 0;
-	m_bUploadNeeded = false;
+	for ( unsigned int i = 0; i < WordCount; i++ )
+		m_auiChanged[i] = 0;
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
@@ -236,7 +153,7 @@ T TStateArrayMonitor<T,N>::GetState( unsigned int slot ) const
 template <class T, unsigned int N>
 T* TStateArrayMonitor<T,N>::GetFirstSlotLocation()
 {
-	return( &m_States[m_uiStartSlot] );
+	return( &m_States[GetStartSlot()] );
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
@@ -0,0 +1,102 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// TStateCacheDX11
+//
+// The state cache maps the configuration of a state object to the index of the
+// state object that was created for it, so that each distinct configuration is
+// only created once.  It is an open addressing hash table with linear probing,
+// which stores the hash of each configuration next to it.  A lookup then only
+// compares the configurations whose hashes match, and usually touches a single
+// entry.
+//
+// The key type needs an operator== and a HashState function, which are declared
+// next to each of the state configuration classes.  Both have to compare the
+// members individually, since the D3D11 descriptions contain padding bytes.
+// The hits and misses of the lookups are counted, which shows how often the
+// states are requested compared to how often they actually have to be created.
+//--------------------------------------------------------------------------------
+#ifndef TStateCacheDX11_h
+#define TStateCacheDX11_h
+//--------------------------------------------------------------------------------
+#include <vector>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	// The HashState functions are built from these steps, which mix in a whole
+	// member at a time (every member of the D3D11 descriptions fits in 32 bits).
+
+	inline unsigned int HashStateValue( unsigned int hash, unsigned int value )
+	{
+		hash = ( hash ^ value ) * 0x9e3779b1u;
+
+		return( hash ^ ( hash >> 16 ) );
+	}
+
+	inline unsigned int HashStateValue( unsigned int hash, float value )
+	{
+		// Positive and negative zero compare as equal, so they have to produce
+		// the same hash as well.
+
+		unsigned int bits = 0;
+
+		if ( value != 0.0f ) {
+			memcpy( &bits, &value, sizeof( bits ) );
+		}
+
+		return( HashStateValue( hash, bits ) );
+	}
+
+	const unsigned int StateHashSeed = 2166136261u;
+
+	template <class TKey>
+	class TStateCacheDX11
+	{
+	public:
+		TStateCacheDX11();
+		~TStateCacheDX11();
+
+		// Returns the index that was stored for the key, or -1 if there is none.
+
+		int Find( const TKey& key );
+		void Insert( const TKey& key, int index );
+		void Clear();
+
+		unsigned int GetCount() const;
+		unsigned int GetHits() const;
+		unsigned int GetMisses() const;
+		void ResetStatistics();
+
+	private:
+		struct Entry
+		{
+			TKey			Key;
+			unsigned int	Hash;
+			int				Index;
+		};
+
+		void Grow();
+
+		// The number of entries is always a power of two (or zero), and an
+		// index of -1 marks an empty entry.
+
+		std::vector<Entry>	m_Entries;
+		unsigned int		m_uiCount;
+
+		unsigned int		m_uiHits;
+		unsigned int		m_uiMisses;
+	};
+
+#include "TStateCacheDX11.inl"
+};
+//--------------------------------------------------------------------------------
+#endif // TStateCacheDX11_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,135 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+template <class TKey>
+TStateCacheDX11<TKey>::TStateCacheDX11() :
+	m_uiCount( 0 ),
+	m_uiHits( 0 ),
+	m_uiMisses( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+template <class TKey>
+TStateCacheDX11<TKey>::~TStateCacheDX11()
+{
+}
+//--------------------------------------------------------------------------------
+template <class TKey>
+int TStateCacheDX11<TKey>::Find( const TKey& key )
+{
+	if ( m_uiCount > 0 ) {
+
+		const unsigned int hash = HashState( key );
+		const unsigned int mask = static_cast<unsigned int>( m_Entries.size() ) - 1;
+
+		// Probe from the home position of the hash until an empty entry is
+		// found, since the table is never allowed to fill up completely.
+
+		for ( unsigned int i = hash & mask; m_Entries[i].Index != -1; i = ( i + 1 ) & mask ) {
+			if ( m_Entries[i].Hash == hash && m_Entries[i].Key == key ) {
+				m_uiHits++;
+				return( m_Entries[i].Index );
+			}
+		}
+	}
+
+	m_uiMisses++;
+
+	return( -1 );
+}
+//--------------------------------------------------------------------------------
+template <class TKey>
+void TStateCacheDX11<TKey>::Insert( const TKey& key, int index )
+{
+	// Keep the load factor at or below 3/4, so that the probe sequences stay
+	// short.
+
+	if ( ( m_uiCount + 1 ) * 4 > m_Entries.size() * 3 ) {
+		Grow();
+	}
+
+	const unsigned int hash = HashState( key );
+	const unsigned int mask = static_cast<unsigned int>( m_Entries.size() ) - 1;
+
+	unsigned int i = hash & mask;
+
+	while ( m_Entries[i].Index != -1 ) {
+		i = ( i + 1 ) & mask;
+	}
+
+	m_Entries[i].Key = key;
+	m_Entries[i].Hash = hash;
+	m_Entries[i].Index = index;
+
+	m_uiCount++;
+}
+//--------------------------------------------------------------------------------
+template <class TKey>
+void TStateCacheDX11<TKey>::Grow()
+{
+	std::vector<Entry> entries( m_Entries.empty() ? 16 : m_Entries.size() * 2 );
+
+	for ( auto& entry : entries ) {
+		entry.Index = -1;
+	}
+
+	const unsigned int mask = static_cast<unsigned int>( entries.size() ) - 1;
+
+	// The stored hashes are reused, so the keys don't need to be hashed again.
+
+	for ( auto& entry : m_Entries ) {
+		if ( entry.Index != -1 ) {
+
+			unsigned int i = entry.Hash & mask;
+
+			while ( entries[i].Index != -1 ) {
+				i = ( i + 1 ) & mask;
+			}
+
+			entries[i] = entry;
+		}
+	}
+
+	m_Entries.swap( entries );
+}
+//--------------------------------------------------------------------------------
+template <class TKey>
+void TStateCacheDX11<TKey>::Clear()
+{
+	m_Entries.clear();
+	m_uiCount = 0;
+}
+//--------------------------------------------------------------------------------
+template <class TKey>
+unsigned int TStateCacheDX11<TKey>::GetCount() const
+{
+	return( m_uiCount );
+}
+//--------------------------------------------------------------------------------
+template <class TKey>
+unsigned int TStateCacheDX11<TKey>::GetHits() const
+{
+	return( m_uiHits );
+}
+//--------------------------------------------------------------------------------
+template <class TKey>
+unsigned int TStateCacheDX11<TKey>::GetMisses() const
+{
+	return( m_uiMisses );
+}
+//--------------------------------------------------------------------------------
+template <class TKey>
+void TStateCacheDX11<TKey>::ResetStatistics()
+{
+	m_uiHits = 0;
+	m_uiMisses = 0;
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,283 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// TextScanner
+//
+// A small scanner for line based text file formats, which reads numbers and
+// keywords directly from a range of characters (i.e. a memory mapped file).  The
+// range doesn't need to be null terminated, and nothing is allocated or copied
+// while scanning.  The number conversions are hand written instead of using the
+// stream operators or the C library, which keeps them independent of the locale
+// and avoids copying every token into a string first.
+//--------------------------------------------------------------------------------
+#ifndef TextScanner_h
+#define TextScanner_h
+//--------------------------------------------------------------------------------
+#include <string>
+#include <math.h>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class TextScanner
+	{
+	public:
+		TextScanner( const char* pBegin, const char* pEnd ) :
+			m_pCursor( pBegin ), m_pEnd( pEnd )
+		{
+		}
+
+		bool AtEnd() const
+		{
+			return( m_pCursor >= m_pEnd );
+		}
+
+		bool AtLineEnd() const
+		{
+			return( m_pCursor >= m_pEnd || *m_pCursor == '\n' || *m_pCursor == '\r' );
+		}
+
+		const char* GetPosition() const
+		{
+			return( m_pCursor );
+		}
+
+		char Peek() const
+		{
+			return( m_pCursor < m_pEnd ? *m_pCursor : 0 );
+		}
+
+		// Skips spaces and tabs, but not line endings.
+
+		void SkipSpaces()
+		{
+			while ( m_pCursor < m_pEnd && ( *m_pCursor == ' ' || *m_pCursor == '\t' ) )
+				m_pCursor++;
+		}
+
+		// Skips all whitespace, including line endings.
+
+		void SkipWhitespace()
+		{
+			while ( m_pCursor < m_pEnd && ( *m_pCursor == ' ' || *m_pCursor == '\t' || *m_pCursor == '\r' || *m_pCursor == '\n' ) )
+				m_pCursor++;
+		}
+
+		// Skips the rest of the current token, up to the next whitespace.
+
+		void SkipToken()
+		{
+			while ( m_pCursor < m_pEnd && *m_pCursor != ' ' && *m_pCursor != '\t' && *m_pCursor != '\r' && *m_pCursor != '\n' )
+				m_pCursor++;
+		}
+
+		// Moves to the first character after the end of the current line.
+
+		void NextLine()
+		{
+			while ( m_pCursor < m_pEnd && *m_pCursor != '\n' )
+				m_pCursor++;
+
+			if ( m_pCursor < m_pEnd )
+				m_pCursor++;
+		}
+
+		// Consumes the given character if it is the next one.
+
+		bool Match( char c )
+		{
+			if ( m_pCursor < m_pEnd && *m_pCursor == c )
+			{
+				m_pCursor++;
+				return( true );
+			}
+
+			return( false );
+		}
+
+		// Consumes the given keyword if it is the next word, i.e. if it is followed
+		// by whitespace or the end of the range.
+
+		bool MatchKeyword( const char* pKeyword )
+		{
+			const char* p = m_pCursor;
+
+			while ( *pKeyword )
+			{
+				if ( p >= m_pEnd || *p != *pKeyword )
+					return( false );
+				p++;
+				pKeyword++;
+			}
+
+			if ( p < m_pEnd && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n' )
+				return( false );
+
+			m_pCursor = p;
+			return( true );
+		}
+
+		// Returns the rest of the current line without leading spaces and the
+		// line ending, and moves to the next line.
+
+		std::string ReadLine()
+		{
+			SkipSpaces();
+
+			const char* pBegin = m_pCursor;
+
+			while ( m_pCursor < m_pEnd && *m_pCursor != '\n' )
+				m_pCursor++;
+
+			const char* pLineEnd = m_pCursor;
+
+			while ( pLineEnd > pBegin && ( pLineEnd[-1] == '\r' || pLineEnd[-1] == ' ' || pLineEnd[-1] == '\t' ) )
+				pLineEnd--;
+
+			NextLine();
+
+			return( std::string( pBegin, pLineEnd ) );
+		}
+
+		// Reads a signed decimal integer, after skipping any spaces.
+
+		bool ReadInt( int& value )
+		{
+			SkipSpaces();
+
+			const char* p = m_pCursor;
+			bool negative = false;
+
+			if ( p < m_pEnd && ( *p == '-' || *p == '+' ) )
+				negative = ( *p++ == '-' );
+
+			if ( p >= m_pEnd || !IsDigit( *p ) )
+				return( false );
+
+			int result = 0;
+
+			while ( p < m_pEnd && IsDigit( *p ) )
+				result = result * 10 + ( *p++ - '0' );
+
+			value = negative ? -result : result;
+			m_pCursor = p;
+
+			return( true );
+		}
+
+		// Reads a decimal floating point number with an optional exponent, after
+		// skipping any spaces.  Up to 19 significant digits are accumulated in an
+		// integer and scaled once, which is more than enough for float values.
+
+		bool ReadFloat( float& value )
+		{
+			SkipSpaces();
+
+			const char* p = m_pCursor;
+			bool negative = false;
+
+			if ( p < m_pEnd && ( *p == '-' || *p == '+' ) )
+				negative = ( *p++ == '-' );
+
+			unsigned long long mantissa = 0;
+			int digits = 0;
+			int exponent = 0;
+			bool valid = false;
+
+			for ( ; p < m_pEnd && IsDigit( *p ); p++, valid = true )
+			{
+				if ( digits < 19 )
+				{
+					mantissa = mantissa * 10 + ( *p - '0' );
+					if ( mantissa ) digits++;
+				}
+				else
+				{
+					exponent++;
+				}
+			}
+
+			if ( p < m_pEnd && *p == '.' )
+			{
+				p++;
+
+				for ( ; p < m_pEnd && IsDigit( *p ); p++, valid = true )
+				{
+					if ( digits < 19 )
+					{
+						mantissa = mantissa * 10 + ( *p - '0' );
+						if ( mantissa ) digits++;
+						exponent--;
+					}
+				}
+			}
+
+			if ( !valid )
+				return( false );
+
+			if ( p < m_pEnd && ( *p == 'e' || *p == 'E' ) )
+			{
+				const char* pExponent = p + 1;
+				bool negativeExponent = false;
+
+				if ( pExponent < m_pEnd && ( *pExponent == '-' || *pExponent == '+' ) )
+					negativeExponent = ( *pExponent++ == '-' );
+
+				if ( pExponent < m_pEnd && IsDigit( *pExponent ) )
+				{
+					int e = 0;
+
+					while ( pExponent < m_pEnd && IsDigit( *pExponent ) )
+					{
+						if ( e < 10000 ) e = e * 10 + ( *pExponent - '0' );
+						pExponent++;
+					}
+
+					exponent += negativeExponent ? -e : e;
+					p = pExponent;
+				}
+			}
+
+			double result = static_cast<double>( mantissa );
+
+			if ( exponent != 0 && mantissa != 0 )
+			{
+				// Powers of ten up to 1e22 are exact in a double, so the common
+				// cases only need a single multiplication or division.
+
+				static const double powers[] = {
+					1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+					1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+				if ( exponent > 0 )
+					result = ( exponent <= 22 ) ? result * powers[exponent] : result * pow( 10.0, exponent );
+				else
+					result = ( exponent >= -22 ) ? result / powers[-exponent] : result * pow( 10.0, exponent );
+			}
+
+			value = static_cast<float>( negative ? -result : result );
+			m_pCursor = p;
+
+			return( true );
+		}
+
+	private:
+		static bool IsDigit( char c )
+		{
+			return( c >= '0' && c <= '9' );
+		}
+
+		const char*	m_pCursor;
+		const char*	m_pEnd;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // TextScanner_h
+//--------------------------------------------------------------------------------
@@ -23,19 +23,46 @@
 //--------------------------------------------------------------------------------
 namespace Glyph3
 {
+	class TransformHierarchy;
+
 	class Transform3D
 	{
 	public:
 		Transform3D( );
+		Transform3D( const Transform3D& other );
 		~Transform3D( );
 
+		Transform3D& operator= ( const Transform3D& other );
+
 		Vector3f& Position( );
 		Matrix3f& Rotation( );
 		Vector3f& Scale( );
 
+		// The local and world matrices are only rebuilt when something that they
+		// depend on has changed.  The local matrix is compared against the 
+		// components it was last built from, and the world matrix tracks the 
+		// version of its parent's world matrix.  Invalidate() forces a complete
+		// rebuild on the next update, and is needed when re-parenting.
+
 		void UpdateLocal( );
+		void UpdateWorld( const Transform3D& parent );
 		void UpdateWorld( const Matrix4f& parent );
 		void UpdateWorld( );
+		void Invalidate( );
+
+		bool LocalChanged( ) const;
+		bool WorldChanged( ) const;
+		unsigned int WorldVersion( ) const;
+
+		// A transform can be bound to a slot of a TransformHierarchy, in which
+		// case its local and world matrices live in the hierarchy's contiguous
+		// arrays.  While bound, the world matrix multiply is deferred to the
+		// hierarchy's batched update, and only the change tracking is done here.
+
+		void Bind( TransformHierarchy* pHierarchy, unsigned int slot, Matrix4f* pLocal, Matrix4f* pWorld );
+		void Unbind( );
+		bool IsBound( ) const;
+		TransformHierarchy* GetHierarchy( ) const;
 
 		const Matrix4f& LocalMatrix( ) const;
 		const Matrix4f& WorldMatrix( ) const;
@@ -59,6 +86,22 @@ namespace Glyph3
 		Matrix4f m_mWorld;			// with the new local matrix and the entity's parent
 		Matrix4f m_mLocal;			// world matrix.
 
+		Vector3f m_vLastTranslation;	// The components that the current local
+		Matrix3f m_mLastRotation;		// matrix was built from, used to detect
+		Vector3f m_vLastScale;			// modifications through the accessors.
+
+		unsigned int m_uiWorldVersion;	// Incremented whenever the world matrix changes.
+		unsigned int m_uiParentVersion;	// The parent world version used for m_mWorld.
+
+		bool m_bInvalid;
+		bool m_bLocalChanged;
+		bool m_bWorldChanged;
+
+		Matrix4f* m_pLocal;				// Point to the member matrices above, or into
+		Matrix4f* m_pWorld;				// the storage of the bound hierarchy.
+
+		TransformHierarchy* m_pHierarchy;
+		unsigned int m_uiSlot;
 	};
 };
 //--------------------------------------------------------------------------------
@@ -0,0 +1,72 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// TransformHierarchy
+//
+// The transform hierarchy is an optional, data oriented storage for the 
+// transforms of a scene graph.  It flattens the graph into arrays of local and
+// world matrices that are ordered so that a parent always precedes its children,
+// and then binds each Transform3D to its slot.  The transforms keep working 
+// through their normal interface, but the world matrix multiplies are performed
+// in a single linear sweep over the arrays with SIMD instructions instead of 
+// during the recursive graph traversal.
+//
+// The flattened order is only valid for the graph structure that it was built
+// from.  Attaching or detaching children below a bound node marks the hierarchy
+// as stale, and it must be rebuilt before its next update.
+//--------------------------------------------------------------------------------
+#ifndef TransformHierarchy_h
+#define TransformHierarchy_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "Matrix4f.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class Node3D;
+	class Transform3D;
+
+	class TransformHierarchy
+	{
+	public:
+		TransformHierarchy( );
+		~TransformHierarchy( );
+
+		void Build( Node3D* pRoot );
+		void Clear( );
+
+		// Performs the deferred world matrix multiplies for all of the slots that
+		// were flagged as changed during the most recent graph update.
+
+		void UpdateWorld( );
+
+		void SetChanged( unsigned int slot, bool changed );
+		void Remove( unsigned int slot );
+		void MarkStale( );
+		bool IsStale( ) const;
+
+		unsigned int GetCount( ) const;
+
+	protected:
+		void AddSlot( Transform3D* pTransform, int parent );
+
+		std::vector<Transform3D*>		m_Transforms;
+		std::vector<int>				m_Parents;
+		std::vector<unsigned char>		m_Changed;
+		std::vector<Matrix4f>			m_Locals;
+		std::vector<Matrix4f>			m_Worlds;
+
+		bool m_bStale;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // TransformHierarchy_h
+//--------------------------------------------------------------------------------
\ No newline at end of file
@@ -78,6 +78,8 @@ namespace Glyph3
 		float y;
 		float z;
 	};
+
+	#include "Vector3f.inl"
 };
 //----------------------------------------------------------------------------------------------------
 #endif // Vector3f_h
@@ -0,0 +1,259 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------
+inline Vector3f::Vector3f( )
+{
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector3f::Vector3f( float X, float Y, float Z )
+{
+	x = X;
+	y = Y;
+	z = Z;
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector3f::Vector3f( const Vector3f& Vector )
+{
+	x = Vector.x;
+	y = Vector.y;
+	z = Vector.z;
+}
+//----------------------------------------------------------------------------------------------------
+inline void Vector3f::MakeZero( )
+{
+	x = 0.0f;
+	y = 0.0f;
+	z = 0.0f;
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector3f Vector3f::Cross( const Vector3f& Vector ) const
+{
+	Vector3f vRet; 
+	
+	vRet.x = y * Vector.z - z * Vector.y;
+	vRet.y = z * Vector.x - x * Vector.z;
+	vRet.z = x * Vector.y - y * Vector.x;
+	
+	return( vRet );
+}
+//----------------------------------------------------------------------------------------------------
+inline float Vector3f::Dot( const Vector3f& Vector ) const
+{
+	float ret = 0.0f;
+	
+	ret  = x * Vector.x;
+	ret += y * Vector.y;
+	ret += z * Vector.z;
+
+	return ret;
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector3f& Vector3f::operator= ( const Vector3f& Vector )
+{
+	x = Vector.x;
+	y = Vector.y;
+	z = Vector.z;
+
+    return( *this );
+}
+//----------------------------------------------------------------------------------------------------
+inline float Vector3f::operator[] ( int iPos ) const
+{
+	if ( iPos == 0 ) return( x );
+	if ( iPos == 1 ) return( y );
+	return( z );
+}
+//----------------------------------------------------------------------------------------------------
+inline float& Vector3f::operator[] ( int iPos )
+{
+	if ( iPos == 0 ) return( x );
+	if ( iPos == 1 ) return( y );
+	return( z );
+}
+//----------------------------------------------------------------------------------------------------
+inline bool Vector3f::operator== ( const Vector3f& Vector ) const
+{
+
+	if ( ( x - Vector.x ) * ( x - Vector.x ) > 0.01f )
+		return false;
+	if ( ( y - Vector.y ) * ( y - Vector.y ) > 0.01f )
+		return false;
+	if ( ( z - Vector.z ) * ( z - Vector.z ) > 0.01f )
+		return false;
+
+	return true;
+}
+//----------------------------------------------------------------------------------------------------
+inline bool Vector3f::operator!= ( const Vector3f& Vector ) const
+{
+    return( !( *this == Vector ) );
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector3f Vector3f::operator+ ( const Vector3f& Vector ) const
+{
+	Vector3f sum;
+
+	sum.x = x + Vector.x;
+	sum.y = y + Vector.y;
+	sum.z = z + Vector.z;
+
+	return( sum );
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector3f Vector3f::operator- ( const Vector3f& Vector ) const
+{
+	Vector3f diff;
+
+	diff.x = x - Vector.x;
+	diff.y = y - Vector.y;
+	diff.z = z - Vector.z;
+
+	return( diff );
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector3f Vector3f::operator* ( float fScalar ) const
+{
+	Vector3f prod;
+
+	prod.x = x * fScalar;
+	prod.y = y * fScalar;
+	prod.z = z * fScalar;
+
+	return( prod );
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector3f Vector3f::operator* ( const Vector3f& Vector ) const
+{
+    Vector3f prod;
+
+    prod.x = x * Vector.x;
+    prod.y = y * Vector.y;
+    prod.z = z * Vector.z;
+
+    return( prod );
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector3f Vector3f::operator/ ( float fScalar ) const
+{
+	Vector3f quot;
+	if ( fScalar != 0.0f )
+	{
+		float fInvScalar = 1.0f / fScalar;
+		quot.x = x * fInvScalar;
+		quot.y = y * fInvScalar;
+		quot.z = z * fInvScalar;
+	}
+	else
+	{
+		quot.MakeZero();
+	}
+
+	return( quot );
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector3f Vector3f::operator/ ( const Vector3f& Vector ) const
+{
+    Vector3f quot;
+    quot.x = Vector.x != 0.0f ? x / Vector.x : 0.0f;
+    quot.y = Vector.y != 0.0f ? y / Vector.y : 0.0f;
+    quot.z = Vector.z != 0.0f ? z / Vector.z : 0.0f;
+
+    return( quot );
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector3f Vector3f::operator- ( ) const
+{
+	Vector3f neg;
+
+	neg.x = -x;
+	neg.y = -y;
+	neg.z = -z;
+
+	return( neg );
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector3f& Vector3f::operator+= ( const Vector3f& Vector )
+{
+	x += Vector.x;
+	y += Vector.y;
+	z += Vector.z;
+
+	return( *this );
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector3f& Vector3f::operator-= ( const Vector3f& Vector )
+{
+	x -= Vector.x;
+	y -= Vector.y;
+	z -= Vector.z;
+
+	return( *this );
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector3f& Vector3f::operator*= ( float fScalar )
+{
+	x *= fScalar;
+	y *= fScalar;
+	z *= fScalar;
+
+	return( *this );
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector3f& Vector3f::operator*= ( const Vector3f& Vector )
+{
+    x *= Vector.x;
+    y *= Vector.y;
+    z *= Vector.z;
+
+    return( *this );
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector3f& Vector3f::operator/= ( float fScalar )
+{
+	if ( fScalar != 0.0f )
+	{
+		float fInvScalar = 1.0f / fScalar;	
+		x *= fInvScalar;
+		y *= fInvScalar;
+		z *= fInvScalar;
+	}
+	else
+	{
+		MakeZero();
+	}
+
+	return( *this );
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector3f& Vector3f::operator/= ( const Vector3f& Vector )
+{
+    x = Vector.x != 0.0f ? x / Vector.x : 0.0f;
+    y = Vector.y != 0.0f ? y / Vector.y : 0.0f;
+    z = Vector.z != 0.0f ? z / Vector.z : 0.0f;
+
+    return( *this );
+}
+//----------------------------------------------------------------------------------------------------
+inline Vector3f Vector3f::Cross( const Vector3f& A, const Vector3f& B )
+{    
+    return A.Cross( B );
+}
+//----------------------------------------------------------------------------------------------------
+inline float Vector3f::Dot( const Vector3f& A, const Vector3f& B )
+{    
+    return A.Dot( B );
+}
+//----------------------------------------------------------------------------------------------------
+inline float Vector3f::LengthSq( const Vector3f& A )
+{
+    return Dot(A, A);
+}
+//----------------------------------------------------------------------------------------------------
@@ -77,6 +77,8 @@ namespace Glyph3
 		float z;
 		float w;
 	};
+
+	#include "Vector4f.inl"
 };
 //----------------------------------------------------------------------------------------------------
 #endif // Vector4f_h
@@ -12,6 +12,7 @@
 #include "PCH.h"
 #include "ActorGenerator.h"
 #include "GeometryLoaderDX11.h"
+#include "AssetCacheDX11.h"
 #include "GeometryGeneratorDX11.h"
 #include "MaterialGeneratorDX11.h"
 #include "ShaderResourceParameterDX11.h"
@@ -39,17 +40,24 @@ Actor* ActorGenerator::GenerateVisualizationTexture2D( RendererDX11& Renderer,
 	pActor->GetNode()->AttachChild( pFrame );
 	pActor->AddElement( pFrame );
 
-	// Create/load the geometry to put around the visualization (i.e. the picture frame)
-	GeometryPtr frameGeometry = GeometryLoaderDX11::loadMS3DFile2( std::wstring( L"ScreenFrame.ms3d" ) );
-	frameGeometry->LoadToBuffers();
+	// Create/load the geometry to put around the visualization (i.e. the picture frame).
+	// The geometry is shared through the asset cache by all of the generated actors.
+	GeometryPtr frameGeometry = AssetCacheDX11::Get().GetGeometry( L"ScreenFrame.ms3d", "ms3d buffers", []() {
+		GeometryPtr pGeometry = GeometryLoaderDX11::loadMS3DFileCached( std::wstring( L"ScreenFrame.ms3d" ) );
+		pGeometry->LoadToBuffers();
+		return( pGeometry );
+	} );
 	pFrame->Visual.SetGeometry( frameGeometry );
 		
 	// Create the material for the picture frame
 	pFrame->Visual.SetMaterial( MaterialGeneratorDX11::GeneratePhong( Renderer ) );
 
 	// Create/load the geometry to put the visualization on (i.e. the picture)
-	GeometryPtr screenGeometry = GeometryLoaderDX11::loadMS3DFile2( std::wstring( L"Screen.ms3d" ) );
-	screenGeometry->LoadToBuffers();
+	GeometryPtr screenGeometry = AssetCacheDX11::Get().GetGeometry( L"Screen.ms3d", "ms3d buffers", []() {
+		GeometryPtr pGeometry = GeometryLoaderDX11::loadMS3DFileCached( std::wstring( L"Screen.ms3d" ) );
+		pGeometry->LoadToBuffers();
+		return( pGeometry );
+	} );
 	pActor->GetBody()->Visual.SetGeometry( screenGeometry );
 
 	// Use the passed in material to render the visualization.  This allows for 
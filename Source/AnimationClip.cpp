@@ -0,0 +1,177 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "AnimationClip.h"
+#include "Tween.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	// The number of keys that a cursor is stepped forward before falling back
+	// to a binary search.
+
+	const unsigned int MAX_CURSOR_STEPS = 4;
+};
+//--------------------------------------------------------------------------------
+AnimationClip::AnimationClip()
+{
+	Clear();
+}
+//--------------------------------------------------------------------------------
+AnimationClip::~AnimationClip()
+{
+}
+//--------------------------------------------------------------------------------
+unsigned int AnimationClip::AddTrack( const std::vector<AnimationState<Vector3f>>& states )
+{
+	for ( auto& state : states )
+	{
+		m_Times.push_back( state.m_fTimeStamp );
+		m_Values.push_back( state.m_tData );
+	}
+
+	// The time range is taken from the first track with keys, and then widened
+	// by each of the following tracks.
+
+	if ( !states.empty() )
+	{
+		if ( m_Times.size() == states.size() ) {
+			m_fStartTime = states.front().m_fTimeStamp;
+			m_fEndTime = states.back().m_fTimeStamp;
+		} else {
+			m_fStartTime = min( m_fStartTime, states.front().m_fTimeStamp );
+			m_fEndTime = max( m_fEndTime, states.back().m_fTimeStamp );
+		}
+	}
+
+	m_TrackOffsets.push_back( static_cast<unsigned int>( m_Times.size() ) );
+
+	return( GetTrackCount() - 1 );
+}
+//--------------------------------------------------------------------------------
+void AnimationClip::Clear()
+{
+	m_TrackOffsets.clear();
+	m_TrackOffsets.push_back( 0 );
+	m_Times.clear();
+	m_Values.clear();
+
+	m_fStartTime = 0.0f;
+	m_fEndTime = 0.0f;
+}
+//--------------------------------------------------------------------------------
+unsigned int AnimationClip::GetTrackCount() const
+{
+	return( static_cast<unsigned int>( m_TrackOffsets.size() ) - 1 );
+}
+//--------------------------------------------------------------------------------
+unsigned int AnimationClip::GetKeyCount( unsigned int track ) const
+{
+	assert( track < GetTrackCount() );
+
+	return( m_TrackOffsets[track+1] - m_TrackOffsets[track] );
+}
+//--------------------------------------------------------------------------------
+float AnimationClip::GetStartTime() const
+{
+	return( m_fStartTime );
+}
+//--------------------------------------------------------------------------------
+float AnimationClip::GetEndTime() const
+{
+	return( m_fEndTime );
+}
+//--------------------------------------------------------------------------------
+unsigned int AnimationClip::FindKey( unsigned int track, float time ) const
+{
+	assert( track < GetTrackCount() );
+
+	const unsigned int first = m_TrackOffsets[track];
+	const unsigned int end = m_TrackOffsets[track+1];
+
+	if ( first == end ) {
+		return( 0 );
+	}
+
+	return( FindKeyInRange( first, end, time ) - first );
+}
+//--------------------------------------------------------------------------------
+unsigned int AnimationClip::FindKeyInRange( unsigned int first, unsigned int end, float time ) const
+{
+	const float* pTimes = m_Times.data();
+	const float* pKey = std::upper_bound( pTimes + first, pTimes + end, time );
+
+	if ( pKey == pTimes + first ) {
+		return( first );
+	}
+
+	return( static_cast<unsigned int>( pKey - pTimes ) - 1 );
+}
+//--------------------------------------------------------------------------------
+void AnimationClip::Sample( float time, unsigned int* pCursors, Vector3f* pResults ) const
+{
+	const unsigned int tracks = GetTrackCount();
+	const unsigned int* pOffsets = m_TrackOffsets.data();
+	const float* pTimes = m_Times.data();
+	const Vector3f* pValues = m_Values.data();
+
+	for ( unsigned int i = 0; i < tracks; i++ )
+	{
+		const unsigned int first = pOffsets[i];
+		const unsigned int end = pOffsets[i+1];
+
+		if ( first == end ) {
+			pResults[i].MakeZero();
+			continue;
+		}
+
+		const unsigned int last = end - 1;
+		unsigned int key = first + pCursors[i];
+
+		// Step the cursor forward while the time moves on steadily, and search
+		// for the key again if it jumps backwards or too far forward.
+
+		if ( key > last || pTimes[key] > time )
+		{
+			key = FindKeyInRange( first, end, time );
+		}
+		else
+		{
+			unsigned int steps = 0;
+
+			while ( key < last && pTimes[key+1] <= time && steps < MAX_CURSOR_STEPS ) {
+				key++;
+				steps++;
+			}
+
+			if ( key < last && pTimes[key+1] <= time ) {
+				key = FindKeyInRange( key, end, time );
+			}
+		}
+
+		pCursors[i] = key - first;
+
+		// Times outside of the keys are clamped to the first and last values.
+
+		if ( key == last || time <= pTimes[key] )
+		{
+			pResults[i] = pValues[key];
+		}
+		else
+		{
+			float interpolant = ( time - pTimes[key] ) / ( pTimes[key+1] - pTimes[key] );
+			pResults[i] = QuadraticInOut( pValues[key], pValues[key+1], interpolant );
+		}
+	}
+}
+//--------------------------------------------------------------------------------
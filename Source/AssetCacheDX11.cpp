@@ -0,0 +1,437 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "AssetCacheDX11.h"
+#include "RendererDX11.h"
+#include "Texture2dDX11.h"
+#include "Log.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	// Returns the number of bits per texel of the common texture formats, which
+	// is good enough for estimating the memory use of a texture.
+
+	unsigned int formatBits( DXGI_FORMAT format )
+	{
+		switch ( format )
+		{
+		case DXGI_FORMAT_BC1_TYPELESS:
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+		case DXGI_FORMAT_BC4_TYPELESS:
+		case DXGI_FORMAT_BC4_UNORM:
+		case DXGI_FORMAT_BC4_SNORM:
+			return( 4 );
+
+		case DXGI_FORMAT_BC2_TYPELESS:
+		case DXGI_FORMAT_BC2_UNORM:
+		case DXGI_FORMAT_BC2_UNORM_SRGB:
+		case DXGI_FORMAT_BC3_TYPELESS:
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB:
+		case DXGI_FORMAT_BC5_TYPELESS:
+		case DXGI_FORMAT_BC5_UNORM:
+		case DXGI_FORMAT_BC5_SNORM:
+		case DXGI_FORMAT_BC6H_TYPELESS:
+		case DXGI_FORMAT_BC6H_UF16:
+		case DXGI_FORMAT_BC6H_SF16:
+		case DXGI_FORMAT_BC7_TYPELESS:
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+		case DXGI_FORMAT_R8_TYPELESS:
+		case DXGI_FORMAT_R8_UNORM:
+		case DXGI_FORMAT_R8_UINT:
+		case DXGI_FORMAT_R8_SNORM:
+		case DXGI_FORMAT_R8_SINT:
+		case DXGI_FORMAT_A8_UNORM:
+			return( 8 );
+
+		case DXGI_FORMAT_R8G8_TYPELESS:
+		case DXGI_FORMAT_R8G8_UNORM:
+		case DXGI_FORMAT_R8G8_UINT:
+		case DXGI_FORMAT_R8G8_SNORM:
+		case DXGI_FORMAT_R8G8_SINT:
+		case DXGI_FORMAT_R16_TYPELESS:
+		case DXGI_FORMAT_R16_FLOAT:
+		case DXGI_FORMAT_D16_UNORM:
+		case DXGI_FORMAT_R16_UNORM:
+		case DXGI_FORMAT_R16_UINT:
+		case DXGI_FORMAT_R16_SNORM:
+		case DXGI_FORMAT_R16_SINT:
+		case DXGI_FORMAT_B5G6R5_UNORM:
+		case DXGI_FORMAT_B5G5R5A1_UNORM:
+			return( 16 );
+
+		case DXGI_FORMAT_R16G16B16A16_TYPELESS:
+		case DXGI_FORMAT_R16G16B16A16_FLOAT:
+		case DXGI_FORMAT_R16G16B16A16_UNORM:
+		case DXGI_FORMAT_R16G16B16A16_UINT:
+		case DXGI_FORMAT_R16G16B16A16_SNORM:
+		case DXGI_FORMAT_R16G16B16A16_SINT:
+		case DXGI_FORMAT_R32G32_TYPELESS:
+		case DXGI_FORMAT_R32G32_FLOAT:
+		case DXGI_FORMAT_R32G32_UINT:
+		case DXGI_FORMAT_R32G32_SINT:
+			return( 64 );
+
+		case DXGI_FORMAT_R32G32B32_TYPELESS:
+		case DXGI_FORMAT_R32G32B32_FLOAT:
+		case DXGI_FORMAT_R32G32B32_UINT:
+		case DXGI_FORMAT_R32G32B32_SINT:
+			return( 96 );
+
+		case DXGI_FORMAT_R32G32B32A32_TYPELESS:
+		case DXGI_FORMAT_R32G32B32A32_FLOAT:
+		case DXGI_FORMAT_R32G32B32A32_UINT:
+		case DXGI_FORMAT_R32G32B32A32_SINT:
+			return( 128 );
+
+		default:
+			return( 32 );
+		}
+	}
+};
+//--------------------------------------------------------------------------------
+AssetCacheDX11::AssetCacheDX11() :
+	m_ullBudget( 0 ),
+	m_ullUsage( 0 ),
+	m_uiHits( 0 ),
+	m_uiMisses( 0 ),
+	m_uiEvictions( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+AssetCacheDX11& AssetCacheDX11::Get()
+{
+	static AssetCacheDX11 cache;
+	return( cache );
+}
+//--------------------------------------------------------------------------------
+GeometryPtr AssetCacheDX11::GetGeometry( const std::wstring& filename, const std::string& options, const GeometryLoader& loader )
+{
+	Asset asset = Acquire( MakeKey( L"geometry", filename, options ), [&]() {
+		Asset loaded;
+		loaded.geometry = loader();
+		loaded.size = GeometrySize( loaded.geometry );
+		return( loaded );
+	} );
+
+	return( asset.geometry );
+}
+//--------------------------------------------------------------------------------
+ResourcePtr AssetCacheDX11::GetTexture( const std::wstring& filename, bool sRGB )
+{
+	return( GetTexture( filename, sRGB ? "srgb" : "", [&]() {
+		return( RendererDX11::Get()->LoadTexture( filename, sRGB ) );
+	} ) );
+}
+//--------------------------------------------------------------------------------
+ResourcePtr AssetCacheDX11::GetTexture( const std::wstring& filename, const std::string& options, const TextureLoader& loader )
+{
+	Asset asset = Acquire( MakeKey( L"texture", filename, options ), [&]() {
+		Asset loaded;
+		loaded.texture = loader();
+		loaded.size = TextureSize( loaded.texture );
+		return( loaded );
+	} );
+
+	return( asset.texture );
+}
+//--------------------------------------------------------------------------------
+AssetCacheDX11::Asset AssetCacheDX11::Acquire( const std::wstring& key, const std::function<Asset()>& loader )
+{
+	std::unique_lock<std::mutex> lock( m_Lock );
+
+	auto entry = m_Entries.find( key );
+
+	if ( entry != m_Entries.end() ) {
+		m_uiHits++;
+		m_LRU.splice( m_LRU.begin(), m_LRU, entry->second.lru );
+		return( entry->second.asset );
+	}
+
+	// If another thread is already loading the asset, wait for it to finish
+	// instead of loading the file a second time.
+
+	auto pending = m_Pending.find( key );
+
+	if ( pending != m_Pending.end() ) {
+		m_uiHits++;
+		std::shared_future<Asset> result = pending->second;
+		lock.unlock();
+		return( result.get() );
+	}
+
+	m_uiMisses++;
+
+	std::promise<Asset> promise;
+	m_Pending[key] = promise.get_future().share();
+
+	// The loader runs without holding the lock, so that other assets can be
+	// requested (and loaded) in the meantime.
+
+	lock.unlock();
+
+	Asset asset;
+
+	try {
+		asset = loader();
+	} catch ( ... ) {
+		lock.lock();
+		m_Pending.erase( key );
+		lock.unlock();
+
+		promise.set_exception( std::current_exception() );
+		throw;
+	}
+
+	lock.lock();
+	m_Pending.erase( key );
+
+	// Failed loads are not cached, so the next request tries to load the file
+	// again.  The new asset is referenced by this call, so it can't be evicted
+	// right away.
+
+	if ( asset.IsValid() ) {
+		m_LRU.push_front( key );
+
+		Entry& added = m_Entries[key];
+		added.asset = asset;
+		added.lru = m_LRU.begin();
+
+		m_ullUsage += asset.size;
+
+		if ( m_ullBudget > 0 ) {
+			Evict( m_ullBudget );
+		}
+	}
+
+	lock.unlock();
+
+	promise.set_value( asset );
+
+	return( asset );
+}
+//--------------------------------------------------------------------------------
+void AssetCacheDX11::Evict( unsigned long long budget )
+{
+	// Walk from the least recently used asset towards the most recently used
+	// one, skipping over the assets that are still in use.  A budget of zero
+	// evicts all of the unused assets.  Their memory is only freed once the
+	// textures have been deleted from the renderer as well.
+
+	auto it = m_LRU.end();
+
+	while ( it != m_LRU.begin() && ( budget == 0 || m_ullUsage > budget ) )
+	{
+		--it;
+
+		auto entry = m_Entries.find( *it );
+
+		if ( entry->second.asset.IsShared() ) {
+			continue;
+		}
+
+		m_ullUsage -= entry->second.asset.size;
+		m_uiEvictions++;
+
+		entry->second.asset.Release();
+
+		m_Entries.erase( entry );
+		it = m_LRU.erase( it );
+	}
+}
+//--------------------------------------------------------------------------------
+void AssetCacheDX11::SetMemoryBudget( unsigned long long bytes )
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	m_ullBudget = bytes;
+
+	if ( m_ullBudget > 0 ) {
+		Evict( m_ullBudget );
+	}
+}
+//--------------------------------------------------------------------------------
+unsigned long long AssetCacheDX11::GetMemoryBudget()
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+	return( m_ullBudget );
+}
+//--------------------------------------------------------------------------------
+unsigned long long AssetCacheDX11::GetMemoryUsage()
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+	return( m_ullUsage );
+}
+//--------------------------------------------------------------------------------
+void AssetCacheDX11::Trim()
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+	Evict( 0 );
+}
+//--------------------------------------------------------------------------------
+void AssetCacheDX11::Clear()
+{
+	// Assets that are still in use stay alive through their other references,
+	// but will be loaded again on the next request.  The unused textures are
+	// deleted from the renderer, since nothing else could delete them later.
+
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	for ( auto& entry : m_Entries ) {
+		if ( !entry.second.asset.IsShared() ) {
+			entry.second.asset.Release();
+		}
+	}
+
+	m_Entries.clear();
+	m_LRU.clear();
+	m_ullUsage = 0;
+}
+//--------------------------------------------------------------------------------
+unsigned int AssetCacheDX11::GetHitCount()
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+	return( m_uiHits );
+}
+//--------------------------------------------------------------------------------
+unsigned int AssetCacheDX11::GetMissCount()
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+	return( m_uiMisses );
+}
+//--------------------------------------------------------------------------------
+unsigned int AssetCacheDX11::GetEvictionCount()
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+	return( m_uiEvictions );
+}
+//--------------------------------------------------------------------------------
+unsigned int AssetCacheDX11::GetAssetCount()
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+	return( static_cast<unsigned int>( m_Entries.size() ) );
+}
+//--------------------------------------------------------------------------------
+void AssetCacheDX11::ResetCounters()
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	m_uiHits = 0;
+	m_uiMisses = 0;
+	m_uiEvictions = 0;
+}
+//--------------------------------------------------------------------------------
+void AssetCacheDX11::LogStatistics()
+{
+	std::wstringstream s;
+
+	{
+		std::lock_guard<std::mutex> lock( m_Lock );
+
+		s << L"Asset cache: " << m_Entries.size() << L" assets using " << m_ullUsage << L" bytes, "
+			<< m_uiHits << L" hits, " << m_uiMisses << L" misses, " << m_uiEvictions << L" evictions";
+	}
+
+	std::wstring message = s.str();
+	Log::Get().Write( message );
+}
+//--------------------------------------------------------------------------------
+std::wstring AssetCacheDX11::MakeKey( const wchar_t* type, const std::wstring& filename, const std::string& options )
+{
+	// Filenames are not case sensitive, and both kinds of separators are
+	// accepted, so they are normalized before being used in the key.
+
+	std::wstring key = type;
+	key += L'|';
+
+	for ( auto c : filename ) {
+		key += ( c == L'\\' ) ? L'/' : static_cast<wchar_t>( towlower( c ) );
+	}
+
+	key += L'|';
+	key.append( options.begin(), options.end() );
+
+	return( key );
+}
+//--------------------------------------------------------------------------------
+unsigned long long AssetCacheDX11::GeometrySize( GeometryPtr geometry )
+{
+	if ( geometry == nullptr ) {
+		return( 0 );
+	}
+
+	// The vertices and indices are kept in system memory, and once the buffers
+	// have been created there is a second copy of them in video memory.
+
+	unsigned long long size = static_cast<unsigned long long>( geometry->CalculateVertexSize() ) * geometry->CalculateVertexCount()
+		+ static_cast<unsigned long long>( geometry->GetIndexCount() ) * sizeof( UINT );
+
+	if ( geometry->m_VB != nullptr ) {
+		size *= 2;
+	}
+
+	return( size );
+}
+//--------------------------------------------------------------------------------
+unsigned long long AssetCacheDX11::TextureSize( ResourcePtr texture )
+{
+	// Only 2D textures are measured, which are what gets loaded from files.
+	// Anything else counts as free for the memory budget.
+
+	if ( texture == nullptr || texture->m_iResource == -1 ) {
+		return( 0 );
+	}
+
+	ResourceDX11* pResource = RendererDX11::Get()->GetResourceByIndex( texture->m_iResource );
+
+	if ( pResource == nullptr || pResource->GetType() != RT_TEXTURE2D ) {
+		return( 0 );
+	}
+
+	D3D11_TEXTURE2D_DESC desc = static_cast<Texture2dDX11*>( pResource )->GetActualDescription();
+
+	unsigned long long texels = 0;
+
+	for ( UINT mip = 0; mip < max( desc.MipLevels, 1u ); mip++ ) {
+		texels += static_cast<unsigned long long>( max( desc.Width >> mip, 1u ) ) * max( desc.Height >> mip, 1u );
+	}
+
+	return( texels * desc.ArraySize * formatBits( desc.Format ) / 8 );
+}
+//--------------------------------------------------------------------------------
+bool AssetCacheDX11::Asset::IsValid() const
+{
+	return( geometry != nullptr || ( texture != nullptr && texture->m_iResource != -1 ) );
+}
+//--------------------------------------------------------------------------------
+bool AssetCacheDX11::Asset::IsShared() const
+{
+	return( geometry.use_count() > 1 || texture.use_count() > 1 );
+}
+//--------------------------------------------------------------------------------
+void AssetCacheDX11::Asset::Release()
+{
+	// The renderer keeps a texture alive until it is deleted, regardless of the
+	// proxies that refer to it.  Geometry is freed with its last reference.
+
+	if ( texture != nullptr && texture->m_iResource != -1 ) {
+		RendererDX11::Get()->DeleteResource( texture );
+	}
+
+	geometry = nullptr;
+	texture = nullptr;
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,131 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "ConstantBufferBatchDX11.h"
+#include "ConstantBufferDX11.h"
+#include "Log.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+ConstantBufferBatchDX11::ConstantBufferBatchDX11()
+{
+}
+//--------------------------------------------------------------------------------
+ConstantBufferBatchDX11::~ConstantBufferBatchDX11()
+{
+}
+//--------------------------------------------------------------------------------
+void ConstantBufferBatchDX11::Reset()
+{
+	// The storage is kept, so that a batch which is refilled every frame
+	// doesn't reallocate.
+
+	m_Data.clear();
+	m_Blocks.clear();
+}
+//--------------------------------------------------------------------------------
+unsigned int ConstantBufferBatchDX11::AddBlock( const void* pData, unsigned int size )
+{
+	unsigned int offset = 0;
+	char* pBlock = AllocateBlock( size, offset );
+
+	memcpy( pBlock, pData, size );
+
+	return( offset );
+}
+//--------------------------------------------------------------------------------
+char* ConstantBufferBatchDX11::AllocateBlock( unsigned int size, unsigned int& offset )
+{
+	// The padding between the blocks is zeroed, so that the uploaded data is
+	// the same from frame to frame when the blocks are.
+
+	offset = static_cast<unsigned int>( m_Data.size() );
+
+	const unsigned int aligned = ( size + BlockAlignment - 1 ) & ~( BlockAlignment - 1 );
+	m_Data.resize( offset + max( aligned, static_cast<unsigned int>( BlockAlignment ) ), 0 );
+
+	Block block;
+	block.offset = offset;
+	block.size = size;
+	m_Blocks.push_back( block );
+
+	return( m_Data.data() + offset );
+}
+//--------------------------------------------------------------------------------
+unsigned int ConstantBufferBatchDX11::GetBlockCount() const
+{
+	return( static_cast<unsigned int>( m_Blocks.size() ) );
+}
+//--------------------------------------------------------------------------------
+unsigned int ConstantBufferBatchDX11::GetBlockOffset( unsigned int block ) const
+{
+	return( m_Blocks[block].offset );
+}
+//--------------------------------------------------------------------------------
+unsigned int ConstantBufferBatchDX11::GetBlockSize( unsigned int block ) const
+{
+	return( m_Blocks[block].size );
+}
+//--------------------------------------------------------------------------------
+unsigned int ConstantBufferBatchDX11::GetSize() const
+{
+	return( static_cast<unsigned int>( m_Data.size() ) );
+}
+//--------------------------------------------------------------------------------
+const char* ConstantBufferBatchDX11::GetData() const
+{
+	return( m_Data.data() );
+}
+//--------------------------------------------------------------------------------
+bool ConstantBufferBatchDX11::Upload( ConstantBufferDX11* pBuffer, IConstantBufferUploader* pUploader )
+{
+	if ( m_Data.empty() )
+		return( true );
+
+	if ( pBuffer == nullptr ) {
+		Log::Get().Write( L"No constant buffer was given for the batched constant data!" );
+		return( false );
+	}
+
+	// Each block is bound on its own, and a shader can only see 4096 constants
+	// (64 KB) of a constant buffer at a time.
+
+	for ( auto& block : m_Blocks ) {
+		if ( GetConstantCount( block.size ) > D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT ) {
+			Log::Get().Write( L"A batched constant block is larger than the 64 KB that a shader can access!" );
+			return( false );
+		}
+	}
+
+	if ( m_Data.size() > pBuffer->GetDesiredDescription().ByteWidth ) {
+		Log::Get().Write( L"The constant buffer is too small for the batched constant data!" );
+		return( false );
+	}
+
+	const unsigned int size = static_cast<unsigned int>( m_Data.size() );
+
+	return( pUploader->UploadConstantData( pBuffer, m_Data.data(), size, 0, size ) );
+}
+//--------------------------------------------------------------------------------
+unsigned int ConstantBufferBatchDX11::GetFirstConstant( unsigned int offset )
+{
+	return( offset / ConstantSize );
+}
+//--------------------------------------------------------------------------------
+unsigned int ConstantBufferBatchDX11::GetConstantCount( unsigned int size )
+{
+	const unsigned int constantsPerBlock = BlockAlignment / ConstantSize;
+	const unsigned int constants = ( size + ConstantSize - 1 ) / ConstantSize;
+
+	return( max( ( constants + constantsPerBlock - 1 ) / constantsPerBlock, 1u ) * constantsPerBlock );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
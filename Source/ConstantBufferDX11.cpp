@@ -13,6 +13,7 @@
 #include "ConstantBufferDX11.h"
 #include "PipelineManagerDX11.h"
 #include "IParameterManager.h"
+#include "MatrixArrayParameterDX11.h"
 #include "Log.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
@@ -21,6 +22,14 @@ ConstantBufferDX11::ConstantBufferDX11( Microsoft::WRL::ComPtr<ID3D11Buffer> pBu
 {
 	m_pBuffer = pBuffer;
 	m_bAutoUpdate = true;
+	m_uiLastThreadID = 0;
+
+	for ( auto& copy : m_Shadows ) {
+		copy.DirtyStart = 0;
+		copy.DirtyEnd = 0;
+		copy.pUploader = nullptr;
+		copy.Generation = 0;
+	}
 }
 //--------------------------------------------------------------------------------
 ConstantBufferDX11::~ConstantBufferDX11()
@@ -40,7 +49,13 @@ void ConstantBufferDX11::AddMapping( ConstantBufferMapping& mapping )
 //--------------------------------------------------------------------------------
 void ConstantBufferDX11::EmptyMappings( )
 {
+	// The copies write all of the variables again for the new mappings.
+
 	m_Mappings.clear();
+
+	for ( auto& copy : m_Shadows ) {
+		copy.ValueIDs.clear();
+	}
 }
 //--------------------------------------------------------------------------------
 void ConstantBufferDX11::EvaluateMappings( PipelineManagerDX11* pPipeline, IParameterManager* pParamManager )
@@ -49,84 +64,181 @@ void ConstantBufferDX11::EvaluateMappings( PipelineManagerDX11* pPipeline, IPara
 	// a non-null result, then this is a constant buffer.
 	if ( m_pBuffer ) 
 	{
-		if ( GetAutoUpdate() )
+		EvaluateMappings( static_cast<IConstantBufferUploader*>( pPipeline ), pParamManager );
+	} else {
+		Log::Get().Write( L"Trying to update a constant buffer that isn't a constant buffer!" );
+	}
+}
+//--------------------------------------------------------------------------------
+void ConstantBufferDX11::EvaluateMappings( IConstantBufferUploader* pUploader, IParameterManager* pParamManager )
+{
+	if ( !GetAutoUpdate() )
+		return;
+
+	const unsigned int threadID = pParamManager->GetID();
+	assert( threadID < NUM_THREADS+1 );
+
+	ShadowCopy& copy = m_Shadows[threadID];
+
+	// The shadow copy covers the whole buffer, and all of the mapped variables.
+
+	unsigned int size = m_DesiredDesc.ByteWidth;
+
+	for ( auto& mapping : m_Mappings )
+		size = max( size, mapping.offset + mapping.size );
+
+	if ( copy.Data.size() < size )
+		copy.Data.resize( size, 0 );
+
+	// A copy that hasn't been written with the current mappings yet writes all
+	// of its variables.
+
+	const bool writeAll = ( copy.ValueIDs.size() != m_Mappings.size() );
+
+	if ( writeAll )
+		copy.ValueIDs.assign( m_Mappings.size(), 0 );
+
+	// Check the parameters that go into this constant buffer, and write the
+	// ones that have new values into the shadow copy.  Concatenated matrices
+	// are calculated lazily, so every parameter is brought up to date before
+	// its value ID is checked.
+
+	for ( unsigned int i = 0; i < m_Mappings.size(); i++ )
+	{
+		const ConstantBufferMapping& mapping = m_Mappings[i];
+		RenderParameterDX11* pParam = mapping.pParameter;
+
+		if ( pParam == nullptr )
+			continue;
+
+		pParamManager->UpdateDerivedParameter( pParam );
+
+		const unsigned int valueID = pParam->GetValueID( threadID );
+
+		if ( writeAll || valueID != copy.ValueIDs[i] ) {
+			copy.ValueIDs[i] = valueID;
+			WriteMapping( copy, mapping, pParamManager );
+		}
+	}
+
+	// The buffer only holds this copy if the copy was uploaded last, and with
+	// the current generation of the same uploader.  Otherwise another context
+	// or another parameter manager has replaced the contents, or a deferred
+	// context has started a new command list, so the whole copy is uploaded
+	// even if none of it has changed.
+
+	const unsigned int generation = pUploader->GetUploadGeneration();
+
+	if ( copy.pUploader != pUploader || copy.Generation != generation || m_uiLastThreadID != threadID ) {
+		copy.DirtyStart = 0;
+		copy.DirtyEnd = static_cast<unsigned int>( copy.Data.size() );
+	}
+
+	// Only upload the data when it differs from what the buffer already holds.
+	// The buffer is mapped with the discard flag, so the complete copy is
+	// uploaded even if only a part of it has changed.
+
+	if ( copy.DirtyEnd > copy.DirtyStart ) {
+
+		if ( pUploader->UploadConstantData( this, copy.Data.data(), static_cast<unsigned int>( copy.Data.size() ),
+			copy.DirtyStart, copy.DirtyEnd - copy.DirtyStart ) ) {
+
+			copy.pUploader = pUploader;
+			copy.Generation = generation;
+			copy.DirtyStart = copy.DirtyEnd = 0;
+			m_uiLastThreadID = threadID;
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+bool ConstantBufferDX11::WriteMapping( ShadowCopy& copy, const ConstantBufferMapping& mapping, IParameterManager* pParamManager )
+{
+	// Each type of parameter that holds data can be written to a variable.  The
+	// variable determines how much of the data is used, so scalars take the
+	// first component of a vector, and smaller matrices the leading part of the
+	// 4x4 matrix.  Integer and boolean variables get the values converted from
+	// floating point.
+
+	RenderParameterDX11* pParam = mapping.pParameter;
+
+	const float* pValues = nullptr;
+	unsigned int count = 0;
+
+	Vector4f vector;
+	Matrix4f matrix;
+
+	switch ( pParam->GetParameterType() )
+	{
+	case VECTOR:
+		vector = pParamManager->GetVectorParameter( pParam );
+		pValues = &vector.x;
+		count = 4;
+		break;
+
+	case MATRIX:
+		matrix = pParamManager->GetMatrixParameter( pParam );
+		pValues = &matrix[0];
+		count = 16;
+		break;
+
+	case MATRIX_ARRAY:
 		{
-			// Check the parameters that go into this constant buffer, and see if they have
-			// new values that need to be loaded into the buffer for this frame.  If not,
-			// then we can safely skip the update of this buffer.
-
-			bool doUpdate = false;
-
-			for ( unsigned int j = 0; j < m_Mappings.size(); j++ ) {
-				if ( m_Mappings[j].pParameter->GetValueID( pParamManager->GetID() ) 
-					!= m_Mappings[j].valueID ) {
-					doUpdate = true;
-					break;
-				}
-			}
+			MatrixArrayParameterDX11* pArray = static_cast<MatrixArrayParameterDX11*>( pParam );
 
-			if ( doUpdate ) {
-
-				// Map the constant buffer into system memory.  We map the buffer 
-				// with the discard write flag since we don't care what was in the
-				// buffer already.
-
-				D3D11_MAPPED_SUBRESOURCE resource = 
-					pPipeline->MapResource( this, 0, D3D11_MAP_WRITE_DISCARD, 0 );
-
-				// Update each variable in the constant buffer.  These variables are identified
-				// by their type, and are currently allowed to be Vector4f, Matrix4f, or Matrix4f
-				// arrays.  Additional types will be added as they are needed...
-
-				for ( unsigned int j = 0; j < m_Mappings.size(); j++ )
-				{
-					RenderParameterDX11* pParam		= m_Mappings[j].pParameter;
-					unsigned int offset				= m_Mappings[j].offset;
-					unsigned int size				= m_Mappings[j].size;
-					unsigned int elements			= m_Mappings[j].elements;
-					unsigned int valueID			= m_Mappings[j].valueID;
-					unsigned int threadID			= pParamManager->GetID();
-
-
-					m_Mappings[j].valueID = pParam->GetValueID( threadID );
-
-					if ( m_Mappings[j].varclass == D3D_SVC_VECTOR )
-					{
-						Vector4f vector = pParamManager->GetVectorParameter( pParam );
-						Vector4f* pBuf = (Vector4f*)((char*)resource.pData + offset);
-						*pBuf = vector;
-					}
-					else if ( ( m_Mappings[j].varclass == D3D_SVC_MATRIX_ROWS ) ||
-						( m_Mappings[j].varclass == D3D_SVC_MATRIX_COLUMNS ) )
-					{
-						// Check if it is an array of matrices first...
-						if ( elements == 0 ) 
-						{
-							Matrix4f matrix = pParamManager->GetMatrixParameter( pParam );
-							Matrix4f* pBuf = (Matrix4f*)((char*)resource.pData + offset);
-							*pBuf = matrix;
-						}
-						else 
-						{
-							// If a matrix array, then use the corresponding parameter type.
-							if ( size == elements * sizeof( Matrix4f ) ) {
-								Matrix4f* pMatrices = pParamManager->GetMatrixArrayParameter( pParam );
-								memcpy( ((char*)resource.pData + offset), (char*)pMatrices, size );
-							} else {
-								Log::Get().Write( L"Mismatch in matrix array count, update will not be performed!!!" );
-							}
-						}
-					} else {
-						Log::Get().Write( L"Non vector or matrix parameter specified in a constant buffer!  This will not be updated!" );
-					}
-				}
-
-				pPipeline->UnMapResource( this, 0 );
+			if ( pArray->GetMatrixCount() * sizeof( Matrix4f ) != mapping.size ) {
+				Log::Get().Write( L"Mismatch in matrix array count, only the overlapping matrices will be updated!" );
 			}
+
+			pValues = reinterpret_cast<const float*>( pParamManager->GetMatrixArrayParameter( pParam ) );
+			count = pValues != nullptr ? pArray->GetMatrixCount() * 16 : 0;
+			break;
+		}
+
+	default:
+		Log::Get().Write( L"Only vector and matrix parameters can be stored in a constant buffer!  This will not be updated!" );
+		return( false );
+	}
+
+	const unsigned int components = min( count, mapping.size / sizeof( float ) );
+
+	if ( mapping.vartype == D3D_SVT_INT || mapping.vartype == D3D_SVT_UINT || mapping.vartype == D3D_SVT_BOOL )
+	{
+		std::vector<unsigned int> converted( components );
+
+		for ( unsigned int i = 0; i < components; i++ ) {
+			if ( mapping.vartype == D3D_SVT_INT )
+				converted[i] = static_cast<unsigned int>( static_cast<int>( pValues[i] ) );
+			else if ( mapping.vartype == D3D_SVT_UINT )
+				converted[i] = static_cast<unsigned int>( pValues[i] );
+			else
+				converted[i] = pValues[i] != 0.0f ? 1 : 0;
 		}
+
+		return( WriteBytes( copy, mapping.offset, converted.data(), components * sizeof( unsigned int ) ) );
+	}
+
+	return( WriteBytes( copy, mapping.offset, pValues, components * sizeof( float ) ) );
+}
+//--------------------------------------------------------------------------------
+bool ConstantBufferDX11::WriteBytes( ShadowCopy& copy, unsigned int offset, const void* pData, unsigned int size )
+{
+	// Bytes that already hold the new values don't make the buffer dirty, which
+	// is what allows an upload to be skipped when values are set repeatedly.
+
+	if ( size == 0 || memcmp( copy.Data.data() + offset, pData, size ) == 0 )
+		return( false );
+
+	memcpy( copy.Data.data() + offset, pData, size );
+
+	if ( copy.DirtyEnd > copy.DirtyStart ) {
+		copy.DirtyStart = min( copy.DirtyStart, offset );
+		copy.DirtyEnd = max( copy.DirtyEnd, offset + size );
 	} else {
-		Log::Get().Write( L"Trying to update a constant buffer that isn't a constant buffer!" );
+		copy.DirtyStart = offset;
+		copy.DirtyEnd = offset + size;
 	}
+
+	return( true );
 }
 //--------------------------------------------------------------------------------
 bool ConstantBufferDX11::ContainsMapping( int ID, const ConstantBufferMapping& mapping )
@@ -144,6 +256,7 @@ bool ConstantBufferDX11::ContainsMapping( int ID, const ConstantBufferMapping& m
 			&& internalMapping.offset == mapping.offset 
 			&& internalMapping.size == mapping.size
 			&& internalMapping.varclass == mapping.varclass
+			&& internalMapping.vartype == mapping.vartype
 			&& internalMapping.elements == mapping.elements ) {
 			result = true;
 		}
@@ -161,4 +274,11 @@ bool ConstantBufferDX11::GetAutoUpdate()
 {
 	return( m_bAutoUpdate );
 }
+//--------------------------------------------------------------------------------
+const std::vector<char>& ConstantBufferDX11::GetShadowData( unsigned int threadID )
+{
+	assert( threadID < NUM_THREADS+1 );
+
+	return( m_Shadows[threadID].Data );
+}
 //--------------------------------------------------------------------------------
\ No newline at end of file
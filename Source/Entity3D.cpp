@@ -18,6 +18,7 @@
 #include "IParameterManager.h"
 #include "Node3D.h"
 #include "SceneGraph.h"
+#include <cfloat>
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
@@ -27,6 +28,9 @@ Entity3D::Entity3D() :
 	//m_bHidden( false ),
 	//m_bPickable( true ),
 	m_pUserData( nullptr ),
+	m_WorldBounds(),
+	m_bBounded( false ),
+	m_bExecutorBounds( false ),
 	Shape(),
 	Controllers( this ),
 	Visual()
@@ -77,11 +81,13 @@ Node3D* Entity3D::GetParent()
 void Entity3D::AttachParent( Node3D* Parent )
 {
 	m_pParent = Parent;
+	Transform.Invalidate();
 }
 //--------------------------------------------------------------------------------
 void Entity3D::DetachParent( )
 {
 	m_pParent = nullptr;
+	Transform.Invalidate();
 }
 //--------------------------------------------------------------------------------
 void Entity3D::Update( float time )
@@ -111,9 +117,71 @@ void Entity3D::UpdateWorld( )
 	// If the entity has a parent, then update its world matrix accordingly.
 
 	if (m_pParent)
-		Transform.UpdateWorld( m_pParent->Transform.WorldMatrix() );
+		Transform.UpdateWorld( m_pParent->Transform );
 	else
 		Transform.UpdateWorld( );
+
+	// Bound transforms get their world matrix from a batched update later on, 
+	// so their bounds are refreshed after that has completed.
+
+	if ( !Transform.IsBound() )
+		UpdateWorldBounds( );
+}
+//--------------------------------------------------------------------------------
+void Entity3D::UpdateWorldBounds( )
+{
+	// Merge all of the model space spheres into a single sphere, and then move
+	// it into world space.  The radius is scaled by the largest axis scaling of
+	// the world matrix so that non-uniform scales stay conservative.  Without
+	// any shapes, the bounds of the executor are only used if the entity has
+	// opted in to them.
+
+	Sphere3f model;
+
+	if ( Shape.GetNumberOfShapes() > 0 )
+	{
+		m_bBounded = true;
+		model = Shape.m_spheres[0];
+
+		for ( const auto& sphere : Shape.m_spheres ) {
+			model.Merge( sphere );
+		}
+	}
+	else
+	{
+		m_bBounded = m_bExecutorBounds && ( Visual.Executor != nullptr ) && Visual.Executor->GetModelBounds( model );
+	}
+
+	if ( !m_bBounded )
+		return;
+
+	const Matrix4f& world = Transform.WorldMatrix();
+
+	float fScaleSq = max( Vector3f::LengthSq( world.GetBasisX() ), 
+						max( Vector3f::LengthSq( world.GetBasisY() ), Vector3f::LengthSq( world.GetBasisZ() ) ) );
+
+	m_WorldBounds.center = ( world * Vector4f( model.center, 1.0f ) ).xyz();
+	m_WorldBounds.radius = model.radius * sqrtf( fScaleSq );
+}
+//--------------------------------------------------------------------------------
+const Sphere3f& Entity3D::GetWorldBounds() const
+{
+	return( m_WorldBounds );
+}
+//--------------------------------------------------------------------------------
+bool Entity3D::IsBounded() const
+{
+	return( m_bBounded );
+}
+//--------------------------------------------------------------------------------
+void Entity3D::SetExecutorBounds( bool enable )
+{
+	m_bExecutorBounds = enable;
+}
+//--------------------------------------------------------------------------------
+bool Entity3D::GetExecutorBounds() const
+{
+	return( m_bExecutorBounds );
 }
 //--------------------------------------------------------------------------------
 //CompositeShape Entity3D::GetWorldBounds() const
@@ -133,10 +201,12 @@ void Entity3D::PreRender( RendererDX11* pRenderer, VIEWTYPE view )
 		Visual.Material->PreRender( pRenderer, view );
 }
 //--------------------------------------------------------------------------------
-void Entity3D::Render( PipelineManagerDX11* pPipelineManager, IParameterManager* pParamManager, VIEWTYPE view )
+void Entity3D::Render( PipelineManagerDX11* pPipelineManager, IParameterManager* pParamManager, VIEWTYPE view, unsigned int lod )
 {
+	const ExecutorPtr& pExecutor = Visual.GetLOD( lod );
+
 	// Test if the entity contains any geometry, and it has a material
-	if ( ( Visual.Executor != NULL ) && ( Visual.Material != NULL ) )
+	if ( ( pExecutor != NULL ) && ( Visual.Material != NULL ) )
 	{
 		// Only render if the material indicates that you should
 		if ( Visual.Material->Params[view].bRender )
@@ -163,11 +233,50 @@ void Entity3D::Render( PipelineManagerDX11* pPipelineManager, IParameterManager*
 			// Let the geometry execute its drawing operation.  This includes 
 			// configuring the input to the pipeline, plus calling an appropriate
 			// draw call.
-			Visual.Executor->Execute( pPipelineManager, pParamManager );
+			pExecutor->Execute( pPipelineManager, pParamManager );
 		}
 	}
 }
 //--------------------------------------------------------------------------------
+float Entity3D::GetScreenSize( const Matrix4f& ViewMatrix, const Matrix4f& ProjMatrix ) const
+{
+	if ( !m_bBounded ) {
+		return( FLT_MAX );
+	}
+
+	// With row vectors, the view space z value is the dot product of the
+	// position with the third column of the view matrix.  The projected radius
+	// is scaled by the vertical term of the projection, and by the inverse depth
+	// for perspective projections (which have a non-zero fourth column).
+
+	const Vector3f& center = m_WorldBounds.center;
+
+	float depth = center.x * ViewMatrix(0,2) + center.y * ViewMatrix(1,2)
+				+ center.z * ViewMatrix(2,2) + ViewMatrix(3,2);
+
+	float size = m_WorldBounds.radius * ProjMatrix(1,1);
+
+	if ( ProjMatrix(2,3) != 0.0f )
+	{
+		if ( depth <= m_WorldBounds.radius ) {
+			return( FLT_MAX );
+		}
+
+		size /= depth;
+	}
+
+	return( size );
+}
+//--------------------------------------------------------------------------------
+unsigned int Entity3D::SelectLOD( const Matrix4f& ViewMatrix, const Matrix4f& ProjMatrix, float scale ) const
+{
+	if ( Visual.LODs.size() == 0 ) {
+		return( 0 );
+	}
+
+	return( Visual.SelectLOD( GetScreenSize( ViewMatrix, ProjMatrix ) * scale ) );
+}
+//--------------------------------------------------------------------------------
 void Entity3D::SetRenderParams( IParameterManager* pParamManager )
 {
 	// Set the world matrix
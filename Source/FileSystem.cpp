@@ -20,6 +20,7 @@ std::wstring FileSystem::sModelsSubFolder = L"Models/";
 std::wstring FileSystem::sScriptsSubFolder = L"Scripts/";
 std::wstring FileSystem::sShaderSubFolder = L"Shaders/";
 std::wstring FileSystem::sTextureSubFolder = L"Textures/";
+std::wstring FileSystem::sCacheSubFolder = L"Cache/";
 //--------------------------------------------------------------------------------
 FileSystem::FileSystem()
 {
@@ -106,6 +107,11 @@ std::wstring FileSystem::GetTextureFolder()
 	return( sDataFolder + sTextureSubFolder );
 }
 //--------------------------------------------------------------------------------
+std::wstring FileSystem::GetCacheFolder()
+{
+	return( sDataFolder + sCacheSubFolder );
+}
+//--------------------------------------------------------------------------------
 void FileSystem::SetDataFolder( const std::wstring& folder )
 {
 	sDataFolder = folder;
@@ -131,6 +137,11 @@ void FileSystem::SetTextureFolder( const std::wstring& folder )
 	sTextureSubFolder = folder;
 }
 //--------------------------------------------------------------------------------
+void FileSystem::SetCacheFolder( const std::wstring& folder )
+{
+	sCacheSubFolder = folder;
+}
+//--------------------------------------------------------------------------------
 bool FileSystem::FileExists( const std::wstring& file )
 {
 	// Check if the file exists, and that it is not a directory
@@ -201,4 +212,14 @@ bool FileSystem::FileIsNewer( const std::wstring& file1, const std::wstring& fil
 
 	return( false );
 }
+//--------------------------------------------------------------------------------
+bool FileSystem::CreateFolder( const std::wstring& folder )
+{
+	// A folder that already exists counts as created.
+
+	if ( CreateDirectoryW( folder.c_str(), nullptr ) )
+		return( true );
+
+	return( GetLastError() == ERROR_ALREADY_EXISTS );
+}
 //--------------------------------------------------------------------------------
\ No newline at end of file
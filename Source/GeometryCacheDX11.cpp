@@ -0,0 +1,286 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "GeometryCacheDX11.h"
+#include "GlyphHash.h"
+#include "MemoryMappedFile.h"
+#include "FileSystem.h"
+#include "Log.h"
+#include <iomanip>
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	// The file starts with a header, followed by the layout elements, the
+	// vertex stream and finally the indices.  All of the sections have sizes
+	// that are multiples of four bytes, so every section stays aligned.
+
+	const unsigned int CACHE_MAGIC = 0x434d4748;	// 'HGMC'
+	const unsigned int CACHE_VERSION = 1;
+
+	struct CacheHeader
+	{
+		unsigned int		magic;
+		unsigned int		version;
+		unsigned long long	key;
+		unsigned int		primitiveType;
+		unsigned int		vertexSize;
+		unsigned int		vertexCount;
+		unsigned int		indexCount;
+		unsigned int		elementCount;
+		unsigned int		reserved;
+		float				bounds[4];
+	};
+
+	struct CacheElement
+	{
+		char				semanticName[40];
+		unsigned int		semanticIndex;
+		unsigned int		format;
+		unsigned int		inputSlot;
+		unsigned int		alignedByteOffset;
+		unsigned int		inputSlotClass;
+		unsigned int		instanceDataStepRate;
+	};
+};
+//--------------------------------------------------------------------------------
+bool GeometryCacheDX11::sEnabled = true;
+//--------------------------------------------------------------------------------
+GeometryCacheDX11::GeometryCacheDX11()
+{
+}
+//--------------------------------------------------------------------------------
+GeometryPtr GeometryCacheDX11::Load( const std::wstring& filename, const std::string& options, unsigned int version, const LoaderFunction& loader )
+{
+	unsigned long long hash = 0;
+
+	if ( !sEnabled || !HashFile( filename, hash ) )
+		return( loader() );
+
+	const unsigned long long key = GetKey( hash, options, version );
+	const std::wstring cacheFile = GetCacheFilename( key );
+
+	GeometryPtr pGeometry = Read( cacheFile, key );
+
+	if ( pGeometry != nullptr )
+		return( pGeometry );
+
+	// Cook the loaded geometry into a cache image, and return the geometry that
+	// is read back from that image so that the result is the same whether the
+	// cache was used or not.
+
+	pGeometry = loader();
+
+	if ( pGeometry == nullptr )
+		return( pGeometry );
+
+	std::vector<char> image;
+	Serialize( *pGeometry, key, image );
+
+	FileSystem fs;
+	fs.CreateFolder( fs.GetCacheFolder() );
+
+	if ( !WriteImage( cacheFile, image ) ) {
+		std::wstring message = L"Could not write the geometry cache file " + cacheFile;
+		Log::Get().Write( message );
+	}
+
+	return( Deserialize( image.data(), image.size(), key ) );
+}
+//--------------------------------------------------------------------------------
+unsigned long long GeometryCacheDX11::GetKey( unsigned long long fileHash, const std::string& options, unsigned int version )
+{
+	const unsigned long long key = GlyphHash::HashData( options.data(), options.size(), fileHash );
+
+	return( GlyphHash::HashData( &version, sizeof( version ), key ) );
+}
+//--------------------------------------------------------------------------------
+bool GeometryCacheDX11::Write( const std::wstring& cacheFile, GeometryDX11& geometry, unsigned long long key )
+{
+	std::vector<char> image;
+	Serialize( geometry, key, image );
+
+	return( WriteImage( cacheFile, image ) );
+}
+//--------------------------------------------------------------------------------
+GeometryPtr GeometryCacheDX11::Read( const std::wstring& cacheFile, unsigned long long key )
+{
+	MemoryMappedFile file;
+
+	if ( !file.Open( cacheFile ) )
+		return( nullptr );
+
+	return( Deserialize( file.GetDataPtr(), file.GetDataSize(), key ) );
+}
+//--------------------------------------------------------------------------------
+bool GeometryCacheDX11::HashFile( const std::wstring& filename, unsigned long long& hash )
+{
+	MemoryMappedFile file;
+
+	if ( !file.Open( filename ) )
+		return( false );
+
+	hash = GlyphHash::HashData( file.GetDataPtr(), file.GetDataSize() );
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+std::wstring GeometryCacheDX11::GetCacheFilename( unsigned long long key )
+{
+	FileSystem fs;
+
+	std::wstringstream name;
+	name << fs.GetCacheFolder() << std::hex << std::setw( 16 ) << std::setfill( L'0' ) << key << L".mesh";
+
+	return( name.str() );
+}
+//--------------------------------------------------------------------------------
+void GeometryCacheDX11::SetEnabled( bool enabled )
+{
+	sEnabled = enabled;
+}
+//--------------------------------------------------------------------------------
+bool GeometryCacheDX11::IsEnabled( )
+{
+	return( sEnabled );
+}
+//--------------------------------------------------------------------------------
+void GeometryCacheDX11::Serialize( GeometryDX11& geometry, unsigned long long key, std::vector<char>& image )
+{
+	std::vector<char> vertices;
+	std::vector<D3D11_INPUT_ELEMENT_DESC> layout;
+
+	geometry.InterleaveVertices( vertices );
+	geometry.GetInputElementDescs( layout );
+	geometry.CalculateBounds();
+
+	CacheHeader header;
+	memset( &header, 0, sizeof( header ) );
+	header.magic = CACHE_MAGIC;
+	header.version = CACHE_VERSION;
+	header.key = key;
+	header.primitiveType = static_cast<unsigned int>( geometry.GetPrimitiveType() );
+	header.vertexSize = geometry.GetVertexSize();
+	header.vertexCount = geometry.GetVertexCount();
+	header.indexCount = geometry.GetIndexCount();
+	header.elementCount = static_cast<unsigned int>( layout.size() );
+	header.bounds[0] = geometry.GetBounds().center.x;
+	header.bounds[1] = geometry.GetBounds().center.y;
+	header.bounds[2] = geometry.GetBounds().center.z;
+	header.bounds[3] = geometry.GetBounds().radius;
+
+	image.resize( sizeof( CacheHeader ) + layout.size() * sizeof( CacheElement ) + vertices.size() + header.indexCount * sizeof( UINT ) );
+	char* pWrite = image.data();
+
+	memcpy( pWrite, &header, sizeof( header ) );
+	pWrite += sizeof( header );
+
+	for ( auto& desc : layout )
+	{
+		// Semantic names are much shorter than the fixed size field in practice,
+		// and longer names are truncated.
+
+		CacheElement element;
+		memset( &element, 0, sizeof( element ) );
+		strncpy( element.semanticName, desc.SemanticName, sizeof( element.semanticName ) - 1 );
+		element.semanticIndex = desc.SemanticIndex;
+		element.format = static_cast<unsigned int>( desc.Format );
+		element.inputSlot = desc.InputSlot;
+		element.alignedByteOffset = desc.AlignedByteOffset;
+		element.inputSlotClass = static_cast<unsigned int>( desc.InputSlotClass );
+		element.instanceDataStepRate = desc.InstanceDataStepRate;
+
+		memcpy( pWrite, &element, sizeof( element ) );
+		pWrite += sizeof( element );
+	}
+
+	if ( vertices.size() > 0 )
+		memcpy( pWrite, vertices.data(), vertices.size() );
+	pWrite += vertices.size();
+
+	if ( header.indexCount > 0 )
+		memcpy( pWrite, geometry.m_vIndices.data(), header.indexCount * sizeof( UINT ) );
+}
+//--------------------------------------------------------------------------------
+bool GeometryCacheDX11::WriteImage( const std::wstring& cacheFile, const std::vector<char>& image )
+{
+	std::ofstream file( cacheFile, std::ios::out | std::ios::binary | std::ios::trunc );
+
+	if ( !file.is_open() )
+		return( false );
+
+	file.write( image.data(), image.size() );
+
+	return( file.good() );
+}
+//--------------------------------------------------------------------------------
+GeometryPtr GeometryCacheDX11::Deserialize( const char* pData, size_t size, unsigned long long key )
+{
+	// Anything that doesn't match the expected version, key and size exactly is
+	// treated as a cache miss, which includes truncated or stale files.
+
+	CacheHeader header;
+
+	if ( pData == nullptr || size < sizeof( header ) )
+		return( nullptr );
+
+	memcpy( &header, pData, sizeof( header ) );
+
+	if ( header.magic != CACHE_MAGIC || header.version != CACHE_VERSION || header.key != key )
+		return( nullptr );
+
+	const unsigned long long layoutSize = static_cast<unsigned long long>( header.elementCount ) * sizeof( CacheElement );
+	const unsigned long long verticesSize = static_cast<unsigned long long>( header.vertexSize ) * header.vertexCount;
+	const unsigned long long indicesSize = static_cast<unsigned long long>( header.indexCount ) * sizeof( UINT );
+
+	if ( size != sizeof( header ) + layoutSize + verticesSize + indicesSize )
+		return( nullptr );
+
+	const char* pRead = pData + sizeof( header );
+
+	std::vector<D3D11_INPUT_ELEMENT_DESC> layout( header.elementCount );
+	std::vector<CacheElement> elements( header.elementCount );
+
+	for ( unsigned int i = 0; i < header.elementCount; i++ )
+	{
+		CacheElement& element = elements[i];
+		memcpy( &element, pRead, sizeof( element ) );
+		pRead += sizeof( element );
+
+		element.semanticName[sizeof( element.semanticName ) - 1] = '\0';
+
+		layout[i].SemanticName = element.semanticName;
+		layout[i].SemanticIndex = element.semanticIndex;
+		layout[i].Format = static_cast<DXGI_FORMAT>( element.format );
+		layout[i].InputSlot = element.inputSlot;
+		layout[i].AlignedByteOffset = element.alignedByteOffset;
+		layout[i].InputSlotClass = static_cast<D3D11_INPUT_CLASSIFICATION>( element.inputSlotClass );
+		layout[i].InstanceDataStepRate = element.instanceDataStepRate;
+	}
+
+	GeometryPtr pGeometry = GeometryPtr( new GeometryDX11() );
+
+	pGeometry->SetPrimitiveType( static_cast<D3D11_PRIMITIVE_TOPOLOGY>( header.primitiveType ) );
+	pGeometry->SetInterleavedVertices( pRead, header.vertexSize, header.vertexCount, layout );
+	pRead += verticesSize;
+
+	pGeometry->m_vIndices.resize( header.indexCount );
+	if ( header.indexCount > 0 )
+		memcpy( pGeometry->m_vIndices.data(), pRead, static_cast<size_t>( indicesSize ) );
+
+	pGeometry->m_Bounds.center = Vector3f( header.bounds[0], header.bounds[1], header.bounds[2] );
+	pGeometry->m_Bounds.radius = header.bounds[3];
+
+	return( pGeometry );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
@@ -17,9 +17,289 @@
 #include "Log.h"
 #include "GlyphString.h"
 #include "PipelineManagerDX11.h"
+#include "JobScheduler.h"
+#include "GlyphSIMD.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
+namespace
+{
+	// Triangles and vertices are processed in blocks of this size when the
+	// tangent frames are computed on multiple threads.
+
+	const unsigned int TANGENT_BLOCK_SIZE = 8 * 1024;
+
+	// The directions of each triangle are stored as two padded float4s, which
+	// can be summed up with a single vector add each.
+
+	const unsigned int DIRECTION_STRIDE = 8;
+
+	// Computes the tangent (s) and bitangent (t) directions of the triangles in
+	// [begin, end).  The operations are the same in the scalar and SSE paths,
+	// so both produce the same results.
+
+	void computeTriangleDirections( const UINT* pIndices, const float* pPositions, const float* pTexCoords,
+		float* pDirections, unsigned int begin, unsigned int end )
+	{
+		unsigned int i = begin;
+
+#if defined(GLYPH_SIMD_SSE)
+		for ( ; i + 4 <= end; i += 4 )
+		{
+			const UINT* t = pIndices + i * 3;
+
+			#define GATHER( data, stride, corner, component ) _mm_setr_ps( \
+				data[t[0 + corner] * stride + component], data[t[3 + corner] * stride + component], \
+				data[t[6 + corner] * stride + component], data[t[9 + corner] * stride + component] )
+
+			__m128 v1x = GATHER( pPositions, 3, 0, 0 ), v1y = GATHER( pPositions, 3, 0, 1 ), v1z = GATHER( pPositions, 3, 0, 2 );
+			__m128 v2x = GATHER( pPositions, 3, 1, 0 ), v2y = GATHER( pPositions, 3, 1, 1 ), v2z = GATHER( pPositions, 3, 1, 2 );
+			__m128 v3x = GATHER( pPositions, 3, 2, 0 ), v3y = GATHER( pPositions, 3, 2, 1 ), v3z = GATHER( pPositions, 3, 2, 2 );
+			__m128 w1x = GATHER( pTexCoords, 2, 0, 0 ), w1y = GATHER( pTexCoords, 2, 0, 1 );
+			__m128 w2x = GATHER( pTexCoords, 2, 1, 0 ), w2y = GATHER( pTexCoords, 2, 1, 1 );
+			__m128 w3x = GATHER( pTexCoords, 2, 2, 0 ), w3y = GATHER( pTexCoords, 2, 2, 1 );
+
+			#undef GATHER
+
+			__m128 x1 = _mm_sub_ps( v2x, v1x ), x2 = _mm_sub_ps( v3x, v1x );
+			__m128 y1 = _mm_sub_ps( v2y, v1y ), y2 = _mm_sub_ps( v3y, v1y );
+			__m128 z1 = _mm_sub_ps( v2z, v1z ), z2 = _mm_sub_ps( v3z, v1z );
+
+			__m128 s1 = _mm_sub_ps( w2x, w1x ), s2 = _mm_sub_ps( w3x, w1x );
+			__m128 t1 = _mm_sub_ps( w2y, w1y ), t2 = _mm_sub_ps( w3y, w1y );
+
+			__m128 r = _mm_div_ps( _mm_set1_ps( 1.0f ), _mm_sub_ps( _mm_mul_ps( s1, t2 ), _mm_mul_ps( s2, t1 ) ) );
+
+			__m128 sx = _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( t2, x1 ), _mm_mul_ps( t1, x2 ) ), r );
+			__m128 sy = _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( t2, y1 ), _mm_mul_ps( t1, y2 ) ), r );
+			__m128 sz = _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( t2, z1 ), _mm_mul_ps( t1, z2 ) ), r );
+			__m128 sw = _mm_setzero_ps();
+
+			__m128 tx = _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( s1, x2 ), _mm_mul_ps( s2, x1 ) ), r );
+			__m128 ty = _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( s1, y2 ), _mm_mul_ps( s2, y1 ) ), r );
+			__m128 tz = _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( s1, z2 ), _mm_mul_ps( s2, z1 ) ), r );
+			__m128 tw = _mm_setzero_ps();
+
+			_MM_TRANSPOSE4_PS( sx, sy, sz, sw );
+			_MM_TRANSPOSE4_PS( tx, ty, tz, tw );
+
+			float* d = pDirections + static_cast<size_t>( i ) * DIRECTION_STRIDE;
+			_mm_storeu_ps( d, sx );			_mm_storeu_ps( d + 4, tx );
+			_mm_storeu_ps( d + 8, sy );		_mm_storeu_ps( d + 12, ty );
+			_mm_storeu_ps( d + 16, sz );	_mm_storeu_ps( d + 20, tz );
+			_mm_storeu_ps( d + 24, sw );	_mm_storeu_ps( d + 28, tw );
+		}
+#endif
+
+		for ( ; i < end; i++ )
+		{
+			const float* v1 = pPositions + pIndices[i * 3 + 0] * 3;
+			const float* v2 = pPositions + pIndices[i * 3 + 1] * 3;
+			const float* v3 = pPositions + pIndices[i * 3 + 2] * 3;
+
+			const float* w1 = pTexCoords + pIndices[i * 3 + 0] * 2;
+			const float* w2 = pTexCoords + pIndices[i * 3 + 1] * 2;
+			const float* w3 = pTexCoords + pIndices[i * 3 + 2] * 2;
+
+			float x1 = v2[0] - v1[0];
+			float x2 = v3[0] - v1[0];
+			float y1 = v2[1] - v1[1];
+			float y2 = v3[1] - v1[1];
+			float z1 = v2[2] - v1[2];
+			float z2 = v3[2] - v1[2];
+
+			float s1 = w2[0] - w1[0];
+			float s2 = w3[0] - w1[0];
+			float t1 = w2[1] - w1[1];
+			float t2 = w3[1] - w1[1];
+
+			float r = 1.0f / ( s1 * t2 - s2 * t1 );
+
+			float* d = pDirections + static_cast<size_t>( i ) * DIRECTION_STRIDE;
+			d[0] = ( t2 * x1 - t1 * x2 ) * r;
+			d[1] = ( t2 * y1 - t1 * y2 ) * r;
+			d[2] = ( t2 * z1 - t1 * z2 ) * r;
+			d[3] = 0.0f;
+			d[4] = ( s1 * x2 - s2 * x1 ) * r;
+			d[5] = ( s1 * y2 - s2 * y1 ) * r;
+			d[6] = ( s1 * z2 - s2 * z1 ) * r;
+			d[7] = 0.0f;
+		}
+	}
+
+	// Adds the directions of a triangle to the sums of one of its vertices.
+
+	inline void addDirections( float* sum, const float* d )
+	{
+#if defined(GLYPH_SIMD_SSE)
+		_mm_storeu_ps( sum, _mm_add_ps( _mm_loadu_ps( sum ), _mm_loadu_ps( d ) ) );
+		_mm_storeu_ps( sum + 4, _mm_add_ps( _mm_loadu_ps( sum + 4 ), _mm_loadu_ps( d + 4 ) ) );
+#else
+		for ( unsigned int k = 0; k < DIRECTION_STRIDE; k++ )
+			sum[k] += d[k];
+#endif
+	}
+
+	// Sums up the directions of the triangles around all of the vertices, in a
+	// single pass over the triangles.
+
+	void sumVertexDirections( const UINT* pIndices, unsigned int triangleCount, const float* pDirections, float* pSums )
+	{
+		for ( unsigned int i = 0; i < triangleCount * 3; i++ )
+			addDirections( pSums + static_cast<size_t>( pIndices[i] ) * DIRECTION_STRIDE, pDirections + static_cast<size_t>( i / 3 ) * DIRECTION_STRIDE );
+	}
+
+	// Groups the triangles by the vertices that they use, so that the triangles
+	// around vertex v are pTriangles[pOffsets[v]] to pTriangles[pOffsets[v+1]].
+	// The triangles of each vertex stay in their original order, so summing
+	// them up per vertex adds the same values in the same order as the single
+	// pass above.
+
+	void groupVertexTriangles( const UINT* pIndices, unsigned int triangleCount, unsigned int vertexCount,
+		std::vector<UINT>& offsets, std::vector<UINT>& triangles )
+	{
+		offsets.assign( vertexCount + 1, 0 );
+		triangles.resize( static_cast<size_t>( triangleCount ) * 3 );
+
+		for ( unsigned int i = 0; i < triangleCount * 3; i++ )
+			offsets[pIndices[i] + 1]++;
+
+		for ( unsigned int v = 0; v < vertexCount; v++ )
+			offsets[v + 1] += offsets[v];
+
+		std::vector<UINT> fill( offsets.begin(), offsets.end() - 1 );
+
+		for ( unsigned int i = 0; i < triangleCount * 3; i++ )
+			triangles[fill[pIndices[i]]++] = i / 3;
+	}
+
+	// Sums up the directions of the triangles around each of the vertices in
+	// [begin, end) from the grouped triangles.  Each vertex only visits its own
+	// triangles, so the vertices can be split up between threads freely.
+
+	void sumVertexDirections( const UINT* pOffsets, const UINT* pTriangles, const float* pDirections, float* pSums,
+		unsigned int begin, unsigned int end )
+	{
+		for ( unsigned int v = begin; v < end; v++ )
+		{
+			float* sum = pSums + static_cast<size_t>( v - begin ) * DIRECTION_STRIDE;
+
+			for ( UINT a = pOffsets[v]; a < pOffsets[v + 1]; a++ )
+				addDirections( sum, pDirections + static_cast<size_t>( pTriangles[a] ) * DIRECTION_STRIDE );
+		}
+	}
+
+	// Orthogonalizes the summed up tangents of the vertices in [begin, end)
+	// against their normals, and determines their handedness.  The sums start
+	// with the ones of the first vertex in the range.
+
+	void computeVertexTangents( const float* pSums, const float* pNormals, float* pTangents, unsigned int begin, unsigned int end )
+	{
+
+		unsigned int i = begin;
+
+#if defined(GLYPH_SIMD_SSE)
+		for ( ; i + 4 <= end; i += 4 )
+		{
+			// Switch to one register per component for the rest of the math.
+
+			const float* sum = pSums + static_cast<size_t>( i - begin ) * DIRECTION_STRIDE;
+			__m128 tx = _mm_loadu_ps( sum ), ty = _mm_loadu_ps( sum + 8 ), tz = _mm_loadu_ps( sum + 16 ), tw = _mm_loadu_ps( sum + 24 );
+			__m128 bx = _mm_loadu_ps( sum + 4 ), by = _mm_loadu_ps( sum + 12 ), bz = _mm_loadu_ps( sum + 20 ), bw = _mm_loadu_ps( sum + 28 );
+			_MM_TRANSPOSE4_PS( tx, ty, tz, tw );
+			_MM_TRANSPOSE4_PS( bx, by, bz, bw );
+
+			const float* n = pNormals + static_cast<size_t>( i ) * 3;
+			__m128 nx = _mm_setr_ps( n[0], n[3], n[6], n[9] );
+			__m128 ny = _mm_setr_ps( n[1], n[4], n[7], n[10] );
+			__m128 nz = _mm_setr_ps( n[2], n[5], n[8], n[11] );
+
+			// Gram-Schmidt orthogonalize
+
+			__m128 dot = _mm_add_ps( _mm_add_ps( _mm_mul_ps( nx, tx ), _mm_mul_ps( ny, ty ) ), _mm_mul_ps( nz, tz ) );
+			__m128 gx = _mm_sub_ps( tx, _mm_mul_ps( nx, dot ) );
+			__m128 gy = _mm_sub_ps( ty, _mm_mul_ps( ny, dot ) );
+			__m128 gz = _mm_sub_ps( tz, _mm_mul_ps( nz, dot ) );
+
+			__m128 magnitude = _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( gx, gx ), _mm_mul_ps( gy, gy ) ), _mm_mul_ps( gz, gz ) ) );
+			__m128 zero = _mm_cmpeq_ps( magnitude, _mm_setzero_ps() );
+			magnitude = _mm_or_ps( _mm_and_ps( zero, _mm_set1_ps( 0.0001f ) ), _mm_andnot_ps( zero, magnitude ) );
+			__m128 inverse = _mm_div_ps( _mm_set1_ps( 1.0f ), magnitude );
+
+			gx = _mm_mul_ps( gx, inverse );
+			gy = _mm_mul_ps( gy, inverse );
+			gz = _mm_mul_ps( gz, inverse );
+
+			// Calculate handedness
+
+			__m128 cx = _mm_sub_ps( _mm_mul_ps( ny, tz ), _mm_mul_ps( nz, ty ) );
+			__m128 cy = _mm_sub_ps( _mm_mul_ps( nz, tx ), _mm_mul_ps( nx, tz ) );
+			__m128 cz = _mm_sub_ps( _mm_mul_ps( nx, ty ), _mm_mul_ps( ny, tx ) );
+			__m128 handedness = _mm_add_ps( _mm_add_ps( _mm_mul_ps( cx, bx ), _mm_mul_ps( cy, by ) ), _mm_mul_ps( cz, bz ) );
+			__m128 negative = _mm_cmplt_ps( handedness, _mm_setzero_ps() );
+			__m128 gw = _mm_or_ps( _mm_and_ps( negative, _mm_set1_ps( -1.0f ) ), _mm_andnot_ps( negative, _mm_set1_ps( 1.0f ) ) );
+
+			_MM_TRANSPOSE4_PS( gx, gy, gz, gw );
+
+			float* out = pTangents + static_cast<size_t>( i ) * 4;
+			_mm_storeu_ps( out, gx );
+			_mm_storeu_ps( out + 4, gy );
+			_mm_storeu_ps( out + 8, gz );
+			_mm_storeu_ps( out + 12, gw );
+		}
+#endif
+
+		for ( ; i < end; i++ )
+		{
+			const float* sum = pSums + static_cast<size_t>( i - begin ) * DIRECTION_STRIDE;
+			const Vector3f t( sum[0], sum[1], sum[2] );
+			const Vector3f b( sum[4], sum[5], sum[6] );
+
+			const Vector3f n( pNormals[i * 3 + 0], pNormals[i * 3 + 1], pNormals[i * 3 + 2] );
+
+			// Gram-Schmidt orthogonalize
+			Vector3f tangent = Vector3f::Normalize( ( t - n * Vector3f::Dot( n, t ) ) );
+
+			// Calculate handedness
+			float sign = ( Vector3f::Dot( Vector3f::Cross( n, t ), b ) < 0.0f ) ? -1.0f : 1.0f;
+
+			float* out = pTangents + static_cast<size_t>( i ) * 4;
+			out[0] = tangent.x;
+			out[1] = tangent.y;
+			out[2] = tangent.z;
+			out[3] = sign;
+		}
+	}
+
+	// Returns the number of 32 bit components of a vertex element format, or
+	// zero for the formats that vertex elements can't hold.
+
+	int FormatTupleSize( DXGI_FORMAT format )
+	{
+		switch ( format )
+		{
+		case DXGI_FORMAT_R32G32B32A32_FLOAT:
+		case DXGI_FORMAT_R32G32B32A32_UINT:
+		case DXGI_FORMAT_R32G32B32A32_SINT:
+			return( 4 );
+		case DXGI_FORMAT_R32G32B32_FLOAT:
+		case DXGI_FORMAT_R32G32B32_UINT:
+		case DXGI_FORMAT_R32G32B32_SINT:
+			return( 3 );
+		case DXGI_FORMAT_R32G32_FLOAT:
+		case DXGI_FORMAT_R32G32_UINT:
+		case DXGI_FORMAT_R32G32_SINT:
+			return( 2 );
+		case DXGI_FORMAT_R32_FLOAT:
+		case DXGI_FORMAT_R32_UINT:
+		case DXGI_FORMAT_R32_SINT:
+			return( 1 );
+		default:
+			return( 0 );
+		}
+	}
+};
+//--------------------------------------------------------------------------------
 GeometryDX11::GeometryDX11( )
 {
 	m_iVertexSize = 0;
@@ -61,6 +341,10 @@ void GeometryDX11::Execute( PipelineManagerDX11* pPipeline, IParameterManager* p
 //--------------------------------------------------------------------------------
 void GeometryDX11::AddElement( VertexElementDX11* element )
 {
+	// The vertices of an interleaved stream have to become elements first, or
+	// they would be replaced by the single new element.
+	DeinterleaveVertices();
+
 	int index = -1;
 	for ( unsigned int i = 0; i < m_vElements.size(); i++ )
 	{
@@ -103,6 +387,13 @@ void GeometryDX11::AddIndex( UINT index )
 }
 //--------------------------------------------------------------------------------
 VertexElementDX11* GeometryDX11::GetElement( std::string name )
+{
+	DeinterleaveVertices();
+
+	return( FindElement( name ) );
+}
+//--------------------------------------------------------------------------------
+VertexElementDX11* GeometryDX11::FindElement( const std::string& name )
 {
     VertexElementDX11* pElement = NULL;
     for ( unsigned int i = 0; i < m_vElements.size(); i++ )
@@ -122,6 +413,8 @@ VertexElementDX11* GeometryDX11::GetElement( std::wstring name )
 //--------------------------------------------------------------------------------
 VertexElementDX11* GeometryDX11::GetElement( int index )
 {
+	DeinterleaveVertices();
+
 	return( m_vElements[index] );
 }
 //--------------------------------------------------------------------------------
@@ -248,6 +541,8 @@ int GeometryDX11::GetVertexCount()
 //--------------------------------------------------------------------------------
 int GeometryDX11::GetElementCount()
 {
+	DeinterleaveVertices();
+
 	return( m_vElements.size() );
 }
 //--------------------------------------------------------------------------------
@@ -258,6 +553,10 @@ int GeometryDX11::GetVertexSize()
 //--------------------------------------------------------------------------------
 int GeometryDX11::CalculateVertexSize()
 {
+	// Interleaved vertex streams keep the size that they were created with.
+	if ( m_vElements.size() == 0 && m_vVertexStream.size() > 0 )
+		return( m_iVertexSize );
+
 	// Reset the current vertex size 
 	m_iVertexSize = 0;
 
@@ -275,6 +574,8 @@ int GeometryDX11::CalculateVertexCount()
 	// elements, but the user should have all the same size elements...
 	if ( m_vElements.size() > 0 )
 		m_iVertexCount = m_vElements[0]->Count();
+	else if ( m_vVertexStream.size() > 0 )
+		m_iVertexCount = static_cast<int>( m_vVertexStream.size() / m_iVertexSize );
 	else
 		m_iVertexCount = 0;
 
@@ -285,7 +586,7 @@ void GeometryDX11::GenerateInputLayout( int ShaderID )
 {
 	int iElems = m_vElements.size();
 
-	if ( iElems == 0 )
+	if ( iElems == 0 && m_vVertexStream.size() == 0 )
 	{
 		// If no vertex elements exist in the geometry, then we can assume the 
 		// vertex data will be generated in the shader itself.  In this case, the
@@ -311,23 +612,9 @@ void GeometryDX11::GenerateInputLayout( int ShaderID )
 		// Check the number of vertices to be created
 		CalculateVertexCount();
 
-		// Allocate the necessary number of element descriptions
-		std::vector<D3D11_INPUT_ELEMENT_DESC> elements;
-
 		// Fill in the vertex element descriptions based on each element
-		for ( unsigned int i = 0; i < m_vElements.size(); i++ )
-		{
-			D3D11_INPUT_ELEMENT_DESC e;
-			e.SemanticName = m_vElements[i]->m_SemanticName.c_str();
-			e.SemanticIndex = m_vElements[i]->m_uiSemanticIndex;
-			e.Format = m_vElements[i]->m_Format;
-			e.InputSlot = m_vElements[i]->m_uiInputSlot;
-			e.AlignedByteOffset = m_vElements[i]->m_uiAlignedByteOffset;
-			e.InputSlotClass = m_vElements[i]->m_InputSlotClass;
-			e.InstanceDataStepRate = m_vElements[i]->m_uiInstanceDataStepRate;
-			
-			elements.push_back( e );
-		}
+		std::vector<D3D11_INPUT_ELEMENT_DESC> elements;
+		GetInputElementDescs( elements );
 
 		// Create the input layout for the given shader index
 
@@ -344,6 +631,10 @@ void GeometryDX11::GenerateInputLayout( int ShaderID )
 //--------------------------------------------------------------------------------
 void GeometryDX11::LoadToBuffers()
 {
+	// The geometry is complete once it is loaded, so this is where its bounds
+	// are refreshed.
+	CalculateBounds();
+
 	// Check the number of vertices to be created
 	CalculateVertexCount();
 
@@ -355,28 +646,26 @@ void GeometryDX11::LoadToBuffers()
 		// Load the vertex buffer first by calculating the required size
 		unsigned int vertices_length = GetVertexSize() * GetVertexCount();
 
-		char* pBytes = new char[vertices_length];
+		// An interleaved stream is used as it is, and the elements are only
+		// interleaved into a temporary buffer.
 
-		for ( int j = 0; j < m_iVertexCount; j++ )
+		std::vector<char> interleaved;
+		const char* pBytes = m_vVertexStream.data();
+
+		if ( m_vElements.size() > 0 )
 		{
-			int iElemOffset = 0;
-			for ( unsigned int i = 0; i < m_vElements.size(); i++ )
-			{
-				memcpy( pBytes + j * m_iVertexSize + iElemOffset, m_vElements[i]->GetPtr(j), m_vElements[i]->SizeInBytes() );
-				iElemOffset += m_vElements[i]->SizeInBytes();
-			}
+			InterleaveVertices( interleaved );
+			pBytes = interleaved.data();
 		}
 
 		D3D11_SUBRESOURCE_DATA data;
-		data.pSysMem = reinterpret_cast<void*>( pBytes );
+		data.pSysMem = reinterpret_cast<const void*>( pBytes );
 		data.SysMemPitch = 0;
 		data.SysMemSlicePitch = 0;
 
 		BufferConfigDX11 vbuffer;
 		vbuffer.SetDefaultVertexBuffer( vertices_length, false );
 		m_VB = RendererDX11::Get()->CreateVertexBuffer( &vbuffer, &data );
-
-		delete [] pBytes; 
 	}
 	
 	// Load the index buffer by calculating the required size
@@ -391,6 +680,206 @@ void GeometryDX11::LoadToBuffers()
 	m_IB = RendererDX11::Get()->CreateIndexBuffer( &ibuffer, &data );
 }
 //--------------------------------------------------------------------------------
+void GeometryDX11::InterleaveVertices( std::vector<char>& vertices )
+{
+	CalculateVertexCount();
+	CalculateVertexSize();
+
+	vertices.resize( m_iVertexSize * m_iVertexCount );
+
+	if ( m_vElements.size() == 0 )
+	{
+		vertices.assign( m_vVertexStream.begin(), m_vVertexStream.end() );
+		return;
+	}
+
+	// Each element is copied in a single pass over its own contiguous data,
+	// with a fixed stride through the interleaved vertices.
+
+	int iElemOffset = 0;
+
+	for ( auto pElement : m_vElements )
+	{
+		const int size = pElement->SizeInBytes();
+		const char* pSource = reinterpret_cast<const char*>( pElement->GetPtr( 0 ) );
+		char* pDest = vertices.data() + iElemOffset;
+
+		for ( int j = 0; j < m_iVertexCount; j++ )
+		{
+			memcpy( pDest, pSource, size );
+			pDest += m_iVertexSize;
+			pSource += size;
+		}
+
+		iElemOffset += size;
+	}
+}
+//--------------------------------------------------------------------------------
+void GeometryDX11::SetInterleavedVertices( const char* pVertices, int vertexSize, int vertexCount, const std::vector<D3D11_INPUT_ELEMENT_DESC>& layout )
+{
+	m_vVertexStream.assign( pVertices, pVertices + vertexSize * vertexCount );
+	m_iVertexSize = vertexSize;
+	m_iVertexCount = vertexCount;
+
+	// The semantic names are copied, and the descriptions are pointed at the
+	// copies once all of them are in place.
+
+	m_vStreamLayout = layout;
+	m_vStreamSemantics.clear();
+
+	for ( auto& element : layout )
+		m_vStreamSemantics.push_back( element.SemanticName );
+
+	for ( unsigned int i = 0; i < m_vStreamLayout.size(); i++ )
+		m_vStreamLayout[i].SemanticName = m_vStreamSemantics[i].c_str();
+}
+//--------------------------------------------------------------------------------
+bool GeometryDX11::DeinterleaveVertices( )
+{
+	if ( m_vElements.size() > 0 || m_vVertexStream.size() == 0 )
+		return( m_vElements.size() > 0 );
+
+	// The layout elements follow each other in the stream without any padding,
+	// in the same way that InterleaveVertices writes them.
+
+	std::vector<VertexElementDX11*> elements;
+	int iElemOffset = 0;
+
+	for ( auto& desc : m_vStreamLayout )
+	{
+		const int tuple = FormatTupleSize( desc.Format );
+		const int size = tuple * sizeof( float );
+
+		if ( tuple == 0 || iElemOffset + size > m_iVertexSize )
+			break;
+
+		VertexElementDX11* pElement = new VertexElementDX11( tuple, m_iVertexCount );
+		pElement->m_SemanticName = desc.SemanticName;
+		pElement->m_uiSemanticIndex = desc.SemanticIndex;
+		pElement->m_Format = desc.Format;
+		pElement->m_uiInputSlot = desc.InputSlot;
+		pElement->m_uiAlignedByteOffset = desc.AlignedByteOffset;
+		pElement->m_InputSlotClass = desc.InputSlotClass;
+		pElement->m_uiInstanceDataStepRate = desc.InstanceDataStepRate;
+
+		const char* pSource = m_vVertexStream.data() + iElemOffset;
+		char* pDest = reinterpret_cast<char*>( pElement->GetPtr( 0 ) );
+
+		for ( int j = 0; j < m_iVertexCount; j++ )
+		{
+			memcpy( pDest, pSource, size );
+			pDest += size;
+			pSource += m_iVertexSize;
+		}
+
+		elements.push_back( pElement );
+		iElemOffset += size;
+	}
+
+	if ( elements.size() != m_vStreamLayout.size() || iElemOffset != m_iVertexSize )
+	{
+		for ( auto pElement : elements )
+			delete pElement;
+
+		Log::Get().Write( L"Could not rebuild the vertex elements of an interleaved vertex stream!" );
+		return( false );
+	}
+
+	m_vElements = elements;
+
+	std::vector<char>().swap( m_vVertexStream );
+	m_vStreamLayout.clear();
+	m_vStreamSemantics.clear();
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void GeometryDX11::GetInputElementDescs( std::vector<D3D11_INPUT_ELEMENT_DESC>& elements )
+{
+	elements.clear();
+
+	if ( m_vElements.size() == 0 )
+	{
+		elements = m_vStreamLayout;
+		return;
+	}
+
+	for ( unsigned int i = 0; i < m_vElements.size(); i++ )
+	{
+		D3D11_INPUT_ELEMENT_DESC e;
+		e.SemanticName = m_vElements[i]->m_SemanticName.c_str();
+		e.SemanticIndex = m_vElements[i]->m_uiSemanticIndex;
+		e.Format = m_vElements[i]->m_Format;
+		e.InputSlot = m_vElements[i]->m_uiInputSlot;
+		e.AlignedByteOffset = m_vElements[i]->m_uiAlignedByteOffset;
+		e.InputSlotClass = m_vElements[i]->m_InputSlotClass;
+		e.InstanceDataStepRate = m_vElements[i]->m_uiInstanceDataStepRate;
+
+		elements.push_back( e );
+	}
+}
+//--------------------------------------------------------------------------------
+void GeometryDX11::CalculateBounds( )
+{
+	// The sphere is centered on the box around the positions, which is a good
+	// enough fit for culling.  Streams don't have a position element, so their
+	// bounds are left as they were restored instead of rebuilding the elements.
+
+	VertexElementDX11* pPositions = FindElement( VertexElementDX11::PositionSemantic );
+
+	if ( pPositions == nullptr || pPositions->Tuple() < 3 || pPositions->Count() == 0 )
+		return;
+
+	Vector3f vMin = *pPositions->Get3f( 0 );
+	Vector3f vMax = vMin;
+
+	for ( int i = 1; i < pPositions->Count(); i++ )
+	{
+		const Vector3f& p = *pPositions->Get3f( i );
+
+		vMin.x = min( vMin.x, p.x ); vMax.x = max( vMax.x, p.x );
+		vMin.y = min( vMin.y, p.y ); vMax.y = max( vMax.y, p.y );
+		vMin.z = min( vMin.z, p.z ); vMax.z = max( vMax.z, p.z );
+	}
+
+	m_Bounds.center = ( vMin + vMax ) * 0.5f;
+	m_Bounds.radius = 0.0f;
+
+	for ( int i = 0; i < pPositions->Count(); i++ )
+		m_Bounds.radius = max( m_Bounds.radius, Vector3f::LengthSq( *pPositions->Get3f( i ) - m_Bounds.center ) );
+
+	m_Bounds.radius = sqrtf( m_Bounds.radius );
+}
+//--------------------------------------------------------------------------------
+const Sphere3f& GeometryDX11::GetBounds( )
+{
+	return( m_Bounds );
+}
+//--------------------------------------------------------------------------------
+bool GeometryDX11::GetModelBounds( Sphere3f& bounds )
+{
+	// Bounds that were never calculated or restored are empty.
+
+	if ( m_Bounds.radius <= 0.0f )
+		return( false );
+
+	// The bone semantic is searched for in both the elements and the layout of
+	// an interleaved stream.
+
+	if ( FindElement( VertexElementDX11::BoneIDSemantic ) != nullptr )
+		return( false );
+
+	for ( auto& semantic : m_vStreamSemantics )
+	{
+		if ( semantic == VertexElementDX11::BoneIDSemantic )
+			return( false );
+	}
+
+	bounds = m_Bounds;
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
 UINT GeometryDX11::GetIndexCount()
 {
 	return( m_vIndices.size() );
@@ -399,7 +888,8 @@ UINT GeometryDX11::GetIndexCount()
 bool GeometryDX11::ComputeTangentFrame( std::string positionSemantic,
                                         std::string normalSemantic, 
                                         std::string texCoordSemantic,
-                                        std::string tangentSemantic )
+                                        std::string tangentSemantic,
+                                        JobScheduler* pScheduler )
 {
     // Only works for triangle lists    
     if ( m_ePrimType != D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST )
@@ -437,8 +927,40 @@ bool GeometryDX11::ComputeTangentFrame( std::string positionSemantic,
         return false;
     }
 
+    const unsigned int vertexCount = static_cast<unsigned int>( CalculateVertexCount() );
+    const unsigned int triangleCount = static_cast<unsigned int>( m_vIndices.size() / 3 );
+
+    if ( pPositionElement->Count() < static_cast<int>( vertexCount ) || pNormalElement->Count() < static_cast<int>( vertexCount ) ||
+        pTexCoordElement->Count() < static_cast<int>( vertexCount ) )
+    {
+        Log::Get().Write( L"Tangent frame computation failed, the vertex elements have different sizes" );
+        return false;
+    }
+
+    // Compute the tangent frame for each vertex. The following code is based on 
+    // "Computing Tangent Space Basis Vectors for an Arbitrary Mesh", by Eric Lengyel
+    // http://www.terathon.com/code/tangent.html
+    //
+    // The directions are computed per triangle first, and then summed up for
+    // the vertices.  A single thread sums them up in one pass over the
+    // triangles.  With several threads, the triangles are grouped by vertex
+    // once instead, so that the vertices can be split into blocks that each
+    // only visit their own triangles.  Both add up the same values in the same
+    // order, so the results don't depend on the number of threads.
+
+    for ( UINT i = 0; i < triangleCount * 3; i++ )
+    {
+        if ( m_vIndices[i] >= vertexCount )
+        {
+            Log::Get().Write( L"Tangent frame computation failed, an index is out of range" );
+            return false;
+        }
+    }
+
+    std::vector<float> directions( static_cast<size_t>( triangleCount ) * DIRECTION_STRIDE );
+
     // Add the new element for the tangent
-    VertexElementDX11* pTangentElement = new VertexElementDX11( 4, CalculateVertexCount() );
+    VertexElementDX11* pTangentElement = new VertexElementDX11( 4, vertexCount );
     pTangentElement->m_SemanticName = VertexElementDX11::TangentSemantic;
     pTangentElement->m_uiSemanticIndex = 0;
     pTangentElement->m_Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
@@ -447,77 +969,48 @@ bool GeometryDX11::ComputeTangentFrame( std::string positionSemantic,
     pTangentElement->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
     pTangentElement->m_uiInstanceDataStepRate = 0;
 
-    // Compute the tangent frame for each vertex. The following code is based on 
-    // "Computing Tangent Space Basis Vectors for an Arbitrary Mesh", by Eric Lengyel
-    // http://www.terathon.com/code/tangent.html
+    const UINT* pIndices = m_vIndices.data();
+    const float* pPositions = ( *pPositionElement )[0];
+    const float* pNormals = ( *pNormalElement )[0];
+    const float* pTexCoords = ( *pTexCoordElement )[0];
+    float* pDirections = directions.data();
+    float* pTangents = ( *pTangentElement )[0];
 
-    // Make temporary arrays for the tangent and the bitangent
-    Vector3f* tangents = new Vector3f[m_iVertexCount];
-    Vector3f* bitangents = new Vector3f[m_iVertexCount];
-    ZeroMemory( tangents, m_iVertexCount * sizeof( Vector3f ) );
-    ZeroMemory( bitangents, m_iVertexCount * sizeof( Vector3f ) );
+    // Use the renderer's job scheduler if none was given, as long as there is
+    // enough work to split up.
+    if ( pScheduler == nullptr && RendererDX11::Get() != nullptr )
+        pScheduler = RendererDX11::Get()->GetJobScheduler();
 
-    // Loop through each triangle    
-    for ( UINT i = 0; i < m_vIndices.size(); i += 3 )
+    if ( pScheduler != nullptr && pScheduler->GetThreadCount() > 1 && triangleCount > TANGENT_BLOCK_SIZE )
     {
-        UINT i1 = m_vIndices[i + 0];
-        UINT i2 = m_vIndices[i + 1];
-        UINT i3 = m_vIndices[i + 2];
-
-        const Vector3f& v1 = *pPositionElement->Get3f( i1 );
-        const Vector3f& v2 = *pPositionElement->Get3f( i2 );
-        const Vector3f& v3 = *pPositionElement->Get3f( i3 );
-
-        const Vector2f& w1 = *pTexCoordElement->Get2f( i1 );
-        const Vector2f& w2 = *pTexCoordElement->Get2f( i2 );
-        const Vector2f& w3 = *pTexCoordElement->Get2f( i3 );
-
-        float x1 = v2.x - v1.x;
-        float x2 = v3.x - v1.x;
-        float y1 = v2.y - v1.y;
-        float y2 = v3.y - v1.y;
-        float z1 = v2.z - v1.z;
-        float z2 = v3.z - v1.z;
-
-        float s1 = w2.x - w1.x;
-        float s2 = w3.x - w1.x;
-        float t1 = w2.y - w1.y;
-        float t2 = w3.y - w1.y;
-
-        float r = 1.0f / ( s1 * t2 - s2 * t1 );
-        Vector3f sDir( ( t2 * x1 - t1 * x2) * r, ( t2 * y1 - t1 * y2 ) * r,
-            ( t2 * z1 - t1 * z2 ) * r );
-        Vector3f tDir( ( s1 * x2 - s2 * x1) * r, ( s1 * y2 - s2 * y1 ) * r,
-            ( s1 * z2 - s2 * z1 ) * r );
-
-        tangents[i1] += sDir;
-        tangents[i2] += sDir;
-        tangents[i3] += sDir;
-
-        bitangents[i1] += tDir;
-        bitangents[i2] += tDir;
-        bitangents[i3] += tDir;        
-    }
+        const unsigned int worker = pScheduler->GetWorkerIndex();
 
-    for ( int i = 0; i < m_iVertexCount; ++i )
-    {
-        Vector3f& n = *pNormalElement->Get3f( i );
-        Vector3f& t = tangents[i];
+        pScheduler->ParallelFor( triangleCount, TANGENT_BLOCK_SIZE, [=]( unsigned int begin, unsigned int end, unsigned int ) {
+            computeTriangleDirections( pIndices, pPositions, pTexCoords, pDirections, begin, end );
+        }, worker );
 
-        // Gram-Schmidt orthogonalize
-        Vector3f tangent = Vector3f::Normalize( ( t - n * Vector3f::Dot( n, t ) ) );                
+        std::vector<UINT> offsets;
+        std::vector<UINT> triangles;
+        groupVertexTriangles( pIndices, triangleCount, vertexCount, offsets, triangles );
 
-        // Calculate handedness
-        float sign = ( Vector3f::Dot( Vector3f::Cross( n, t ), bitangents[i] ) < 0.0f ) ? -1.0f : 1.0f;
+        const UINT* pOffsets = offsets.data();
+        const UINT* pTriangles = triangles.data();
+
+        pScheduler->ParallelFor( vertexCount, TANGENT_BLOCK_SIZE, [=]( unsigned int begin, unsigned int end, unsigned int ) {
+            std::vector<float> sums( static_cast<size_t>( end - begin ) * DIRECTION_STRIDE, 0.0f );
+            sumVertexDirections( pOffsets, pTriangles, pDirections, sums.data(), begin, end );
+            computeVertexTangents( sums.data(), pNormals, pTangents, begin, end );
+        }, worker );
+    }
+    else
+    {
+        std::vector<float> sums( static_cast<size_t>( vertexCount ) * DIRECTION_STRIDE, 0.0f );
 
-        Vector4f& finalTangent = *pTangentElement->Get4f( i );
-        finalTangent = Vector4f( tangent, sign );
+        computeTriangleDirections( pIndices, pPositions, pTexCoords, pDirections, 0, triangleCount );
+        sumVertexDirections( pIndices, triangleCount, pDirections, sums.data() );
+        computeVertexTangents( sums.data(), pNormals, pTangents, 0, vertexCount );
     }
 
-    // Clean up our temporary arrays
-    delete[] tangents;
-    delete[] bitangents;
-    
     AddElement( pTangentElement );
 
     return true;
@@ -19,6 +19,7 @@
 #include "ShaderResourceParameterWriterDX11.h"
 #include "EventManager.h"
 #include "EvtErrorMessage.h"
+#include "AssetCacheDX11.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
@@ -923,10 +924,10 @@ void GeometryGeneratorDX11::GenerateWeightedSkinnedCone( GeometryPtr pGeometry,
 						
 				pGeometry->SetPrimitiveType( D3D11_PRIMITIVE_TOPOLOGY_3_CONTROL_POINT_PATCHLIST );		
 
-				ResourcePtr ColorTexture = RendererDX11::Get()->LoadTexture( L"EyeOfHorus_128_blurred.png" );
+				ResourcePtr ColorTexture = AssetCacheDX11::Get().GetTexture( L"EyeOfHorus_128_blurred.png" );
 				pActor->GetBody()->Parameters.SetShaderResourceParameter( L"ColorTexture", ColorTexture );
 
-				ResourcePtr HeightTexture = RendererDX11::Get()->LoadTexture( L"EyeOfHorus.png" );
+				ResourcePtr HeightTexture = AssetCacheDX11::Get().GetTexture( L"EyeOfHorus.png" );
 				pActor->GetBody()->Parameters.SetShaderResourceParameter( L"HeightTexture", HeightTexture );
 
 				SamplerStateConfigDX11 SamplerConfig;
@@ -21,6 +21,8 @@
 #include "MaterialGeneratorDX11.h"
 #include <sstream>
 #include "FileSystem.h"
+#include "MemoryMappedFile.h"
+#include "GeometryCacheDX11.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
@@ -28,475 +30,407 @@ GeometryLoaderDX11::GeometryLoaderDX11( )
 {
 }
 //--------------------------------------------------------------------------------
-GeometryPtr GeometryLoaderDX11::loadMS3DFile2( std::wstring filename )
+namespace
 {
-	// Get the file path to the models
-	FileSystem fs;
-	filename = fs.GetModelsFolder() + filename;
+	// The versions of the geometry that the cached loaders produce.  They are a
+	// part of the geometry cache keys, so they have to be incremented whenever
+	// a change to a loader changes its output.  Otherwise stale cache files
+	// would keep being used in place of the new output.
 
-	// Temporary Milkshape structures
-	unsigned short usVertexCount = 0;
-	unsigned short usTriangleCount = 0;
-	unsigned short usGroupCount = 0;
-	unsigned short usMaterialCount = 0;
-	MS3DVertex* pMS3DVertices = NULL;
-	MS3DTriangle* pMS3DTriangles = NULL;
-	MS3DGroup* pMS3DGroups = NULL;
-	MS3DMaterial* pMS3DMaterials = NULL;
-
-	std::ifstream fin;
-	MS3DHeader header;
-
-	// Open the file and read the MS3D header data
-	fin.open( filename.c_str(),std::ios::binary );
-	fin.read((char*)(&(header.id)), sizeof(header.id));
-	fin.read((char*)(&(header.version)), sizeof(header.version));
-	if (header.version!=3 && header.version!=4)
-		return NULL;
-
-	// Load all the vertices
-	fin.read((char*)(&usVertexCount), sizeof(unsigned short));
-	pMS3DVertices = new MS3DVertex[usVertexCount];
-	for (int i = 0; i < usVertexCount; i++)
-	{
-		fin.read((char*)&(pMS3DVertices[i].flags), sizeof(unsigned char));
-		fin.read((char*)&(pMS3DVertices[i].vertex[0]), sizeof(float));
-		fin.read((char*)&(pMS3DVertices[i].vertex[1]), sizeof(float));
-		fin.read((char*)&(pMS3DVertices[i].vertex[2]), sizeof(float));
-		fin.read((char*)&(pMS3DVertices[i].boneId), sizeof(char));
-		fin.read((char*)&(pMS3DVertices[i].referenceCount), sizeof(unsigned char));
-	}
+	const unsigned int MS3D_COOKER_VERSION = 2;
+	const unsigned int PLY_COOKER_VERSION = 1;
 
-	// Load all the triangle indices
-	fin.read((char*)(&usTriangleCount), sizeof(unsigned short));
-	pMS3DTriangles = new MS3DTriangle[usTriangleCount];
-	for (int i = 0; i < usTriangleCount; i++)
+	VertexElementDX11* CreateVertexElement( const std::string& semantic, int tuple, DXGI_FORMAT format, unsigned int count, bool first )
 	{
-		fin.read((char*)&(pMS3DTriangles[i].flags),sizeof(unsigned short));
-		fin.read((char*)&(pMS3DTriangles[i].vertexIndices[0]), sizeof(unsigned short)); //3*sizeof(unsigned short));
-		fin.read((char*)&(pMS3DTriangles[i].vertexIndices[1]), sizeof(unsigned short)); //3*sizeof(unsigned short));
-		fin.read((char*)&(pMS3DTriangles[i].vertexIndices[2]), sizeof(unsigned short)); //3*sizeof(unsigned short));
-		fin.read((char*)&(pMS3DTriangles[i].vertexNormals[0]), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].vertexNormals[1]), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].vertexNormals[2]), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].s), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].t), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].smoothingGroup), sizeof(unsigned char));
-		fin.read((char*)&(pMS3DTriangles[i].groupIndex), sizeof(unsigned char));
+		VertexElementDX11* pElement = new VertexElementDX11( tuple, count );
+		pElement->m_SemanticName = semantic;
+		pElement->m_uiSemanticIndex = 0;
+		pElement->m_Format = format;
+		pElement->m_uiInputSlot = 0;
+		pElement->m_uiAlignedByteOffset = first ? 0 : D3D11_APPEND_ALIGNED_ELEMENT;
+		pElement->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+		pElement->m_uiInstanceDataStepRate = 0;
+
+		return( pElement );
 	}
 
-	// Load all the group information
-	fin.read((char*)(&usGroupCount), sizeof(unsigned short));
-	pMS3DGroups = new MS3DGroup[usGroupCount];
-	for (int i = 0; i < usGroupCount; i++)
-	{
-		fin.read((char*)&(pMS3DGroups[i].flags), sizeof(unsigned char));
-		fin.read((char*)&(pMS3DGroups[i].name), sizeof(char[32]));
-		fin.read((char*)&(pMS3DGroups[i].numtriangles), sizeof(unsigned short));
-		unsigned short triCount = pMS3DGroups[i].numtriangles;
-		pMS3DGroups[i].triangleIndices = new unsigned short[triCount];
-		fin.read((char*)(pMS3DGroups[i].triangleIndices), sizeof(unsigned short) * triCount);
-		fin.read((char*)&(pMS3DGroups[i].materialIndex), sizeof(char));
-	}
+	// Reads the packed fields of a file from memory.  Reading past the end of
+	// the data fails, and leaves the destination untouched.
 
-	// Load all the material information
-	fin.read((char*)(&usMaterialCount),sizeof(unsigned short));
-	pMS3DMaterials = new MS3DMaterial[usMaterialCount];
-	for (int i = 0; i < usMaterialCount; i++)
+	class BinaryReader
 	{
-		fin.read((char*)&(pMS3DMaterials[i].name), sizeof(char[32]));
-		fin.read((char*)&(pMS3DMaterials[i].ambient), 4 * sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].diffuse), 4 * sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].specular), 4 * sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].emissive), 4 * sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].shininess), sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].transparency), sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].mode), sizeof(char));
-		fin.read((char*)&(pMS3DMaterials[i].texture), sizeof(char[128]));
-		fin.read((char*)&(pMS3DMaterials[i].alphamap), sizeof(char[128]));
-	}
+	public:
+		BinaryReader( const char* pData, size_t size ) :
+			m_pCursor( pData ), m_pEnd( pData + size )
+		{
+		}
 
-	// Close the file (remaining file data unused)
-	fin.close();
-
-
-	// create the vertex element streams
-	VertexElementDX11* pPositions = new VertexElementDX11( 3, usTriangleCount*3 );
-    pPositions->m_SemanticName = VertexElementDX11::PositionSemantic;
-	pPositions->m_uiSemanticIndex = 0;
-	pPositions->m_Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	pPositions->m_uiInputSlot = 0;
-	pPositions->m_uiAlignedByteOffset = 0;
-	pPositions->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	pPositions->m_uiInstanceDataStepRate = 0;
-
-	VertexElementDX11* pTexcoords = new VertexElementDX11( 2, usTriangleCount*3 );
-	pTexcoords->m_SemanticName = VertexElementDX11::TexCoordSemantic;
-	pTexcoords->m_uiSemanticIndex = 0;
-	pTexcoords->m_Format = DXGI_FORMAT_R32G32_FLOAT;
-	pTexcoords->m_uiInputSlot = 0;
-	pTexcoords->m_uiAlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	pTexcoords->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	pTexcoords->m_uiInstanceDataStepRate = 0;
-
-	VertexElementDX11* pNormals = new VertexElementDX11( 3, usTriangleCount*3 );
-	pNormals->m_SemanticName = VertexElementDX11::NormalSemantic;
-	pNormals->m_uiSemanticIndex = 0;
-	pNormals->m_Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	pNormals->m_uiInputSlot = 0;
-	pNormals->m_uiAlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	pNormals->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	pNormals->m_uiInstanceDataStepRate = 0;
-
-	Vector3f* pPos = (Vector3f*)((*pPositions)[0]);
-	Vector3f* pNrm = (Vector3f*)((*pNormals)[0]);
-	Vector2f* pTex = (Vector2f*)((*pTexcoords)[0]);
+		bool Read( void* pDest, size_t size )
+		{
+			if ( static_cast<size_t>( m_pEnd - m_pCursor ) < size )
+				return( false );
 
-	GeometryPtr MeshPtr = GeometryPtr( new GeometryDX11() );
+			memcpy( pDest, m_pCursor, size );
+			m_pCursor += size;
 
-	//for ( int i = 0; i < usVertexCount; i++ )
-	//{
-	//	pPos[i].x() = pMS3DVertices[i].vertex[0];
-	//	pPos[i].y() = pMS3DVertices[i].vertex[1];
-	//	pPos[i].z() = -pMS3DVertices[i].vertex[2];
-	//	pNrm[i].MakeZero();
-	//}
+			return( true );
+		}
 
-	TriangleIndices face;
+		template <typename T>
+		bool Read( T& value )
+		{
+			return( Read( &value, sizeof( T ) ) );
+		}
 
-	for ( int i = 0; i < usTriangleCount; i++ )
-	{
+		bool Skip( size_t size )
+		{
+			if ( static_cast<size_t>( m_pEnd - m_pCursor ) < size )
+				return( false );
 
-		face.i1 = 3*i+0;
-		face.i2 = 3*i+2;
-		face.i3 = 3*i+1;
-
-		pPos[3*i+0].x = pMS3DVertices[pMS3DTriangles[i].vertexIndices[0]].vertex[0];
-		pPos[3*i+0].y = pMS3DVertices[pMS3DTriangles[i].vertexIndices[0]].vertex[1];
-		pPos[3*i+0].z = -pMS3DVertices[pMS3DTriangles[i].vertexIndices[0]].vertex[2];
-		pPos[3*i+1].x = pMS3DVertices[pMS3DTriangles[i].vertexIndices[1]].vertex[0];
-		pPos[3*i+1].y = pMS3DVertices[pMS3DTriangles[i].vertexIndices[1]].vertex[1];
-		pPos[3*i+1].z = -pMS3DVertices[pMS3DTriangles[i].vertexIndices[1]].vertex[2];
-		pPos[3*i+2].x = pMS3DVertices[pMS3DTriangles[i].vertexIndices[2]].vertex[0];
-		pPos[3*i+2].y = pMS3DVertices[pMS3DTriangles[i].vertexIndices[2]].vertex[1];
-		pPos[3*i+2].z = -pMS3DVertices[pMS3DTriangles[i].vertexIndices[2]].vertex[2];
-
-		pNrm[3*i+0].x = pMS3DTriangles[i].vertexNormals[0][0];
-		pNrm[3*i+0].y = pMS3DTriangles[i].vertexNormals[0][1];
-		pNrm[3*i+0].z = -pMS3DTriangles[i].vertexNormals[0][2];
-		pNrm[3*i+1].x = pMS3DTriangles[i].vertexNormals[1][0];
-		pNrm[3*i+1].y = pMS3DTriangles[i].vertexNormals[1][1];
-		pNrm[3*i+1].z = -pMS3DTriangles[i].vertexNormals[1][2];
-		pNrm[3*i+2].x = pMS3DTriangles[i].vertexNormals[2][0];
-		pNrm[3*i+2].y = pMS3DTriangles[i].vertexNormals[2][1];
-		pNrm[3*i+2].z = -pMS3DTriangles[i].vertexNormals[2][2];
-
-		pTex[3*i+0].x = pMS3DTriangles[i].s[0];
-		pTex[3*i+0].y = pMS3DTriangles[i].t[0];
-		pTex[3*i+1].x = pMS3DTriangles[i].s[1];
-		pTex[3*i+1].y = pMS3DTriangles[i].t[1];
-		pTex[3*i+2].x = pMS3DTriangles[i].s[2];
-		pTex[3*i+2].y = pMS3DTriangles[i].t[2];
-
-		MeshPtr->AddFace( face );
-	}
+			m_pCursor += size;
 
-	for ( int i = 0; i < usVertexCount; i++ )
-	{
-		pNrm[i].Normalize();
-	}
+			return( true );
+		}
 
-	MeshPtr->AddElement( pPositions );
-	MeshPtr->AddElement( pTexcoords );
-	MeshPtr->AddElement( pNormals );
+	private:
+		const char*	m_pCursor;
+		const char*	m_pEnd;
+	};
 
-	// Delete temporary materials
-	if (pMS3DMaterials != NULL)
+	// The contents of an MS3D file that are used by the loaders.  The keyframes
+	// are held in vectors, so the pointers of the joint structures are unused.
+
+	struct MS3DJointData
 	{
-		delete[] pMS3DMaterials;
-		pMS3DMaterials = NULL;
-	}
+		MS3DKeyframeJoint joint;
+		std::vector<MS3DKeyframeRotation> rotations;
+		std::vector<MS3DKeyframePosition> positions;
+	};
 
-	// Delete temporary groups and their indices
-	if (pMS3DGroups != NULL)
+	struct MS3DModel
 	{
-		for (int i = 0; i < usGroupCount; i++)
+		std::vector<MS3DVertex> vertices;
+		std::vector<MS3DTriangle> triangles;
+		std::vector<MS3DJointData> joints;
+	};
+
+	bool ReadMS3DFile( const std::wstring& filename, bool withJoints, MS3DModel& model )
+	{
+		// The whole file is mapped into memory, and the fields are copied out of
+		// it directly instead of reading them one at a time from a stream.
+
+		MemoryMappedFile file;
+
+		if ( !file.Open( filename ) )
+			return( false );
+
+		BinaryReader reader( file.GetDataPtr(), file.GetDataSize() );
+
+		MS3DHeader header;
+		if ( !reader.Read( header.id ) || !reader.Read( header.version ) )
+			return( false );
+
+		if ( header.version != 3 && header.version != 4 )
+			return( false );
+
+		// Load all the vertices
+		unsigned short usVertexCount = 0;
+		if ( !reader.Read( usVertexCount ) )
+			return( false );
+
+		model.vertices.resize( usVertexCount );
+
+		for ( auto& vertex : model.vertices )
 		{
-			if (pMS3DGroups[i].triangleIndices != NULL)
-			{
-				delete[] pMS3DGroups[i].triangleIndices;
-				pMS3DGroups[i].triangleIndices = NULL;
-			}
+			if ( !reader.Read( vertex.flags ) || !reader.Read( vertex.vertex ) ||
+				 !reader.Read( vertex.boneId ) || !reader.Read( vertex.referenceCount ) )
+				return( false );
+		}
+
+		// Load all the triangle indices
+		unsigned short usTriangleCount = 0;
+		if ( !reader.Read( usTriangleCount ) )
+			return( false );
+
+		model.triangles.resize( usTriangleCount );
+
+		for ( auto& triangle : model.triangles )
+		{
+			if ( !reader.Read( triangle.flags ) || !reader.Read( triangle.vertexIndices ) ||
+				 !reader.Read( triangle.vertexNormals ) || !reader.Read( triangle.s ) ||
+				 !reader.Read( triangle.t ) || !reader.Read( triangle.smoothingGroup ) ||
+				 !reader.Read( triangle.groupIndex ) )
+				return( false );
+
+			for ( int i = 0; i < 3; i++ )
+				if ( triangle.vertexIndices[i] >= usVertexCount )
+					return( false );
+		}
+
+		if ( !withJoints )
+			return( true );
+
+		// Skip over the groups and materials, which aren't used by the loaders.
+		unsigned short usGroupCount = 0;
+		if ( !reader.Read( usGroupCount ) )
+			return( false );
+
+		for ( int i = 0; i < usGroupCount; i++ )
+		{
+			unsigned short triCount = 0;
+			if ( !reader.Skip( sizeof( unsigned char ) + sizeof( char[32] ) ) || !reader.Read( triCount ) ||
+				 !reader.Skip( sizeof( unsigned short ) * triCount + sizeof( char ) ) )
+				return( false );
+		}
+
+		unsigned short usMaterialCount = 0;
+		if ( !reader.Read( usMaterialCount ) )
+			return( false );
+
+		const size_t materialSize = sizeof( char[32] ) + 16 * sizeof( float ) + 2 * sizeof( float ) + sizeof( char ) + 2 * sizeof( char[128] );
+
+		if ( !reader.Skip( materialSize * usMaterialCount ) )
+			return( false );
+
+		// Files without any keyframer data just don't have a skeleton.
+		float fAnimationFPS;
+		float fCurrentTime;
+		int iTotalFrames;
+		unsigned short nNumJoints = 0;
+
+		if ( !reader.Read( fAnimationFPS ) || !reader.Read( fCurrentTime ) ||
+			 !reader.Read( iTotalFrames ) || !reader.Read( nNumJoints ) )
+			return( true );
+
+		model.joints.resize( nNumJoints );
+
+		for ( auto& data : model.joints )
+		{
+			MS3DKeyframeJoint& joint = data.joint;
+
+			if ( !reader.Read( joint.flags ) || !reader.Read( joint.name ) ||
+				 !reader.Read( joint.parentName ) || !reader.Read( joint.rotation ) ||
+				 !reader.Read( joint.position ) || !reader.Read( joint.numKeyFramesRot ) ||
+				 !reader.Read( joint.numKeyFramesTrans ) )
+				return( false );
+
+			joint.name[31] = 0;
+			joint.parentName[31] = 0;
+			joint.keyFramesRot = nullptr;
+			joint.keyFramesTrans = nullptr;
+
+			data.rotations.resize( joint.numKeyFramesRot );
+			data.positions.resize( joint.numKeyFramesTrans );
+
+			for ( auto& key : data.rotations )
+				if ( !reader.Read( key.time ) || !reader.Read( key.rotation ) )
+					return( false );
+
+			for ( auto& key : data.positions )
+				if ( !reader.Read( key.time ) || !reader.Read( key.position ) )
+					return( false );
 		}
-		delete[] pMS3DGroups;
-		pMS3DGroups = NULL;
+
+		return( true );
 	}
 
-	// Delete temporary triangles
-	if (pMS3DTriangles != NULL)
+	// A vertex of the expanded triangle list, which is used as the key to weld
+	// identical vertices together.  The members are all four bytes wide, so the
+	// structure has no padding and can be hashed and compared as raw bytes.
+
+	struct MS3DCorner
 	{
-		delete[] pMS3DTriangles;
-		pMS3DTriangles = NULL;
-	}
+		float position[3];
+		float normal[3];
+		float texcoord[2];
+		int bone;
+	};
 
-	// Delete temporary vertices
-	if (pMS3DVertices != NULL)
+	struct MS3DCornerHash
 	{
-        delete[] pMS3DVertices;
-		pMS3DVertices = NULL;
-	}
+		size_t operator()( const MS3DCorner& corner ) const
+		{
+			// FNV-1a over the bytes of the corner.
+			const unsigned char* pBytes = reinterpret_cast<const unsigned char*>( &corner );
+			unsigned int hash = 2166136261u;
 
-	//MeshPtr->GenerateVertexDeclaration();
-	//MeshPtr->LoadToBuffers();
+			for ( size_t i = 0; i < sizeof( MS3DCorner ); i++ )
+				hash = ( hash ^ pBytes[i] ) * 16777619u;
 
-	return( MeshPtr );
-}
-//--------------------------------------------------------------------------------
-GeometryPtr GeometryLoaderDX11::loadMS3DFileWithAnimation( std::wstring filename, SkinnedActor* pActor )
-{
-	// Get the file path to the models
-	FileSystem fs;
-	filename = fs.GetModelsFolder() + filename;
+			return( hash );
+		}
+	};
 
-	// Temporary Milkshape structures
-	unsigned short usVertexCount = 0;
-	unsigned short usTriangleCount = 0;
-	unsigned short usGroupCount = 0;
-	unsigned short usMaterialCount = 0;
-	MS3DVertex* pMS3DVertices = NULL;
-	MS3DTriangle* pMS3DTriangles = NULL;
-	MS3DGroup* pMS3DGroups = NULL;
-	MS3DMaterial* pMS3DMaterials = NULL;
-
-	int i;
-	std::ifstream fin;
-	MS3DHeader header;
-
-	// Open the file and read the MS3D header data
-	fin.open( filename.c_str(),std::ios::binary );
-	fin.read((char*)(&(header.id)), sizeof(header.id));
-	fin.read((char*)(&(header.version)), sizeof(header.version));
-	if (header.version!=3 && header.version!=4)
-		return NULL;
-
-	// Load all the vertices
-	fin.read((char*)(&usVertexCount), sizeof(unsigned short));
-	pMS3DVertices = new MS3DVertex[usVertexCount];
-	for (i=0; i < usVertexCount; i++)
+	struct MS3DCornerEqual
 	{
-		fin.read((char*)&(pMS3DVertices[i].flags), sizeof(unsigned char));
-		fin.read((char*)&(pMS3DVertices[i].vertex[0]), sizeof(float));
-		fin.read((char*)&(pMS3DVertices[i].vertex[1]), sizeof(float));
-		fin.read((char*)&(pMS3DVertices[i].vertex[2]), sizeof(float));
-		fin.read((char*)&(pMS3DVertices[i].boneId), sizeof(char));
-		fin.read((char*)&(pMS3DVertices[i].referenceCount), sizeof(unsigned char));
-	}
+		bool operator()( const MS3DCorner& a, const MS3DCorner& b ) const
+		{
+			return( memcmp( &a, &b, sizeof( MS3DCorner ) ) == 0 );
+		}
+	};
 
-	// Load all the triangle indices
-	fin.read((char*)(&usTriangleCount), sizeof(unsigned short));
-	pMS3DTriangles = new MS3DTriangle[usTriangleCount];
-	for (i=0; i < usTriangleCount; i++)
+	float CanonicalFloat( float value )
 	{
-		fin.read((char*)&(pMS3DTriangles[i].flags),sizeof(unsigned short));
-		fin.read((char*)&(pMS3DTriangles[i].vertexIndices[0]), sizeof(unsigned short)); //3*sizeof(unsigned short));
-		fin.read((char*)&(pMS3DTriangles[i].vertexIndices[1]), sizeof(unsigned short)); //3*sizeof(unsigned short));
-		fin.read((char*)&(pMS3DTriangles[i].vertexIndices[2]), sizeof(unsigned short)); //3*sizeof(unsigned short));
-		fin.read((char*)&(pMS3DTriangles[i].vertexNormals[0]), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].vertexNormals[1]), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].vertexNormals[2]), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].s), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].t), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].smoothingGroup), sizeof(unsigned char));
-		fin.read((char*)&(pMS3DTriangles[i].groupIndex), sizeof(unsigned char));
+		// Negative zero compares equal to zero, but has a different bit pattern.
+		return( value == 0.0f ? 0.0f : value );
 	}
 
-	// Load all the group information
-	fin.read((char*)(&usGroupCount), sizeof(unsigned short));
-	pMS3DGroups = new MS3DGroup[usGroupCount];
-	for (i=0; i < usGroupCount; i++)
+	void WeldMS3DTriangles( const MS3DModel& model, bool withBones, bool weld, std::vector<MS3DCorner>& vertices, std::vector<UINT>& indices )
 	{
-		fin.read((char*)&(pMS3DGroups[i].flags), sizeof(unsigned char));
-		fin.read((char*)&(pMS3DGroups[i].name), sizeof(char[32]));
-		fin.read((char*)&(pMS3DGroups[i].numtriangles), sizeof(unsigned short));
-		unsigned short triCount = pMS3DGroups[i].numtriangles;
-		pMS3DGroups[i].triangleIndices = new unsigned short[triCount];
-		fin.read((char*)(pMS3DGroups[i].triangleIndices), sizeof(unsigned short) * triCount);
-		fin.read((char*)&(pMS3DGroups[i].materialIndex), sizeof(char));
-	}
+		// The z axis is mirrored when converting to the left handed coordinate
+		// system, so the winding order of the corners is reversed as well.
 
-	// Load all the material information
-	fin.read((char*)(&usMaterialCount),sizeof(unsigned short));
-	pMS3DMaterials = new MS3DMaterial[usMaterialCount];
-	for (i=0; i < usMaterialCount; i++)
-	{
-		fin.read((char*)&(pMS3DMaterials[i].name), sizeof(char[32]));
-		fin.read((char*)&(pMS3DMaterials[i].ambient), 4 * sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].diffuse), 4 * sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].specular), 4 * sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].emissive), 4 * sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].shininess), sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].transparency), sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].mode), sizeof(char));
-		fin.read((char*)&(pMS3DMaterials[i].texture), sizeof(char[128]));
-		fin.read((char*)&(pMS3DMaterials[i].alphamap), sizeof(char[128]));
-	}
+		static const int order[3] = { 0, 2, 1 };
 
-	float fAnimationFPS; // 4 bytes
-	float fCurrentTime; // 4 bytes
-	int iTotalFrames; // 4 bytes
-	unsigned short nNumJoints; // 2 bytes
+		std::unordered_map<MS3DCorner, UINT, MS3DCornerHash, MS3DCornerEqual> lookup;
+		lookup.reserve( weld ? model.triangles.size() * 3 : 0 );
 
-	fin.read((char*)&(fAnimationFPS), sizeof(float));
-	fin.read((char*)&(fCurrentTime), sizeof(float));
-	fin.read((char*)&(iTotalFrames), sizeof(int));
-	fin.read((char*)&(nNumJoints), sizeof(unsigned short));
+		vertices.clear();
+		indices.clear();
+		indices.reserve( model.triangles.size() * 3 );
 
+		// The loaders have always normalized only the first 'vertex count' normals
+		// of the expanded triangle corners, and the remaining normals are used as
+		// they are stored in the file.  This is kept so that the welded geometry
+		// matches the expanded corners exactly.
 
-	MS3DKeyframeJoint* pMS3DJoints = 0;
+		const size_t normalized = model.vertices.size();
 
-	if ( nNumJoints > 0 )
-		pMS3DJoints = new MS3DKeyframeJoint[nNumJoints];
+		for ( size_t t = 0; t < model.triangles.size(); t++ )
+		{
+			const MS3DTriangle& triangle = model.triangles[t];
 
-	for ( i = 0; i < nNumJoints; i++ )
+			for ( int k = 0; k < 3; k++ )
+			{
+				int c = order[k];
+				const MS3DVertex& vertex = model.vertices[triangle.vertexIndices[c]];
+
+				Vector3f normal( triangle.vertexNormals[c][0], triangle.vertexNormals[c][1], -triangle.vertexNormals[c][2] );
+
+				if ( 3 * t + c < normalized )
+					normal.Normalize();
+
+				MS3DCorner corner;
+				corner.position[0] = CanonicalFloat( vertex.vertex[0] );
+				corner.position[1] = CanonicalFloat( vertex.vertex[1] );
+				corner.position[2] = CanonicalFloat( -vertex.vertex[2] );
+				corner.normal[0] = CanonicalFloat( normal.x );
+				corner.normal[1] = CanonicalFloat( normal.y );
+				corner.normal[2] = CanonicalFloat( normal.z );
+				corner.texcoord[0] = CanonicalFloat( triangle.s[c] );
+				corner.texcoord[1] = CanonicalFloat( triangle.t[c] );
+				corner.bone = withBones ? vertex.boneId : 0;
+
+				// Without welding, every corner keeps a vertex of its own.
+
+				if ( !weld ) {
+					indices.push_back( static_cast<UINT>( vertices.size() ) );
+					vertices.push_back( corner );
+					continue;
+				}
+
+				auto result = lookup.insert( std::make_pair( corner, static_cast<UINT>( vertices.size() ) ) );
+
+				if ( result.second )
+					vertices.push_back( corner );
+
+				indices.push_back( result.first->second );
+			}
+		}
+	}
+
+	GeometryPtr CreateMS3DGeometry( const MS3DModel& model, bool withBones, bool weld )
 	{
-		fin.read((char*)&(pMS3DJoints[i].flags), sizeof(unsigned char));
-		fin.read((char*)&(pMS3DJoints[i].name), sizeof(char[32]));
-		fin.read((char*)&(pMS3DJoints[i].parentName), sizeof(char[32]));
-		fin.read((char*)&(pMS3DJoints[i].rotation[0]), 3 * sizeof(float));
-		fin.read((char*)&(pMS3DJoints[i].position[0]), 3 * sizeof(float));
-		fin.read((char*)&(pMS3DJoints[i].numKeyFramesRot), sizeof(unsigned short));
-		fin.read((char*)&(pMS3DJoints[i].numKeyFramesTrans), sizeof(unsigned short));
-
-		pMS3DJoints[i].keyFramesRot = new MS3DKeyframeRotation[pMS3DJoints[i].numKeyFramesRot];
-		pMS3DJoints[i].keyFramesTrans = new MS3DKeyframePosition[pMS3DJoints[i].numKeyFramesTrans];
-
-		for ( int j = 0; j < pMS3DJoints[i].numKeyFramesRot; j++ )
+		std::vector<MS3DCorner> vertices;
+		GeometryPtr MeshPtr = GeometryPtr( new GeometryDX11() );
+
+		WeldMS3DTriangles( model, withBones, weld, vertices, MeshPtr->m_vIndices );
+
+		unsigned int count = static_cast<unsigned int>( vertices.size() );
+
+		// create the vertex element streams
+		VertexElementDX11* pPositions = CreateVertexElement( VertexElementDX11::PositionSemantic, 3, DXGI_FORMAT_R32G32B32_FLOAT, count, true );
+		VertexElementDX11* pBoneIDs = withBones ? CreateVertexElement( VertexElementDX11::BoneIDSemantic, 1, DXGI_FORMAT_R32_SINT, count, false ) : nullptr;
+		VertexElementDX11* pTexcoords = CreateVertexElement( VertexElementDX11::TexCoordSemantic, 2, DXGI_FORMAT_R32G32_FLOAT, count, false );
+		VertexElementDX11* pNormals = CreateVertexElement( VertexElementDX11::NormalSemantic, 3, DXGI_FORMAT_R32G32B32_FLOAT, count, false );
+
+		Vector3f* pPos = pPositions->Get3f( 0 );
+		Vector3f* pNrm = pNormals->Get3f( 0 );
+		Vector2f* pTex = pTexcoords->Get2f( 0 );
+
+		for ( unsigned int i = 0; i < count; i++ )
 		{
-			fin.read((char*)&(pMS3DJoints[i].keyFramesRot[j].time), 1 * sizeof(float));
-			fin.read((char*)&(pMS3DJoints[i].keyFramesRot[j].rotation), 3 * sizeof(float));
+			const MS3DCorner& corner = vertices[i];
+
+			pPos[i] = Vector3f( corner.position[0], corner.position[1], corner.position[2] );
+			pNrm[i] = Vector3f( corner.normal[0], corner.normal[1], corner.normal[2] );
+			pTex[i] = Vector2f( corner.texcoord[0], corner.texcoord[1] );
 		}
 
-		for ( int j = 0; j < pMS3DJoints[i].numKeyFramesTrans; j++ )
+		MeshPtr->AddElement( pPositions );
+
+		if ( pBoneIDs )
 		{
-			fin.read((char*)&(pMS3DJoints[i].keyFramesTrans[j].time), 1 * sizeof(float));
-			fin.read((char*)&(pMS3DJoints[i].keyFramesTrans[j].position), 3 * sizeof(float));
-		}
+			int* pIds = pBoneIDs->Get1i( 0 );
 
-		//std::wstringstream s;
-		//s << GlyphString::ToUnicode( std::string( pMS3DJoints[i].name ) ) << std::endl;
-		//for ( int z = 0; z < pMS3DJoints[i].numKeyFramesRot; z++ )
-		//	s << L"rotation: " << pMS3DJoints[i].keyFramesRot[z].time << L" " <<pMS3DJoints[i].keyFramesRot[z].rotation[0] << L" " << pMS3DJoints[i].keyFramesRot[z].rotation[1] << L" " << pMS3DJoints[i].keyFramesRot[z].rotation[2] << std::endl;
+			for ( unsigned int i = 0; i < count; i++ )
+				pIds[i] = vertices[i].bone;
 
-		//for ( int z = 0; z < pMS3DJoints[i].numKeyFramesTrans; z++ )
-		//	s << L"position: " << pMS3DJoints[i].keyFramesTrans[z].time << L" " <<pMS3DJoints[i].keyFramesTrans[z].position[0] << L" " << pMS3DJoints[i].keyFramesTrans[z].position[1] << L" " << pMS3DJoints[i].keyFramesTrans[z].position[2] << std::endl;
+			MeshPtr->AddElement( pBoneIDs );
+		}
+
+		MeshPtr->AddElement( pTexcoords );
+		MeshPtr->AddElement( pNormals );
 
-		//Log::Get().Write( s.str() );
+		return( MeshPtr );
 	}
+};
+//--------------------------------------------------------------------------------
+GeometryPtr GeometryLoaderDX11::loadMS3DFile2( std::wstring filename, bool weld )
+{
+	// Get the file path to the models
+	FileSystem fs;
+	filename = fs.GetModelsFolder() + filename;
 
+	MS3DModel model;
 
+	if ( !ReadMS3DFile( filename, false, model ) )
+		return( NULL );
 
-	// Close the file (remaining file data unused)
-	fin.close();
-
-
-	// create the vertex element streams
-	VertexElementDX11* pPositions = new VertexElementDX11( 3, usTriangleCount*3 );
-	pPositions->m_SemanticName = VertexElementDX11::PositionSemantic;
-	pPositions->m_uiSemanticIndex = 0;
-	pPositions->m_Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	pPositions->m_uiInputSlot = 0;
-	pPositions->m_uiAlignedByteOffset = 0;
-	pPositions->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	pPositions->m_uiInstanceDataStepRate = 0;
-
-	VertexElementDX11* pBoneIDs = new VertexElementDX11( 1, usTriangleCount*3 );
-	pBoneIDs->m_SemanticName = VertexElementDX11::BoneIDSemantic;
-	pBoneIDs->m_uiSemanticIndex = 0;
-	pBoneIDs->m_Format = DXGI_FORMAT_R32_SINT;
-	pBoneIDs->m_uiInputSlot = 0;
-	pBoneIDs->m_uiAlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	pBoneIDs->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	pBoneIDs->m_uiInstanceDataStepRate = 0;
-
-	VertexElementDX11* pTexcoords = new VertexElementDX11( 2, usTriangleCount*3 );
-	pTexcoords->m_SemanticName = VertexElementDX11::TexCoordSemantic;
-	pTexcoords->m_uiSemanticIndex = 0;
-	pTexcoords->m_Format = DXGI_FORMAT_R32G32_FLOAT;
-	pTexcoords->m_uiInputSlot = 0;
-	pTexcoords->m_uiAlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	pTexcoords->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	pTexcoords->m_uiInstanceDataStepRate = 0;
-
-	VertexElementDX11* pNormals = new VertexElementDX11( 3, usTriangleCount*3 );
-	pNormals->m_SemanticName = VertexElementDX11::NormalSemantic;
-	pNormals->m_uiSemanticIndex = 0;
-	pNormals->m_Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	pNormals->m_uiInputSlot = 0;
-	pNormals->m_uiAlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	pNormals->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	pNormals->m_uiInstanceDataStepRate = 0;
-
-	Vector3f* pPos = pPositions->Get3f( 0 );
-	int* pIds = pBoneIDs->Get1i( 0 );
-	Vector3f* pNrm = pNormals->Get3f( 0 );
-	Vector2f* pTex = pTexcoords->Get2f( 0 );
+	// Identical vertices of the triangles are welded together if requested.
+	// Either way, the result is an indexed triangle list.
 
-	// Create the geometry object, and fill it with the data read from the file.
+	GeometryPtr MeshPtr = CreateMS3DGeometry( model, false, weld );
 
-	GeometryPtr MeshPtr = GeometryPtr( new GeometryDX11() );
+	//MeshPtr->LoadToBuffers();
 
-	TriangleIndices face;
+	return( MeshPtr );
+}
+//--------------------------------------------------------------------------------
+GeometryPtr GeometryLoaderDX11::loadMS3DFileCached( std::wstring filename )
+{
+	FileSystem fs;
 
-	for ( int i = 0; i < usTriangleCount; i++ )
-	{
+	return( GeometryCacheDX11::Load( fs.GetModelsFolder() + filename, "ms3d", MS3D_COOKER_VERSION, [&]() {
+		return( loadMS3DFile2( filename ) );
+	} ) );
+}
+//--------------------------------------------------------------------------------
+GeometryPtr GeometryLoaderDX11::loadMS3DFileWithAnimation( std::wstring filename, SkinnedActor* pActor )
+{
+	// Get the file path to the models
+	FileSystem fs;
+	filename = fs.GetModelsFolder() + filename;
 
-		face.i1 = 3*i+0;
-		face.i2 = 3*i+2;
-		face.i3 = 3*i+1;
-
-		pPos[3*i+0].x = pMS3DVertices[pMS3DTriangles[i].vertexIndices[0]].vertex[0];
-		pPos[3*i+0].y = pMS3DVertices[pMS3DTriangles[i].vertexIndices[0]].vertex[1];
-		pPos[3*i+0].z = -pMS3DVertices[pMS3DTriangles[i].vertexIndices[0]].vertex[2];
-		pPos[3*i+1].x = pMS3DVertices[pMS3DTriangles[i].vertexIndices[1]].vertex[0];
-		pPos[3*i+1].y = pMS3DVertices[pMS3DTriangles[i].vertexIndices[1]].vertex[1];
-		pPos[3*i+1].z = -pMS3DVertices[pMS3DTriangles[i].vertexIndices[1]].vertex[2];
-		pPos[3*i+2].x = pMS3DVertices[pMS3DTriangles[i].vertexIndices[2]].vertex[0];
-		pPos[3*i+2].y = pMS3DVertices[pMS3DTriangles[i].vertexIndices[2]].vertex[1];
-		pPos[3*i+2].z = -pMS3DVertices[pMS3DTriangles[i].vertexIndices[2]].vertex[2];
-
-		pIds[3*i+0] = pMS3DVertices[pMS3DTriangles[i].vertexIndices[0]].boneId;
-		pIds[3*i+1] = pMS3DVertices[pMS3DTriangles[i].vertexIndices[1]].boneId;
-		pIds[3*i+2] = pMS3DVertices[pMS3DTriangles[i].vertexIndices[2]].boneId;
-
-		pNrm[3*i+0].x = pMS3DTriangles[i].vertexNormals[0][0];
-		pNrm[3*i+0].y = pMS3DTriangles[i].vertexNormals[0][1];
-		pNrm[3*i+0].z = -pMS3DTriangles[i].vertexNormals[0][2];
-		pNrm[3*i+1].x = pMS3DTriangles[i].vertexNormals[1][0];
-		pNrm[3*i+1].y = pMS3DTriangles[i].vertexNormals[1][1];
-		pNrm[3*i+1].z = -pMS3DTriangles[i].vertexNormals[1][2];
-		pNrm[3*i+2].x = pMS3DTriangles[i].vertexNormals[2][0];
-		pNrm[3*i+2].y = pMS3DTriangles[i].vertexNormals[2][1];
-		pNrm[3*i+2].z = -pMS3DTriangles[i].vertexNormals[2][2];
-
-		pTex[3*i+0].x = pMS3DTriangles[i].s[0];
-		pTex[3*i+0].y = pMS3DTriangles[i].t[0];
-		pTex[3*i+1].x = pMS3DTriangles[i].s[1];
-		pTex[3*i+1].y = pMS3DTriangles[i].t[1];
-		pTex[3*i+2].x = pMS3DTriangles[i].s[2];
-		pTex[3*i+2].y = pMS3DTriangles[i].t[2];
-
-		MeshPtr->AddFace( face );
-	}
+	MS3DModel model;
 
-	for ( int i = 0; i < usVertexCount; i++ )
-	{
-		pNrm[i].Normalize();
-	}
+	if ( !ReadMS3DFile( filename, true, model ) )
+		return( NULL );
 
-	MeshPtr->AddElement( pPositions );
-	MeshPtr->AddElement( pBoneIDs );
-	MeshPtr->AddElement( pTexcoords );
-	MeshPtr->AddElement( pNormals );
+	// Create the geometry object, and fill it with the data read from the file.
+	// Vertices are only welded when they also share the same bone.
+
+	GeometryPtr MeshPtr = CreateMS3DGeometry( model, true, true );
 
 	// Now set the geometry in the SkinnedActor, and create the bones
 	// and add them to the SkinnedActor.
@@ -509,48 +443,46 @@ GeometryPtr GeometryLoaderDX11::loadMS3DFileWithAnimation( std::wstring filename
 		// Create an array of nodes, one for each joint.
 		std::map<std::string,Node3D*> JointNodes;
 
-		for ( int i = 0; i < nNumJoints; i++ )
+		for ( auto& data : model.joints )
 		{
+			const MS3DKeyframeJoint& joint = data.joint;
+
 			Node3D* pBone = new Node3D();
 
-			Vector3f BindPosition = Vector3f( pMS3DJoints[i].position[0],
-			 									pMS3DJoints[i].position[1],
-												pMS3DJoints[i].position[2] );
+			Vector3f BindPosition = Vector3f( joint.position[0], joint.position[1], joint.position[2] );
 
 			AnimationStream<Vector3f>* pPosFrames = new AnimationStream<Vector3f>();
 
-			for ( int j = 0; j < pMS3DJoints[i].numKeyFramesTrans; j++ )
+			for ( auto& key : data.positions )
 			{
-				Vector3f p = Vector3f( pMS3DJoints[i].keyFramesTrans[j].position[0],
-					pMS3DJoints[i].keyFramesTrans[j].position[1],
-					pMS3DJoints[i].keyFramesTrans[j].position[2] );
+				Vector3f p = Vector3f( key.position[0], key.position[1], key.position[2] );
 
-				pPosFrames->AddState( AnimationState<Vector3f>( pMS3DJoints[i].keyFramesTrans[j].time, p ) ); 
+				AnimationState<Vector3f> state( key.time, p );
+				pPosFrames->AddState( state );
 			}
 
 			AnimationStream<Vector3f>* pRotFrames = new AnimationStream<Vector3f>();
 			
-			Vector3f BindRotation = Vector3f( pMS3DJoints[i].rotation[0] + 6.28f, pMS3DJoints[i].rotation[1] + 6.28f, pMS3DJoints[i].rotation[2] + 6.28f );
+			Vector3f BindRotation = Vector3f( joint.rotation[0] + 6.28f, joint.rotation[1] + 6.28f, joint.rotation[2] + 6.28f );
 
-			for ( int j = 0; j < pMS3DJoints[i].numKeyFramesRot; j++ )
+			for ( auto& key : data.rotations )
 			{
-				Vector3f p = Vector3f( pMS3DJoints[i].keyFramesRot[j].rotation[0] + 6.28f,
-					pMS3DJoints[i].keyFramesRot[j].rotation[1] + 6.28f,
-					pMS3DJoints[i].keyFramesRot[j].rotation[2] + 6.28f );
+				Vector3f p = Vector3f( key.rotation[0] + 6.28f, key.rotation[1] + 6.28f, key.rotation[2] + 6.28f );
 
-				pRotFrames->AddState( AnimationState<Vector3f>( pMS3DJoints[i].keyFramesRot[j].time, p ) ); 
+				AnimationState<Vector3f> state( key.time, p );
+				pRotFrames->AddState( state );
 			}
 
 			pActor->AddBoneNode( pBone, BindPosition, BindRotation, pPosFrames, pRotFrames );
 
-			JointNodes[std::string(pMS3DJoints[i].name)] = pBone;
+			JointNodes[std::string(joint.name)] = pBone;
 		}
 
 		// Connect up the bones to form the skeleton.
-		for ( int i = 0; i < nNumJoints; i++ )
+		for ( auto& data : model.joints )
 		{
-			Node3D* pParent = JointNodes[std::string(pMS3DJoints[i].parentName)];
-			Node3D* pChild = JointNodes[std::string(pMS3DJoints[i].name)];
+			Node3D* pParent = JointNodes[std::string(data.joint.parentName)];
+			Node3D* pChild = JointNodes[std::string(data.joint.name)];
 
 			// If the node has a parent, link them
 			if ( pParent && pChild )
@@ -563,610 +495,656 @@ GeometryPtr GeometryLoaderDX11::loadMS3DFileWithAnimation( std::wstring filename
 		}
 	}
 
+	//MeshPtr->GenerateVertexDeclaration();
+	MeshPtr->LoadToBuffers();
 
-	// Delete temporary joint information
-	if ( pMS3DJoints )
+	return( MeshPtr );
+}
+//--------------------------------------------------------------------------------
+namespace
+{
+	// The scalar types that can be used by the properties of a PLY file.
+
+	enum PlyType
 	{
-		for ( int i = 0; i < nNumJoints; i++ )
-		{
-			delete[] pMS3DJoints[i].keyFramesRot;
-			delete[] pMS3DJoints[i].keyFramesTrans;
-		}
-		delete[] pMS3DJoints;
-	}
+		PLY_INVALID,
+		PLY_CHAR,
+		PLY_UCHAR,
+		PLY_SHORT,
+		PLY_USHORT,
+		PLY_INT,
+		PLY_UINT,
+		PLY_FLOAT,
+		PLY_DOUBLE
+	};
+
+	enum PlyFormat
+	{
+		PLY_ASCII,
+		PLY_BINARY_LITTLE_ENDIAN,
+		PLY_BINARY_BIG_ENDIAN
+	};
 
+	struct PlyProperty
+	{
+		std::string name;
+		bool isList;
+		PlyType type;
+		PlyType listLengthType;
+	};
 
-	// Delete temporary materials
-	if (pMS3DMaterials != NULL)
+	struct PlyElement
 	{
-		delete[] pMS3DMaterials;
-		pMS3DMaterials = NULL;
-	}
+		std::string name;
+		unsigned int count;
+		std::vector< PlyProperty > properties;
+	};
 
-	// Delete temporary groups and their indices
-	if (pMS3DGroups != NULL)
+	PlyType ParsePlyType( const std::string& name )
 	{
-		for (i = 0; i < usGroupCount; i++)
-		{
-			if (pMS3DGroups[i].triangleIndices != NULL)
-			{
-				delete[] pMS3DGroups[i].triangleIndices;
-				pMS3DGroups[i].triangleIndices = NULL;
-			}
-		}
-		delete[] pMS3DGroups;
-		pMS3DGroups = NULL;
+		// Both the original type names and the sized names are accepted.
+
+		if ( name == "char" || name == "int8" )			return( PLY_CHAR );
+		if ( name == "uchar" || name == "uint8" )		return( PLY_UCHAR );
+		if ( name == "short" || name == "int16" )		return( PLY_SHORT );
+		if ( name == "ushort" || name == "uint16" )		return( PLY_USHORT );
+		if ( name == "int" || name == "int32" )			return( PLY_INT );
+		if ( name == "uint" || name == "uint32" )		return( PLY_UINT );
+		if ( name == "float" || name == "float32" )		return( PLY_FLOAT );
+		if ( name == "double" || name == "float64" )	return( PLY_DOUBLE );
+
+		return( PLY_INVALID );
 	}
 
-	// Delete temporary triangles
-	if (pMS3DTriangles != NULL)
+	int FindPlyElementIndex( const std::vector<PlyElement>& elements, const std::string& name )
 	{
-		delete[] pMS3DTriangles;
-		pMS3DTriangles = NULL;
+		for ( unsigned int i = 0; i < elements.size(); i++ )
+			if ( elements[i].name == name )
+				return( i );
+
+		return( -1 );
 	}
 
-	// Delete temporary vertices
-	if (pMS3DVertices != NULL)
+	int FindPlyPropertyIndex( const std::vector<PlyProperty>& properties, const std::string& name )
 	{
-        delete[] pMS3DVertices;
-		pMS3DVertices = NULL;
+		for ( unsigned int i = 0; i < properties.size(); i++ )
+			if ( properties[i].name == name )
+				return( i );
+
+		return( -1 );
 	}
 
-	//MeshPtr->GenerateVertexDeclaration();
-	MeshPtr->LoadToBuffers();
+	// Parses the header, and returns a pointer to the first byte of the body.
 
-	return( MeshPtr );
-}
-//--------------------------------------------------------------------------------
-GeometryPtr GeometryLoaderDX11::loadStanfordPlyFile( std::wstring filename, bool withAdjacency )
-{
-	// Get the file path to the models
-	FileSystem fs;
-	filename = fs.GetModelsFolder() + filename;
+	const char* ParsePlyHeader( const char* pData, const char* pEnd, PlyFormat& format, std::vector<PlyElement>& elements )
+	{
+		const char* pCursor = pData;
+		bool bFormat = false;
+		unsigned int line = 0;
 
-	// Load the contents of the file
-	std::ifstream fin;
+		while ( pCursor < pEnd )
+		{
+			// Grab the next line of the header, without the line ending.
 
-	// Open the file and read the MS3D header data
-	fin.open( filename.c_str(), std::ios::in );
+			const char* pLineEnd = std::find( pCursor, pEnd, '\n' );
+			std::string txt( pCursor, pLineEnd );
+			pCursor = ( pLineEnd < pEnd ) ? pLineEnd + 1 : pEnd;
 
-	if(!fin.is_open())
-	{
-		// signal error - bad filename?
-		throw new std::exception( "Could not open file" );
-	}
+			if ( !txt.empty() && txt.back() == '\r' )
+				txt.pop_back();
 
-	// Parse the input
-	std::string txt;
+			std::istringstream tokens( txt );
+			std::string keyword;
+			tokens >> keyword;
 
-	// Read in header
-	std::getline(fin, txt);
+			if ( line++ == 0 )
+			{
+				if ( keyword != "ply" )
+					throw new std::exception( "File does not contain the correct header - 'PLY' expected." );
+			}
+			else if ( keyword == "end_header" )
+			{
+				if ( !bFormat )
+					throw new std::exception( "File header does not declare a format." );
 
-	if( 0 != txt.compare( "ply" ) )
-	{
-		// signal error - not a PLY format file
-		throw new std::exception( "File does not contain the correct header - 'PLY' expected." );
-	}
+				return( pCursor );
+			}
+			else if ( keyword == "format" )
+			{
+				std::string name, version;
+				tokens >> name >> version;
+
+				if ( name == "ascii" )
+					format = PLY_ASCII;
+				else if ( name == "binary_little_endian" )
+					format = PLY_BINARY_LITTLE_ENDIAN;
+				else if ( name == "binary_big_endian" )
+					format = PLY_BINARY_BIG_ENDIAN;
+				else
+					throw new std::exception( "File is not correct format - ASCII or binary 1.0 expected." );
+
+				if ( version != "1.0" )
+					throw new std::exception( "File is not correct format - ASCII or binary 1.0 expected." );
+
+				bFormat = true;
+			}
+			else if ( keyword == "comment" || keyword == "obj_info" || keyword.empty() )
+			{
+				continue;
+			}
+			else if ( keyword == "element" )
+			{
+				// "element <name> <count>"
+				PlyElement element;
+				tokens >> element.name >> element.count;
 
-	std::getline(fin, txt);
+				if ( tokens.fail() )
+					throw new std::exception( "File header contains an invalid element declaration" );
 
-	if( 0 != txt.compare( "format ascii 1.0" ) )
-	{
-		// signal error - not a format of PLY that this code supports
-		throw new std::exception( "File is not correct format - ASCII 1.0 expected." );
+				elements.push_back( element );
+			}
+			else if ( keyword == "property" )
+			{
+				// "property <type> <name>" or "property list <length_type> <type> <name>"
+				if ( elements.empty() )
+					throw new std::exception( "File header contains a property outside of an element" );
+
+				PlyProperty property;
+				std::string type;
+				tokens >> type;
+
+				property.isList = ( type == "list" );
+				property.listLengthType = PLY_INVALID;
+
+				if ( property.isList ) {
+					std::string lengthType;
+					tokens >> lengthType >> type;
+					property.listLengthType = ParsePlyType( lengthType );
+				}
+
+				tokens >> property.name;
+				property.type = ParsePlyType( type );
+
+				if ( tokens.fail() || property.type == PLY_INVALID || ( property.isList && property.listLengthType == PLY_INVALID ) )
+					throw new std::exception( "File header contains an invalid property declaration" );
+
+				elements.back().properties.push_back( property );
+			}
+			else
+			{
+				throw new std::exception( "File header contains unexpected line beginning" );
+			}
+		}
+
+		throw new std::exception( "File header is not terminated with 'end_header'" );
 	}
 
-	std::vector< PlyElementDesc > elements;
+	// The readers decode one value at a time from the body of the file.  The body
+	// decoding is a template on the reader type, so the format is only checked
+	// once per file instead of once per value.
 
-	// Read in the rest of the header
-	while(fin.is_open() && !fin.eof())
+	class PlyAsciiReader
 	{
-		// Grab the next line of the header
-		std::getline(fin, txt);
+	public:
+		PlyAsciiReader( const char* pBegin, const char* pEnd ) :
+			m_pCursor( pBegin ), m_pEnd( pEnd )
+		{
+		}
 
-		// If we're at the end then stop processing
-		if(0 == txt.compare("end_header"))
+		double ReadValue( PlyType type )
 		{
-			break;
+			NextToken();
+
+			// Integers are scanned directly, and the floating point values are
+			// handed to strtod from a null terminated copy of the token, since
+			// the mapped data isn't terminated.
+
+			if ( type != PLY_FLOAT && type != PLY_DOUBLE )
+				return( static_cast<double>( ScanInteger() ) );
+
+			char buffer[64];
+			size_t length = m_pTokenEnd - m_pCursor;
+
+			if ( length >= sizeof( buffer ) )
+				throw new std::exception( "File contains an invalid number" );
+
+			memcpy( buffer, m_pCursor, length );
+			buffer[length] = 0;
+
+			char* pParsed = nullptr;
+			double value = strtod( buffer, &pParsed );
+
+			if ( pParsed != buffer + length )
+				throw new std::exception( "File contains an invalid number" );
+
+			m_pCursor = m_pTokenEnd;
+
+			return( value );
 		}
-		// If this line is a comment, skip to the next line
-		else if(0 == txt.compare(0, 7, "comment"))
+
+		unsigned int ReadIndex( PlyType type )
 		{
-			continue;
+			NextToken();
+
+			if ( type == PLY_FLOAT || type == PLY_DOUBLE ) {
+				m_pCursor = m_pTokenEnd;
+				return( 0 );
+			}
+
+			return( static_cast<unsigned int>( ScanInteger() ) );
 		}
-		// If this line is an element, process it
-		else if(0 == txt.compare(0, 7, "element"))
+
+		void SkipValue( PlyType type )
 		{
-			elements.push_back(ParsePLYElementHeader( txt, fin ));
+			NextToken();
+			m_pCursor = m_pTokenEnd;
 		}
-		// Otherwise, wtf?
-		else
+
+	private:
+		static bool IsSpace( char c )
 		{
-			throw new std::exception("File header contains unexpected line beginning");
+			return( c == ' ' || c == '\t' || c == '\r' || c == '\n' );
 		}
-	}
 
-	// Read all the raw data
-	for( std::vector< PlyElementDesc >::iterator it = elements.begin(); it != elements.end(); ++it)
-	{
-		(*it).data = ReadPLYElementData(fin, *it);
-	}
+		void NextToken()
+		{
+			while ( m_pCursor < m_pEnd && IsSpace( *m_pCursor ) )
+				m_pCursor++;
 
-	// Create a resource to contain the geometry
-	GeometryPtr MeshPtr = GeometryPtr( new GeometryDX11() );
+			if ( m_pCursor == m_pEnd )
+				throw new std::exception( "Unexpected end of file" );
 
-	// Convert data to D3D11 format
-	int elemIdx = -1;
+			m_pTokenEnd = m_pCursor;
 
-	// Pull out all the vertex data
-	if(-1 < (elemIdx = FindPlyElementIndex(elements, "vertex")))
-	{
-		PlyElementDesc d = elements.at( elemIdx );
-		
-		// Has positions?
-		int xIdx = FindPlyElementPropertyIndex( d.dataFormat, "x" );
-		int yIdx = FindPlyElementPropertyIndex( d.dataFormat, "y" );
-		int zIdx = FindPlyElementPropertyIndex( d.dataFormat, "z" );
-
-		if ((-1 != xIdx) && (-1 != yIdx) && (-1 != zIdx))
-		{
-			VertexElementDX11 *pPositions = new VertexElementDX11( 3, d.elementCount );
-			pPositions->m_SemanticName = VertexElementDX11::PositionSemantic;
-			pPositions->m_uiSemanticIndex = 0;
-			pPositions->m_Format = DXGI_FORMAT_R32G32B32_FLOAT;
-			pPositions->m_uiInputSlot = 0;
-			pPositions->m_uiAlignedByteOffset = 0;
-			pPositions->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-			pPositions->m_uiInstanceDataStepRate = 0;
-
-			Vector3f* pRawPos = pPositions->Get3f( 0 );
-
-			for(int v = 0; v < d.elementCount; ++v)
-			{
-				void** raw = d.data.at(v);
+			while ( m_pTokenEnd < m_pEnd && !IsSpace( *m_pTokenEnd ) )
+				m_pTokenEnd++;
+		}
 
-				float x = *reinterpret_cast<float*>(raw[xIdx]);
-				float y = *reinterpret_cast<float*>(raw[yIdx]);
-				float z = *reinterpret_cast<float*>(raw[zIdx]);
+		long long ScanInteger()
+		{
+			bool negative = false;
 
-				pRawPos[v] = Vector3f( x, y, z );
-			}
+			if ( *m_pCursor == '-' || *m_pCursor == '+' )
+				negative = ( *m_pCursor++ == '-' );
 
-			MeshPtr->AddElement( pPositions );
-		}
+			if ( m_pCursor == m_pTokenEnd )
+				throw new std::exception( "File contains an invalid number" );
 
-		// Has normals?
-		int nxIdx = FindPlyElementPropertyIndex( d.dataFormat, "nx" );
-		int nyIdx = FindPlyElementPropertyIndex( d.dataFormat, "ny" );
-		int nzIdx = FindPlyElementPropertyIndex( d.dataFormat, "nz" );
+			long long value = 0;
 
-		if ((-1 != nxIdx) && (-1 != nyIdx) && (-1 != nzIdx))
-		{
-			VertexElementDX11 *pNormals = new VertexElementDX11( 3, d.elementCount );
-			pNormals->m_SemanticName = VertexElementDX11::NormalSemantic;
-			pNormals->m_uiSemanticIndex = 0;
-			pNormals->m_Format = DXGI_FORMAT_R32G32B32_FLOAT;
-			pNormals->m_uiInputSlot = 0;
-			pNormals->m_uiAlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-			pNormals->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-			pNormals->m_uiInstanceDataStepRate = 0;
-
-			Vector3f* pRawNorms = pNormals->Get3f( 0 );
-
-			for(int v = 0; v < d.elementCount; ++v)
+			for ( ; m_pCursor < m_pTokenEnd; m_pCursor++ )
 			{
-				void** raw = d.data.at(v);
+				unsigned int digit = static_cast<unsigned int>( *m_pCursor - '0' );
 
-				float x = *reinterpret_cast<float*>(raw[nxIdx]);
-				float y = *reinterpret_cast<float*>(raw[nyIdx]);
-				float z = *reinterpret_cast<float*>(raw[nzIdx]);
+				if ( digit > 9 )
+					throw new std::exception( "File contains an invalid number" );
 
-				pRawNorms[v] = Vector3f( x, y, z );
+				value = value * 10 + digit;
 			}
 
-			MeshPtr->AddElement( pNormals );
+			return( negative ? -value : value );
 		}
-	}
-	else
-	{
-		throw new std::exception("Expected a 'vertex' element, but not found");
-	}
 
-	// Pull out all the face index data
-	if(-1 < (elemIdx = FindPlyElementIndex(elements, "face")))
+		const char*	m_pCursor;
+		const char*	m_pTokenEnd;
+		const char*	m_pEnd;
+	};
+
+	template <bool Swap>
+	class PlyBinaryReader
 	{
-		PlyElementDesc d = elements.at( elemIdx );
+	public:
+		PlyBinaryReader( const char* pBegin, const char* pEnd ) :
+			m_pCursor( pBegin ), m_pEnd( pEnd )
+		{
+		}
 
-		// Firstly, assert that the format is correct
-		if((1 != d.dataFormat.size()) && d.dataFormat.at(0).isList && (0 == d.dataFormat.at(0).type.compare("uint")))
+		double ReadValue( PlyType type )
 		{
-			// Expect a single list of integers
-			throw new std::exception("Expected 'face' to be a single list of integers per-face");
+			switch ( type )
+			{
+			case PLY_CHAR:		return( Read<signed char>() );
+			case PLY_UCHAR:		return( Read<unsigned char>() );
+			case PLY_SHORT:		return( Read<short>() );
+			case PLY_USHORT:	return( Read<unsigned short>() );
+			case PLY_INT:		return( Read<int>() );
+			case PLY_UINT:		return( Read<unsigned int>() );
+			case PLY_FLOAT:		return( Read<float>() );
+			default:			return( Read<double>() );
+			}
 		}
 
-		// Secondly, assert that each list is of the same dimension
-		int faceSize = -1;
-		for(int f = 0; f < d.elementCount; ++f)
+		unsigned int ReadIndex( PlyType type )
 		{
-			void** raw = d.data.at(f);
-			PlyDataArray<int>* idxs = reinterpret_cast<PlyDataArray<int>*>(raw[0]);
-			
-			if( -1 == faceSize)
-				faceSize = idxs->length;
-			else if(faceSize != idxs->length)
-				throw new std::exception("Expected each face to have the same number of indexes");
+			switch ( type )
+			{
+			case PLY_CHAR:		return( static_cast<unsigned int>( Read<signed char>() ) );
+			case PLY_UCHAR:		return( Read<unsigned char>() );
+			case PLY_SHORT:		return( static_cast<unsigned int>( Read<short>() ) );
+			case PLY_USHORT:	return( Read<unsigned short>() );
+			case PLY_INT:		return( static_cast<unsigned int>( Read<int>() ) );
+			case PLY_UINT:		return( Read<unsigned int>() );
+			case PLY_FLOAT:		return( static_cast<unsigned int>( Read<float>() ) );
+			default:			return( static_cast<unsigned int>( Read<double>() ) );
+			}
 		}
 
-		if(withAdjacency)
+		void SkipValue( PlyType type )
 		{
-			MeshPtr->SetPrimitiveType( (D3D11_PRIMITIVE_TOPOLOGY)(D3D11_PRIMITIVE_TOPOLOGY_1_CONTROL_POINT_PATCHLIST + ((2*faceSize) - 1)) );
+			static const size_t sizes[] = { 0, 1, 1, 2, 2, 4, 4, 4, 8 };
 
-			// Grab all of the faces so we can search for adjacency
-			int* pRaw = new int[d.elementCount * faceSize];
+			if ( static_cast<size_t>( m_pEnd - m_pCursor ) < sizes[type] )
+				throw new std::exception( "Unexpected end of file" );
 
-			int pRawIdx = 0;
+			m_pCursor += sizes[type];
+		}
 
-			for(int f = 0; f < d.elementCount; ++f)
-			{
-				void** raw = d.data.at(f);
-				PlyDataArray<int>* idxs = reinterpret_cast<PlyDataArray<int>*>(raw[0]);
+	private:
+		template <typename T>
+		T Read()
+		{
+			if ( static_cast<size_t>( m_pEnd - m_pCursor ) < sizeof( T ) )
+				throw new std::exception( "Unexpected end of file" );
 
-				for(unsigned int fi = 0; fi < idxs->length; ++fi)
-					pRaw[pRawIdx++] = idxs->data[fi];
-			}
+			char bytes[sizeof( T )];
+			memcpy( bytes, m_pCursor, sizeof( T ) );
+			m_pCursor += sizeof( T );
 
-			// We can now go and add the actual indices
-			for(int f = 0; f < (d.elementCount * faceSize); f+=3)
-			{
-				MeshPtr->AddIndex( pRaw[f + 0] );
-				MeshPtr->AddIndex( pRaw[f + 1] );
-				MeshPtr->AddIndex( pRaw[f + 2] );
-
-				// We now need to find an adjacency for each
-				// edge where possible
-				int a0 = FindAdjacentIndex( pRaw[f + 0], pRaw[f + 1], pRaw[f + 2], pRaw, d.elementCount * faceSize );
-				int a1 = FindAdjacentIndex( pRaw[f + 1], pRaw[f + 2], pRaw[f + 0], pRaw, d.elementCount * faceSize );
-				int a2 = FindAdjacentIndex( pRaw[f + 2], pRaw[f + 0], pRaw[f + 1], pRaw, d.elementCount * faceSize );
-
-				std::wstringstream out;
-				out << "Actual indices <" << pRaw[f+0] << ", " << pRaw[f+1] << ", " << pRaw[f+2] << "> have adjacency <" << a0 << ", " << a1 << ", " << a2 << ">.";
-				OutputDebugString( out.str().c_str() );
-				OutputDebugString( L"\n" );
-
-				MeshPtr->AddIndex( a0 );
-				MeshPtr->AddIndex( a1 );
-				MeshPtr->AddIndex( a2 );
-			}
+			if ( Swap )
+				std::reverse( bytes, bytes + sizeof( T ) );
+
+			T value;
+			memcpy( &value, bytes, sizeof( T ) );
 
-			delete[] pRaw;
+			return( value );
 		}
-		else
-		{
-			// Thirdly, can now set the appropriate topology
-			MeshPtr->SetPrimitiveType( (D3D11_PRIMITIVE_TOPOLOGY)(D3D11_PRIMITIVE_TOPOLOGY_1_CONTROL_POINT_PATCHLIST + (faceSize - 1)) );
 
-			// Finally, extract this data
-			for(int f = 0; f < d.elementCount; ++f)
-			{
-				void** raw = d.data.at(f);
-				PlyDataArray<int>* idxs = reinterpret_cast<PlyDataArray<int>*>(raw[0]);
+		const char*	m_pCursor;
+		const char*	m_pEnd;
+	};
 
-				for(unsigned int fi = 0; fi < idxs->length; ++fi)
-					MeshPtr->AddIndex( idxs->data[fi] );
-			}
-		}
-	}
-	else
+	// The destinations for the decoded data.  Each vertex property is written to
+	// its own float pointer (with a stride of three floats) if it is used, and
+	// the face lists are appended to the index array.
+
+	struct PlyTargets
 	{
-		throw new std::exception("Expected a 'face' element, but not found");
-	}
+		int vertexElement;
+		std::vector<float*> vertexOutputs;
 
-	// Push into renderable resource
-	MeshPtr->LoadToBuffers( );
+		int faceElement;
+		int faceProperty;
+		int faceSize;
+		std::vector<UINT>* pIndices;
+	};
 
-	// Release all intermediary memory
-	for( std::vector< PlyElementDesc >::iterator it = elements.begin(); it != elements.end(); ++it)
+	template <typename TReader>
+	void ReadPlyBody( TReader& reader, const std::vector<PlyElement>& elements, PlyTargets& targets )
 	{
-		PlyElementDesc d = *it;
-		for(int e = 0; e < d.elementCount; ++e)
+		for ( int e = 0; e < static_cast<int>( elements.size() ); e++ )
 		{
-			void** raw = d.data.at(e);
+			const PlyElement& element = elements[e];
+			const std::vector<PlyProperty>& properties = element.properties;
 
-			if(d.dataFormat.at(0).isList)
-			{
-				PlyDataArray<void*>* rawArray = reinterpret_cast<PlyDataArray<void*>*>(raw[0]);
-				SAFE_DELETE_ARRAY( rawArray->data );
-				SAFE_DELETE(raw[0]);
-			}
-			else
+			for ( unsigned int i = 0; i < element.count; i++ )
 			{
-				SAFE_DELETE(raw[0]);
+				for ( unsigned int p = 0; p < properties.size(); p++ )
+				{
+					const PlyProperty& property = properties[p];
+
+					if ( e == targets.faceElement && static_cast<int>( p ) == targets.faceProperty )
+					{
+						int length = static_cast<int>( reader.ReadValue( property.listLengthType ) );
+
+						if ( targets.faceSize == -1 )
+							targets.faceSize = length;
+						else if ( targets.faceSize != length )
+							throw new std::exception( "Expected each face to have the same number of indexes" );
+
+						for ( int v = 0; v < length; v++ )
+							targets.pIndices->push_back( reader.ReadIndex( property.type ) );
+					}
+					else if ( property.isList )
+					{
+						int length = static_cast<int>( reader.ReadValue( property.listLengthType ) );
+
+						for ( int v = 0; v < length; v++ )
+							reader.SkipValue( property.type );
+					}
+					else if ( e == targets.vertexElement && targets.vertexOutputs[p] )
+					{
+						targets.vertexOutputs[p][3*i] = static_cast<float>( reader.ReadValue( property.type ) );
+					}
+					else
+					{
+						reader.SkipValue( property.type );
+					}
+				}
 			}
 		}
 	}
 
-	// Return to caller
-	return MeshPtr;
-}
-
-int GeometryLoaderDX11::FindAdjacentIndex( int edgeStart, int edgeEnd, int triV, int* pRaw, int rawLen)
-{
-	for(int f = 0; f < rawLen; f+=3)
+	unsigned long long PlyEdgeKey( UINT a, UINT b )
 	{
-		int esIdx = -1;
-		for( int i = 0; i < 3; ++i ) { if(pRaw[f+i]==edgeStart) esIdx = i; }
+		return( a < b ? ( static_cast<unsigned long long>( a ) << 32 ) | b
+					  : ( static_cast<unsigned long long>( b ) << 32 ) | a );
+	}
 
-		int eeIdx = -1;
-		for( int i = 0; i < 3; ++i ) { if(pRaw[f+i]==edgeEnd) eeIdx = i; }
+	void BuildTriangleAdjacency( const std::vector<UINT>& triangles, std::vector<UINT>& output )
+	{
+		// Record the opposite vertex of the first two triangles that share each
+		// edge, in the order of the triangles.  An edge's adjacent vertex is then
+		// the opposite vertex of the other triangle, or the edge's start vertex if
+		// the edge is on a boundary.
 
-		if((-1!=esIdx)&&(-1!=eeIdx))
+		struct EdgeOpposites
 		{
-			int oIdx = -1;
-			for(int i = 0; i < 3; ++i) { if((i!=esIdx) && (i!=eeIdx)) oIdx = i; }
+			UINT first;
+			UINT second;
+			unsigned int count;
+		};
 
-			if(pRaw[f+oIdx]!=triV)
-				return pRaw[f + oIdx];
-		}
-	}
+		std::unordered_map<unsigned long long, EdgeOpposites> edges;
+		edges.reserve( triangles.size() );
 
-	return edgeStart;
-}
+		for ( size_t t = 0; t + 2 < triangles.size(); t += 3 )
+		{
+			for ( int k = 0; k < 3; k++ )
+			{
+				UINT a = triangles[t + k];
+				UINT b = triangles[t + ( k + 1 ) % 3];
+				UINT c = triangles[t + ( k + 2 ) % 3];
 
-GeometryLoaderDX11::PlyElementDesc GeometryLoaderDX11::ParsePLYElementHeader(std::string headerLine, std::ifstream& input)
-{
-	GeometryLoaderDX11::PlyElementDesc desc;
-	std::string txt;
-
-	// Parse the header line
-	// "element <name> <count>"
-	int split = headerLine.find_first_of(' ', 8);
-	desc.name = headerLine.substr(8, split - 8);
-		
-	split = headerLine.rfind( ' ' );
-	std::istringstream elemCount(headerLine.substr(split, headerLine.length() - split));
-	elemCount >> desc.elementCount;
-
-	// Parse any attached properties
-	while(input.is_open() && !input.eof())
-	{
-		std::getline( input, txt );
+				EdgeOpposites& edge = edges[PlyEdgeKey( a, b )];
 
-		if(0 == txt.compare(0, 13, "property list"))
-		{
-			// Parse this property list declaration
-			desc.dataFormat.push_back(ParsePLYElementPropertyList(txt.substr(14, txt.length() - 14)));
-		}
-		else if(0 == txt.compare(0, 8, "property"))
-		{
-			// Parse this property declaration
-			desc.dataFormat.push_back(ParsePLYElementProperty(txt.substr(9, txt.length() - 9)));
+				if ( edge.count == 0 )
+					edge.first = c;
+				else if ( edge.count == 1 )
+					edge.second = c;
+
+				edge.count++;
+			}
 		}
-		else
+
+		output.clear();
+		output.reserve( triangles.size() * 2 );
+
+		for ( size_t t = 0; t + 2 < triangles.size(); t += 3 )
 		{
-			// At this point we'll also have read a line too far so
-			// need to "unread" it to avoid breaking remaining parsing.
-			input.putback('\n');
-			for(int i = -1 + txt.length(); i >= 0; i--)
-				input.putback(txt.at(i));
-			// (there must be a better way, no?!?)
-			break;
+			output.push_back( triangles[t + 0] );
+			output.push_back( triangles[t + 1] );
+			output.push_back( triangles[t + 2] );
+
+			for ( int k = 0; k < 3; k++ )
+			{
+				UINT a = triangles[t + k];
+				UINT b = triangles[t + ( k + 1 ) % 3];
+				UINT c = triangles[t + ( k + 2 ) % 3];
+
+				const EdgeOpposites& edge = edges[PlyEdgeKey( a, b )];
+
+				if ( edge.first != c )
+					output.push_back( edge.first );
+				else if ( edge.count > 1 && edge.second != c )
+					output.push_back( edge.second );
+				else
+					output.push_back( a );
+			}
 		}
 	}
+};
+//--------------------------------------------------------------------------------
+GeometryPtr GeometryLoaderDX11::loadStanfordPlyFile( std::wstring filename, bool withAdjacency )
+{
+	GeometryPtr MeshPtr = loadStanfordPlyData( filename, withAdjacency );
 
-	return desc;
-}
+	// Push into renderable resource
+	MeshPtr->LoadToBuffers( );
 
-GeometryLoaderDX11::PlyElementPropertyDeclaration GeometryLoaderDX11::ParsePLYElementProperty(std::string desc)
+	return( MeshPtr );
+}
+//--------------------------------------------------------------------------------
+GeometryPtr GeometryLoaderDX11::loadStanfordPlyFileCached( std::wstring filename, bool withAdjacency )
 {
-	// <type> <name>
-	GeometryLoaderDX11::PlyElementPropertyDeclaration decl;
-	decl.isList = false;
+	FileSystem fs;
 
-	int split = desc.find(' ');
+	GeometryPtr MeshPtr = GeometryCacheDX11::Load( fs.GetModelsFolder() + filename, withAdjacency ? "ply adjacency" : "ply", PLY_COOKER_VERSION, [&]() {
+		return( loadStanfordPlyData( filename, withAdjacency ) );
+	} );
 
-	decl.type = desc.substr(0, split);
-	decl.name = desc.substr(split + 1, desc.length() - (split + 1));
+	MeshPtr->LoadToBuffers( );
 
-	return decl;
+	return( MeshPtr );
 }
-
-GeometryLoaderDX11::PlyElementPropertyDeclaration GeometryLoaderDX11::ParsePLYElementPropertyList(std::string desc)
+//--------------------------------------------------------------------------------
+GeometryPtr GeometryLoaderDX11::loadStanfordPlyData( std::wstring filename, bool withAdjacency )
 {
-	// <length_type> <element_type> <name>
-	GeometryLoaderDX11::PlyElementPropertyDeclaration decl;
-	decl.isList = true;
+	// Get the file path to the models
+	FileSystem fs;
+	filename = fs.GetModelsFolder() + filename;
 
-	int split = desc.find(' ');
-	decl.listLengthType = desc.substr(0, split);
+	// Map the file into memory, so that the body can be decoded directly from
+	// the mapped view.
 
-	decl.type = desc.substr(split + 1, desc.rfind(' ') - (split + 1));
+	MemoryMappedFile file;
 
-	split = desc.rfind(' ') + 1;
-	decl.name = desc.substr(split, desc.length() - split);
+	if ( !file.Open( filename ) )
+	{
+		// signal error - bad filename?
+		throw new std::exception( "Could not open file" );
+	}
 
-	return decl;
-}
+	const char* pData = file.GetDataPtr();
+	const char* pEnd = pData + file.GetDataSize();
 
-std::vector<void**> GeometryLoaderDX11::ReadPLYElementData(std::ifstream& input, const GeometryLoaderDX11::PlyElementDesc& desc)
-{
-	std::vector<void**> raw;
+	PlyFormat format = PLY_ASCII;
+	std::vector< PlyElement > elements;
 
-	for(int i = 0; i < desc.elementCount; ++i)
-	{
-		std::string txt;
-		std::getline(input, txt);
+	const char* pBody = ParsePlyHeader( pData, pEnd, format, elements );
 
-		raw.push_back(ParsePLYElementData(txt, desc.dataFormat));
-	}
+	// Create a resource to contain the geometry
+	GeometryPtr MeshPtr = GeometryPtr( new GeometryDX11() );
 
-	return raw;
-}
+	PlyTargets targets;
 
-void** GeometryLoaderDX11::ParsePLYElementData(std::string text, const std::vector<PlyElementPropertyDeclaration>& desc)
-{
-	void** parsed;
+	// The vertex positions and normals are decoded straight into the vertex
+	// elements of the geometry.
+
+	targets.vertexElement = FindPlyElementIndex( elements, "vertex" );
 
-	parsed = new void*[desc.size()];
+	if ( -1 == targets.vertexElement )
+		throw new std::exception( "Expected a 'vertex' element, but not found" );
 
-	std::vector<std::string> tokens;
-	std::istringstream is (text);
-	std::string tmps;
-    while (is.good()) {
-        is >> tmps;
-		tokens.push_back(tmps);
-    }
+	const PlyElement& vertices = elements[targets.vertexElement];
+	targets.vertexOutputs.assign( vertices.properties.size(), nullptr );
 
+	const char* names[2][3] = { { "x", "y", "z" }, { "nx", "ny", "nz" } };
+	const std::string semantics[2] = { VertexElementDX11::PositionSemantic, VertexElementDX11::NormalSemantic };
 
-	unsigned int e = 0;
-	for(std::vector<std::string>::iterator it = tokens.begin(); it != tokens.end(); ++it)
+	for ( int s = 0; s < 2; s++ )
 	{
-		if( e >= desc.size())
-			break;
+		int idx[3];
 
-		if(desc[e].isList)
+		for ( int c = 0; c < 3; c++ )
 		{
-			// Read this as length
-			int arrLen = 0;
+			idx[c] = FindPlyPropertyIndex( vertices.properties, names[s][c] );
 
-			arrLen = ExtractDataVal<int>(*it);
-
-			// Size up the type
-			if(0 == desc[e].type.compare("char"))
-			{
-				parsed[e] = ExtractDataPtrArray<char>(arrLen, it);
-			}
-			else if(0 == desc[e].type.compare("uchar"))
-			{
-				parsed[e] = ExtractDataPtrArray<unsigned char>(arrLen, it);
-			}
-			else if(0 == desc[e].type.compare("short"))
-			{
-				parsed[e] = ExtractDataPtrArray<short>(arrLen, it);
-			}
-			else if(0 == desc[e].type.compare("ushort"))
-			{
-				parsed[e] = ExtractDataPtrArray<unsigned short>(arrLen, it);
-			}
-			else if(0 == desc[e].type.compare("int"))
-			{
-				parsed[e] = ExtractDataPtrArray<int>(arrLen, it);
-			}
-			else if(0 == desc[e].type.compare("uint"))
-			{
-				parsed[e] = ExtractDataPtrArray<unsigned int>(arrLen, it);
-			}
-			else if(0 == desc[e].type.compare("float"))
-			{
-				parsed[e] = ExtractDataPtrArray<float>(arrLen, it);
-			}
-			else if(0 == desc[e].type.compare("double"))
-			{
-				parsed[e] = ExtractDataPtrArray<double>(arrLen, it);
-			}
-			else
-			{
-				// wtf?
-			}
+			if ( -1 != idx[c] && vertices.properties[idx[c]].isList )
+				idx[c] = -1;
 		}
-		else
+
+		if ( ( -1 != idx[0] ) && ( -1 != idx[1] ) && ( -1 != idx[2] ) )
 		{
-			if(0 == desc[e].type.compare("char"))
-			{
-				parsed[e] = ExtractDataPtr<char>(*it);
-			}
-			else if(0 == desc[e].type.compare("uchar"))
-			{
-				parsed[e] = ExtractDataPtr<unsigned char>(*it);
-			}
-			else if(0 == desc[e].type.compare("short"))
-			{
-				parsed[e] = ExtractDataPtr<short>(*it);
-			}
-			else if(0 == desc[e].type.compare("ushort"))
-			{
-				parsed[e] = ExtractDataPtr<unsigned short>(*it);
-			}
-			else if(0 == desc[e].type.compare("int"))
-			{
-				parsed[e] = ExtractDataPtr<int>(*it);
-			}
-			else if(0 == desc[e].type.compare("uint"))
-			{
-				parsed[e] = ExtractDataPtr<unsigned int>(*it);
-			}
-			else if(0 == desc[e].type.compare("float"))
-			{
-				parsed[e] = ExtractDataPtr<float>(*it);
-			}
-			else if(0 == desc[e].type.compare("double"))
-			{
-				parsed[e] = ExtractDataPtr<double>(*it);
-			}
-			else
-			{
-				// wtf?
-			}
-		}
+			VertexElementDX11* pElement = CreateVertexElement( semantics[s], 3, DXGI_FORMAT_R32G32B32_FLOAT, vertices.count, MeshPtr->GetElementCount() == 0 );
+			float* pRaw = reinterpret_cast<float*>( pElement->Get3f( 0 ) );
 
-		++e;
+			for ( int c = 0; c < 3; c++ )
+				targets.vertexOutputs[idx[c]] = pRaw + c;
+
+			MeshPtr->AddElement( pElement );
+		}
 	}
 
-	return parsed;
-}
+	// The face indices are read from the vertex index list of the face element.
 
-template<typename T> T* GeometryLoaderDX11::ExtractDataPtr(std::string input)
-{
-	T* t = new T;
+	targets.faceElement = FindPlyElementIndex( elements, "face" );
 
-	std::istringstream iss(input);
+	if ( -1 == targets.faceElement )
+		throw new std::exception( "Expected a 'face' element, but not found" );
 
-	iss >> *t;
+	const PlyElement& faces = elements[targets.faceElement];
 
-	return t;
-}
+	targets.faceProperty = FindPlyPropertyIndex( faces.properties, "vertex_indices" );
 
-template<typename T> T GeometryLoaderDX11::ExtractDataVal(std::string input)
-{
-	T t;
+	if ( -1 == targets.faceProperty )
+		targets.faceProperty = FindPlyPropertyIndex( faces.properties, "vertex_index" );
 
-	std::istringstream iss(input);
+	if ( -1 == targets.faceProperty || !faces.properties[targets.faceProperty].isList )
+		throw new std::exception( "Expected 'face' to contain a list of vertex indices per-face" );
 
-	iss >> t;
+	std::vector<UINT> indices;
+	indices.reserve( faces.count * 3 );
 
-	return t;
-}
+	targets.faceSize = -1;
+	targets.pIndices = &indices;
 
-template<typename T> GeometryLoaderDX11::PlyDataArray<T>* GeometryLoaderDX11::ExtractDataPtrArray(int length, std::vector<std::string>::iterator iterator)
-{
-	PlyDataArray<T>* t = new PlyDataArray<T>;
-	t->length = length;
-	t->data = new T[length];
+	// Decode the body with the reader for its format.
 
-	for(int i = 0; i < length; ++i)
+	if ( PLY_ASCII == format )
 	{
-		std::istringstream iss(*(++iterator));
-		iss >> t->data[i];
+		PlyAsciiReader reader( pBody, pEnd );
+		ReadPlyBody( reader, elements, targets );
+	}
+	else if ( PLY_BINARY_LITTLE_ENDIAN == format )
+	{
+		PlyBinaryReader<false> reader( pBody, pEnd );
+		ReadPlyBody( reader, elements, targets );
+	}
+	else
+	{
+		PlyBinaryReader<true> reader( pBody, pEnd );
+		ReadPlyBody( reader, elements, targets );
 	}
 
-	return t;
-}
+	int faceSize = ( targets.faceSize > 0 ) ? targets.faceSize : 3;
 
+	if ( withAdjacency )
+	{
+		if ( 3 != faceSize )
+			throw new std::exception( "Adjacency can only be generated for triangle faces" );
 
+		// Each triangle is followed by the vertices that are adjacent to its
+		// three edges.
 
-int GeometryLoaderDX11::FindPlyElementIndex(std::vector<PlyElementDesc> elems, std::string name)
-{
-	for(unsigned int idx = 0; idx < elems.size(); ++idx)
-		if(0 == elems.at(idx).name.compare(name))
-			return idx;
+		MeshPtr->SetPrimitiveType( (D3D11_PRIMITIVE_TOPOLOGY)(D3D11_PRIMITIVE_TOPOLOGY_1_CONTROL_POINT_PATCHLIST + ((2*faceSize) - 1)) );
+		BuildTriangleAdjacency( indices, MeshPtr->m_vIndices );
+	}
+	else
+	{
+		MeshPtr->SetPrimitiveType( (D3D11_PRIMITIVE_TOPOLOGY)(D3D11_PRIMITIVE_TOPOLOGY_1_CONTROL_POINT_PATCHLIST + (faceSize - 1)) );
+		MeshPtr->m_vIndices.swap( indices );
+	}
 
-	return -1;
+	return( MeshPtr );
 }
-
-int GeometryLoaderDX11::FindPlyElementPropertyIndex(std::vector<PlyElementPropertyDeclaration> elems, std::string name)
-{
-	for(unsigned int idx = 0; idx < elems.size(); ++idx)
-		if(0 == elems.at(idx).name.compare(name))
-			return idx;
-
-	return -1;
-}
\ No newline at end of file
+//--------------------------------------------------------------------------------
@@ -0,0 +1,502 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "GeometryOptimizerDX11.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	const UINT NO_VERTEX = 0xffffffff;
+
+	// The FIFO cache is modelled with a timestamp per vertex, which is set when
+	// the vertex is added to the cache.  A vertex is still in the cache as long
+	// as fewer than cacheSize other vertices have been added after it, and the
+	// whole cache is flushed by advancing the timestamp by more than that.
+
+	unsigned int updateCache( const UINT* pTriangle, unsigned int cacheSize, std::vector<unsigned int>& timestamps, unsigned int& timestamp )
+	{
+		unsigned int misses = 0;
+
+		for ( int i = 0; i < 3; i++ ) {
+			if ( timestamp - timestamps[pTriangle[i]] > cacheSize ) {
+				timestamps[pTriangle[i]] = timestamp++;
+				misses++;
+			}
+		}
+
+		return( misses );
+	}
+
+	// The index based passes only accept indices of existing vertices, and
+	// leave any other indices unchanged.
+
+	bool validIndices( const std::vector<UINT>& indices, unsigned int vertexCount )
+	{
+		for ( auto index : indices ) {
+			if ( index >= vertexCount ) {
+				return( false );
+			}
+		}
+
+		return( true );
+	}
+
+	// Returns the vertex count of geometry that the passes can be run on, or
+	// zero if the geometry can't be optimized.
+
+	unsigned int optimizableVertexCount( GeometryPtr pGeometry )
+	{
+		if ( pGeometry == nullptr || pGeometry->m_VB != nullptr ||
+			pGeometry->GetPrimitiveType() != D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST ) {
+			return( 0 );
+		}
+
+		const unsigned int vertexCount = static_cast<unsigned int>( pGeometry->CalculateVertexCount() );
+
+		for ( auto pElement : pGeometry->m_vElements ) {
+			if ( pElement->Count() != static_cast<int>( vertexCount ) ) {
+				return( 0 );
+			}
+		}
+
+		if ( !validIndices( pGeometry->m_vIndices, vertexCount ) ) {
+			return( 0 );
+		}
+
+		return( vertexCount );
+	}
+
+	struct Cluster
+	{
+		unsigned int	start;
+		unsigned int	end;
+		float			key;
+	};
+};
+//--------------------------------------------------------------------------------
+GeometryOptimizerDX11::GeometryOptimizerDX11()
+{
+}
+//--------------------------------------------------------------------------------
+bool GeometryOptimizerDX11::Optimize( GeometryPtr pGeometry, unsigned int cacheSize, float overdrawThreshold )
+{
+	if ( !OptimizeVertexCache( pGeometry, cacheSize ) )
+		return( false );
+
+	if ( overdrawThreshold > 0.0f )
+		OptimizeOverdraw( pGeometry, cacheSize, overdrawThreshold );
+
+	return( OptimizeVertexFetch( pGeometry ) );
+}
+//--------------------------------------------------------------------------------
+bool GeometryOptimizerDX11::OptimizeVertexCache( GeometryPtr pGeometry, unsigned int cacheSize )
+{
+	const unsigned int vertexCount = optimizableVertexCount( pGeometry );
+
+	if ( vertexCount == 0 )
+		return( false );
+
+	return( OptimizeVertexCache( pGeometry->m_vIndices, vertexCount, cacheSize ) );
+}
+//--------------------------------------------------------------------------------
+bool GeometryOptimizerDX11::OptimizeOverdraw( GeometryPtr pGeometry, unsigned int cacheSize, float threshold )
+{
+	const unsigned int vertexCount = optimizableVertexCount( pGeometry );
+
+	if ( vertexCount == 0 )
+		return( false );
+
+	// The clusters are sorted by their positions, which are only available from
+	// a position element.
+
+	VertexElementDX11* pPositions = pGeometry->GetElement( VertexElementDX11::PositionSemantic );
+
+	if ( pPositions == nullptr || pPositions->Tuple() < 3 )
+		return( false );
+
+	std::vector<Vector3f> positions( vertexCount );
+
+	for ( unsigned int i = 0; i < vertexCount; i++ ) {
+		const float* p = ( *pPositions )[i];
+		positions[i] = Vector3f( p[0], p[1], p[2] );
+	}
+
+	return( OptimizeOverdraw( pGeometry->m_vIndices, positions.data(), vertexCount, cacheSize, threshold ) );
+}
+//--------------------------------------------------------------------------------
+bool GeometryOptimizerDX11::OptimizeVertexFetch( GeometryPtr pGeometry )
+{
+	const unsigned int vertexCount = optimizableVertexCount( pGeometry );
+
+	if ( vertexCount == 0 )
+		return( false );
+
+	std::vector<UINT> remap;
+	GenerateVertexFetchRemap( pGeometry->m_vIndices, vertexCount, remap );
+
+	for ( auto& index : pGeometry->m_vIndices ) {
+		index = remap[index];
+	}
+
+	// Move each vertex of each element to its new position, from a copy of the
+	// original data.
+
+	for ( auto pElement : pGeometry->m_vElements )
+	{
+		const int tuple = pElement->Tuple();
+		std::vector<float> original( ( *pElement )[0], ( *pElement )[0] + tuple * vertexCount );
+
+		for ( unsigned int v = 0; v < vertexCount; v++ ) {
+			memcpy( ( *pElement )[remap[v]], &original[v * tuple], tuple * sizeof( float ) );
+		}
+	}
+
+	if ( pGeometry->m_vElements.size() == 0 && pGeometry->m_vVertexStream.size() > 0 )
+	{
+		const size_t vertexSize = pGeometry->m_vVertexStream.size() / vertexCount;
+		std::vector<char> original( pGeometry->m_vVertexStream );
+
+		for ( unsigned int v = 0; v < vertexCount; v++ ) {
+			memcpy( &pGeometry->m_vVertexStream[remap[v] * vertexSize], &original[v * vertexSize], vertexSize );
+		}
+	}
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+VertexCacheStatistics GeometryOptimizerDX11::SimulateVertexCache( GeometryPtr pGeometry, unsigned int cacheSize )
+{
+	return( SimulateVertexCache( pGeometry->m_vIndices, static_cast<unsigned int>( pGeometry->CalculateVertexCount() ), cacheSize ) );
+}
+//--------------------------------------------------------------------------------
+bool GeometryOptimizerDX11::OptimizeVertexCache( std::vector<UINT>& indices, unsigned int vertexCount, unsigned int cacheSize )
+{
+	if ( !validIndices( indices, vertexCount ) )
+		return( false );
+
+	const unsigned int triangleCount = static_cast<unsigned int>( indices.size() / 3 );
+
+	if ( triangleCount == 0 )
+		return( true );
+
+	// Build the list of the triangles that use each vertex, and count how many
+	// of them are still waiting to be emitted (the live triangles).
+
+	std::vector<unsigned int> offsets( vertexCount + 1, 0 );
+
+	for ( unsigned int i = 0; i < triangleCount * 3; i++ ) {
+		offsets[indices[i] + 1]++;
+	}
+
+	std::vector<unsigned int> live( vertexCount );
+
+	for ( unsigned int v = 0; v < vertexCount; v++ ) {
+		live[v] = offsets[v + 1];
+		offsets[v + 1] += offsets[v];
+	}
+
+	std::vector<unsigned int> adjacency( triangleCount * 3 );
+	std::vector<unsigned int> fill( offsets.begin(), offsets.end() - 1 );
+
+	for ( unsigned int t = 0; t < triangleCount; t++ ) {
+		for ( int k = 0; k < 3; k++ ) {
+			adjacency[fill[indices[t * 3 + k]]++] = t;
+		}
+	}
+
+	std::vector<unsigned int> timestamps( vertexCount, 0 );
+	std::vector<bool> emitted( triangleCount, false );
+	std::vector<UINT> deadEnd;
+	std::vector<UINT> candidates;
+	std::vector<UINT> result;
+
+	deadEnd.reserve( triangleCount * 3 );
+	result.reserve( triangleCount * 3 );
+
+	unsigned int timestamp = cacheSize + 1;
+	unsigned int cursor = 0;
+
+	UINT fanning = 0;
+	while ( live[fanning] == 0 ) { fanning++; }
+
+	while ( fanning != NO_VERTEX )
+	{
+		// Emit all of the remaining triangles around the fanning vertex.
+
+		candidates.clear();
+
+		for ( unsigned int a = offsets[fanning]; a < offsets[fanning + 1]; a++ )
+		{
+			const unsigned int t = adjacency[a];
+
+			if ( emitted[t] )
+				continue;
+
+			emitted[t] = true;
+
+			for ( int k = 0; k < 3; k++ )
+			{
+				const UINT v = indices[t * 3 + k];
+
+				result.push_back( v );
+				deadEnd.push_back( v );
+				candidates.push_back( v );
+				live[v]--;
+
+				if ( timestamp - timestamps[v] > cacheSize ) {
+					timestamps[v] = timestamp++;
+				}
+			}
+		}
+
+		// Continue with the vertex that has been in the cache the longest, as
+		// long as fanning around it won't push it out of the cache.  Each of
+		// its live triangles adds at most two new vertices to the cache.
+
+		UINT next = NO_VERTEX;
+		long long bestPriority = -1;
+
+		for ( auto v : candidates )
+		{
+			if ( live[v] == 0 )
+				continue;
+
+			long long priority = 0;
+			const long long age = timestamp - timestamps[v];
+
+			if ( age + 2 * live[v] <= cacheSize ) {
+				priority = age;
+			}
+
+			if ( priority > bestPriority ) {
+				bestPriority = priority;
+				next = v;
+			}
+		}
+
+		// At a dead end, go back to the most recently used vertex that still
+		// has live triangles, and otherwise to the next one in index order.
+
+		while ( next == NO_VERTEX && !deadEnd.empty() ) {
+			const UINT v = deadEnd.back();
+			deadEnd.pop_back();
+
+			if ( live[v] > 0 ) {
+				next = v;
+			}
+		}
+
+		while ( next == NO_VERTEX && cursor < vertexCount ) {
+			if ( live[cursor] > 0 ) {
+				next = cursor;
+			}
+			cursor++;
+		}
+
+		fanning = next;
+	}
+
+	// Any indices after the last complete triangle are kept as they are.
+
+	result.insert( result.end(), indices.begin() + triangleCount * 3, indices.end() );
+	indices.swap( result );
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+bool GeometryOptimizerDX11::OptimizeOverdraw( std::vector<UINT>& indices, const Vector3f* pPositions, unsigned int vertexCount, unsigned int cacheSize, float threshold )
+{
+	if ( !validIndices( indices, vertexCount ) || ( pPositions == nullptr && vertexCount > 0 ) )
+		return( false );
+
+	const unsigned int triangleCount = static_cast<unsigned int>( indices.size() / 3 );
+
+	if ( triangleCount == 0 )
+		return( true );
+
+	std::vector<unsigned int> timestamps( vertexCount, 0 );
+	unsigned int timestamp = cacheSize + 1;
+
+	// A triangle that misses all three of its vertices usually starts a new
+	// patch of the mesh, where the cache optimized order has a hard boundary.
+
+	std::vector<unsigned int> patches;
+
+	for ( unsigned int t = 0; t < triangleCount; t++ ) {
+		if ( updateCache( &indices[t * 3], cacheSize, timestamps, timestamp ) == 3 || t == 0 ) {
+			patches.push_back( t );
+		}
+	}
+
+	patches.push_back( triangleCount );
+
+	// Each patch is split further into clusters, as soon as the ACMR of the
+	// current cluster is within the threshold of the ACMR of the whole patch.
+
+	std::vector<Cluster> clusters;
+
+	for ( size_t p = 0; p + 1 < patches.size(); p++ )
+	{
+		const unsigned int start = patches[p];
+		const unsigned int end = patches[p + 1];
+
+		timestamp += cacheSize + 1;
+
+		unsigned int patchMisses = 0;
+
+		for ( unsigned int t = start; t < end; t++ ) {
+			patchMisses += updateCache( &indices[t * 3], cacheSize, timestamps, timestamp );
+		}
+
+		const float target = static_cast<float>( patchMisses ) / ( end - start ) * threshold;
+
+		timestamp += cacheSize + 1;
+
+		unsigned int clusterStart = start;
+		unsigned int clusterMisses = 0;
+
+		for ( unsigned int t = start; t < end; t++ )
+		{
+			clusterMisses += updateCache( &indices[t * 3], cacheSize, timestamps, timestamp );
+
+			if ( static_cast<float>( clusterMisses ) / ( t + 1 - clusterStart ) <= target || t + 1 == end ) {
+				Cluster cluster = { clusterStart, t + 1, 0.0f };
+				clusters.push_back( cluster );
+
+				clusterStart = t + 1;
+				clusterMisses = 0;
+				timestamp += cacheSize + 1;
+			}
+		}
+	}
+
+	// Sort the clusters so that the ones that face away from the center of the
+	// mesh are drawn first, since they are the most likely to occlude others.
+
+	Vector3f meshCentroid( 0.0f, 0.0f, 0.0f );
+
+	for ( unsigned int i = 0; i < triangleCount * 3; i++ ) {
+		meshCentroid += pPositions[indices[i]];
+	}
+
+	meshCentroid /= static_cast<float>( triangleCount * 3 );
+
+	for ( auto& cluster : clusters )
+	{
+		Vector3f centroid( 0.0f, 0.0f, 0.0f );
+		Vector3f normal( 0.0f, 0.0f, 0.0f );
+		float area = 0.0f;
+
+		for ( unsigned int t = cluster.start; t < cluster.end; t++ )
+		{
+			const Vector3f& p0 = pPositions[indices[t * 3 + 0]];
+			const Vector3f& p1 = pPositions[indices[t * 3 + 1]];
+			const Vector3f& p2 = pPositions[indices[t * 3 + 2]];
+
+			const Vector3f n = Vector3f::Cross( p1 - p0, p2 - p0 );
+			const float a = Vector3f::Magnitude( n );
+
+			centroid += ( p0 + p1 + p2 ) * ( a / 3.0f );
+			normal += n;
+			area += a;
+		}
+
+		const float length = Vector3f::Magnitude( normal );
+
+		if ( area > 0.0f && length > 0.0f ) {
+			cluster.key = Vector3f::Dot( centroid / area - meshCentroid, normal / length );
+		}
+	}
+
+	std::stable_sort( clusters.begin(), clusters.end(), []( const Cluster& a, const Cluster& b ) {
+		return( a.key > b.key );
+	} );
+
+	std::vector<UINT> result;
+	result.reserve( triangleCount * 3 );
+
+	for ( auto& cluster : clusters ) {
+		result.insert( result.end(), indices.begin() + cluster.start * 3, indices.begin() + cluster.end * 3 );
+	}
+
+	result.insert( result.end(), indices.begin() + triangleCount * 3, indices.end() );
+	indices.swap( result );
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+bool GeometryOptimizerDX11::GenerateVertexFetchRemap( const std::vector<UINT>& indices, unsigned int vertexCount, std::vector<UINT>& remap )
+{
+	remap.clear();
+
+	if ( !validIndices( indices, vertexCount ) )
+		return( false );
+
+	// The vertices are numbered in the order of their first use, and vertices
+	// that aren't used at all are kept at the end in their original order.
+
+	remap.assign( vertexCount, NO_VERTEX );
+
+	UINT next = 0;
+
+	for ( auto index : indices ) {
+		if ( remap[index] == NO_VERTEX ) {
+			remap[index] = next++;
+		}
+	}
+
+	for ( auto& index : remap ) {
+		if ( index == NO_VERTEX ) {
+			index = next++;
+		}
+	}
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+VertexCacheStatistics GeometryOptimizerDX11::SimulateVertexCache( const std::vector<UINT>& indices, unsigned int vertexCount, unsigned int cacheSize )
+{
+	VertexCacheStatistics statistics;
+	memset( &statistics, 0, sizeof( statistics ) );
+
+	statistics.triangles = static_cast<unsigned int>( indices.size() / 3 );
+
+	std::vector<unsigned int> timestamps( vertexCount, 0 );
+	std::vector<bool> used( vertexCount, false );
+	unsigned int timestamp = cacheSize + 1;
+
+	for ( unsigned int t = 0; t < statistics.triangles; t++ )
+	{
+		const UINT* pTriangle = &indices[t * 3];
+
+		for ( int k = 0; k < 3; k++ ) {
+			if ( pTriangle[k] < vertexCount && !used[pTriangle[k]] ) {
+				used[pTriangle[k]] = true;
+				statistics.vertices++;
+			}
+		}
+
+		if ( pTriangle[0] < vertexCount && pTriangle[1] < vertexCount && pTriangle[2] < vertexCount ) {
+			statistics.transforms += updateCache( pTriangle, cacheSize, timestamps, timestamp );
+		}
+	}
+
+	if ( statistics.triangles > 0 )
+		statistics.acmr = static_cast<float>( statistics.transforms ) / statistics.triangles;
+
+	if ( statistics.vertices > 0 )
+		statistics.atvr = static_cast<float>( statistics.transforms ) / statistics.vertices;
+
+	return( statistics );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
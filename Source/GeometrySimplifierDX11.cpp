@@ -0,0 +1,801 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "GeometrySimplifierDX11.h"
+#include "GeometryOptimizerDX11.h"
+#include "GlyphHash.h"
+#include <cfloat>
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	const UINT NO_VERTEX = 0xffffffff;
+	const UINT MANY_VERTICES = 0xfffffffe;
+
+	// Border and seam edges are constrained by planes through the edge that are
+	// perpendicular to the triangle, and these are weighted more heavily than
+	// the surface itself so that the outlines keep their shape.
+
+	const double BOUNDARY_WEIGHT = 10.0;
+
+	enum VertexKind
+	{
+		MANIFOLD,	// An interior vertex without a seam, which can move anywhere.
+		BORDER,		// A vertex on an open border, which can move along the border.
+		SEAM,		// One of the two wedges of a seam, which move along the seam together.
+		LOCKED		// Anything more complex, which never moves.
+	};
+
+	struct Quadric
+	{
+		double a00, a11, a22;
+		double a10, a20, a21;
+		double b0, b1, b2;
+		double c;
+		double w;
+	};
+
+	void addPlane( Quadric& Q, const Vector3f& n, float d, double weight )
+	{
+		Q.a00 += weight * n.x * n.x;
+		Q.a11 += weight * n.y * n.y;
+		Q.a22 += weight * n.z * n.z;
+		Q.a10 += weight * n.y * n.x;
+		Q.a20 += weight * n.z * n.x;
+		Q.a21 += weight * n.z * n.y;
+		Q.b0 += weight * n.x * d;
+		Q.b1 += weight * n.y * d;
+		Q.b2 += weight * n.z * d;
+		Q.c += weight * d * d;
+		Q.w += weight;
+	}
+
+	void addQuadric( Quadric& Q, const Quadric& R )
+	{
+		Q.a00 += R.a00; Q.a11 += R.a11; Q.a22 += R.a22;
+		Q.a10 += R.a10; Q.a20 += R.a20; Q.a21 += R.a21;
+		Q.b0 += R.b0; Q.b1 += R.b1; Q.b2 += R.b2;
+		Q.c += R.c;
+		Q.w += R.w;
+	}
+
+	// The quadric gives the weighted sum of the squared distances to its planes,
+	// so dividing by the total weight gives an average squared distance.
+
+	double quadricError( const Quadric& Q, const Vector3f& p )
+	{
+		const double x = p.x, y = p.y, z = p.z;
+
+		double r = Q.a00 * x * x + Q.a11 * y * y + Q.a22 * z * z
+				 + 2.0 * ( Q.a10 * x * y + Q.a20 * x * z + Q.a21 * y * z )
+				 + 2.0 * ( Q.b0 * x + Q.b1 * y + Q.b2 * z ) + Q.c;
+
+		return( Q.w > 0.0 ? fabs( r ) / Q.w : 0.0 );
+	}
+
+	UINT nextCorner( UINT corner )
+	{
+		return( corner % 3 == 2 ? corner - 2 : corner + 1 );
+	}
+
+	UINT prevCorner( UINT corner )
+	{
+		return( corner % 3 == 0 ? corner + 2 : corner - 1 );
+	}
+
+	// The corners of the triangles around each vertex, stored contiguously with
+	// an offset per vertex.  The half edges leaving a vertex start at its corners.
+
+	struct Adjacency
+	{
+		std::vector<UINT>	offsets;
+		std::vector<UINT>	corners;
+	};
+
+	void buildAdjacency( Adjacency& adjacency, const std::vector<UINT>& indices, unsigned int vertexCount )
+	{
+		adjacency.offsets.assign( vertexCount + 1, 0 );
+
+		for ( auto index : indices ) {
+			adjacency.offsets[index + 1]++;
+		}
+
+		for ( unsigned int v = 0; v < vertexCount; v++ ) {
+			adjacency.offsets[v + 1] += adjacency.offsets[v];
+		}
+
+		std::vector<UINT> fill( adjacency.offsets.begin(), adjacency.offsets.end() - 1 );
+		adjacency.corners.resize( indices.size() );
+
+		for ( UINT i = 0; i < indices.size(); i++ ) {
+			adjacency.corners[fill[indices[i]]++] = i;
+		}
+	}
+
+	bool hasEdge( const Adjacency& adjacency, const std::vector<UINT>& indices, UINT a, UINT b )
+	{
+		for ( UINT i = adjacency.offsets[a]; i < adjacency.offsets[a + 1]; i++ ) {
+			if ( indices[nextCorner( adjacency.corners[i] )] == b ) {
+				return( true );
+			}
+		}
+
+		return( false );
+	}
+
+	// Tests for an edge between the positions of two vertices, from any of the
+	// wedges at the position of the first one.
+
+	bool hasPositionEdge( const Adjacency& adjacency, const std::vector<UINT>& indices, const std::vector<UINT>& position, const UINT* pWedges, UINT a, UINT b )
+	{
+		UINT v = a;
+
+		do {
+			for ( UINT i = adjacency.offsets[v]; i < adjacency.offsets[v + 1]; i++ ) {
+				if ( position[indices[nextCorner( adjacency.corners[i] )]] == position[b] ) {
+					return( true );
+				}
+			}
+
+			v = pWedges[v];
+		} while ( v != a );
+
+		return( false );
+	}
+
+	// After a pass of collapses, the loops along the borders and seams are
+	// pointed at the vertices that their neighbours were collapsed into.  When a
+	// vertex's own neighbour was collapsed into it, the loop skips ahead instead.
+
+	void remapLoops( std::vector<UINT>& loop, const std::vector<UINT>& remap )
+	{
+		for ( UINT v = 0; v < loop.size(); v++ )
+		{
+			if ( loop[v] < MANY_VERTICES )
+			{
+				const UINT l = loop[v];
+				const UINT r = remap[l];
+
+				loop[v] = ( r == v ) ? loop[l] : r;
+			}
+		}
+	}
+
+	struct Collapse
+	{
+		UINT	v;
+		UINT	t;
+		double	error;
+
+		bool operator<( const Collapse& other ) const
+		{
+			if ( error != other.error ) return( error < other.error );
+			if ( v != other.v ) return( v < other.v );
+			return( t < other.t );
+		}
+	};
+
+	unsigned int formatSize( DXGI_FORMAT format )
+	{
+		switch ( format )
+		{
+		case DXGI_FORMAT_R32_FLOAT:
+		case DXGI_FORMAT_R32_UINT:
+		case DXGI_FORMAT_R32_SINT:
+		case DXGI_FORMAT_R8G8B8A8_UNORM:
+		case DXGI_FORMAT_R8G8B8A8_UINT:
+			return( 4 );
+		case DXGI_FORMAT_R32G32_FLOAT:
+		case DXGI_FORMAT_R32G32_UINT:
+		case DXGI_FORMAT_R32G32_SINT:
+			return( 8 );
+		case DXGI_FORMAT_R32G32B32_FLOAT:
+		case DXGI_FORMAT_R32G32B32_UINT:
+		case DXGI_FORMAT_R32G32B32_SINT:
+			return( 12 );
+		case DXGI_FORMAT_R32G32B32A32_FLOAT:
+		case DXGI_FORMAT_R32G32B32A32_UINT:
+		case DXGI_FORMAT_R32G32B32A32_SINT:
+			return( 16 );
+		default:
+			return( 0 );
+		}
+	}
+
+	// Returns the offset of the float3 position within the interleaved vertices
+	// of the geometry, or -1 if there is no usable position.  The elements are
+	// interleaved in order without any padding.
+
+	int positionOffset( GeometryDX11& geometry )
+	{
+		int offset = 0;
+
+		if ( geometry.m_vElements.size() > 0 )
+		{
+			for ( auto pElement : geometry.m_vElements )
+			{
+				if ( pElement->m_SemanticName == VertexElementDX11::PositionSemantic && pElement->m_uiSemanticIndex == 0 ) {
+					return( pElement->Tuple() >= 3 ? offset : -1 );
+				}
+
+				offset += pElement->SizeInBytes();
+			}
+
+			return( -1 );
+		}
+
+		for ( auto& desc : geometry.m_vStreamLayout )
+		{
+			if ( desc.AlignedByteOffset != D3D11_APPEND_ALIGNED_ELEMENT ) {
+				offset = static_cast<int>( desc.AlignedByteOffset );
+			}
+
+			if ( VertexElementDX11::PositionSemantic == desc.SemanticName && desc.SemanticIndex == 0 ) {
+				const bool float3 = desc.Format == DXGI_FORMAT_R32G32B32_FLOAT || desc.Format == DXGI_FORMAT_R32G32B32A32_FLOAT;
+				return( float3 ? offset : -1 );
+			}
+
+			const unsigned int size = formatSize( desc.Format );
+
+			if ( size == 0 ) {
+				return( -1 );
+			}
+
+			offset += size;
+		}
+
+		return( -1 );
+	}
+};
+//--------------------------------------------------------------------------------
+GeometrySimplifierDX11::GeometrySimplifierDX11()
+{
+}
+//--------------------------------------------------------------------------------
+GeometryPtr GeometrySimplifierDX11::Simplify( GeometryPtr pGeometry, unsigned int targetTriangles, float maxError, SimplificationReport* pReport )
+{
+	if ( pGeometry == nullptr || pGeometry->GetPrimitiveType() != D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST ) {
+		return( nullptr );
+	}
+
+	const int offset = positionOffset( *pGeometry );
+
+	if ( offset < 0 ) {
+		return( nullptr );
+	}
+
+	std::vector<char> vertices;
+	pGeometry->InterleaveVertices( vertices );
+
+	const unsigned int vertexSize = static_cast<unsigned int>( pGeometry->GetVertexSize() );
+	const unsigned int vertexCount = static_cast<unsigned int>( pGeometry->GetVertexCount() );
+
+	if ( vertexCount == 0 || offset + 3 * sizeof( float ) > vertexSize ) {
+		return( nullptr );
+	}
+
+	std::vector<UINT> indices( pGeometry->m_vIndices );
+
+	for ( auto index : indices ) {
+		if ( index >= vertexCount ) {
+			return( nullptr );
+		}
+	}
+
+	// Vertices that are identical in all of their attributes are welded first,
+	// so that only real seams remain.  Any hash collisions between different
+	// vertices simply leave them unwelded.
+
+	std::vector<UINT> weld( vertexCount, NO_VERTEX );
+	std::unordered_map<unsigned long long,UINT> unique;
+
+	for ( auto& index : indices )
+	{
+		if ( weld[index] == NO_VERTEX )
+		{
+			const char* pVertex = &vertices[index * vertexSize];
+			const unsigned long long hash = GlyphHash::HashData( pVertex, vertexSize );
+			auto it = unique.find( hash );
+
+			if ( it == unique.end() ) {
+				unique[hash] = index;
+				weld[index] = index;
+			} else if ( memcmp( &vertices[it->second * vertexSize], pVertex, vertexSize ) == 0 ) {
+				weld[index] = it->second;
+			} else {
+				weld[index] = index;
+			}
+		}
+
+		index = weld[index];
+	}
+
+	// The remaining vertices that share a position are linked into circular
+	// wedge lists, in the order of their indices.
+
+	std::vector<Vector3f> positions( vertexCount );
+	std::vector<UINT> wedges( vertexCount );
+	std::unordered_map<unsigned long long,UINT> heads;
+
+	for ( UINT v = 0; v < vertexCount; v++ )
+	{
+		const char* pPosition = &vertices[v * vertexSize + offset];
+		memcpy( &positions[v], pPosition, 3 * sizeof( float ) );
+		wedges[v] = v;
+
+		if ( weld[v] != v ) {
+			continue;
+		}
+
+		const unsigned long long hash = GlyphHash::HashData( pPosition, 3 * sizeof( float ) );
+		auto it = heads.find( hash );
+
+		if ( it == heads.end() ) {
+			heads[hash] = v;
+		} else if ( memcmp( &vertices[it->second * vertexSize + offset], pPosition, 3 * sizeof( float ) ) == 0 ) {
+			wedges[v] = wedges[it->second];
+			wedges[it->second] = v;
+		}
+	}
+
+	const float error = Simplify( indices, positions.data(), wedges.data(), vertexCount, targetTriangles, maxError );
+
+	// The simplified geometry only contains the vertices that are still used, in
+	// the order that the triangles first use them.
+
+	std::vector<UINT> remap( vertexCount, NO_VERTEX );
+	std::vector<char> compacted;
+	UINT count = 0;
+
+	for ( auto& index : indices )
+	{
+		if ( remap[index] == NO_VERTEX ) {
+			remap[index] = count++;
+			compacted.insert( compacted.end(), &vertices[index * vertexSize], &vertices[index * vertexSize] + vertexSize );
+		}
+
+		index = remap[index];
+	}
+
+	GeometryPtr pResult = GeometryPtr( new GeometryDX11() );
+	pResult->SetPrimitiveType( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+
+	if ( pGeometry->m_vElements.size() > 0 )
+	{
+		unsigned int elementOffset = 0;
+
+		for ( auto pElement : pGeometry->m_vElements )
+		{
+			const unsigned int size = pElement->SizeInBytes();
+			VertexElementDX11* pCopy = new VertexElementDX11( pElement->Tuple(), count );
+
+			pCopy->m_SemanticName = pElement->m_SemanticName;
+			pCopy->m_uiSemanticIndex = pElement->m_uiSemanticIndex;
+			pCopy->m_Format = pElement->m_Format;
+			pCopy->m_uiInputSlot = pElement->m_uiInputSlot;
+			pCopy->m_uiAlignedByteOffset = pElement->m_uiAlignedByteOffset;
+			pCopy->m_InputSlotClass = pElement->m_InputSlotClass;
+			pCopy->m_uiInstanceDataStepRate = pElement->m_uiInstanceDataStepRate;
+
+			for ( UINT v = 0; v < count; v++ ) {
+				memcpy( pCopy->GetPtr( v ), &compacted[v * vertexSize + elementOffset], size );
+			}
+
+			pResult->AddElement( pCopy );
+			elementOffset += size;
+		}
+	}
+	else if ( count > 0 )
+	{
+		pResult->SetInterleavedVertices( compacted.data(), vertexSize, count, pGeometry->m_vStreamLayout );
+	}
+
+	pResult->m_vIndices.swap( indices );
+
+	// The remaining vertices always fit into the bounds of the source, which
+	// are kept for streams that don't calculate their own.
+
+	pResult->m_Bounds = pGeometry->GetBounds();
+	pResult->CalculateBounds();
+
+	if ( pReport != nullptr ) {
+		pReport->sourceTriangles = pGeometry->GetIndexCount() / 3;
+		pReport->triangles = pResult->GetIndexCount() / 3;
+		pReport->vertices = count;
+		pReport->error = error;
+	}
+
+	return( pResult );
+}
+//--------------------------------------------------------------------------------
+std::vector<GeometryPtr> GeometrySimplifierDX11::GenerateLODChain( GeometryPtr pGeometry, unsigned int levels, float reduction, float maxError, std::vector<SimplificationReport>* pReports )
+{
+	std::vector<GeometryPtr> chain;
+
+	if ( pGeometry == nullptr ) {
+		return( chain );
+	}
+
+	unsigned int triangles = pGeometry->GetIndexCount() / 3;
+
+	for ( unsigned int level = 0; level < levels; level++ )
+	{
+		const unsigned int target = static_cast<unsigned int>( triangles * reduction );
+
+		if ( target == 0 ) {
+			break;
+		}
+
+		SimplificationReport report;
+		GeometryPtr pLevel = Simplify( pGeometry, target, maxError, &report );
+
+		if ( pLevel == nullptr || report.triangles >= triangles ) {
+			break;
+		}
+
+		GeometryOptimizerDX11::Optimize( pLevel );
+
+		chain.push_back( pLevel );
+		triangles = report.triangles;
+
+		if ( pReports != nullptr ) {
+			pReports->push_back( report );
+		}
+	}
+
+	return( chain );
+}
+//--------------------------------------------------------------------------------
+float GeometrySimplifierDX11::Simplify( std::vector<UINT>& indices, const Vector3f* pPositions, const UINT* pWedges, unsigned int vertexCount, unsigned int targetTriangles, float maxError )
+{
+	// Each vertex is represented by the first vertex of its wedge list, which
+	// identifies its position and holds the quadric for that position.
+
+	std::vector<UINT> position( vertexCount );
+
+	for ( UINT v = 0; v < vertexCount; v++ )
+	{
+		UINT first = v;
+
+		for ( UINT w = pWedges[v]; w != v; w = pWedges[w] ) {
+			first = min( first, w );
+		}
+
+		position[v] = first;
+	}
+
+	// The positions are scaled into a unit cube, which keeps the quadrics well
+	// conditioned and makes the errors relative to the extent of the mesh.
+
+	Vector3f minimum( FLT_MAX, FLT_MAX, FLT_MAX );
+	Vector3f maximum( -FLT_MAX, -FLT_MAX, -FLT_MAX );
+
+	for ( auto index : indices )
+	{
+		for ( int i = 0; i < 3; i++ ) {
+			minimum[i] = min( minimum[i], pPositions[index][i] );
+			maximum[i] = max( maximum[i], pPositions[index][i] );
+		}
+	}
+
+	const float extent = max( maximum.x - minimum.x, max( maximum.y - minimum.y, maximum.z - minimum.z ) );
+
+	if ( !( extent > 0.0f ) ) {
+		return( 0.0f );
+	}
+
+	std::vector<Vector3f> points( vertexCount );
+
+	for ( UINT v = 0; v < vertexCount; v++ ) {
+		points[v] = ( pPositions[v] - minimum ) / extent;
+	}
+
+	// Triangles that are already degenerate would confuse the classification.
+
+	size_t write = 0;
+
+	for ( size_t i = 0; i + 2 < indices.size(); i += 3 )
+	{
+		const UINT a = indices[i], b = indices[i+1], c = indices[i+2];
+
+		if ( position[a] != position[b] && position[b] != position[c] && position[c] != position[a] ) {
+			indices[write++] = a;
+			indices[write++] = b;
+			indices[write++] = c;
+		}
+	}
+
+	indices.resize( write );
+
+	Adjacency adjacency;
+	buildAdjacency( adjacency, indices, vertexCount );
+
+	// Half edges without an opposite half edge between the same two vertices
+	// are open, which is the case on both borders and seams.  Each vertex
+	// records its open neighbours, which form loops along the borders and seams.
+
+	std::vector<UINT> openOut( vertexCount, NO_VERTEX );
+	std::vector<UINT> openIn( vertexCount, NO_VERTEX );
+
+	for ( UINT i = 0; i < indices.size(); i++ )
+	{
+		const UINT a = indices[i];
+		const UINT b = indices[nextCorner( i )];
+
+		if ( !hasEdge( adjacency, indices, b, a ) ) {
+			openOut[a] = ( openOut[a] == NO_VERTEX ) ? b : MANY_VERTICES;
+			openIn[b] = ( openIn[b] == NO_VERTEX ) ? a : MANY_VERTICES;
+		}
+	}
+
+	std::vector<unsigned char> kind( vertexCount, LOCKED );
+
+	for ( UINT v = 0; v < vertexCount; v++ )
+	{
+		const UINT w = pWedges[v];
+		const UINT out = openOut[v], in = openIn[v];
+
+		if ( w == v )
+		{
+			// A vertex on a border needs exactly one border edge in each
+			// direction, and the edges must be open at its position as well -
+			// otherwise it is the end of a seam.
+
+			if ( out == NO_VERTEX && in == NO_VERTEX ) {
+				kind[v] = MANIFOLD;
+			} else if ( out < MANY_VERTICES && in < MANY_VERTICES &&
+				!hasPositionEdge( adjacency, indices, position, pWedges, out, v ) &&
+				!hasPositionEdge( adjacency, indices, position, pWedges, v, in ) ) {
+				kind[v] = BORDER;
+			}
+		}
+		else if ( pWedges[w] == v )
+		{
+			// The two wedges of a seam each have one open edge in each direction,
+			// which run along the same positions in opposite directions.
+
+			if ( out < MANY_VERTICES && in < MANY_VERTICES && openOut[w] < MANY_VERTICES && openIn[w] < MANY_VERTICES &&
+				position[in] == position[openOut[w]] && position[out] == position[openIn[w]] && position[in] != position[out] ) {
+				kind[v] = SEAM;
+			}
+		}
+	}
+
+	// The quadrics are accumulated per position, from the planes of the
+	// triangles weighted by their area and from the border and seam edges.
+
+	Quadric zero;
+	memset( &zero, 0, sizeof( zero ) );
+	std::vector<Quadric> quadrics( vertexCount, zero );
+
+	for ( UINT i = 0; i < indices.size(); i++ )
+	{
+		const UINT a = indices[i];
+		const UINT b = indices[nextCorner( i )];
+		const UINT c = indices[prevCorner( i )];
+
+		Vector3f normal = Vector3f::Cross( points[b] - points[a], points[c] - points[a] );
+		const float area = Vector3f::Magnitude( normal );
+
+		if ( !( area > 0.0f ) ) {
+			continue;
+		}
+
+		normal /= area;
+
+		// Each triangle is visited once per corner, so only the first corner
+		// adds the triangle's plane.
+
+		if ( i % 3 == 0 ) {
+			const float d = -Vector3f::Dot( normal, points[a] );
+			addPlane( quadrics[position[a]], normal, d, area );
+			addPlane( quadrics[position[b]], normal, d, area );
+			addPlane( quadrics[position[c]], normal, d, area );
+		}
+
+		if ( openOut[a] != NO_VERTEX && !hasEdge( adjacency, indices, b, a ) )
+		{
+			const Vector3f edge = points[b] - points[a];
+			Vector3f perpendicular = Vector3f::Cross( edge, normal );
+			const float length = Vector3f::Magnitude( perpendicular );
+
+			if ( length > 0.0f ) {
+				perpendicular /= length;
+				const float d = -Vector3f::Dot( perpendicular, points[a] );
+				addPlane( quadrics[position[a]], perpendicular, d, length * length * BOUNDARY_WEIGHT );
+				addPlane( quadrics[position[b]], perpendicular, d, length * length * BOUNDARY_WEIGHT );
+			}
+		}
+	}
+
+	auto const can_collapse = [&]( UINT v, UINT t ) {
+		if ( position[v] == position[t] ) {
+			return( false );
+		}
+
+		switch ( kind[v] )
+		{
+		case MANIFOLD:
+			return( true );
+		case BORDER:
+			return( ( t == openOut[v] || t == openIn[v] ) && ( kind[t] == BORDER || kind[t] == LOCKED ) );
+		case SEAM:
+			return( ( t == openOut[v] || t == openIn[v] ) && ( kind[t] == SEAM || kind[t] == LOCKED ) );
+		default:
+			return( false );
+		}
+	};
+
+	std::vector<UINT> collapseRemap( vertexCount );
+	std::vector<unsigned char> collapseLocked( vertexCount );
+
+	// A collapse is rejected if moving the vertex would flip any of the
+	// triangles around it that remain afterwards.  Earlier collapses of the same
+	// pass are taken into account through the remap.
+
+	auto const has_flips = [&]( UINT v, UINT t ) {
+		const Vector3f& pv = points[v];
+		const Vector3f& pt = points[t];
+
+		for ( UINT i = adjacency.offsets[v]; i < adjacency.offsets[v + 1]; i++ )
+		{
+			const UINT corner = adjacency.corners[i];
+			const UINT a = collapseRemap[indices[nextCorner( corner )]];
+			const UINT b = collapseRemap[indices[prevCorner( corner )]];
+
+			if ( position[a] == position[t] || position[b] == position[t] || position[a] == position[b] ) {
+				continue;
+			}
+
+			const Vector3f before = Vector3f::Cross( points[a] - pv, points[b] - pv );
+			const Vector3f after = Vector3f::Cross( points[a] - pt, points[b] - pt );
+
+			if ( Vector3f::Dot( before, after ) <= 0.0f ) {
+				return( true );
+			}
+		}
+
+		return( false );
+	};
+
+	const size_t targetIndexCount = static_cast<size_t>( targetTriangles ) * 3;
+	const double errorLimit = static_cast<double>( maxError ) * maxError;
+	double resultError = 0.0;
+
+	std::vector<Collapse> collapses;
+
+	// Each pass sorts the candidate collapses by their error and applies as
+	// many as possible, with each position taking part in at most one collapse
+	// so that the errors stay accurate.
+
+	while ( indices.size() > targetIndexCount )
+	{
+		collapses.clear();
+
+		for ( UINT i = 0; i < indices.size(); i++ )
+		{
+			const UINT a = indices[i];
+			const UINT b = indices[nextCorner( i )];
+
+			// Closed edges are seen from both of their triangles, but only need
+			// to be considered once.
+
+			if ( a > b && hasEdge( adjacency, indices, b, a ) ) {
+				continue;
+			}
+
+			const double ab = can_collapse( a, b ) ? quadricError( quadrics[position[a]], points[b] ) : DBL_MAX;
+			const double ba = can_collapse( b, a ) ? quadricError( quadrics[position[b]], points[a] ) : DBL_MAX;
+
+			if ( ab == DBL_MAX && ba == DBL_MAX ) {
+				continue;
+			}
+
+			Collapse collapse;
+			collapse.v = ( ab <= ba ) ? a : b;
+			collapse.t = ( ab <= ba ) ? b : a;
+			collapse.error = min( ab, ba );
+			collapses.push_back( collapse );
+		}
+
+		std::sort( collapses.begin(), collapses.end() );
+
+		for ( UINT v = 0; v < vertexCount; v++ ) {
+			collapseRemap[v] = v;
+			collapseLocked[v] = 0;
+		}
+
+		const size_t triangleGoal = ( indices.size() - targetIndexCount ) / 3;
+		size_t removed = 0;
+		unsigned int applied = 0;
+
+		for ( auto& collapse : collapses )
+		{
+			if ( collapse.error > errorLimit || removed >= triangleGoal ) {
+				break;
+			}
+
+			const UINT v = collapse.v;
+			const UINT t = collapse.t;
+
+			if ( collapseLocked[position[v]] || collapseLocked[position[t]] ) {
+				continue;
+			}
+
+			// The other wedge of a seam follows the seam in the opposite
+			// direction, to the other wedge of the target.
+
+			UINT w = NO_VERTEX, t2 = NO_VERTEX;
+
+			if ( kind[v] == SEAM )
+			{
+				w = pWedges[v];
+				t2 = ( t == openOut[v] ) ? openIn[w] : openOut[w];
+
+				if ( t2 >= MANY_VERTICES || position[t2] != position[t] ) {
+					continue;
+				}
+			}
+
+			if ( has_flips( v, t ) || ( w != NO_VERTEX && has_flips( w, t2 ) ) ) {
+				continue;
+			}
+
+			collapseRemap[v] = t;
+
+			if ( w != NO_VERTEX ) {
+				collapseRemap[w] = t2;
+			}
+
+			addQuadric( quadrics[position[t]], quadrics[position[v]] );
+			collapseLocked[position[v]] = 1;
+			collapseLocked[position[t]] = 1;
+
+			removed += ( kind[v] == BORDER ) ? 1 : 2;
+			resultError = max( resultError, collapse.error );
+			applied++;
+		}
+
+		if ( applied == 0 ) {
+			break;
+		}
+
+		// The triangles around the collapsed edges are now degenerate, and are
+		// removed.
+
+		write = 0;
+
+		for ( size_t i = 0; i < indices.size(); i += 3 )
+		{
+			const UINT a = collapseRemap[indices[i]];
+			const UINT b = collapseRemap[indices[i+1]];
+			const UINT c = collapseRemap[indices[i+2]];
+
+			if ( position[a] != position[b] && position[b] != position[c] && position[c] != position[a] ) {
+				indices[write++] = a;
+				indices[write++] = b;
+				indices[write++] = c;
+			}
+		}
+
+		indices.resize( write );
+
+		remapLoops( openOut, collapseRemap );
+		remapLoops( openIn, collapseRemap );
+
+		buildAdjacency( adjacency, indices, vertexCount );
+	}
+
+	return( static_cast<float>( sqrt( resultError ) ) );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,66 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "GlyphHash.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	unsigned long long Rotate( unsigned long long value, int bits )
+	{
+		return( ( value << bits ) | ( value >> ( 64 - bits ) ) );
+	}
+};
+//--------------------------------------------------------------------------------
+GlyphHash::GlyphHash( )
+{
+}
+//--------------------------------------------------------------------------------
+unsigned long long GlyphHash::HashData( const void* pData, size_t size, unsigned long long seed )
+{
+	// The data is hashed eight bytes at a time, which keeps hashing a source
+	// file much cheaper than parsing it.
+
+	const unsigned long long M1 = 0x87c37b91114253d5ull;
+	const unsigned long long M2 = 0x4cf5ad432745937full;
+
+	const unsigned char* pBytes = static_cast<const unsigned char*>( pData );
+	unsigned long long hash = seed ^ ( static_cast<unsigned long long>( size ) * M1 );
+
+	size_t i = 0;
+
+	for ( ; i + 8 <= size; i += 8 )
+	{
+		unsigned long long word;
+		memcpy( &word, pBytes + i, sizeof( word ) );
+
+		hash ^= Rotate( word * M1, 31 ) * M2;
+		hash = Rotate( hash, 27 ) * 5 + 0x52dce729;
+	}
+
+	unsigned long long tail = 0;
+
+	for ( int shift = 0; i < size; i++, shift += 8 )
+		tail |= static_cast<unsigned long long>( pBytes[i] ) << shift;
+
+	hash ^= Rotate( tail * M1, 31 ) * M2;
+
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdull;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ull;
+	hash ^= hash >> 33;
+
+	return( hash );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
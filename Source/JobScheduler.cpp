@@ -0,0 +1,262 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "JobScheduler.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+JobCounter::JobCounter() :
+	m_uiPending( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+bool JobCounter::IsComplete() const
+{
+	return( m_uiPending.load() == 0 );
+}
+//--------------------------------------------------------------------------------
+JobScheduler::JobScheduler() :
+	m_uiQueuedJobs( 0 ),
+	m_bRunning( false )
+{
+	// Until the scheduler is initialized, all jobs are executed by the thread
+	// that waits for them.
+
+	m_Queues.push_back( std::unique_ptr<WorkerQueue>( new WorkerQueue() ) );
+}
+//--------------------------------------------------------------------------------
+JobScheduler::~JobScheduler()
+{
+	Shutdown();
+}
+//--------------------------------------------------------------------------------
+void JobScheduler::Initialize( unsigned int threads )
+{
+	Shutdown();
+
+	if ( threads == 0 ) {
+		threads = GetHardwareThreadCount();
+	}
+
+	m_Queues.clear();
+
+	for ( unsigned int i = 0; i < threads; i++ ) {
+		m_Queues.push_back( std::unique_ptr<WorkerQueue>( new WorkerQueue() ) );
+	}
+
+	m_bRunning = true;
+
+	// The calling thread takes the first queue, so one thread less is created.
+
+	for ( unsigned int i = 1; i < threads; i++ ) {
+		m_Threads.push_back( std::thread( &JobScheduler::WorkerThreadProc, this, i ) );
+	}
+}
+//--------------------------------------------------------------------------------
+void JobScheduler::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_SleepLock );
+		m_bRunning = false;
+	}
+
+	m_WakeCondition.notify_all();
+
+	for ( auto& thread : m_Threads ) {
+		thread.join();
+	}
+
+	m_Threads.clear();
+}
+//--------------------------------------------------------------------------------
+unsigned int JobScheduler::GetThreadCount() const
+{
+	return( static_cast<unsigned int>( m_Queues.size() ) );
+}
+//--------------------------------------------------------------------------------
+unsigned int JobScheduler::GetHardwareThreadCount()
+{
+	// The hardware concurrency is only a hint, and may be reported as zero.
+
+	unsigned int count = std::thread::hardware_concurrency();
+
+	return( count > 0 ? count : 1 );
+}
+//--------------------------------------------------------------------------------
+unsigned int JobScheduler::GetWorkerIndex() const
+{
+	const std::thread::id id = std::this_thread::get_id();
+
+	for ( unsigned int i = 0; i < m_Threads.size(); i++ ) {
+		if ( m_Threads[i].get_id() == id ) {
+			return( i + 1 );
+		}
+	}
+
+	return( 0 );
+}
+//--------------------------------------------------------------------------------
+void JobScheduler::Submit( const JobFunction& job, JobCounter& counter, unsigned int worker )
+{
+	assert( worker < m_Queues.size() );
+
+	counter.m_uiPending++;
+
+	Job entry;
+	entry.Function = job;
+	entry.pCounter = &counter;
+
+	{
+		std::lock_guard<std::mutex> lock( m_Queues[worker]->Lock );
+		m_Queues[worker]->Jobs.push_back( entry );
+	}
+
+	// The count is modified under the sleep lock, so that a worker can't miss
+	// the notification between checking the count and going to sleep.
+
+	{
+		std::lock_guard<std::mutex> lock( m_SleepLock );
+		m_uiQueuedJobs++;
+	}
+
+	m_WakeCondition.notify_one();
+}
+//--------------------------------------------------------------------------------
+void JobScheduler::Wait( JobCounter& counter, unsigned int worker )
+{
+	assert( worker < m_Queues.size() );
+
+	while ( !counter.IsComplete() )
+	{
+		Job job;
+
+		if ( Acquire( worker, job, &counter ) ) {
+			Execute( job, worker );
+		} else {
+			std::this_thread::yield();
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+void JobScheduler::ParallelFor( unsigned int count, unsigned int grain, const JobRangeFunction& function, unsigned int worker )
+{
+	if ( grain == 0 ) {
+		grain = 1;
+	}
+
+	// Small ranges aren't worth the cost of scheduling, so they are processed
+	// directly by the calling thread.
+
+	if ( count <= grain ) {
+		if ( count > 0 ) function( 0, count, worker );
+		return;
+	}
+
+	JobCounter counter;
+
+	for ( unsigned int begin = 0; begin < count; begin += grain )
+	{
+		unsigned int end = ( count - begin > grain ) ? begin + grain : count;
+
+		Submit( [&function,begin,end]( unsigned int thread ) {
+			function( begin, end, thread );
+		}, counter, worker );
+	}
+
+	Wait( counter, worker );
+}
+//--------------------------------------------------------------------------------
+bool JobScheduler::Pop( unsigned int worker, Job& job, JobCounter* pCounter )
+{
+	// The owner takes the most recently queued job, which is the most likely
+	// to still have its data in the cache.
+
+	WorkerQueue& queue = *m_Queues[worker];
+	std::lock_guard<std::mutex> lock( queue.Lock );
+
+	for ( auto it = queue.Jobs.rbegin(); it != queue.Jobs.rend(); ++it )
+	{
+		if ( pCounter == nullptr || it->pCounter == pCounter ) {
+			job = std::move( *it );
+			queue.Jobs.erase( std::next( it ).base() );
+			return( true );
+		}
+	}
+
+	return( false );
+}
+//--------------------------------------------------------------------------------
+bool JobScheduler::Steal( unsigned int worker, Job& job, JobCounter* pCounter )
+{
+	// Other threads take the oldest job, which is usually the largest piece of
+	// the remaining work.  The victims are visited starting after the thief so
+	// that the threads don't all contend for the same queue.
+
+	const unsigned int count = static_cast<unsigned int>( m_Queues.size() );
+
+	for ( unsigned int i = 1; i < count; i++ )
+	{
+		WorkerQueue& queue = *m_Queues[( worker + i ) % count];
+		std::lock_guard<std::mutex> lock( queue.Lock );
+
+		for ( auto it = queue.Jobs.begin(); it != queue.Jobs.end(); ++it )
+		{
+			if ( pCounter == nullptr || it->pCounter == pCounter ) {
+				job = std::move( *it );
+				queue.Jobs.erase( it );
+				return( true );
+			}
+		}
+	}
+
+	return( false );
+}
+//--------------------------------------------------------------------------------
+bool JobScheduler::Acquire( unsigned int worker, Job& job, JobCounter* pCounter )
+{
+	if ( Pop( worker, job, pCounter ) || Steal( worker, job, pCounter ) ) {
+		m_uiQueuedJobs--;
+		return( true );
+	}
+
+	return( false );
+}
+//--------------------------------------------------------------------------------
+void JobScheduler::Execute( Job& job, unsigned int worker )
+{
+	job.Function( worker );
+	job.pCounter->m_uiPending--;
+}
+//--------------------------------------------------------------------------------
+void JobScheduler::WorkerThreadProc( unsigned int worker )
+{
+	for ( ; ; )
+	{
+		Job job;
+
+		if ( Acquire( worker, job ) ) {
+			Execute( job, worker );
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock( m_SleepLock );
+
+		m_WakeCondition.wait( lock, [this]() {
+			return( !m_bRunning || m_uiQueuedJobs.load() > 0 );
+		} );
+
+		if ( !m_bRunning ) {
+			return;
+		}
+	}
+}
+//--------------------------------------------------------------------------------
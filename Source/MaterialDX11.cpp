@@ -17,7 +17,10 @@
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
-MaterialDX11::MaterialDX11()
+unsigned int MaterialDX11::s_uiNextMaterialID = 0;
+//--------------------------------------------------------------------------------
+MaterialDX11::MaterialDX11() :
+	m_uiMaterialID( s_uiNextMaterialID++ )
 {
 	for ( int i = 0; i < VT_NUM_VIEW_TYPES; i++ )
 	{
@@ -84,4 +87,9 @@ void MaterialDX11::GetAllVertexShaderIDs( std::vector<int>& idlist )
 		}
 	}
 }
+//--------------------------------------------------------------------------------
+unsigned int MaterialDX11::GetMaterialID() const
+{
+	return( m_uiMaterialID );
+}
 //--------------------------------------------------------------------------------
\ No newline at end of file
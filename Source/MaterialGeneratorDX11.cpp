@@ -17,6 +17,7 @@
 #include "ShaderResourceParameterWriterDX11.h"
 #include "SamplerParameterWriterDX11.h"
 #include "SamplerStateConfigDX11.h"
+#include "AssetCacheDX11.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
@@ -425,7 +426,7 @@ MaterialPtr MaterialGeneratorDX11::GenerateImmediateGeometryTexturedMaterial( Re
 	// Load a texture to initialize with.  Then add a parameter writer to the 
 	// material which will be used to set the texture for usage with this material.
 
-	ResourcePtr ColorTexture = RendererDX11::Get()->LoadTexture( L"EyeOfHorus_128.png" );
+	ResourcePtr ColorTexture = AssetCacheDX11::Get().GetTexture( L"EyeOfHorus_128.png" );
 	pMaterial->Parameters.SetShaderResourceParameter( L"ColorTexture", ColorTexture );
 
 	// Create a sampler for use by this material.  Then add a parameter writer to the 
@@ -592,7 +593,7 @@ MaterialPtr MaterialGeneratorDX11::GenerateTextMaterial( RendererDX11& Renderer
 	// Load a texture to initialize with.  Then add a parameter writer to the 
 	// material which will be used to set the texture for usage with this material.
 
-	ResourcePtr ColorTexture = RendererDX11::Get()->LoadTexture( L"EyeOfHorus_128.png" );
+	ResourcePtr ColorTexture = AssetCacheDX11::Get().GetTexture( L"EyeOfHorus_128.png" );
 	pMaterial->Parameters.SetShaderResourceParameter( L"ColorTexture", ColorTexture );
 
 	// Create a sampler for use by this material.  Then add a parameter writer to the 
@@ -14,21 +14,12 @@
 //----------------------------------------------------------------------------------------------------
 using namespace Glyph3;
 //----------------------------------------------------------------------------------------------------
-Matrix4f::Matrix4f()
-{
-}
-//----------------------------------------------------------------------------------------------------
 Matrix4f::Matrix4f( bool bZero )
 {
 	if (bZero)
 		memset(m_afEntry, 0, 4*4*sizeof(float));
 }
 //----------------------------------------------------------------------------------------------------
-Matrix4f::Matrix4f( const Matrix4f& Matrix )
-{
-    memcpy( m_afEntry, (void*)&Matrix, 16*sizeof(float) );
-}
-//----------------------------------------------------------------------------------------------------
 Matrix4f::Matrix4f(	float fM11, float fM12, float fM13, float fM14,
 						float fM21, float fM22, float fM23, float fM24,
 						float fM31, float fM32, float fM33, float fM34,
@@ -55,12 +46,6 @@ Matrix4f::Matrix4f(	float fM11, float fM12, float fM13, float fM14,
 	m_afEntry[15] = fM44;
 }
 //----------------------------------------------------------------------------------------------------
-Matrix4f& Matrix4f::operator= ( const Matrix4f& Matrix )
-{
-    memcpy( m_afEntry, Matrix.m_afEntry, 16*sizeof(float) );
-    return( *this );
-}
-//----------------------------------------------------------------------------------------------------
 void Matrix4f::RotationX( float fRadians )
 {
     float fSin = sinf( fRadians );
@@ -185,53 +170,6 @@ void Matrix4f::Translate( float fX, float fY, float fZ )
 	m_afEntry[15] = 1.0f;
 }
 //----------------------------------------------------------------------------------------------------
-Matrix4f Matrix4f::Inverse() const
-{
-    float fA0 = m_afEntry[ 0]*m_afEntry[ 5] - m_afEntry[ 1]*m_afEntry[ 4];
-    float fA1 = m_afEntry[ 0]*m_afEntry[ 6] - m_afEntry[ 2]*m_afEntry[ 4];
-    float fA2 = m_afEntry[ 0]*m_afEntry[ 7] - m_afEntry[ 3]*m_afEntry[ 4];
-    float fA3 = m_afEntry[ 1]*m_afEntry[ 6] - m_afEntry[ 2]*m_afEntry[ 5];
-    float fA4 = m_afEntry[ 1]*m_afEntry[ 7] - m_afEntry[ 3]*m_afEntry[ 5];
-    float fA5 = m_afEntry[ 2]*m_afEntry[ 7] - m_afEntry[ 3]*m_afEntry[ 6];
-    float fB0 = m_afEntry[ 8]*m_afEntry[13] - m_afEntry[ 9]*m_afEntry[12];
-    float fB1 = m_afEntry[ 8]*m_afEntry[14] - m_afEntry[10]*m_afEntry[12];
-    float fB2 = m_afEntry[ 8]*m_afEntry[15] - m_afEntry[11]*m_afEntry[12];
-    float fB3 = m_afEntry[ 9]*m_afEntry[14] - m_afEntry[10]*m_afEntry[13];
-    float fB4 = m_afEntry[ 9]*m_afEntry[15] - m_afEntry[11]*m_afEntry[13];
-    float fB5 = m_afEntry[10]*m_afEntry[15] - m_afEntry[11]*m_afEntry[14];
-
-    float fDet = fA0*fB5 - fA1*fB4 + fA2*fB3 + fA3*fB2 - fA4*fB1 + fA5*fB0;
-    //if ( Math<Real>::FAbs(fDet) <= Math<Real>::EPSILON )
-    //    return Matrix4::ZERO;
-
-    Matrix4f kInv;
-    kInv(0,0) = + m_afEntry[ 5]*fB5 - m_afEntry[ 6]*fB4 + m_afEntry[ 7]*fB3;
-    kInv(1,0) = - m_afEntry[ 4]*fB5 + m_afEntry[ 6]*fB2 - m_afEntry[ 7]*fB1;
-    kInv(2,0) = + m_afEntry[ 4]*fB4 - m_afEntry[ 5]*fB2 + m_afEntry[ 7]*fB0;
-    kInv(3,0) = - m_afEntry[ 4]*fB3 + m_afEntry[ 5]*fB1 - m_afEntry[ 6]*fB0;
-    kInv(0,1) = - m_afEntry[ 1]*fB5 + m_afEntry[ 2]*fB4 - m_afEntry[ 3]*fB3;
-    kInv(1,1) = + m_afEntry[ 0]*fB5 - m_afEntry[ 2]*fB2 + m_afEntry[ 3]*fB1;
-    kInv(2,1) = - m_afEntry[ 0]*fB4 + m_afEntry[ 1]*fB2 - m_afEntry[ 3]*fB0;
-    kInv(3,1) = + m_afEntry[ 0]*fB3 - m_afEntry[ 1]*fB1 + m_afEntry[ 2]*fB0;
-    kInv(0,2) = + m_afEntry[13]*fA5 - m_afEntry[14]*fA4 + m_afEntry[15]*fA3;
-    kInv(1,2) = - m_afEntry[12]*fA5 + m_afEntry[14]*fA2 - m_afEntry[15]*fA1;
-    kInv(2,2) = + m_afEntry[12]*fA4 - m_afEntry[13]*fA2 + m_afEntry[15]*fA0;
-    kInv(3,2) = - m_afEntry[12]*fA3 + m_afEntry[13]*fA1 - m_afEntry[14]*fA0;
-    kInv(0,3) = - m_afEntry[ 9]*fA5 + m_afEntry[10]*fA4 - m_afEntry[11]*fA3;
-    kInv(1,3) = + m_afEntry[ 8]*fA5 - m_afEntry[10]*fA2 + m_afEntry[11]*fA1;
-    kInv(2,3) = - m_afEntry[ 8]*fA4 + m_afEntry[ 9]*fA2 - m_afEntry[11]*fA0;
-    kInv(3,3) = + m_afEntry[ 8]*fA3 - m_afEntry[ 9]*fA1 + m_afEntry[10]*fA0;
-
-    float fInvDet = ((float)1.0)/fDet;
-    for (int iRow = 0; iRow < 4; iRow++)
-    {
-        for (int iCol = 0; iCol < 4; iCol++)
-            kInv(iRow,iCol) *= fInvDet;
-    }
-
-    return( kInv );
-}
-//----------------------------------------------------------------------------------------------------
 Vector3f Matrix4f::GetBasisX() const
 {
 	Vector3f Basis;
@@ -507,56 +445,6 @@ Matrix4f Matrix4f::OrthographicLHMatrix( float zn, float zf, float width, float
 	return( ret );
 }
 //----------------------------------------------------------------------------------------------------
-float Matrix4f::operator[] ( int iPos ) const
-{
-    return( m_afEntry[iPos] );
-}
-//----------------------------------------------------------------------------------------------------
-float& Matrix4f::operator[] ( int iPos )
-{
-    return( m_afEntry[iPos] );
-}
-//----------------------------------------------------------------------------------------------------
-float Matrix4f::operator() ( int iRow, int iCol ) const
-{
-    return( m_afEntry[I(iRow,iCol)] );
-}
-//----------------------------------------------------------------------------------------------------
-float& Matrix4f::operator() ( int iRow, int iCol )
-{
-    return( m_afEntry[I(iRow,iCol)] );
-}
-//----------------------------------------------------------------------------------------------------
-bool Matrix4f::operator== ( const Matrix4f& Matrix ) const
-{
-    return( memcmp( m_afEntry, Matrix.m_afEntry, 4*4*sizeof(float) ) == 0 );
-}
-//----------------------------------------------------------------------------------------------------
-bool Matrix4f::operator!= ( const Matrix4f& Matrix ) const
-{
-    return( memcmp( m_afEntry, Matrix.m_afEntry, 4*4*sizeof(float) ) != 0 );
-}
-//----------------------------------------------------------------------------------------------------
-Matrix4f Matrix4f::operator* ( const Matrix4f& Matrix ) const
-{
-	Matrix4f mProd;
-
-	for (int iRow = 0; iRow < 4; iRow++)
-	{
-		for (int iCol = 0; iCol < 4; iCol++)
-		{
-			int i = I(iRow, iCol);
-			mProd.m_afEntry[i] = 0.0f;
-			for (int iMid = 0; iMid < 4; iMid++)
-			{
-				mProd.m_afEntry[i] += 
-					m_afEntry[I(iRow, iMid)] * Matrix.m_afEntry[I(iMid, iCol)];
-			}
-		}
-	}
-	return( mProd );
-}
-//----------------------------------------------------------------------------------------------------
 Matrix4f Matrix4f::operator+ ( const Matrix4f& Matrix ) const
 {
 	Matrix4f mSum;
@@ -639,26 +527,6 @@ Matrix4f& Matrix4f::operator*= ( float fScalar )
 	return( *this );
 }
 //----------------------------------------------------------------------------------------------------
-Matrix4f& Matrix4f::operator*= ( const Matrix4f& Matrix )
-{
-	Matrix4f mProd = *this; 
-	
-	for ( int iRow = 0; iRow < 4; iRow++ )
-	{
-		for ( int iCol = 0; iCol < 4; iCol++ )
-		{
-			int i = I(iRow, iCol);
-			m_afEntry[i] = 0.0f;
-			for ( int iMid = 0; iMid < 4; iMid++ )
-			{
-				m_afEntry[i] += 
-					mProd.m_afEntry[I(iRow, iMid)] * Matrix.m_afEntry[I(iMid, iCol)];
-			}
-		}
-	}
-	return( *this );
-}
-//----------------------------------------------------------------------------------------------------
 Matrix4f& Matrix4f::operator/= ( float fScalar )
 {
 	if ( fScalar != 0.0f )
@@ -695,19 +563,6 @@ void Matrix4f::MakeIdentity()
 	}
 }
 //----------------------------------------------------------------------------------------------------
-void Matrix4f::MakeTranspose()
-{
-	Matrix4f mTranspose;
-
-	for ( int iRow = 0; iRow < 4; iRow++ )
-	{
-		for ( int iCol = 0; iCol < 4; iCol++ )
-			mTranspose.m_afEntry[I(iRow,iCol)] = m_afEntry[I(iCol,iRow)];
-	}
-    
-	memcpy( m_afEntry, mTranspose.m_afEntry, 4*4*sizeof(float) );
-}
-//----------------------------------------------------------------------------------------------------
 Matrix4f Matrix4f::Zero()
 {
 	Matrix4f mReturn = Matrix4f( true );
@@ -733,37 +588,6 @@ Matrix4f Matrix4f::Identity()
 	return( mIdent );
 }
 //----------------------------------------------------------------------------------------------------
-Matrix4f Matrix4f::Transpose()
-{
-	Matrix4f mTranspose;
-
-	for ( int iRow = 0; iRow < 4; iRow++ )
-	{
-		for ( int iCol = 0; iCol < 4; iCol++ )
-			mTranspose.m_afEntry[I(iRow,iCol)] = m_afEntry[I(iCol,iRow)];
-	}
-
-	return( mTranspose );
-
-}
-//----------------------------------------------------------------------------------------------------
-int Matrix4f::I( int iRow, int iCol )
-{
-    return( 4*iRow + iCol );
-}
-//----------------------------------------------------------------------------------------------------
-Vector4f Matrix4f::operator* ( const Vector4f& Vector ) const
-{
-    Vector4f vProd;
-    for ( int iCol = 0; iCol < 4; iCol++ )
-    {
-        vProd[iCol] = 0.0f;
-        for ( int iRow = 0; iRow < 4; iRow++ )
-            vProd[iCol] += m_afEntry[I(iRow,iCol)] * Vector[iRow];
-    }
-    return( vProd );
-}
-//----------------------------------------------------------------------------------------------------
 void Matrix4f::SetRow( int iRow, const Vector4f& Vector )
 {
 	for ( int iCol = 0; iCol < 4; iCol++ )
@@ -0,0 +1,110 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "MemoryMappedFile.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+MemoryMappedFile::MemoryMappedFile()
+{
+	m_hFile = INVALID_HANDLE_VALUE;
+	m_hMapping = nullptr;
+	m_pData = nullptr;
+	m_uiSize = 0;
+}
+//--------------------------------------------------------------------------------
+MemoryMappedFile::~MemoryMappedFile()
+{
+	Close();
+}
+//--------------------------------------------------------------------------------
+bool MemoryMappedFile::Open( const std::wstring& filename )
+{
+	// Close the current file if one is open.
+	Close();
+
+	m_hFile = CreateFileW( filename.c_str(),
+						   GENERIC_READ,
+						   FILE_SHARE_READ,
+						   nullptr,
+						   OPEN_EXISTING,
+						   FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+						   nullptr );
+
+	if ( INVALID_HANDLE_VALUE == m_hFile ) {
+		return( false );
+	}
+
+	LARGE_INTEGER FileSize = { 0 };
+
+	if ( !GetFileSizeEx( m_hFile, &FileSize ) || FileSize.QuadPart > static_cast<LONGLONG>( SIZE_MAX ) ) {
+		Close();
+		return( false );
+	}
+
+	m_uiSize = static_cast<size_t>( FileSize.QuadPart );
+
+	// An empty file can't be mapped, but it is still a valid file with no data.
+
+	if ( m_uiSize == 0 ) {
+		return( true );
+	}
+
+	m_hMapping = CreateFileMappingW( m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr );
+
+	if ( nullptr == m_hMapping ) {
+		Close();
+		return( false );
+	}
+
+	m_pData = static_cast<const char*>( MapViewOfFile( m_hMapping, FILE_MAP_READ, 0, 0, 0 ) );
+
+	if ( nullptr == m_pData ) {
+		Close();
+		return( false );
+	}
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+bool MemoryMappedFile::Close( )
+{
+	if ( nullptr != m_pData ) {
+		UnmapViewOfFile( m_pData );
+		m_pData = nullptr;
+	}
+
+	if ( nullptr != m_hMapping ) {
+		CloseHandle( m_hMapping );
+		m_hMapping = nullptr;
+	}
+
+	if ( INVALID_HANDLE_VALUE != m_hFile ) {
+		CloseHandle( m_hFile );
+		m_hFile = INVALID_HANDLE_VALUE;
+	}
+
+	m_uiSize = 0;
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+const char* MemoryMappedFile::GetDataPtr() const
+{
+	return( m_pData );
+}
+//--------------------------------------------------------------------------------
+size_t MemoryMappedFile::GetDataSize() const
+{
+	return( m_uiSize );
+}
+//--------------------------------------------------------------------------------
@@ -11,144 +11,402 @@
 //--------------------------------------------------------------------------------
 #include "PCH.h"
 #include "MeshOBJ.h"
-#include "GlyphString.h"
+#include "MemoryMappedFile.h"
+#include "TextScanner.h"
+#include "JobScheduler.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 using namespace Glyph3::OBJ;
 //--------------------------------------------------------------------------------
-Vector3f toVec3(const std::vector<std::string>& tokens)
+namespace
 {
-	assert(tokens.size() >= 4);
+	// Files are split into chunks of roughly this size for parallel parsing.
 
-	return Vector3f(
-		std::stof(tokens[1]),
-		std::stof(tokens[2]),
-		std::stof(tokens[3]) );
-}
-//--------------------------------------------------------------------------------
-Vector2f toVec2(const std::vector<std::string>& tokens)
-{
-	assert(tokens.size() >= 3);
-	return Vector2f(
-		std::stof(tokens[1]),
-		std::stof(tokens[2]));
-}
-//--------------------------------------------------------------------------------
-std::array<int, 3> toIndexTriple(const std::string s)
-{
-	// Split the string according to '/' into tokens
-	std::vector<std::string> elems;
-	std::stringstream ss(s);
-	std::string item;
+	const size_t CHUNK_SIZE = 4 * 1024 * 1024;
 
-	elems = GlyphString::split(s, '/');
+	// A face corner as it is read from a chunk.  Each component is either an
+	// absolute (zero based) index, an index relative to the chunk's own
+	// attribute arrays (for negative indices in the file), or missing.
 
-	// We need to have at least one index to do anything.
-	assert(elems.size() >= 1 && elems.size() <= 3);
+	enum ComponentType
+	{
+		COMPONENT_MISSING,
+		COMPONENT_ABSOLUTE,
+		COMPONENT_RELATIVE
+	};
 
-	// initialize to 0, then fill in indices with the available data.
-	std::array<int, 3> triple = { 0, 0, 0 };
+	struct corner_t
+	{
+		int index[3];
+		unsigned char type[3];
+	};
+
+	// Declarations that change the current object or material are recorded
+	// with the number of faces that preceded them in the chunk, so that they
+	// can be replayed in file order while merging.
+
+	enum EventType
+	{
+		EVENT_OBJECT,
+		EVENT_MATERIAL,
+		EVENT_MATERIAL_LIB
+	};
+
+	struct event_t
+	{
+		EventType type;
+		size_t face;
+		std::string name;
+	};
+
+	struct chunk_t
+	{
+		std::vector<Vector3f> positions;
+		std::vector<Vector3f> normals;
+		std::vector<Vector2f> coords;
+		std::vector<corner_t> corners;
+		std::vector<MeshOBJ::face_t> faces;
+		std::vector<event_t> events;
+	};
 
-	for (size_t i = 0; i < elems.size(); ++i) {
-		if (elems[i].size() > 0) {
-			triple[i] = atoi(elems[i].c_str()) - 1; // Indices start at 1, so shift down one to match our vector format.
+	// The components of a corner are stored in position, texture, normal order,
+	// following the v/vt/vn layout of the face declarations.
+
+	void readComponent(TextScanner& scanner, corner_t& corner, int component, size_t localCount)
+	{
+		int value = 0;
+
+		if (!scanner.ReadInt(value) || value == 0) {
+			corner.index[component] = 0;
+			corner.type[component] = COMPONENT_MISSING;
+		}
+		else if (value > 0) {
+			corner.index[component] = value - 1;	// Indices start at 1 in the file.
+			corner.type[component] = COMPONENT_ABSOLUTE;
+		}
+		else {
+			corner.index[component] = static_cast<int>(localCount) + value;
+			corner.type[component] = COMPONENT_RELATIVE;
 		}
 	}
 
-	return triple;
-}
-//--------------------------------------------------------------------------------
-int relativeOffset(int index, int refVal)
-{
-	if (index < 0)
-		index = index + refVal + 1; // With negative indices, add the current size of the arrays for relative offsets.
+	void parseFace(TextScanner& scanner, chunk_t& chunk)
+	{
+		MeshOBJ::face_t face;
+		face.start = static_cast<unsigned int>(chunk.corners.size());
 
-	return index;
-}
-//--------------------------------------------------------------------------------
-MeshOBJ::MeshOBJ(const std::wstring& filename)
-{
-	// Open the file in text mode.  If there is an issue opening the file, 
-	// just exit since nothing has been allocated.
+		scanner.SkipSpaces();
 
-	std::ifstream objFile(filename, std::ios::in);
-	if (!objFile.is_open()) { return; }
+		while (!scanner.AtLineEnd())
+		{
+			corner_t corner;
 
-	// We will process the file one line at a time.
-	std::string line;
+			readComponent(scanner, corner, 0, chunk.positions.size());
+			corner.index[1] = corner.index[2] = 0;
+			corner.type[1] = corner.type[2] = COMPONENT_MISSING;
 
-	// Initialize to a single group in case none are declared within the file.
-	//objects.push_back( object_t() );
+			if (scanner.Match('/')) {
+				if (scanner.Peek() != '/')
+					readComponent(scanner, corner, 1, chunk.coords.size());
+				if (scanner.Match('/'))
+					readComponent(scanner, corner, 2, chunk.normals.size());
+			}
 
-	while (std::getline(objFile, line))
-	{
-		std::stringstream   lineStream(line);
-		std::string         token;
-		std::vector<std::string> tokenList;
+			// Anything else in the token is malformed, and is skipped.
+			scanner.SkipToken();
+			scanner.SkipSpaces();
 
-		while (lineStream >> token) {
-			tokenList.push_back(token);
+			if (corner.type[0] != COMPONENT_MISSING)
+				chunk.corners.push_back(corner);
 		}
 
-		// Check for an empty line
-		if (tokenList.size() != 0) {
-			if (tokenList[0] == "v") {
-				positions.emplace_back(toVec3(tokenList));
-			}
-			else if (tokenList[0] == "vn") {
-				normals.emplace_back(toVec3(tokenList));
-			}
-			else if (tokenList[0] == "vt") {
-				coords.emplace_back(toVec2(tokenList));
-			}
-			else if (tokenList[0] == "f" ||
-				     tokenList[0] == "l" ||
-					 tokenList[0] == "p" ) {
+		face.count = static_cast<unsigned int>(chunk.corners.size()) - face.start;
+
+		if (face.count > 0)
+			chunk.faces.push_back(face);
+	}
+
+	void parseChunk(const char* pBegin, const char* pEnd, chunk_t& chunk)
+	{
+		TextScanner scanner(pBegin, pEnd);
 
-				face_t f;
+		while (!scanner.AtEnd())
+		{
+			scanner.SkipSpaces();
 
-				for ( size_t i = 1; i < tokenList.size(); ++i ) {
-					auto triple = toIndexTriple( tokenList[i] );
-					f.positionIndices.push_back( relativeOffset( triple[0], positions.size() ) );
-					f.coordIndices.push_back( relativeOffset( triple[1], coords.size() ) );
-					f.normalIndices.push_back( relativeOffset( triple[2], normals.size() ) );
+			Vector3f v3;
+			Vector2f v2;
+
+			switch (scanner.Peek())
+			{
+			case 'v':
+				if (scanner.MatchKeyword("v")) {
+					v3.MakeZero();
+					scanner.ReadFloat(v3.x); scanner.ReadFloat(v3.y); scanner.ReadFloat(v3.z);
+					chunk.positions.push_back(v3);
+				}
+				else if (scanner.MatchKeyword("vn")) {
+					v3.MakeZero();
+					scanner.ReadFloat(v3.x); scanner.ReadFloat(v3.y); scanner.ReadFloat(v3.z);
+					chunk.normals.push_back(v3);
 				}
+				else if (scanner.MatchKeyword("vt")) {
+					v2.MakeZero();
+					scanner.ReadFloat(v2.x); scanner.ReadFloat(v2.y);
+					chunk.coords.push_back(v2);
+				}
+				break;
 
-				// If no object has been declared yet, then add one along with
-				// a subobject.  Otherwise, ensure that the current object has
-				// at least one subobject already with which to add the face to.
-				if ( objects.size() == 0 ) { 
-					objects.push_back(object_t());
-				} 
+			case 'f':
+			case 'l':
+			case 'p':
+				if (scanner.MatchKeyword("f") || scanner.MatchKeyword("l") || scanner.MatchKeyword("p"))
+					parseFace(scanner, chunk);
+				break;
 
-				if ( objects.back().subobjects.size() == 0 ) {
-					objects.back().subobjects.push_back(subobject_t());
+			case 'o':
+				if (scanner.MatchKeyword("o")) {
+					event_t e = { EVENT_OBJECT, chunk.faces.size(), scanner.ReadLine() };
+					e.name = e.name.substr(0, e.name.find_first_of(" \t"));
+					chunk.events.push_back(e);
+					continue;
+				}
+				break;
+
+			case 'u':
+				if (scanner.MatchKeyword("usemtl")) {
+					event_t e = { EVENT_MATERIAL, chunk.faces.size(), scanner.ReadLine() };
+					chunk.events.push_back(e);
+					continue;
+				}
+				break;
+
+			case 'm':
+				if (scanner.MatchKeyword("mtllib")) {
+					event_t e = { EVENT_MATERIAL_LIB, chunk.faces.size(), scanner.ReadLine() };
+					chunk.events.push_back(e);
+					continue;
 				}
-				
-				objects.back().subobjects.back().faces.emplace_back(f);
+				break;
 			}
-			else if (tokenList[0] == "o") {
-				// Check if the default object is currently in use. If so,
-				// put this name on that object, otherwise we create a new one.
-				if (objects.size() == 1 && objects.back().subobjects.back().faces.size() == 0) {
-					objects.back().name = tokenList[1];
+
+			// Comments, groups, smoothing groups and anything else that isn't
+			// used by the loader are skipped along with the rest of the line.
+			scanner.NextLine();
+		}
+	}
+
+	// Splits the data into chunks that end just after a line break, so that no
+	// line is divided between two chunks.
+
+	std::vector<const char*> findChunkBoundaries(const char* pData, size_t size, size_t chunks)
+	{
+		std::vector<const char*> boundaries;
+		boundaries.push_back(pData);
+
+		const char* pEnd = pData + size;
+
+		for (size_t i = 1; i < chunks; ++i)
+		{
+			const char* p = max(pData + size / chunks * i, boundaries.back());
+
+			while (p < pEnd && *p != '\n')
+				++p;
+
+			if (p < pEnd)
+				++p;
+
+			if (p > boundaries.back() && p < pEnd)
+				boundaries.push_back(p);
+		}
+
+		boundaries.push_back(pEnd);
+
+		return boundaries;
+	}
+
+	// The vertices are welded by their resolved index triples, with -1 for the
+	// missing or out of range components.  Since every corner has a position,
+	// the position index is used directly as the bucket of a hash table, and the
+	// vertices of each bucket are chained together through their indices.
+
+	struct vertexKey_t
+	{
+		int index[3];
+	};
+
+	const unsigned int NO_VERTEX = 0xffffffff;
+
+	int resolveComponent(const corner_t& corner, int component, size_t base, size_t count)
+	{
+		if (corner.type[component] == COMPONENT_MISSING)
+			return -1;
+
+		long long index = corner.index[component];
+
+		if (corner.type[component] == COMPONENT_RELATIVE)
+			index += static_cast<long long>(base);
+
+		if (index < 0 || index >= static_cast<long long>(count))
+			return -1;
+
+		return static_cast<int>(index);
+	}
+};
+//--------------------------------------------------------------------------------
+MeshOBJ::MeshOBJ(const std::wstring& filename, JobScheduler* pScheduler)
+{
+	// Map the file into memory.  If there is an issue opening the file, just
+	// exit since nothing has been allocated.
+
+	MemoryMappedFile file;
+	if (!file.Open(filename) || file.GetDataSize() == 0) { return; }
+
+	const char* pData = file.GetDataPtr();
+	const size_t size = file.GetDataSize();
+
+	// Parse the chunks, in parallel if there is a scheduler available.  Each
+	// chunk only writes to its own set of arrays.
+
+	size_t chunkCount = 1;
+
+	if (pScheduler != nullptr && pScheduler->GetThreadCount() > 1)
+		chunkCount = max(1, size / CHUNK_SIZE);
+
+	std::vector<const char*> boundaries = findChunkBoundaries(pData, size, chunkCount);
+	std::vector<chunk_t> chunks(boundaries.size() - 1);
+
+	if (chunks.size() > 1) {
+		pScheduler->ParallelFor(static_cast<unsigned int>(chunks.size()), 1,
+			[&](unsigned int begin, unsigned int end, unsigned int) {
+				for (unsigned int i = begin; i < end; ++i)
+					parseChunk(boundaries[i], boundaries[i+1], chunks[i]);
+			}, pScheduler->GetWorkerIndex());
+	}
+	else {
+		parseChunk(boundaries[0], boundaries[1], chunks[0]);
+	}
+
+	// Concatenate the attributes of the chunks, remembering where each chunk
+	// starts so that its relative indices can be resolved.
+
+	std::vector<Vector3f> filePositions;
+	std::vector<Vector3f> fileNormals;
+	std::vector<Vector2f> fileCoords;
+	std::vector<std::array<size_t, 3>> bases(chunks.size());
+
+	size_t cornerCount = 0;
+
+	for (size_t i = 0; i < chunks.size(); ++i) {
+		bases[i][0] = filePositions.size();
+		bases[i][1] = fileCoords.size();
+		bases[i][2] = fileNormals.size();
+
+		filePositions.insert(filePositions.end(), chunks[i].positions.begin(), chunks[i].positions.end());
+		fileCoords.insert(fileCoords.end(), chunks[i].coords.begin(), chunks[i].coords.end());
+		fileNormals.insert(fileNormals.end(), chunks[i].normals.begin(), chunks[i].normals.end());
+		cornerCount += chunks[i].corners.size();
+
+		std::vector<Vector3f>().swap(chunks[i].positions);
+		std::vector<Vector2f>().swap(chunks[i].coords);
+		std::vector<Vector3f>().swap(chunks[i].normals);
+	}
+
+	const size_t counts[3] = { filePositions.size(), fileCoords.size(), fileNormals.size() };
+
+	// Replay the faces and declarations of the chunks in file order, welding
+	// the corners into unique vertices as they are added.
+
+	std::vector<unsigned int> firstVertex(counts[0] + 1, NO_VERTEX);
+	std::vector<unsigned int> nextVertex;
+	std::vector<vertexKey_t> vertexKeys;
+
+	indices.reserve(cornerCount);
+
+	for (size_t i = 0; i < chunks.size(); ++i)
+	{
+		const chunk_t& chunk = chunks[i];
+		size_t nextEvent = 0;
+
+		for (size_t f = 0; f <= chunk.faces.size(); ++f)
+		{
+			for (; nextEvent < chunk.events.size() && chunk.events[nextEvent].face == f; ++nextEvent)
+			{
+				const event_t& e = chunk.events[nextEvent];
+
+				if (e.type == EVENT_OBJECT) {
+					// Check if the default object is currently in use. If so,
+					// put this name on that object, otherwise we create a new one.
+					if (objects.size() == 1 && (objects.back().subobjects.size() == 0 || objects.back().subobjects.back().faces.size() == 0)) {
+						objects.back().name = e.name;
+					}
+					else {
+						objects.push_back(object_t());
+						objects.back().name = e.name;
+					}
+				}
+				else if (e.type == EVENT_MATERIAL_LIB) {
+					material_libs.push_back(e.name);
+				}
+				else if (e.type == EVENT_MATERIAL) {
+					if (objects.size() == 0) { objects.push_back(object_t()); }
+					objects.back().subobjects.push_back(subobject_t());
+					objects.back().subobjects.back().material_name = e.name;
 				}
-				else {
-					objects.push_back(object_t());
-					objects.back().name = tokenList[1];
+			}
+
+			if (f == chunk.faces.size())
+				break;
+
+			face_t face;
+			face.start = static_cast<unsigned int>(indices.size());
+			face.count = chunk.faces[f].count;
+
+			for (unsigned int c = 0; c < face.count; ++c)
+			{
+				const corner_t& corner = chunk.corners[chunk.faces[f].start + c];
+
+				vertexKey_t key;
+				for (int k = 0; k < 3; ++k)
+					key.index[k] = resolveComponent(corner, k, bases[i][k], counts[k]);
+
+				// Invalid positions share the extra bucket at the end of the table.
+				unsigned int& bucket = firstVertex[key.index[0] >= 0 ? key.index[0] : counts[0]];
+				unsigned int vertex = bucket;
+
+				while (vertex != NO_VERTEX && (vertexKeys[vertex].index[0] != key.index[0] ||
+					vertexKeys[vertex].index[1] != key.index[1] || vertexKeys[vertex].index[2] != key.index[2]))
+					vertex = nextVertex[vertex];
+
+				if (vertex == NO_VERTEX) {
+					vertex = static_cast<unsigned int>(positions.size());
+					vertexKeys.push_back(key);
+					nextVertex.push_back(bucket);
+					bucket = vertex;
+
+					positions.push_back(key.index[0] >= 0 ? filePositions[key.index[0]] : Vector3f(0.0f, 0.0f, 0.0f));
+					coords.push_back(key.index[1] >= 0 ? fileCoords[key.index[1]] : Vector2f(0.0f, 0.0f));
+					normals.push_back(key.index[2] >= 0 ? fileNormals[key.index[2]] : Vector3f(0.0f, 0.0f, 0.0f));
 				}
+
+				indices.push_back(vertex);
 			}
-			else if (tokenList[0] == "mtllib") {
-				material_libs.push_back(line.substr(7));
+
+			// If no object has been declared yet, then add one along with
+			// a subobject.  Otherwise, ensure that the current object has
+			// at least one subobject already with which to add the face to.
+			if ( objects.size() == 0 ) {
+				objects.push_back(object_t());
 			}
-			else if (tokenList[0] == "usemtl") {
-				if (objects.size() == 0) { objects.push_back(object_t()); }
+
+			if ( objects.back().subobjects.size() == 0 ) {
 				objects.back().subobjects.push_back(subobject_t());
-				objects.back().subobjects.back().material_name = line.substr(7);
 			}
+
+			objects.back().subobjects.back().faces.push_back(face);
 		}
 	}
 
-	// The file will close on its own when it goes out of scope.
+	// The file will be unmapped on its own when it goes out of scope.
 }
-//--------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,340 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "MeshSTL.h"
+#include "MemoryMappedFile.h"
+#include "TextScanner.h"
+#include "JobScheduler.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+using namespace Glyph3::STL;
+//--------------------------------------------------------------------------------
+namespace
+{
+	// The size of the header and face count at the start of a binary file.
+
+	const size_t HEADER_SIZE = 84;
+
+	// Binary files are decoded in blocks of this many faces, and ascii files are
+	// split into chunks of roughly this many bytes when running in parallel.
+
+	const unsigned int FACE_BLOCK_SIZE = 64 * 1024;
+	const size_t CHUNK_SIZE = 4 * 1024 * 1024;
+
+	void decodeBinaryFaces( const char* pRecords, unsigned int begin, unsigned int end, MeshSTL::Face* pFaces )
+	{
+		// The records are 50 bytes long, so they are not aligned for direct
+		// access.  The first 48 bytes have the same layout as our face though,
+		// and are copied over in one piece.
+
+		static_assert( sizeof( MeshSTL::Face ) == 48, "The face must match the layout of the file records." );
+
+		for ( unsigned int i = begin; i < end; ++i ) {
+			memcpy( &pFaces[i], pRecords + static_cast<size_t>( i ) * MeshSTL::FILE_FACE_SIZE, sizeof( MeshSTL::Face ) );
+		}
+	}
+
+	bool isAscii( const char* pData, size_t size )
+	{
+		TextScanner scanner( pData, pData + size );
+		scanner.SkipWhitespace();
+
+		return( scanner.MatchKeyword( "solid" ) );
+	}
+
+	// Returns the start of the line following the next 'endfacet' keyword, so
+	// that ascii files can be split between two facets.
+
+	const char* findFacetEnd( const char* p, const char* pEnd )
+	{
+		static const char keyword[] = "endfacet";
+		const size_t length = sizeof( keyword ) - 1;
+
+		for ( ; p + length <= pEnd; ++p ) {
+			if ( *p == 'e' && memcmp( p, keyword, length ) == 0 ) {
+				break;
+			}
+		}
+
+		while ( p < pEnd && *p != '\n' ) { ++p; }
+		if ( p < pEnd ) { ++p; }
+
+		return( p < pEnd ? p : pEnd );
+	}
+
+	void parseAscii( const char* pBegin, const char* pEnd, std::vector<MeshSTL::Face>& faces )
+	{
+		TextScanner scanner( pBegin, pEnd );
+
+		MeshSTL::Face face;
+		Vector3f polygon[3];
+		unsigned int vertexCount = 0;
+
+		face.normal.MakeZero();
+
+		while ( !scanner.AtEnd() )
+		{
+			scanner.SkipWhitespace();
+
+			if ( scanner.MatchKeyword( "vertex" ) ) {
+				Vector3f& v = polygon[min( vertexCount, 2u )];
+				v.MakeZero();
+				scanner.ReadFloat( v.x ); scanner.ReadFloat( v.y ); scanner.ReadFloat( v.z );
+
+				// Facets with more than three vertices are split into a fan of
+				// triangles around the first vertex.
+
+				if ( ++vertexCount >= 3 ) {
+					face.v0 = polygon[0];
+					face.v1 = polygon[1];
+					face.v2 = polygon[2];
+					faces.push_back( face );
+					polygon[1] = polygon[2];
+				}
+			}
+			else if ( scanner.MatchKeyword( "facet" ) ) {
+				face.normal.MakeZero();
+				scanner.SkipSpaces();
+				if ( scanner.MatchKeyword( "normal" ) ) {
+					scanner.ReadFloat( face.normal.x ); scanner.ReadFloat( face.normal.y ); scanner.ReadFloat( face.normal.z );
+				}
+				vertexCount = 0;
+			}
+			else if ( scanner.MatchKeyword( "solid" ) || scanner.MatchKeyword( "endsolid" ) ) {
+				// The rest of the line is the name of the solid.
+				scanner.NextLine();
+			}
+			else {
+				// The 'outer loop', 'endloop' and 'endfacet' keywords don't carry
+				// any data, and are skipped along with anything unexpected.
+				scanner.SkipToken();
+			}
+		}
+	}
+
+	// Vertices are welded by the bit patterns of their positions (and normals,
+	// for faceted meshes) in an open addressing hash table.
+
+	float canonicalFloat( float value )
+	{
+		// Negative zero compares equal to zero, but has a different bit pattern.
+		return( value == 0.0f ? 0.0f : value );
+	}
+
+	unsigned long long hashVector( const Vector3f& v, unsigned long long hash )
+	{
+		unsigned int bits[3];
+		memcpy( bits, &v.x, sizeof( bits ) );
+
+		for ( int i = 0; i < 3; ++i ) {
+			hash = ( hash ^ bits[i] ) * 0x100000001b3ull;
+		}
+
+		return( hash );
+	}
+
+	size_t tableSlot( unsigned long long hash, size_t mask )
+	{
+		// The float bits of round numbers have many trailing zeros, so the upper
+		// bits of the hash are mixed into the lower ones that select the slot.
+
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdull;
+		hash ^= hash >> 33;
+
+		return( static_cast<size_t>( hash ) & mask );
+	}
+
+	const unsigned int NO_VERTEX = 0xffffffff;
+};
+//--------------------------------------------------------------------------------
+MeshSTL::MeshSTL( const std::wstring& filename, JobScheduler* pScheduler ) : faces()
+{
+	// Map the file into memory.  If the file doesn't open, simply return
+	// without loading.
+
+	MemoryMappedFile stlFile;
+	if ( !stlFile.Open( filename ) ) { return; }
+
+	const char* pData = stlFile.GetDataPtr();
+	const size_t fileSize = stlFile.GetDataSize();
+
+	const bool parallel = pScheduler != nullptr && pScheduler->GetThreadCount() > 1;
+
+	// Binary files may start with 'solid' too, so a file is only treated as
+	// ascii if its size doesn't match the face count of its binary header.
+
+	unsigned int faceCount = 0;
+
+	if ( fileSize >= HEADER_SIZE ) {
+		memcpy( &faceCount, pData + 80, sizeof( faceCount ) );
+	}
+
+	const unsigned long long binarySize = HEADER_SIZE + static_cast<unsigned long long>( faceCount ) * FILE_FACE_SIZE;
+
+	if ( fileSize != binarySize && isAscii( pData, fileSize ) )
+	{
+		// Split the file between facets, parse the chunks separately and then
+		// append their faces in file order.
+
+		std::vector<const char*> boundaries( 1, pData );
+		const char* pEnd = pData + fileSize;
+
+		if ( parallel ) {
+			const size_t chunks = fileSize / CHUNK_SIZE;
+
+			for ( size_t i = 1; i < chunks; ++i ) {
+				const char* p = findFacetEnd( max( pData + fileSize / chunks * i, boundaries.back() ), pEnd );
+				if ( p > boundaries.back() && p < pEnd ) { boundaries.push_back( p ); }
+			}
+		}
+
+		boundaries.push_back( pEnd );
+
+		if ( boundaries.size() > 2 ) {
+			std::vector<std::vector<Face>> chunkFaces( boundaries.size() - 1 );
+
+			pScheduler->ParallelFor( static_cast<unsigned int>( chunkFaces.size() ), 1,
+				[&]( unsigned int begin, unsigned int end, unsigned int ) {
+					for ( unsigned int i = begin; i < end; ++i ) {
+						parseAscii( boundaries[i], boundaries[i+1], chunkFaces[i] );
+					}
+				}, pScheduler->GetWorkerIndex() );
+
+			size_t total = 0;
+			for ( auto& chunk : chunkFaces ) { total += chunk.size(); }
+
+			faces.reserve( total );
+			for ( auto& chunk : chunkFaces ) { faces.insert( faces.end(), chunk.begin(), chunk.end() ); }
+		} else {
+			parseAscii( pData, pEnd, faces );
+		}
+	}
+
+	// Files that didn't produce any ascii faces are read as binary, as long as
+	// they are large enough to hold all of the faces in the header.
+
+	if ( faces.empty() && fileSize >= HEADER_SIZE && fileSize >= binarySize )
+	{
+		// Size the vector up front and copy the face records into it, in
+		// blocks on the worker threads if there is a scheduler available.
+
+		faces.resize( faceCount );
+
+		const char* pRecords = pData + HEADER_SIZE;
+		Face* pFaces = faces.data();
+
+		if ( parallel && faceCount > FACE_BLOCK_SIZE ) {
+			pScheduler->ParallelFor( faceCount, FACE_BLOCK_SIZE,
+				[=]( unsigned int begin, unsigned int end, unsigned int ) {
+					decodeBinaryFaces( pRecords, begin, end, pFaces );
+				}, pScheduler->GetWorkerIndex() );
+		} else {
+			decodeBinaryFaces( pRecords, 0, faceCount, pFaces );
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+void MeshSTL::Weld( bool smoothNormals )
+{
+	positions.clear();
+	normals.clear();
+	indices.clear();
+	indices.reserve( faces.size() * 3 );
+
+	// Start with enough slots for about half as many unique vertices as there
+	// are faces, which is typical for closed meshes, and grow when the table
+	// becomes half full.
+
+	size_t tableSize = 1024;
+	while ( tableSize < faces.size() ) { tableSize *= 2; }
+
+	std::vector<unsigned int> table( tableSize, NO_VERTEX );
+
+	for ( auto& face : faces )
+	{
+		// The face normal is computed from the vertices, and the normal in the
+		// file is only used as a fallback for degenerate faces.  Its magnitude
+		// is twice the area of the face, which weights the smooth normals.
+
+		Vector3f normal = Vector3f::Cross( face.v1 - face.v0, face.v2 - face.v0 );
+
+		if ( Vector3f::LengthSq( normal ) == 0.0f ) {
+			normal = face.normal;
+		}
+
+		if ( !smoothNormals ) {
+			normal.Normalize();
+			normal = Vector3f( canonicalFloat( normal.x ), canonicalFloat( normal.y ), canonicalFloat( normal.z ) );
+		}
+
+		const Vector3f* corners[3] = { &face.v0, &face.v1, &face.v2 };
+
+		for ( int c = 0; c < 3; ++c )
+		{
+			Vector3f position( canonicalFloat( corners[c]->x ), canonicalFloat( corners[c]->y ), canonicalFloat( corners[c]->z ) );
+
+			unsigned long long hash = hashVector( position, 0xcbf29ce484222325ull );
+			if ( !smoothNormals ) { hash = hashVector( normal, hash ); }
+
+			size_t mask = table.size() - 1;
+			size_t slot = tableSlot( hash, mask );
+			unsigned int vertex;
+
+			while ( ( vertex = table[slot] ) != NO_VERTEX ) {
+				if ( memcmp( &positions[vertex], &position, sizeof( Vector3f ) ) == 0 &&
+					( smoothNormals || memcmp( &normals[vertex], &normal, sizeof( Vector3f ) ) == 0 ) ) {
+					break;
+				}
+				slot = ( slot + 1 ) & mask;
+			}
+
+			if ( vertex == NO_VERTEX )
+			{
+				vertex = static_cast<unsigned int>( positions.size() );
+				table[slot] = vertex;
+				positions.push_back( position );
+				normals.push_back( smoothNormals ? Vector3f( 0.0f, 0.0f, 0.0f ) : normal );
+
+				// Rehash all of the vertices into a table of twice the size.
+
+				if ( positions.size() * 2 > table.size() )
+				{
+					table.assign( table.size() * 2, NO_VERTEX );
+					mask = table.size() - 1;
+
+					for ( unsigned int v = 0; v < positions.size(); ++v ) {
+						unsigned long long h = hashVector( positions[v], 0xcbf29ce484222325ull );
+						if ( !smoothNormals ) { h = hashVector( normals[v], h ); }
+
+						size_t s = tableSlot( h, mask );
+						while ( table[s] != NO_VERTEX ) { s = ( s + 1 ) & mask; }
+						table[s] = v;
+					}
+				}
+			}
+
+			if ( smoothNormals ) {
+				normals[vertex] += normal;
+			}
+
+			indices.push_back( vertex );
+		}
+	}
+
+	if ( smoothNormals ) {
+		for ( auto& normal : normals ) {
+			normal.Normalize();
+		}
+	}
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
@@ -13,12 +13,32 @@
 #include "Node3D.h"
 #include "Entity3D.h"
 #include "SceneGraph.h"
+#include "TransformHierarchy.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
+namespace
+{
+	// Changing the children of a node that is bound to a hierarchy changes the
+	// flattened ordering, even if the child itself isn't bound (yet).  The child
+	// only marks its own hierarchy when it is invalidated.
+
+	void MarkHierarchyStale( Node3D* pNode )
+	{
+		TransformHierarchy* pHierarchy = pNode->Transform.GetHierarchy();
+
+		if ( pHierarchy != nullptr )
+			pHierarchy->MarkStale();
+	}
+};
+//--------------------------------------------------------------------------------
 Node3D::Node3D() :
 	m_pParent( nullptr ),
-	Controllers( this )
+	Controllers( this ),
+	m_WorldBounds(),
+	m_bBounded( true ),
+	m_bEmpty( true ),
+	m_bSubtreeChanged( true )
 {
 }
 //--------------------------------------------------------------------------------
@@ -54,13 +74,32 @@ void Node3D::Update( float time )
 	UpdateLocal( time );
 	UpdateWorld( );
 
+	// Track if anything in this subtree has moved, which allows queries for the 
+	// changed entities to skip over the static parts of the graph.
+
+	m_bSubtreeChanged = Transform.WorldChanged();
+
 	for ( auto pChild : m_Leafs ) {
-		if ( pChild ) pChild->Update( time );
+		if ( pChild ) {
+			pChild->Update( time );
+			m_bSubtreeChanged |= pChild->Transform.WorldChanged();
+		}
 	}
 
 	for ( auto node : m_Nodes ) {
-		if ( node ) node->Update( time );
+		if ( node ) {
+			node->Update( time );
+			m_bSubtreeChanged |= node->SubtreeChanged();
+		}
 	}
+
+	if ( !Transform.IsBound() )
+		UpdateWorldBounds( );
+}
+//--------------------------------------------------------------------------------
+bool Node3D::SubtreeChanged() const
+{
+	return( m_bSubtreeChanged );
 }
 //--------------------------------------------------------------------------------
 void Node3D::UpdateLocal( float fTime )
@@ -79,13 +118,75 @@ void Node3D::UpdateWorld( )
 	// If the entity has a parent, then update its world matrix accordingly.
 
 	if ( m_pParent )
-		Transform.UpdateWorld( m_pParent->Transform.WorldMatrix() );
+		Transform.UpdateWorld( m_pParent->Transform );
 	else
 		Transform.UpdateWorld( );
 }
 //--------------------------------------------------------------------------------
+void Node3D::UpdateWorldBounds( )
+{
+	// Start with an empty volume, and then grow it to include each of the 
+	// children.  Empty child nodes don't contribute anything to the bounds.
+
+	m_bBounded = true;
+	m_bEmpty = true;
+
+	for ( auto pChild : m_Leafs )
+	{
+		if ( !pChild ) continue;
+
+		if ( !pChild->IsBounded() ) {
+			m_bBounded = false;
+			m_bEmpty = false;
+			return;
+		}
+
+		if ( m_bEmpty ) {
+			m_WorldBounds = pChild->GetWorldBounds();
+			m_bEmpty = false;
+		} else {
+			m_WorldBounds.Merge( pChild->GetWorldBounds() );
+		}
+	}
+
+	for ( auto node : m_Nodes )
+	{
+		if ( !node || node->IsEmpty() ) continue;
+
+		if ( !node->IsBounded() ) {
+			m_bBounded = false;
+			m_bEmpty = false;
+			return;
+		}
+
+		if ( m_bEmpty ) {
+			m_WorldBounds = node->GetWorldBounds();
+			m_bEmpty = false;
+		} else {
+			m_WorldBounds.Merge( node->GetWorldBounds() );
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+const Sphere3f& Node3D::GetWorldBounds() const
+{
+	return( m_WorldBounds );
+}
+//--------------------------------------------------------------------------------
+bool Node3D::IsBounded() const
+{
+	return( m_bBounded );
+}
+//--------------------------------------------------------------------------------
+bool Node3D::IsEmpty() const
+{
+	return( m_bEmpty );
+}
+//--------------------------------------------------------------------------------
 void Node3D::AttachChild( Entity3D* Child )
 {
+	MarkHierarchyStale( this );
+
 	// Check for open spots in the vector
 	for ( auto& pChild : m_Leafs )
 	{
@@ -104,6 +205,8 @@ void Node3D::AttachChild( Entity3D* Child )
 //--------------------------------------------------------------------------------
 void Node3D::AttachChild( Node3D* Child )
 {
+	MarkHierarchyStale( this );
+
 	// Check for open spots in the vector
 	for ( auto& pChild : m_Nodes )
 	{
@@ -128,6 +231,7 @@ void Node3D::DetachChild( Entity3D* Child )
 		{
 			pChild->DetachParent();
 			pChild = nullptr;
+			MarkHierarchyStale( this );
 		}
 	}
 }
@@ -140,6 +244,7 @@ void Node3D::DetachChild( Node3D* Child )
 		{
 			pChild->DetachParent();
 			pChild = nullptr;
+			MarkHierarchyStale( this );
 		}
 	}
 }
@@ -147,11 +252,13 @@ void Node3D::DetachChild( Node3D* Child )
 void Node3D::AttachParent( Node3D* Parent )
 {
 	m_pParent = Parent;
+	Transform.Invalidate();
 }
 //--------------------------------------------------------------------------------
 void Node3D::DetachParent( )
 {
 	m_pParent = nullptr;
+	Transform.Invalidate();
 }
 //--------------------------------------------------------------------------------
 Node3D* Node3D::GetParent()
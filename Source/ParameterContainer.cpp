@@ -37,9 +37,11 @@ void ParameterContainer::AddRenderParameter( ParameterWriter* pWriter )
 		// Search the list to see if this parameter is already there
 		ParameterWriter* pCurr = 0;
 
+		unsigned int ID = pWriter->GetRenderParameterRef()->GetParameterID();
+
 		for ( unsigned int i = 0; i < m_RenderParameters.size(); i++ )
 		{
-			if ( pWriter->GetRenderParameterRef()->GetName() == m_RenderParameters[i]->GetRenderParameterRef()->GetName() )
+			if ( ID == m_RenderParameters[i]->GetRenderParameterRef()->GetParameterID() )
 			{
 				pCurr = m_RenderParameters[i];
 				break;
@@ -58,6 +60,19 @@ void ParameterContainer::AddRenderParameter( ParameterWriter* pWriter )
 }
 //--------------------------------------------------------------------------------
 ParameterWriter* ParameterContainer::GetRenderParameter( const std::wstring& name )
+{
+	// Resolve the name to its parameter ID once, and then search by ID.  If the
+	// parameter was never registered, then no writer can be referencing it.
+
+	RenderParameterDX11* pParameter = RendererDX11::Get()->m_pParamMgr->GetParameterRef( name );
+
+	if ( pParameter == nullptr )
+		return( nullptr );
+
+	return( GetRenderParameter( pParameter->GetParameterID() ) );
+}
+//--------------------------------------------------------------------------------
+ParameterWriter* ParameterContainer::GetRenderParameter( unsigned int ID )
 {
 	ParameterWriter* pResult = nullptr;
 
@@ -65,7 +80,7 @@ ParameterWriter* ParameterContainer::GetRenderParameter( const std::wstring& nam
 	{
 		RenderParameterDX11* pParameter = pParameterWriter->GetRenderParameterRef();
 		if ( pParameter != nullptr ) {
-			if ( name.compare( pParameter->GetName() ) == 0 ) {
+			if ( pParameter->GetParameterID() == ID ) {
 				pResult = pParameterWriter;
 				break;
 			}
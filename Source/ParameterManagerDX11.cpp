@@ -22,7 +22,8 @@
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
-std::map< std::wstring, RenderParameterDX11* >	ParameterManagerDX11::m_Parameters;
+std::unordered_map< std::wstring, unsigned int >	ParameterManagerDX11::m_ParameterIDs;
+std::vector< RenderParameterDX11* >	ParameterManagerDX11::m_Parameters;
 //--------------------------------------------------------------------------------
 ParameterManagerDX11::ParameterManagerDX11( unsigned int ID )
 {
@@ -36,18 +37,22 @@ ParameterManagerDX11::ParameterManagerDX11( unsigned int ID )
 	m_pViewProjMatrix = GetMatrixParameterRef( std::wstring( L"ViewProjMatrix" ) );
 	m_pWorldProjMatrix = GetMatrixParameterRef( std::wstring( L"WorldProjMatrix" ) );
 	m_pWorldViewProjMatrix = GetMatrixParameterRef( std::wstring( L"WorldViewProjMatrix" ) );
+
+	InitializeDerivedMatrix( 0, m_pWorldViewMatrix, m_pWorldMatrix, m_pViewMatrix );
+	InitializeDerivedMatrix( 1, m_pViewProjMatrix, m_pViewMatrix, m_pProjMatrix );
+	InitializeDerivedMatrix( 2, m_pWorldProjMatrix, m_pWorldMatrix, m_pProjMatrix );
+	InitializeDerivedMatrix( 3, m_pWorldViewProjMatrix, m_pWorldMatrix, m_pViewProjMatrix );
 }
 //--------------------------------------------------------------------------------
 ParameterManagerDX11::~ParameterManagerDX11()
 {
 	// Iterate the list of parameters and release them
-	std::map< std::wstring, RenderParameterDX11* >::iterator iter = m_Parameters.begin();
-	while ( iter != m_Parameters.end() ) {
-		SAFE_DELETE( iter->second );
-		iter++;
+	for ( auto pParameter : m_Parameters ) {
+		SAFE_DELETE( pParameter );
 	}
 
 	m_Parameters.clear();
+	m_ParameterIDs.clear();
 }
 //--------------------------------------------------------------------------------
 unsigned int ParameterManagerDX11::GetID()
@@ -159,14 +164,14 @@ unsigned int ParameterManagerDX11::GetID()
 //--------------------------------------------------------------------------------
 void ParameterManagerDX11::SetVectorParameter( const std::wstring& name, Vector4f* pVector )
 {
-	RenderParameterDX11* pParameter = m_Parameters[name];
+	RenderParameterDX11* pParameter = FindParameter( name );
 
 	// Only create the new parameter if it hasn't already been registered
 	if ( pParameter == 0 )
 	{
 		pParameter = new VectorParameterDX11();
 		pParameter->SetName( name );
-		m_Parameters[name] = reinterpret_cast<RenderParameterDX11*>( pParameter );
+		RegisterParameter( pParameter );
 
 		// Initialize the parameter with the current data in all slots
 		pParameter->InitializeParameterData( reinterpret_cast<void*>( pVector ) );
@@ -182,14 +187,14 @@ void ParameterManagerDX11::SetVectorParameter( const std::wstring& name, Vector4
 //--------------------------------------------------------------------------------
 void ParameterManagerDX11::SetMatrixParameter( const std::wstring& name, Matrix4f* pMatrix )
 {
-	RenderParameterDX11* pParameter = m_Parameters[name];
+	RenderParameterDX11* pParameter = FindParameter( name );
 
 	// Only create the new parameter if it hasn't already been registered
 	if ( pParameter == 0 )
 	{
 		pParameter = new MatrixParameterDX11();
 		pParameter->SetName( name );
-		m_Parameters[name] = reinterpret_cast<RenderParameterDX11*>( pParameter );
+		RegisterParameter( pParameter );
 		
 		// Initialize the parameter with the current data in all slots
 		pParameter->InitializeParameterData( reinterpret_cast<void*>( pMatrix ) );
@@ -205,14 +210,14 @@ void ParameterManagerDX11::SetMatrixParameter( const std::wstring& name, Matrix4
 //--------------------------------------------------------------------------------
 void ParameterManagerDX11::SetMatrixArrayParameter( const std::wstring& name, int count, Matrix4f* pMatrix )
 {
-	RenderParameterDX11* pParameter = m_Parameters[name];
+	RenderParameterDX11* pParameter = FindParameter( name );
 
 	// Only create the new parameter if it hasn't already been registered
 	if ( pParameter == 0 )
 	{
 		pParameter = new MatrixArrayParameterDX11( count );
 		pParameter->SetName( name );
-		m_Parameters[name] = reinterpret_cast<RenderParameterDX11*>( pParameter );
+		RegisterParameter( pParameter );
 
 		// Initialize the parameter with the current data in all slots
 		pParameter->InitializeParameterData( reinterpret_cast<void*>( pMatrix ) );
@@ -228,14 +233,14 @@ void ParameterManagerDX11::SetMatrixArrayParameter( const std::wstring& name, in
 //--------------------------------------------------------------------------------
 void ParameterManagerDX11::SetShaderResourceParameter( const std::wstring& name, ResourcePtr resource )
 {
-	RenderParameterDX11* pParameter = m_Parameters[name];
+	RenderParameterDX11* pParameter = FindParameter( name );
 
 	// Only create the new parameter if it hasn't already been registered
 	if ( pParameter == 0 )
 	{
 		pParameter = new ShaderResourceParameterDX11();
 		pParameter->SetName( name );
-		m_Parameters[name] = reinterpret_cast<RenderParameterDX11*>( pParameter );
+		RegisterParameter( pParameter );
 
 		// Initialize the parameter with the current data in all slots
 		pParameter->InitializeParameterData( reinterpret_cast<void*>( &resource->m_iResourceSRV ) );
@@ -251,14 +256,14 @@ void ParameterManagerDX11::SetShaderResourceParameter( const std::wstring& name,
 //--------------------------------------------------------------------------------
 void ParameterManagerDX11::SetUnorderedAccessParameter( const std::wstring& name, ResourcePtr resource, unsigned int initial )
 {
-	RenderParameterDX11* pParameter = m_Parameters[name];
+	RenderParameterDX11* pParameter = FindParameter( name );
 
 	// Only create the new parameter if it hasn't already been registered
 	if ( pParameter == 0 )
 	{
 		pParameter = new UnorderedAccessParameterDX11();
 		pParameter->SetName( name );
-		m_Parameters[name] = reinterpret_cast<RenderParameterDX11*>( pParameter );
+		RegisterParameter( pParameter );
 
 		// Initialize the parameter with the current data in all slots
 		UAVParameterData data; 
@@ -283,14 +288,14 @@ void ParameterManagerDX11::SetUnorderedAccessParameter( const std::wstring& name
 //--------------------------------------------------------------------------------
 void ParameterManagerDX11::SetConstantBufferParameter( const std::wstring& name, ResourcePtr resource )
 {
-	RenderParameterDX11* pParameter = m_Parameters[name];
+	RenderParameterDX11* pParameter = FindParameter( name );
 
 	// Only create the new parameter if it hasn't already been registered
 	if ( pParameter == 0 )
 	{
 		pParameter = new ConstantBufferParameterDX11();
 		pParameter->SetName( name );
-		m_Parameters[name] = reinterpret_cast<RenderParameterDX11*>( pParameter );
+		RegisterParameter( pParameter );
 
 		// Initialize the parameter with the current data in all slots
 		pParameter->InitializeParameterData( reinterpret_cast<void*>( &resource->m_iResource ) );
@@ -306,14 +311,14 @@ void ParameterManagerDX11::SetConstantBufferParameter( const std::wstring& name,
 //--------------------------------------------------------------------------------
 void ParameterManagerDX11::SetSamplerParameter( const std::wstring& name, int* pID )
 {
-	RenderParameterDX11* pParameter = m_Parameters[name];
+	RenderParameterDX11* pParameter = FindParameter( name );
 
 	// Only create the new parameter if it hasn't already been registered
 	if ( pParameter == 0 )
 	{
 		pParameter = new SamplerParameterDX11();
 		pParameter->SetName( name );
-		m_Parameters[name] = reinterpret_cast<RenderParameterDX11*>( pParameter );
+		RegisterParameter( pParameter );
 
 		// Initialize the parameter with the current data in all slots
 		pParameter->InitializeParameterData( reinterpret_cast<void*>( pID ) );
@@ -410,7 +415,7 @@ Vector4f ParameterManagerDX11::GetVectorParameter( const std::wstring& name )
 	{
 		pParam = new VectorParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		RegisterParameter( pParam );
 	}
 
 	return( result );
@@ -431,14 +436,16 @@ Matrix4f ParameterManagerDX11::GetMatrixParameter( const std::wstring& name )
 
 	if ( pParam != 0 )
 	{
-		if ( pParam->GetParameterType() == MATRIX ) 
+		if ( pParam->GetParameterType() == MATRIX ) {
+			UpdateDerivedParameter( pParam );
 			result = reinterpret_cast<MatrixParameterDX11*>( pParam )->GetMatrix( GetID() );
+		}
 	}
 	else
 	{
 		pParam = new MatrixParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		RegisterParameter( pParam );
 	}
 
 	return( result );
@@ -466,7 +473,7 @@ Matrix4f* ParameterManagerDX11::GetMatrixArrayParameter( const std::wstring& nam
 	{
 		pParam = new MatrixArrayParameterDX11( count );
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		RegisterParameter( pParam );
 		pResult = reinterpret_cast<MatrixArrayParameterDX11*>( pParam )->GetMatrices( GetID() );
 	}
 
@@ -495,7 +502,7 @@ int ParameterManagerDX11::GetShaderResourceParameter( const std::wstring& name )
 	{
 		pParam = new ShaderResourceParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		RegisterParameter( pParam );
 	}
 
 	return( result );
@@ -523,7 +530,7 @@ int ParameterManagerDX11::GetUnorderedAccessParameter( const std::wstring& name
 	{
 		pParam = new UnorderedAccessParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		RegisterParameter( pParam );
 	}
 
 	return( result );
@@ -551,7 +558,7 @@ int ParameterManagerDX11::GetConstantBufferParameter( const std::wstring& name )
 	{
 		pParam = new ConstantBufferParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		RegisterParameter( pParam );
 	}
 
 	return( result );
@@ -579,7 +586,7 @@ int ParameterManagerDX11::GetSamplerStateParameter( const std::wstring& name )
 	{
 		pParam = new SamplerParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		RegisterParameter( pParam );
 	}
 
 	return( result );	
@@ -611,8 +618,10 @@ Matrix4f ParameterManagerDX11::GetMatrixParameter( RenderParameterDX11* pParam )
 	// If the parameter is not found, create a new default one.  This goes 
 	// into the bottom level manager.
 
-	if ( pParam->GetParameterType() == MATRIX ) 
+	if ( pParam->GetParameterType() == MATRIX ) {
+		UpdateDerivedParameter( pParam );
 		result = reinterpret_cast<MatrixParameterDX11*>( pParam )->GetMatrix( GetID() );
+	}
 
 	return( result );
 }
@@ -709,7 +718,7 @@ VectorParameterDX11* ParameterManagerDX11::GetVectorParameterRef( const std::wst
 	{
 		pParam = new VectorParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		RegisterParameter( pParam );
 	}
 
 	return( reinterpret_cast<VectorParameterDX11*>( pParam ) );
@@ -729,7 +738,7 @@ MatrixParameterDX11* ParameterManagerDX11::GetMatrixParameterRef( const std::wst
 	{
 		pParam = new MatrixParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		RegisterParameter( pParam );
 	}
 
 	return( reinterpret_cast<MatrixParameterDX11*>( pParam ) );
@@ -746,7 +755,7 @@ MatrixArrayParameterDX11* ParameterManagerDX11::GetMatrixArrayParameterRef( cons
 	{
 		pParam = new MatrixArrayParameterDX11( count );
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		RegisterParameter( pParam );
 	}
 
 	return( reinterpret_cast<MatrixArrayParameterDX11*>( pParam ) );
@@ -766,7 +775,7 @@ ShaderResourceParameterDX11* ParameterManagerDX11::GetShaderResourceParameterRef
 	{
 		pParam = new ShaderResourceParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		RegisterParameter( pParam );
 	}
 
 	return( reinterpret_cast<ShaderResourceParameterDX11*>( pParam ) );
@@ -786,7 +795,7 @@ UnorderedAccessParameterDX11* ParameterManagerDX11::GetUnorderedAccessParameterR
 	{
 		pParam = new UnorderedAccessParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		RegisterParameter( pParam );
 	}
 
 	return( reinterpret_cast<UnorderedAccessParameterDX11*>( pParam ) );
@@ -806,7 +815,7 @@ ConstantBufferParameterDX11* ParameterManagerDX11::GetConstantBufferParameterRef
 	{
 		pParam = new ConstantBufferParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		RegisterParameter( pParam );
 	}
 
 	return( reinterpret_cast<ConstantBufferParameterDX11*>( pParam ) );
@@ -826,7 +835,7 @@ SamplerParameterDX11* ParameterManagerDX11::GetSamplerStateParameterRef( const s
 	{
 		pParam = new SamplerParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		RegisterParameter( pParam );
 	}
 
 	return( reinterpret_cast<SamplerParameterDX11*>( pParam ) );	
@@ -835,58 +844,60 @@ SamplerParameterDX11* ParameterManagerDX11::GetSamplerStateParameterRef( const s
 void ParameterManagerDX11::SetWorldMatrixParameter( Matrix4f* pMatrix )
 {
 	SetMatrixParameter( m_pWorldMatrix, pMatrix );
-
-	Matrix4f WorldMatrix = GetMatrixParameter( m_pWorldMatrix );
-	Matrix4f ViewMatrix = GetMatrixParameter( m_pViewMatrix );
-	Matrix4f ProjMatrix = GetMatrixParameter( m_pProjMatrix );
-
-	Matrix4f WorldViewMatrix = WorldMatrix * ViewMatrix;
-	Matrix4f ViewProjMatrix = ViewMatrix * ProjMatrix;
-	Matrix4f WorldProjMatrix = WorldMatrix * ProjMatrix;
-	Matrix4f WorldViewProjMatrix = WorldMatrix * ViewProjMatrix;
-
-	SetMatrixParameter( m_pWorldViewMatrix, &WorldViewMatrix );
-	SetMatrixParameter( m_pViewProjMatrix, &ViewProjMatrix );
-	SetMatrixParameter( m_pWorldProjMatrix, &WorldProjMatrix );
-	SetMatrixParameter( m_pWorldViewProjMatrix, &WorldViewProjMatrix );
 }
 //--------------------------------------------------------------------------------
 void ParameterManagerDX11::SetViewMatrixParameter( Matrix4f* pMatrix )
 {
 	SetMatrixParameter( m_pViewMatrix, pMatrix );
-
-	Matrix4f WorldMatrix = GetMatrixParameter( m_pWorldMatrix );
-	Matrix4f ViewMatrix = GetMatrixParameter( m_pViewMatrix );
-	Matrix4f ProjMatrix = GetMatrixParameter( m_pProjMatrix );
-
-	Matrix4f WorldViewMatrix = WorldMatrix * ViewMatrix;
-	Matrix4f ViewProjMatrix = ViewMatrix * ProjMatrix;
-	Matrix4f WorldProjMatrix = WorldMatrix * ProjMatrix;
-	Matrix4f WorldViewProjMatrix = WorldMatrix * ViewProjMatrix;
-
-	SetMatrixParameter( m_pWorldViewMatrix, &WorldViewMatrix );
-	SetMatrixParameter( m_pViewProjMatrix, &ViewProjMatrix );
-	SetMatrixParameter( m_pWorldProjMatrix, &WorldProjMatrix );
-	SetMatrixParameter( m_pWorldViewProjMatrix, &WorldViewProjMatrix );
 }
 //--------------------------------------------------------------------------------
 void ParameterManagerDX11::SetProjMatrixParameter( Matrix4f* pMatrix )
 {
 	SetMatrixParameter( m_pProjMatrix, pMatrix );
+}
+//--------------------------------------------------------------------------------
+void ParameterManagerDX11::UpdateDerivedParameter( RenderParameterDX11* pParameter )
+{
+	for ( int i = 0; i < DERIVED_MATRIX_COUNT; i++ ) {
+		if ( m_DerivedMatrices[i].pMatrix == pParameter ) {
+			UpdateDerivedMatrix( m_DerivedMatrices[i] );
+			break;
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+void ParameterManagerDX11::InitializeDerivedMatrix( int index, MatrixParameterDX11* pMatrix,
+	MatrixParameterDX11* pLeft, MatrixParameterDX11* pRight )
+{
+	// The cached IDs start out invalid so that the first read always performs
+	// the calculation.
 
-	Matrix4f WorldMatrix = GetMatrixParameter( m_pWorldMatrix );
-	Matrix4f ViewMatrix = GetMatrixParameter( m_pViewMatrix );
-	Matrix4f ProjMatrix = GetMatrixParameter( m_pProjMatrix );
+	m_DerivedMatrices[index].pMatrix = pMatrix;
+	m_DerivedMatrices[index].pLeft = pLeft;
+	m_DerivedMatrices[index].pRight = pRight;
+	m_DerivedMatrices[index].uiLeftID = static_cast<unsigned int>( -1 );
+	m_DerivedMatrices[index].uiRightID = static_cast<unsigned int>( -1 );
+}
+//--------------------------------------------------------------------------------
+void ParameterManagerDX11::UpdateDerivedMatrix( DerivedMatrix& derived )
+{
+	// An input may itself be a concatenated matrix (WorldViewProj is built from
+	// ViewProj), so it is brought up to date before its value ID is checked.
+
+	UpdateDerivedParameter( derived.pRight );
 
-	Matrix4f WorldViewMatrix = WorldMatrix * ViewMatrix;
-	Matrix4f ViewProjMatrix = ViewMatrix * ProjMatrix;
-	Matrix4f WorldProjMatrix = WorldMatrix * ProjMatrix;
-	Matrix4f WorldViewProjMatrix = WorldMatrix * ViewProjMatrix;
+	unsigned int uiLeftID = derived.pLeft->GetValueID( GetID() );
+	unsigned int uiRightID = derived.pRight->GetValueID( GetID() );
+
+	if ( uiLeftID != derived.uiLeftID || uiRightID != derived.uiRightID )
+	{
+		Matrix4f product;
+		Matrix4f::Multiply( derived.pLeft->GetMatrix( GetID() ), derived.pRight->GetMatrix( GetID() ), product );
+		SetMatrixParameter( derived.pMatrix, &product );
 
-	SetMatrixParameter( m_pWorldViewMatrix, &WorldViewMatrix );
-	SetMatrixParameter( m_pViewProjMatrix, &ViewProjMatrix );
-	SetMatrixParameter( m_pWorldProjMatrix, &WorldProjMatrix );
-	SetMatrixParameter( m_pWorldViewProjMatrix, &WorldViewProjMatrix );
+		derived.uiLeftID = uiLeftID;
+		derived.uiRightID = uiRightID;
+	}
 }
 //--------------------------------------------------------------------------------
 void ParameterManagerDX11::AttachParent( IParameterManager* pParent )
@@ -899,10 +910,52 @@ void ParameterManagerDX11::DetachParent( )
 	m_pParent = 0;
 }
 //--------------------------------------------------------------------------------
+unsigned int ParameterManagerDX11::GetParameterID( const std::wstring& name )
+{
+	// Check this parameter manager first, and then the parent manager.
+
+	RenderParameterDX11* pParam = GetParameterRef( name );
+
+	if ( pParam != 0 )
+		return( pParam->GetParameterID() );
+
+	return( RenderParameterDX11::INVALID_PARAMETER_ID );
+}
+//--------------------------------------------------------------------------------
+RenderParameterDX11* ParameterManagerDX11::GetParameterRef( unsigned int ID )
+{
+	if ( ID < m_Parameters.size() )
+		return( m_Parameters[ID] );
+
+	return( 0 );
+}
+//--------------------------------------------------------------------------------
+RenderParameterDX11* ParameterManagerDX11::FindParameter( const std::wstring& name )
+{
+	// Look up the interned ID of the name.  Unlike indexing a map, this never
+	// inserts an entry for a name that hasn't been registered.
+
+	auto it = m_ParameterIDs.find( name );
+
+	if ( it != m_ParameterIDs.end() )
+		return( m_Parameters[it->second] );
+
+	return( 0 );
+}
+//--------------------------------------------------------------------------------
+void ParameterManagerDX11::RegisterParameter( RenderParameterDX11* pParameter )
+{
+	unsigned int ID = static_cast<unsigned int>( m_Parameters.size() );
+
+	pParameter->SetParameterID( ID );
+	m_ParameterIDs[pParameter->GetName()] = ID;
+	m_Parameters.push_back( pParameter );
+}
+//--------------------------------------------------------------------------------
 RenderParameterDX11* ParameterManagerDX11::GetParameterRef( const std::wstring& name )
 {
 	// First check this parameter manager
-	RenderParameterDX11* pParam = m_Parameters[name];
+	RenderParameterDX11* pParam = FindParameter( name );
 
 	// Then check the parent manager
 	if ( ( pParam == 0 ) && ( m_pParent ) )
@@ -63,3 +63,8 @@ void PipelineExecutorDX11::SetLayoutElements( unsigned int count, D3D11_INPUT_EL
 	}
 }
 //--------------------------------------------------------------------------------
+bool PipelineExecutorDX11::GetModelBounds( Sphere3f& bounds )
+{
+	return( false );
+}
+//--------------------------------------------------------------------------------
@@ -42,6 +42,7 @@
 #include "ComputeShaderDX11.h"
 
 #include "IndirectArgsBufferDX11.h"
+#include "ConstantBufferDX11.h"
 
 #include "ScreenGrab.h"
 #include <wincodec.h>
@@ -59,6 +60,7 @@ using namespace Glyph3;
 PipelineManagerDX11::PipelineManagerDX11()
 {
     m_iCurrentQuery = 0;
+	m_uiUploadGeneration = 0;
 
     ZeroMemory(&m_PipelineStatsData, sizeof(D3D11_QUERY_DATA_PIPELINE_STATISTICS));
 
@@ -326,6 +328,7 @@ void PipelineManagerDX11::ClearPipelineState( )
 		ID3D11CommandList* pList;
 		m_pContext->FinishCommandList( true, &pList );
 		pList->Release();
+		m_uiUploadGeneration++;
 	}
 }
 //--------------------------------------------------------------------------------
@@ -745,6 +748,31 @@ void PipelineManagerDX11::UnMapResource( ResourceDX11* pGlyphResource, UINT subr
 	m_pContext->Unmap( pResource, subresource );
 }
 //--------------------------------------------------------------------------------
+bool PipelineManagerDX11::UploadConstantData( ConstantBufferDX11* pBuffer, const char* pData, unsigned int size,
+	unsigned int dirtyOffset, unsigned int dirtySize )
+{
+	// Map the constant buffer into system memory.  We map the buffer with the
+	// discard write flag since we don't care what was in the buffer already,
+	// which also means that all of the data has to be copied, not only the
+	// dirty range.
+
+	D3D11_MAPPED_SUBRESOURCE resource = MapResource( pBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0 );
+
+	if ( resource.pData == nullptr )
+		return( false );
+
+	memcpy( resource.pData, pData, min( size, pBuffer->GetDesiredDescription().ByteWidth ) );
+
+	UnMapResource( pBuffer, 0 );
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+unsigned int PipelineManagerDX11::GetUploadGeneration()
+{
+	return( m_uiUploadGeneration );
+}
+//--------------------------------------------------------------------------------
 void PipelineManagerDX11::UpdateSubresource( int rid, UINT DstSubresource, const D3D11_BOX *pDstBox, const void *pSrcData, UINT SrcRowPitch, UINT SrcDepthPitch )
 {
 	// Acquire the engine's resource wrapper.
@@ -868,6 +896,7 @@ void PipelineManagerDX11::GenerateCommandList( CommandListDX11* pList )
 	if ( m_pContext->GetType() == D3D11_DEVICE_CONTEXT_DEFERRED )
 	{
 		m_pContext->FinishCommandList( false, &pList->m_pList );
+		m_uiUploadGeneration++;
 
 		// Reset the cached context state to default, since we do that for all
 		// command lists.
@@ -907,8 +936,10 @@ void PipelineManagerDX11::GenerateCommandList( CommandListDX11* pList )
 //--------------------------------------------------------------------------------
 void PipelineManagerDX11::ExecuteCommandList( CommandListDX11* pList )
 {
-	if ( pList->ListAvailable() )
+	if ( pList->ListAvailable() ) {
 		m_pContext->ExecuteCommandList( pList->m_pList, false );
+		m_uiUploadGeneration++;
+	}
 
 	InputAssemblerStage.ClearCurrentState();
 	InputAssemblerStage.ClearDesiredState();
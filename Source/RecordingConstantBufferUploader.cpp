@@ -0,0 +1,89 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "RecordingConstantBufferUploader.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+RecordingConstantBufferUploader::RecordingConstantBufferUploader() :
+	m_uiGeneration( 0 )
+{
+	Reset();
+}
+//--------------------------------------------------------------------------------
+RecordingConstantBufferUploader::~RecordingConstantBufferUploader()
+{
+}
+//--------------------------------------------------------------------------------
+void RecordingConstantBufferUploader::BeginFrame()
+{
+	memset( &m_Frame, 0, sizeof( m_Frame ) );
+}
+//--------------------------------------------------------------------------------
+void RecordingConstantBufferUploader::BeginCommandList()
+{
+	m_Contents.clear();
+	m_uiGeneration++;
+}
+//--------------------------------------------------------------------------------
+void RecordingConstantBufferUploader::Reset()
+{
+	memset( &m_Frame, 0, sizeof( m_Frame ) );
+	memset( &m_Total, 0, sizeof( m_Total ) );
+
+	// The buffers have to upload their contents again, just like after a new
+	// command list.
+
+	BeginCommandList();
+}
+//--------------------------------------------------------------------------------
+ConstantBufferUploadStatistics RecordingConstantBufferUploader::GetFrameStatistics() const
+{
+	return( m_Frame );
+}
+//--------------------------------------------------------------------------------
+ConstantBufferUploadStatistics RecordingConstantBufferUploader::GetTotalStatistics() const
+{
+	return( m_Total );
+}
+//--------------------------------------------------------------------------------
+const std::vector<char>* RecordingConstantBufferUploader::GetContents( ConstantBufferDX11* pBuffer ) const
+{
+	auto contents = m_Contents.find( pBuffer );
+
+	if ( contents == m_Contents.end() )
+		return( nullptr );
+
+	return( &contents->second );
+}
+//--------------------------------------------------------------------------------
+bool RecordingConstantBufferUploader::UploadConstantData( ConstantBufferDX11* pBuffer, const char* pData, unsigned int size,
+	unsigned int dirtyOffset, unsigned int dirtySize )
+{
+	m_Contents[pBuffer].assign( pData, pData + size );
+
+	m_Frame.maps++;
+	m_Frame.bytesUploaded += size;
+	m_Frame.bytesDirty += dirtySize;
+
+	m_Total.maps++;
+	m_Total.bytesUploaded += size;
+	m_Total.bytesDirty += dirtySize;
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+unsigned int RecordingConstantBufferUploader::GetUploadGeneration()
+{
+	return( m_uiGeneration );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
@@ -21,14 +21,16 @@
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
-RenderParameterDX11::RenderParameterDX11()
+RenderParameterDX11::RenderParameterDX11() :
+	m_uiParameterID( INVALID_PARAMETER_ID )
 {
 	for ( int i = 0; i < NUM_THREADS+1; i++ ) {
 		m_auiValueID[i] = 0;
 	}
 }
 //--------------------------------------------------------------------------------
-RenderParameterDX11::RenderParameterDX11( RenderParameterDX11& copy )
+RenderParameterDX11::RenderParameterDX11( RenderParameterDX11& copy ) :
+	m_uiParameterID( INVALID_PARAMETER_ID )
 {
 	m_sParameterName = copy.m_sParameterName;
 }
@@ -67,6 +69,16 @@ unsigned int RenderParameterDX11::GetValueID( unsigned int threadID )
 	return( m_auiValueID[threadID] );
 }
 //--------------------------------------------------------------------------------
+unsigned int RenderParameterDX11::GetParameterID() const
+{
+	return( m_uiParameterID );
+}
+//--------------------------------------------------------------------------------
+void RenderParameterDX11::SetParameterID( unsigned int ID )
+{
+	m_uiParameterID = ID;
+}
+//--------------------------------------------------------------------------------
 //RenderParameterDX11* RenderParameterDX11::CreateCopy()
 //{
 //	RenderParameterDX11* pParam = 0;
@@ -0,0 +1,215 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "RenderQueue.h"
+#include "Entity3D.h"
+#include "MaterialDX11.h"
+#include "RenderEffectDX11.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	// The layout of the sort keys, from the most significant bit down:
+	//
+	//   opaque: | 1 alpha | 3 pass | 12 vertex shader | 12 pixel shader | 12 material | 24 depth |
+	//   alpha:  | 1 alpha | 3 pass | 24 inverted depth | 12 material | 12 pixel shader | 12 vertex shader |
+	//
+	// Opaque entities are grouped by state first and drawn front to back within
+	// each group, while alpha entities are drawn strictly back to front.
+
+	const unsigned long long ID_MASK = 0xfff;
+	const unsigned long long DEPTH_MASK = 0xffffff;
+
+	unsigned long long QuantizeDepth( float depth )
+	{
+		// For non-negative floats the bit pattern increases with the value, so
+		// the upper bits can be used directly as a sortable integer.
+
+		if ( !( depth > 0.0f ) ) {
+			return( 0 );
+		}
+
+		unsigned int bits;
+		memcpy( &bits, &depth, sizeof( bits ) );
+
+		return( ( bits >> 7 ) & DEPTH_MASK );
+	}
+
+	unsigned long long ShaderID( int index )
+	{
+		// Unused stages have an index of -1, so the IDs are offset by one.
+		return( static_cast<unsigned long long>( index + 1 ) & ID_MASK );
+	}
+};
+//--------------------------------------------------------------------------------
+RenderQueue::RenderQueue()
+{
+}
+//--------------------------------------------------------------------------------
+RenderQueue::~RenderQueue()
+{
+}
+//--------------------------------------------------------------------------------
+void RenderQueue::Build( const std::vector<Entity3D*>& entities, VIEWTYPE view, const Matrix4f& ViewMatrix, const Matrix4f& ProjMatrix, float lodScale )
+{
+	m_Items.clear();
+	m_Items.reserve( entities.size() );
+
+	for ( auto pEntity : entities )
+	{
+		// Entities without any geometry or material (or that are not rendered
+		// in this view type) would not draw anything, so they are left out.
+
+		MaterialDX11* pMaterial = pEntity->Visual.Material.get();
+
+		if ( pEntity->Visual.Executor == nullptr || pMaterial == nullptr ) {
+			continue;
+		}
+
+		if ( !pMaterial->Params[view].bRender || pMaterial->Params[view].pEffect == nullptr ) {
+			continue;
+		}
+
+		RenderQueueItem item;
+		item.key = MakeKey( pEntity, view, ViewMatrix );
+		item.pEntity = pEntity;
+		item.lod = pEntity->SelectLOD( ViewMatrix, ProjMatrix, lodScale );
+		m_Items.push_back( item );
+	}
+
+	Sort();
+}
+//--------------------------------------------------------------------------------
+void RenderQueue::Clear()
+{
+	m_Items.clear();
+}
+//--------------------------------------------------------------------------------
+void RenderQueue::Render( PipelineManagerDX11* pPipelineManager, IParameterManager* pParamManager, VIEWTYPE view )
+{
+	for ( auto& item : m_Items ) {
+		item.pEntity->Render( pPipelineManager, pParamManager, view, item.lod );
+	}
+}
+//--------------------------------------------------------------------------------
+void RenderQueue::Render( PipelineManagerDX11* pPipelineManager, IParameterManager* pParamManager, VIEWTYPE view, unsigned int begin, unsigned int end )
+{
+	assert( begin <= end && end <= m_Items.size() );
+
+	for ( unsigned int i = begin; i < end; i++ ) {
+		m_Items[i].pEntity->Render( pPipelineManager, pParamManager, view, m_Items[i].lod );
+	}
+}
+//--------------------------------------------------------------------------------
+unsigned int RenderQueue::GetCount() const
+{
+	return( static_cast<unsigned int>( m_Items.size() ) );
+}
+//--------------------------------------------------------------------------------
+Entity3D* RenderQueue::GetEntity( unsigned int index ) const
+{
+	return( m_Items[index].pEntity );
+}
+//--------------------------------------------------------------------------------
+unsigned long long RenderQueue::MakeKey( Entity3D* pEntity, VIEWTYPE view, const Matrix4f& ViewMatrix )
+{
+	MaterialDX11* pMaterial = pEntity->Visual.Material.get();
+	RenderEffectDX11* pEffect = pMaterial->Params[view].pEffect;
+
+	// The depth is measured at the center of the entity's bounds if it has any,
+	// or at its origin otherwise.  With row vectors, the view space z value is
+	// the dot product of the position with the third column of the matrix.
+
+	Vector3f position = pEntity->IsBounded() ? pEntity->GetWorldBounds().center
+											 : pEntity->Transform.WorldMatrix().GetTranslation();
+
+	float depth = position.x * ViewMatrix(0,2) + position.y * ViewMatrix(1,2)
+				+ position.z * ViewMatrix(2,2) + ViewMatrix(3,2);
+
+	unsigned long long vs = ShaderID( pEffect->GetVertexShader() );
+	unsigned long long ps = ShaderID( pEffect->GetPixelShader() );
+	unsigned long long material = static_cast<unsigned long long>( pMaterial->GetMaterialID() ) & ID_MASK;
+	unsigned long long z = QuantizeDepth( depth );
+	unsigned long long pass = static_cast<unsigned long long>( pEntity->Visual.iPass ) & 0x7;
+
+	unsigned long long key = 0;
+
+	if ( pEntity->Visual.iPass == Renderable::ALPHA )
+	{
+		key |= 1ull << 63;
+		key |= pass << 60;
+		key |= ( DEPTH_MASK - z ) << 36;
+		key |= material << 24;
+		key |= ps << 12;
+		key |= vs;
+	}
+	else
+	{
+		key |= pass << 60;
+		key |= vs << 48;
+		key |= ps << 36;
+		key |= material << 24;
+		key |= z;
+	}
+
+	return( key );
+}
+//--------------------------------------------------------------------------------
+void RenderQueue::Sort()
+{
+	// An LSD radix sort over the bytes of the keys.  Each pass is stable, which
+	// keeps equal keys in their original order.  Passes where every key has the
+	// same byte value don't change the order, so they are skipped entirely.
+
+	const size_t count = m_Items.size();
+
+	if ( count < 2 ) {
+		return;
+	}
+
+	m_Scratch.resize( count );
+
+	RenderQueueItem* pSrc = m_Items.data();
+	RenderQueueItem* pDst = m_Scratch.data();
+
+	for ( int shift = 0; shift < 64; shift += 8 )
+	{
+		size_t histogram[256] = { 0 };
+
+		for ( size_t i = 0; i < count; i++ ) {
+			histogram[ ( pSrc[i].key >> shift ) & 0xff ]++;
+		}
+
+		if ( histogram[ ( pSrc[0].key >> shift ) & 0xff ] == count ) {
+			continue;
+		}
+
+		size_t offset = 0;
+		for ( int b = 0; b < 256; b++ ) {
+			size_t bucket = histogram[b];
+			histogram[b] = offset;
+			offset += bucket;
+		}
+
+		for ( size_t i = 0; i < count; i++ ) {
+			pDst[ histogram[ ( pSrc[i].key >> shift ) & 0xff ]++ ] = pSrc[i];
+		}
+
+		std::swap( pSrc, pDst );
+	}
+
+	if ( pSrc != m_Items.data() ) {
+		m_Items.swap( m_Scratch );
+	}
+}
+//--------------------------------------------------------------------------------
@@ -26,6 +26,7 @@ Renderable::~Renderable()
 {
 	Executor = nullptr;
 	Material = nullptr;
+	LODs.clear();
 }
 //--------------------------------------------------------------------------------
 void Renderable::SetMaterial( MaterialPtr pMaterial )
@@ -33,15 +34,20 @@ void Renderable::SetMaterial( MaterialPtr pMaterial )
 	Material = pMaterial;
 
 	// Query all of the vertex shader IDs that will be used so that the pipeline
-	// executor class can pre-create them.
+	// executor class can pre-create them, for every level of detail.
 
-	if ( Material != nullptr && Executor != nullptr )
+	if ( Material != nullptr )
 	{
 		std::vector<int> idlist;
 		Material->GetAllVertexShaderIDs( idlist );
 
 		for ( auto ID : idlist ) {
-			Executor->GenerateInputLayout( ID );
+			if ( Executor != nullptr ) {
+				Executor->GenerateInputLayout( ID );
+			}
+			for ( auto& lod : LODs ) {
+				lod.Executor->GenerateInputLayout( ID );
+			}
 		}
 	}
 }
@@ -74,3 +80,64 @@ ExecutorPtr Renderable::GetGeometry( )
 	return( Executor );
 }
 //--------------------------------------------------------------------------------
+void Renderable::AddLOD( ExecutorPtr pExecutor, float screenSize )
+{
+	if ( pExecutor == nullptr ) {
+		return;
+	}
+
+	LevelOfDetail lod;
+	lod.Executor = pExecutor;
+	lod.ScreenSize = screenSize;
+
+	// The levels are kept ordered by their screen size, so that the selection
+	// can stop at the first level that the entity is too large for.
+
+	auto it = LODs.begin();
+	while ( it != LODs.end() && it->ScreenSize >= screenSize ) {
+		it++;
+	}
+
+	LODs.insert( it, lod );
+
+	if ( Material != nullptr )
+	{
+		std::vector<int> idlist;
+		Material->GetAllVertexShaderIDs( idlist );
+
+		for ( auto ID : idlist ) {
+			pExecutor->GenerateInputLayout( ID );
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+void Renderable::ClearLODs( )
+{
+	LODs.clear();
+}
+//--------------------------------------------------------------------------------
+unsigned int Renderable::GetLODCount( ) const
+{
+	return( static_cast<unsigned int>( LODs.size() ) + 1 );
+}
+//--------------------------------------------------------------------------------
+const ExecutorPtr& Renderable::GetLOD( unsigned int level ) const
+{
+	if ( level == 0 || LODs.size() == 0 ) {
+		return( Executor );
+	}
+
+	return( LODs[min( level, static_cast<unsigned int>( LODs.size() ) ) - 1].Executor );
+}
+//--------------------------------------------------------------------------------
+unsigned int Renderable::SelectLOD( float screenSize ) const
+{
+	unsigned int level = 0;
+
+	while ( level < LODs.size() && screenSize < LODs[level].ScreenSize ) {
+		level++;
+	}
+
+	return( level );
+}
+//--------------------------------------------------------------------------------
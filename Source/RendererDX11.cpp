@@ -41,6 +41,7 @@
 #include "BlendStateConfigDX11.h"
 #include "DepthStencilStateConfigDX11.h"
 #include "RasterizerStateConfigDX11.h"
+#include "SamplerStateConfigDX11.h"
 
 #include "VertexShaderDX11.h"
 #include "HullShaderDX11.h"
@@ -49,6 +50,7 @@
 #include "PixelShaderDX11.h"
 #include "ComputeShaderDX11.h"
 #include "ShaderFactoryDX11.h"
+#include "ShaderCompilerDX11.h"
 #include "ShaderReflectionDX11.h"
 #include "ShaderReflectionFactoryDX11.h"
 
@@ -112,6 +114,8 @@ RendererDX11::RendererDX11()
 	MultiThreadingConfig.ApplyConfiguration();
 
 	m_FeatureLevel = D3D_FEATURE_LEVEL_9_1; // Initialize this to only support 9.1...
+
+	m_ShaderCache.SetCompiler( std::shared_ptr<IShaderCompiler>( new ShaderCompilerDX11() ) );
 }
 //--------------------------------------------------------------------------------
 RendererDX11::~RendererDX11()
@@ -357,47 +361,40 @@ bool RendererDX11::Initialize( D3D_DRIVER_TYPE DriverType, D3D_FEATURE_LEVEL Fea
 
 
 	// Initialize the multithreading portion of the renderer.  This includes
-	// creating the threads themselves, initializing the thread payloads as well.
+	// creating the thread payloads, and starting the job scheduler with one
+	// thread for each hardware thread (limited to the number of payloads).
+
+	m_vThreadPayloads.resize( NUM_THREADS );
 
 	for ( int i = 0; i < NUM_THREADS; i++ )
 	{
-		// Mark each payload so that the thread knows which synchronization primitives to use.
-		g_aPayload[i].id = i;
+		ThreadPayLoad& payload = m_vThreadPayloads[i];
+		payload.id = i;
 
-		// Create a deferred context for each thread's pipeline.
+		// Create a deferred context for each payload's pipeline.
 		DeviceContextComPtr pDeferred;
 		m_pDevice->CreateDeferredContext( 0, pDeferred.GetAddressOf() );
 
 		// Create the pipeline and set the context.
-		g_aPayload[i].pPipeline = new PipelineManagerDX11();
-		g_aPayload[i].pPipeline->SetDeviceContext( pDeferred, m_FeatureLevel );
-		g_aPayload[i].pPipeline->RasterizerStage.DesiredState.RasterizerState.SetState( 0 );
-		g_aPayload[i].pPipeline->OutputMergerStage.DesiredState.DepthStencilState.SetState( 0 );
-		g_aPayload[i].pPipeline->OutputMergerStage.DesiredState.BlendState.SetState( 0 );
+		payload.pPipeline = new PipelineManagerDX11();
+		payload.pPipeline->SetDeviceContext( pDeferred, m_FeatureLevel );
+		payload.pPipeline->RasterizerStage.DesiredState.RasterizerState.SetState( 0 );
+		payload.pPipeline->OutputMergerStage.DesiredState.DepthStencilState.SetState( 0 );
+		payload.pPipeline->OutputMergerStage.DesiredState.BlendState.SetState( 0 );
 
+		// Generate a new parameter manager for each payload.
+		payload.pParamManager = new ParameterManagerDX11( i+1 );
+		payload.pParamManager->AttachParent( m_pParamMgr );
 
-		// Create the command list.
-		g_aPayload[i].pList = new CommandListDX11();
-		
-		// Generate a new parameter manager for each thread.
-		g_aPayload[i].pParamManager = new ParameterManagerDX11( i+1 );
-		g_aPayload[i].pParamManager->AttachParent( m_pParamMgr );
-
-		// Initialize the payload data variables.
-		g_aPayload[i].bComplete = true;
-		g_aPayload[i].pTask = nullptr;
-
-		// Create the threads in a suspended state.
-		g_aThreadHandles[i] = 0;
-		g_aThreadHandles[i] = (HANDLE)_beginthreadex( 0, 0xfffff, _TaskThreadProc, &g_aPayload[i], CREATE_SUSPENDED, 0 );
+		m_vFreeThreadPayloads.push_back( &payload );
+	}
 
-		// Create the synchronization events.
-		g_aBeginEventHandle[i] = CreateEvent( 0, FALSE, FALSE, 0 );
-		g_aEndEventHandle[i] = CreateEvent( 0, FALSE, FALSE, 0 );
+	unsigned int threads = JobScheduler::GetHardwareThreadCount();
+	m_JobScheduler.Initialize( min( threads, static_cast<unsigned int>( NUM_THREADS ) ) );
 
-		// Start the thread up now that it has a synch object to use.
-		ResumeThread( g_aThreadHandles[i] );
-	}
+	std::wstringstream s;
+	s << L"Job scheduler started with " << m_JobScheduler.GetThreadCount() << L" threads";
+	Log::Get().Write( s.str() );
 
 	return( true );
 }
@@ -408,20 +405,22 @@ void RendererDX11::Shutdown()
 	LogObjectPtrVector<ShaderDX11*>( m_vShaders );
 
 	// Shutdown all of the threads
-	for ( int i = 0; i < NUM_THREADS; i++ )
-	{
-		g_aPayload[i].bComplete = true;
-		g_aPayload[i].pTask = nullptr;
-		
-		SAFE_DELETE( g_aPayload[i].pParamManager );
-		SAFE_DELETE( g_aPayload[i].pPipeline );
-		SAFE_DELETE( g_aPayload[i].pList );
+	m_JobScheduler.Shutdown();
 
-		CloseHandle( g_aThreadHandles[i] );
-		CloseHandle( g_aBeginEventHandle[i] );
-		CloseHandle( g_aEndEventHandle[i] );
+	for ( auto& payload : m_vThreadPayloads )
+	{
+		SAFE_DELETE( payload.pParamManager );
+		SAFE_DELETE( payload.pPipeline );
 	}
 
+	m_vThreadPayloads.clear();
+	m_vFreeThreadPayloads.clear();
+
+	for ( auto pList : m_vCommandLists )
+		delete pList;
+
+	m_vCommandLists.clear();
+
 
 	SAFE_DELETE( m_pParamMgr );
 	SAFE_DELETE( pImmPipeline );
@@ -433,19 +432,30 @@ void RendererDX11::Shutdown()
 	m_DepthStencilStates.clear();
 	m_RasterizerStates.clear();
 	m_vSamplerStates.clear();
+
+	m_BlendStateLookup.Clear();
+	m_DepthStencilStateLookup.Clear();
+	m_RasterizerStateLookup.Clear();
+	m_SamplerStateLookup.Clear();
 	m_vInputLayouts.clear();
 	m_vViewPorts.clear();
 
 	for ( auto pShader : m_vShaders )
 		delete pShader;
 
+	m_vShaders.clear();
+	m_ShaderLookup.clear();
+	m_ShaderCache.ClearMemoryCache();
+
 	m_vShaderResourceViews.clear();
 	m_vRenderTargetViews.clear();
 	m_vDepthStencilViews.clear();
 	m_vUnorderedAccessViews.clear();
 
-	for ( auto pResource : m_vResources )
-		delete pResource;
+	for ( unsigned int i = 0; i < m_Resources.GetSlotCount(); i++ )
+		delete m_Resources.GetSlot( i );
+
+	m_Resources.Clear();
 
 	for ( auto pSwapChain : m_vSwapChains ) {
 		if ( pSwapChain->m_pSwapChain != nullptr ) {
@@ -1041,8 +1051,8 @@ void RendererDX11::ResizeSwapChain( int SID, UINT width, UINT height )
 
 	this->pImmPipeline->ClearPipelineState();
 	
-	for ( int i = 0; i < NUM_THREADS; i++ ) {
-		g_aPayload[i].pPipeline->ClearPipelineState();
+	for ( auto& payload : m_vThreadPayloads ) {
+		payload.pPipeline->ClearPipelineState();
 	}
 
 	// Resize the buffers.
@@ -1083,26 +1093,19 @@ int RendererDX11::LoadShader( ShaderType type, std::wstring& filename, std::wstr
                                 std::wstring& model, const D3D_SHADER_MACRO* pDefines, bool enablelogging )
 {
 
-	// Check the existing list of shader files to see if there are any matches
-	// before trying to load it up again.  This will reduce the load times,
-	// and should speed up rendering in many cases since the shader object won't 
-	// have to be bound again.  
-	//
-	// In the case that there are any defines passed in, we skip returning the 
-	// cached shader - we assume that something is different about the shader due
-	// to the defines, so we can't just reuse a previously loaded one.
-	
-	for ( unsigned int i = 0; i < m_vShaders.size(); i++ )
-	{
-		ShaderDX11* pShader = m_vShaders[i];
+	// Check the existing shaders to see if there are any matches before trying
+	// to load it up again.  This will reduce the load times, and should speed up
+	// rendering in many cases since the shader object won't have to be bound
+	// again.  The defines are part of the key, so each permutation of a shader
+	// is only created once.
 
-		if ( pShader->FileName.compare( filename ) == 0
-			&& pShader->Function.compare( function ) == 0
-			&& pShader->ShaderModel.compare( model ) == 0
-			&& pDefines == nullptr )
-		{
-			return( i );
-		}
+	const unsigned long long key = ShaderCacheDX11::GetRequestKey(
+		ShaderFactoryDX11::CreateRequest( filename, function, model, pDefines ) );
+
+	auto existing = m_ShaderLookup.find( key );
+
+	if ( existing != m_ShaderLookup.end() ) {
+		return( existing->second );
 	}
 
 	HRESULT hr = S_OK;
@@ -1213,6 +1216,7 @@ int RendererDX11::LoadShader( ShaderType type, std::wstring& filename, std::wstr
 	pShaderWrapper->ShaderModel = model;
 
 	m_vShaders.push_back( pShaderWrapper );
+	m_ShaderLookup[key] = m_vShaders.size() - 1;
 
 
 
@@ -1384,10 +1388,10 @@ int RendererDX11::CreateBlendState( BlendStateConfigDX11* pConfig )
 {
 	// If this state has already been created before, just return the index.
 
-	auto entry = m_BlendStateLookup.find( *pConfig );
+	int index = m_BlendStateLookup.Find( *pConfig );
 
-	if ( entry != m_BlendStateLookup.end() ) {
-		return entry->second;
+	if ( index != -1 ) {
+		return index;
 	}
 
 	// If it hasn't been created before, create it, then store it, and return it.
@@ -1405,7 +1409,7 @@ int RendererDX11::CreateBlendState( BlendStateConfigDX11* pConfig )
 	m_BlendStates.push_back( pState );
 
 	int id = m_BlendStates.size() - 1;
-	m_BlendStateLookup[*pConfig] = id;
+	m_BlendStateLookup.Insert( *pConfig, id );
 
 	return id;
 }
@@ -1414,10 +1418,10 @@ int RendererDX11::CreateDepthStencilState( DepthStencilStateConfigDX11* pConfig
 {
 	// If this state has already been created before, just return the index.
 
-	auto entry = m_DepthStencilStateLookup.find( *pConfig );
+	int index = m_DepthStencilStateLookup.Find( *pConfig );
 
-	if ( entry != m_DepthStencilStateLookup.end() ) {
-		return entry->second;
+	if ( index != -1 ) {
+		return index;
 	}
 
 	// If it hasn't been created before, create it, then store it, and return it.
@@ -1435,7 +1439,7 @@ int RendererDX11::CreateDepthStencilState( DepthStencilStateConfigDX11* pConfig
 	m_DepthStencilStates.push_back( pState );
 
 	int id = m_DepthStencilStates.size() - 1;
-	m_DepthStencilStateLookup[*pConfig] = id;
+	m_DepthStencilStateLookup.Insert( *pConfig, id );
 
 	return id;
 }
@@ -1444,10 +1448,10 @@ int RendererDX11::CreateRasterizerState( RasterizerStateConfigDX11* pConfig )
 {
 	// If this state has already been created before, just return the index.
 
-	auto entry = m_RasterizerStateLookup.find( *pConfig );
+	int index = m_RasterizerStateLookup.Find( *pConfig );
 
-	if ( entry != m_RasterizerStateLookup.end() ) {
-		return entry->second;
+	if ( index != -1 ) {
+		return index;
 	}
 
 	// If it hasn't been created before, create it, then store it, and return it.
@@ -1465,13 +1469,25 @@ int RendererDX11::CreateRasterizerState( RasterizerStateConfigDX11* pConfig )
 	m_RasterizerStates.push_back( pState );
 
 	int id = m_RasterizerStates.size() - 1;
-	m_RasterizerStateLookup[*pConfig] = id;
+	m_RasterizerStateLookup.Insert( *pConfig, id );
 
 	return id;
 }
 //--------------------------------------------------------------------------------
 int RendererDX11::CreateSamplerState( D3D11_SAMPLER_DESC* pDesc )
 {
+	// If this state has already been created before, just return the index.
+	// The description is copied into a config object to serve as the key.
+
+	SamplerStateConfigDX11 config;
+	static_cast<D3D11_SAMPLER_DESC&>( config ) = *pDesc;
+
+	int index = m_SamplerStateLookup.Find( config );
+
+	if ( index != -1 ) {
+		return index;
+	}
+
 	SamplerStateComPtr pState;
 
 	HRESULT hr = m_pDevice->CreateSamplerState( pDesc, pState.GetAddressOf() );
@@ -1484,7 +1500,30 @@ int RendererDX11::CreateSamplerState( D3D11_SAMPLER_DESC* pDesc )
 
 	m_vSamplerStates.push_back( pState );
 
-	return( m_vSamplerStates.size() - 1 );
+	int id = m_vSamplerStates.size() - 1;
+	m_SamplerStateLookup.Insert( config, id );
+
+	return id;
+}
+//--------------------------------------------------------------------------------
+const TStateCacheDX11<BlendStateConfigDX11>& RendererDX11::GetBlendStateCache() const
+{
+	return( m_BlendStateLookup );
+}
+//--------------------------------------------------------------------------------
+const TStateCacheDX11<DepthStencilStateConfigDX11>& RendererDX11::GetDepthStencilStateCache() const
+{
+	return( m_DepthStencilStateLookup );
+}
+//--------------------------------------------------------------------------------
+const TStateCacheDX11<RasterizerStateConfigDX11>& RendererDX11::GetRasterizerStateCache() const
+{
+	return( m_RasterizerStateLookup );
+}
+//--------------------------------------------------------------------------------
+const TStateCacheDX11<SamplerStateConfigDX11>& RendererDX11::GetSamplerStateCache() const
+{
+	return( m_SamplerStateLookup );
 }
 //--------------------------------------------------------------------------------
 int RendererDX11::CreateViewPort( D3D11_VIEWPORT viewport )
@@ -1574,17 +1613,14 @@ const ViewPortDX11& RendererDX11::GetViewPort( int ID )
 //--------------------------------------------------------------------------------
 ResourceDX11* RendererDX11::GetResourceByIndex( int ID )
 {
-	ResourceDX11* pResource = 0;
-
-	unsigned int index = ID & 0xffff;
-	int innerID = ( ID & 0xffff0000 ) >> 16;
+	// The handle is checked against the generation of its slot, so a handle to
+	// a resource that has been deleted returns null instead of whatever resource
+	// is now stored in the same slot.
 
-	if ( index < m_vResources.size() ) {
-		pResource = m_vResources[index];
+	ResourceDX11* pResource = m_Resources.Get( ID );
 
-		if ( pResource->GetInnerID() != innerID ) {
-			Log::Get().Write( L"Inner ID doesn't match resource index!!!" );
-		}
+	if ( pResource == nullptr && ID != -1 ) {
+		Log::Get().Write( L"Resource ID is stale or invalid!!!" );
 	}
 
 	return( pResource );
@@ -1623,95 +1659,133 @@ void RendererDX11::ProcessTaskQueue( )
 	{
 		// Single-threaded processing of the render view queue
 
-		for ( int i = m_vQueuedTasks.size()-1; i >= 0; i-=NUM_THREADS )
+		IParameterManager* pParamManager = m_vThreadPayloads[0].pParamManager;
+
+		for ( int i = m_vQueuedTasks.size()-1; i >= 0; i-- )
         {
-			for ( int j = 0; j < NUM_THREADS; j++ )
-			{
-				if ( (i-j) >= 0 )
-				{
-					//
-					pImmPipeline->BeginEvent( std::wstring( L"View Draw: ") + m_vQueuedTasks[i-j]->GetName() );
-					m_vQueuedTasks[i-j]->ExecuteTask( pImmPipeline, g_aPayload[j].pParamManager );
-					pImmPipeline->EndEvent();
-					//PIXEndEvent();
-				}
-			}
+			pImmPipeline->BeginEvent( std::wstring( L"View Draw: ") + m_vQueuedTasks[i]->GetName() );
+			m_vQueuedTasks[i]->ExecuteTask( pImmPipeline, pParamManager );
+			pImmPipeline->EndEvent();
         }
 
 		m_vQueuedTasks.clear();
 	}
 	else
 	{
-		// Multi-threaded processing of the render view queue
+		// Multi-threaded processing of the render view queue.  Each task is a
+		// separate job, so a slow task only occupies a single thread while the
+		// others continue with the remaining tasks.
 
-		for ( int i = m_vQueuedTasks.size()-1; i >= 0; i-=NUM_THREADS )
+		const int count = static_cast<int>( m_vQueuedTasks.size() );
+
+		while ( m_vCommandLists.size() < m_vQueuedTasks.size() ) {
+			m_vCommandLists.push_back( new CommandListDX11() );
+		}
+
+		JobCounter counter;
+
+		for ( int i = count-1; i >= 0; i-- )
 		{
-			DWORD count = 0;
-
-			for ( int j = 0; j < NUM_THREADS; j++ )
-			{
-				if ( (i-j) >= 0 )
-				{
-					count++;
-					g_aPayload[j].pTask = m_vQueuedTasks[i-j];
-					SetEvent( g_aBeginEventHandle[j] );
-				}
-			}
+			Task* pTask = m_vQueuedTasks[i];
+			CommandListDX11* pList = m_vCommandLists[i];
+
+			m_JobScheduler.Submit( [this,pTask,pList]( unsigned int worker ) {
+				ExecuteTaskJob( pTask, pList );
+			}, counter );
+		}
 
-			WaitForMultipleObjects( count, g_aEndEventHandle, true, INFINITE );
+		m_JobScheduler.Wait( counter );
 
-			for ( int j = 0; count > 0; count-- )
-			{
-				pImmPipeline->ExecuteCommandList( g_aPayload[j].pList );
-				g_aPayload[j].pList->ReleaseList();
-				j++;
-			}
+		// The command lists are executed in the same order that the tasks would
+		// have been processed in by the single threaded path.
 
+		for ( int i = count-1; i >= 0; i-- )
+		{
+			pImmPipeline->ExecuteCommandList( m_vCommandLists[i] );
+			m_vCommandLists[i]->ReleaseList();
 		}
 
 		m_vQueuedTasks.clear();
 	}
 }
 //--------------------------------------------------------------------------------
+void RendererDX11::ExecuteTaskJob( Task* pTask, CommandListDX11* pList )
+{
+	// Here is the render view process for each job.  A job records a single
+	// task's rendering commands into a command list, which is later executed
+	// by the immediate context.
+
+	ThreadPayLoad* pPayload = AcquireThreadPayload();
+
+	pPayload->pPipeline->m_pContext->ClearState();
 
+	// Execute the render view with the provided pipeline and parameter managers.
+	pTask->ExecuteTask( pPayload->pPipeline, pPayload->pParamManager );
 
+	// Generate the command list.
+	pPayload->pPipeline->GenerateCommandList( pList );
+
+	ReleaseThreadPayload( pPayload );
+}
+//--------------------------------------------------------------------------------
+JobScheduler* RendererDX11::GetJobScheduler()
+{
+	return( &m_JobScheduler );
+}
 //--------------------------------------------------------------------------------
-// Here is the render view process for each thread.  The intention here is to 
-// have a thread perform a single render view's rendering commands to generate
-// a command list.  This list is later used by the immediate context to execute
-// the list.
+ShaderCacheDX11* RendererDX11::GetShaderCache()
+{
+	return( &m_ShaderCache );
+}
 //--------------------------------------------------------------------------------
-HANDLE						g_aThreadHandles[NUM_THREADS];
-Glyph3::ThreadPayLoad		g_aPayload[NUM_THREADS];
-HANDLE						g_aBeginEventHandle[NUM_THREADS];
-HANDLE						g_aEndEventHandle[NUM_THREADS];
+void RendererDX11::PrecompileShaders( const std::vector<ShaderCompileRequestDX11>& requests )
+{
+	std::vector<ShaderBytecodePtr> results;
+	m_ShaderCache.GetBytecode( requests, results, &m_JobScheduler );
 
+	ShaderCacheStatistics stats = m_ShaderCache.GetStatistics();
 
-unsigned int WINAPI _TaskThreadProc( void* lpParameter )
+	std::wstringstream s;
+	s << L"Precompiled " << requests.size() << L" shaders: " << stats.compilations << L" compilations, "
+		<< stats.diskHits << L" disk cache hits, " << stats.memoryHits << L" memory cache hits in total";
+	Log::Get().Write( s.str() );
+}
+//--------------------------------------------------------------------------------
+ThreadPayLoad* RendererDX11::AcquireThreadPayload()
 {
-	ThreadPayLoad* pPayload = (ThreadPayLoad*) lpParameter;
-
-	int id = pPayload->id;
+	// There are at least as many payloads as threads, so this only waits while
+	// some of them are lent out to record parts of another task.  Those jobs
+	// never wait on anything themselves, so a payload is released shortly.
 
+	ThreadPayLoad* pPayload = TryAcquireThreadPayload();
 
-	for ( ; ; )
-	{
-		// Wait for the main thread to signal that there is a payload available.
-		WaitForSingleObject( g_aBeginEventHandle[id], INFINITE );
+	while ( pPayload == nullptr ) {
+		std::this_thread::yield();
+		pPayload = TryAcquireThreadPayload();
+	}
 
-		pPayload->pPipeline->m_pContext->ClearState();
+	return( pPayload );
+}
+//--------------------------------------------------------------------------------
+ThreadPayLoad* RendererDX11::TryAcquireThreadPayload()
+{
+	std::lock_guard<std::mutex> lock( m_ThreadPayloadLock );
 
-		// Execute the render view with the provided pipeline and parameter managers.
-		pPayload->pTask->ExecuteTask( pPayload->pPipeline, pPayload->pParamManager );
+	if ( m_vFreeThreadPayloads.empty() ) {
+		return( nullptr );
+	}
 
-		// Generate the command list.
-		pPayload->pPipeline->GenerateCommandList( pPayload->pList );
+	ThreadPayLoad* pPayload = m_vFreeThreadPayloads.back();
+	m_vFreeThreadPayloads.pop_back();
 
-		// Signal to the main thread that the view has been collected into a command list.
-		SetEvent( g_aEndEventHandle[id] );
-	}
+	return( pPayload );
+}
+//--------------------------------------------------------------------------------
+void RendererDX11::ReleaseThreadPayload( ThreadPayLoad* pPayload )
+{
+	std::lock_guard<std::mutex> lock( m_ThreadPayloadLock );
 
-	return( 0 );
+	m_vFreeThreadPayloads.push_back( pPayload );
 }
 //--------------------------------------------------------------------------------
 Texture1dDX11* RendererDX11::GetTexture1DByIndex( int rid )
@@ -1721,10 +1795,10 @@ Texture1dDX11* RendererDX11::GetTexture1DByIndex( int rid )
 	ResourceDX11* pResource = GetResourceByIndex(rid);
 
 	if ( pResource != NULL ) {
-		if ( pResource->GetType() != RT_TEXTURE1D ) {
+		if ( m_Resources.GetType( rid ) != RT_TEXTURE1D ) {
 			Log::Get().Write( L"Trying to access a non-texture1D resource!!!!" );
 		} else {
-			pResult = reinterpret_cast<Texture1dDX11*>( pResource );
+			pResult = static_cast<Texture1dDX11*>( pResource );
 		}
 	}
 
@@ -1738,10 +1812,10 @@ Texture2dDX11* RendererDX11::GetTexture2DByIndex( int rid )
 	ResourceDX11* pResource = GetResourceByIndex(rid);
 
 	if ( pResource != NULL ) {
-		if ( pResource->GetType() != RT_TEXTURE2D ) {
+		if ( m_Resources.GetType( rid ) != RT_TEXTURE2D ) {
 			Log::Get().Write( L"Trying to access a non-texture2D resource!!!!" );
 		} else {
-			pResult = reinterpret_cast<Texture2dDX11*>( pResource );
+			pResult = static_cast<Texture2dDX11*>( pResource );
 		}
 	}
 
@@ -1755,10 +1829,10 @@ Texture3dDX11* RendererDX11::GetTexture3DByIndex( int rid )
 	ResourceDX11* pResource = GetResourceByIndex(rid);
 	
 	if ( pResource != NULL ) {
-		if ( pResource->GetType() != RT_TEXTURE3D ) {
+		if ( m_Resources.GetType( rid ) != RT_TEXTURE3D ) {
 			Log::Get().Write( L"Trying to access a non-texture3D resource!!!!" );
 		} else {
-			pResult = reinterpret_cast<Texture3dDX11*>( pResource );
+			pResult = static_cast<Texture3dDX11*>( pResource );
 		}
 	}
 
@@ -1782,10 +1856,12 @@ BufferDX11* RendererDX11::GetGenericBufferByIndex( int rid )
 	ResourceDX11* pResource = GetResourceByIndex(rid);
 	
 	if ( pResource != NULL ) {
-		if ( pResource->GetType() == RT_TEXTURE1D || pResource->GetType() == RT_TEXTURE2D || pResource->GetType() == RT_TEXTURE3D ) {
+		int type = m_Resources.GetType( rid );
+
+		if ( type == RT_TEXTURE1D || type == RT_TEXTURE2D || type == RT_TEXTURE3D ) {
 			Log::Get().Write( L"Trying to access a non-buffer resource!!!!" );
 		} else {
-			pResult = reinterpret_cast<BufferDX11*>( pResource );
+			pResult = static_cast<BufferDX11*>( pResource );
 		}
 	}
 
@@ -1799,10 +1875,10 @@ ConstantBufferDX11* RendererDX11::GetConstantBufferByIndex( int rid )
 	ResourceDX11* pResource = GetResourceByIndex(rid);
 	
 	if ( pResource != NULL ) {
-		if ( pResource->GetType() != RT_CONSTANTBUFFER ) {
+		if ( m_Resources.GetType( rid ) != RT_CONSTANTBUFFER ) {
 			Log::Get().Write( L"Trying to access a non-vertex buffer resource!!!!" );
 		} else {
-			pResult = reinterpret_cast<ConstantBufferDX11*>( pResource );
+			pResult = static_cast<ConstantBufferDX11*>( pResource );
 		}
 	}
 
@@ -1816,10 +1892,10 @@ VertexBufferDX11* RendererDX11::GetVertexBufferByIndex( int rid )
 	ResourceDX11* pResource = GetResourceByIndex(rid);
 	
 	if ( pResource != NULL ) {
-		if ( pResource->GetType() != RT_VERTEXBUFFER ) {
+		if ( m_Resources.GetType( rid ) != RT_VERTEXBUFFER ) {
 			Log::Get().Write( L"Trying to access a non-vertex buffer resource!!!!" );
 		} else {
-			pResult = reinterpret_cast<VertexBufferDX11*>( pResource );
+			pResult = static_cast<VertexBufferDX11*>( pResource );
 		}
 	}
 
@@ -1833,10 +1909,10 @@ IndexBufferDX11* RendererDX11::GetIndexBufferByIndex( int rid )
 	ResourceDX11* pResource = GetResourceByIndex(rid);
 
 	if ( pResource != NULL ) {
-		if ( pResource->GetType() != RT_INDEXBUFFER ) {
+		if ( m_Resources.GetType( rid ) != RT_INDEXBUFFER ) {
 			Log::Get().Write( L"Trying to access a non-index buffer resource!!!!" );
 		} else {
-			pResult = reinterpret_cast<IndexBufferDX11*>( pResource );
+			pResult = static_cast<IndexBufferDX11*>( pResource );
 		}
 	}
 
@@ -1850,10 +1926,10 @@ ByteAddressBufferDX11* RendererDX11::GetByteAddressBufferByIndex( int rid )
 	ResourceDX11* pResource = GetResourceByIndex(rid);
 
 	if ( pResource != NULL ) {
-		if ( pResource->GetType() != RT_BYTEADDRESSBUFFER ) {
+		if ( m_Resources.GetType( rid ) != RT_BYTEADDRESSBUFFER ) {
 			Log::Get().Write( L"Trying to access a non-byte address buffer resource!!!!" );
 		} else {
-			pResult = reinterpret_cast<ByteAddressBufferDX11*>( pResource );
+			pResult = static_cast<ByteAddressBufferDX11*>( pResource );
 		}
 	}
 
@@ -1867,10 +1943,10 @@ IndirectArgsBufferDX11*	RendererDX11::GetIndirectArgsBufferByIndex( int rid )
 	ResourceDX11* pResource = GetResourceByIndex(rid);			
 			
 	if ( pResource != NULL ) {
-		if ( pResource->GetType() != RT_INDIRECTARGSBUFFER ) {
+		if ( m_Resources.GetType( rid ) != RT_INDIRECTARGSBUFFER ) {
 			Log::Get().Write( L"Trying to access a non-indirect args buffer resource!!!!" );
 		} else {
-			pResult = reinterpret_cast<IndirectArgsBufferDX11*>( pResource );
+			pResult = static_cast<IndirectArgsBufferDX11*>( pResource );
 		}
 	}
 
@@ -1884,10 +1960,10 @@ StructuredBufferDX11* RendererDX11::GetStructuredBufferByIndex( int rid )
 	ResourceDX11* pResource = GetResourceByIndex(rid);
 
 	if ( pResource != NULL ) {
-		if ( pResource->GetType() != RT_STRUCTUREDBUFFER ) {
+		if ( m_Resources.GetType( rid ) != RT_STRUCTUREDBUFFER ) {
 			Log::Get().Write( L"Trying to access a non-structured buffer resource!!!!" );
 		} else {
-			pResult = reinterpret_cast<StructuredBufferDX11*>( pResource );
+			pResult = static_cast<StructuredBufferDX11*>( pResource );
 		}
 	}
 
@@ -1926,41 +2002,22 @@ UnorderedAccessViewDX11& RendererDX11::GetUnorderedAccessViewByIndex( int rid )
 	return( m_vUnorderedAccessViews[rid] );
 }
 //--------------------------------------------------------------------------------
-int	RendererDX11::GetUnusedResourceIndex()
-{
-	// Initialize return index to -1.
-	int index = -1;
-	
-	// Search for a NULL index location.
-	for ( unsigned int i = 0; i < m_vResources.size(); i++ ) {
-		if ( m_vResources[i] == NULL ) {
-			index = i;
-			break;
-		}
-	}
-
-	// Return either an empty location, or -1 if none exist.
-	return( index );
-}
-//--------------------------------------------------------------------------------
 int	RendererDX11::StoreNewResource( ResourceDX11* pResource )
 {
-	// This method either finds an empty spot in the list, or just appends the
-	// resource to the end of it if none are available.
+	// This method takes a free slot from the table, or appends a new one if
+	// none are available.  The returned handle includes the generation of the
+	// slot, which is what lets stale handles be detected later on.
+
+	int index = m_Resources.Add( pResource, pResource->GetType() );
 
-	int index = GetUnusedResourceIndex();
+	// The table owns the resources that it holds, so a resource that can't be
+	// stored is released here instead of being leaked.
 
 	if ( index == -1 ) {
-		m_vResources.push_back( pResource );
-		index = m_vResources.size() - 1;
-	} else {
-		m_vResources[index] = pResource;
+		Log::Get().Write( L"The resource table is full!!!" );
+		delete pResource;
 	}
 
-	// Shift the inner ID to the upper 16 bits.
-	int innerID = (int)pResource->GetInnerID() << 16;
-	index = index + innerID;
-
 	return( index );
 }
 //--------------------------------------------------------------------------------
@@ -1976,11 +2033,10 @@ void RendererDX11::DeleteResource( int index )
 {
 	// Here the resource is looked up, then deleted if it was found.  After 
 	// being deleted, it is 
-	ResourceDX11* pResource = GetResourceByIndex( index );
+	ResourceDX11* pResource = m_Resources.Remove( index );
 
 	if ( pResource != nullptr ) {
 		delete pResource;
-		m_vResources[index & 0xffff] = nullptr;
 	}
 }
 //--------------------------------------------------------------------------------
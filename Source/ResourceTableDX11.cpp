@@ -0,0 +1,160 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "ResourceTableDX11.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+ResourceTableDX11::ResourceTableDX11() :
+	m_uiFirstFree( EndOfList ),
+	m_uiLastFree( EndOfList ),
+	m_uiCount( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+ResourceTableDX11::~ResourceTableDX11()
+{
+}
+//--------------------------------------------------------------------------------
+int ResourceTableDX11::Add( ResourceDX11* pResource, int type )
+{
+	unsigned int index = m_uiFirstFree;
+
+	if ( index != EndOfList ) {
+
+		// Take the oldest free slot from the front of the list.
+
+		m_uiFirstFree = m_Slots[index].nextFree;
+
+		if ( m_uiFirstFree == EndOfList ) {
+			m_uiLastFree = EndOfList;
+		}
+
+	} else {
+
+		if ( m_Slots.size() >= MaxSlots ) {
+			return( -1 );
+		}
+
+		Slot slot;
+		slot.generation = 0;
+		m_Slots.push_back( slot );
+
+		index = static_cast<unsigned int>( m_Slots.size() - 1 );
+	}
+
+	Slot& slot = m_Slots[index];
+	slot.pResource = pResource;
+	slot.type = type;
+	slot.nextFree = EndOfList;
+
+	m_uiCount++;
+
+	return( static_cast<int>( ( slot.generation << IndexBits ) | index ) );
+}
+//--------------------------------------------------------------------------------
+ResourceDX11* ResourceTableDX11::Remove( int handle )
+{
+	if ( Find( handle ) == nullptr ) {
+		return( nullptr );
+	}
+
+	unsigned int index = static_cast<unsigned int>( handle ) & IndexMask;
+
+	Slot& slot = m_Slots[index];
+	ResourceDX11* pResource = slot.pResource;
+
+	// Bumping the generation invalidates all of the handles to this slot, and
+	// the slot is then appended to the end of the free list.
+
+	slot.pResource = nullptr;
+	slot.generation = ( slot.generation + 1 ) & GenerationMask;
+	slot.nextFree = EndOfList;
+
+	if ( m_uiLastFree != EndOfList ) {
+		m_Slots[m_uiLastFree].nextFree = index;
+	} else {
+		m_uiFirstFree = index;
+	}
+
+	m_uiLastFree = index;
+	m_uiCount--;
+
+	return( pResource );
+}
+//--------------------------------------------------------------------------------
+const ResourceTableDX11::Slot* ResourceTableDX11::Find( int handle ) const
+{
+	if ( handle < 0 ) {
+		return( nullptr );
+	}
+
+	unsigned int index = static_cast<unsigned int>( handle ) & IndexMask;
+	unsigned int generation = static_cast<unsigned int>( handle ) >> IndexBits;
+
+	if ( index >= m_Slots.size() ) {
+		return( nullptr );
+	}
+
+	const Slot& slot = m_Slots[index];
+
+	if ( slot.pResource == nullptr || slot.generation != generation ) {
+		return( nullptr );
+	}
+
+	return( &slot );
+}
+//--------------------------------------------------------------------------------
+ResourceDX11* ResourceTableDX11::Get( int handle ) const
+{
+	const Slot* pSlot = Find( handle );
+
+	return( pSlot != nullptr ? pSlot->pResource : nullptr );
+}
+//--------------------------------------------------------------------------------
+int ResourceTableDX11::GetType( int handle ) const
+{
+	const Slot* pSlot = Find( handle );
+
+	return( pSlot != nullptr ? pSlot->type : 0 );
+}
+//--------------------------------------------------------------------------------
+bool ResourceTableDX11::IsValid( int handle ) const
+{
+	return( Find( handle ) != nullptr );
+}
+//--------------------------------------------------------------------------------
+unsigned int ResourceTableDX11::GetCount() const
+{
+	return( m_uiCount );
+}
+//--------------------------------------------------------------------------------
+unsigned int ResourceTableDX11::GetSlotCount() const
+{
+	return( static_cast<unsigned int>( m_Slots.size() ) );
+}
+//--------------------------------------------------------------------------------
+ResourceDX11* ResourceTableDX11::GetSlot( unsigned int slot ) const
+{
+	assert( slot < m_Slots.size() );
+
+	return( m_Slots[slot].pResource );
+}
+//--------------------------------------------------------------------------------
+void ResourceTableDX11::Clear()
+{
+	m_Slots.clear();
+	m_uiFirstFree = EndOfList;
+	m_uiLastFree = EndOfList;
+	m_uiCount = 0;
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
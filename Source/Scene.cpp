@@ -16,7 +16,8 @@
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
-Scene::Scene()
+Scene::Scene() :
+	m_pTransforms( nullptr )
 {
 	m_pRoot = new Node3D();
 }
@@ -28,6 +29,8 @@ Scene::~Scene()
 		SAFE_DELETE( pActor );
 	}
 
+	SAFE_DELETE( m_pTransforms );
+
 	delete m_pRoot;
 }
 //--------------------------------------------------------------------------------
@@ -41,7 +44,44 @@ void Scene::Update( float time )
 	// Perform the udpate on the root, which will propagate through the scene
 	// and update all entities in the scene.
 
+	if ( m_pTransforms == nullptr ) {
+		m_pRoot->Update( time );
+		return;
+	}
+
+	// With batched transforms, the graph traversal only runs the controllers and
+	// determines what has changed.  The world matrices are then produced by the
+	// hierarchy, and finally the bounds are refreshed from the new matrices.
+
+	if ( m_pTransforms->IsStale() )
+		m_pTransforms->Build( m_pRoot );
+
 	m_pRoot->Update( time );
+
+	// Controllers can attach or detach nodes during the traversal.  Those nodes
+	// read their parent's world matrix before the batched update has produced
+	// it, so the hierarchy is rebuilt right away and all of its slots are swept
+	// again, instead of leaving the world matrices a frame behind.
+
+	if ( m_pTransforms->IsStale() )
+		m_pTransforms->Build( m_pRoot );
+
+	m_pTransforms->UpdateWorld( );
+	UpdateWorldBounds( m_pRoot );
+}
+//--------------------------------------------------------------------------------
+void Scene::SetBatchedTransformsEnabled( bool enable )
+{
+	if ( enable && m_pTransforms == nullptr ) {
+		m_pTransforms = new TransformHierarchy();
+	} else if ( !enable ) {
+		SAFE_DELETE( m_pTransforms );
+	}
+}
+//--------------------------------------------------------------------------------
+bool Scene::IsBatchedTransformsEnabled() const
+{
+	return( m_pTransforms != nullptr );
 }
 //--------------------------------------------------------------------------------
 void Scene::Render( RendererDX11* pRenderer )
@@ -25,6 +25,34 @@ void Glyph3::GetAllEntities( Node3D* node, std::vector< Entity3D* >& set ) {
 	}
 }
 //--------------------------------------------------------------------------------
+void Glyph3::GetChangedEntities( Node3D* node, std::vector< Entity3D* >& set )
+{
+	if ( !node->SubtreeChanged() )
+		return;
+
+	for ( auto entity : node->Leafs() ) {
+		if ( entity && entity->Transform.WorldChanged() )
+			set.push_back( entity );
+	}
+
+	for ( auto n : node->Nodes() ) {
+		if ( n ) GetChangedEntities( n, set );
+	}
+}
+//--------------------------------------------------------------------------------
+void Glyph3::UpdateWorldBounds( Node3D* node )
+{
+	for ( auto entity : node->Leafs() ) {
+		if ( entity ) entity->UpdateWorldBounds();
+	}
+
+	for ( auto n : node->Nodes() ) {
+		if ( n ) UpdateWorldBounds( n );
+	}
+
+	node->UpdateWorldBounds();
+}
+//--------------------------------------------------------------------------------
 bool Glyph3::EntityInSubTree( Node3D* node, Entity3D* entity )
 {
 	for ( const auto& e : node->Leafs())
@@ -44,18 +72,75 @@ bool Glyph3::EntityInSubTree( Node3D* node, Entity3D* entity )
 	return false;
 }
 //--------------------------------------------------------------------------------
-void Glyph3::GetIntersectingEntities( Node3D* node, std::vector< Entity3D* >& set, Frustum3f& bounds )
+namespace
+{
+	// Adds all of the non-null entities of a subtree without any testing.  This
+	// is used once a node has been found to be completely inside of the volume.
+	void AcceptSubTree( Node3D* node, std::vector< Entity3D* >& set, CullingStats* pStats )
+	{
+		for ( auto entity : node->Leafs() ) {
+			if ( entity ) {
+				set.push_back( entity );
+				if ( pStats ) pStats->EntitiesVisible++;
+			}
+		}
+
+		for ( auto n : node->Nodes() ) {
+			if ( n ) AcceptSubTree( n, set, pStats );
+		}
+	}
+
+	// The traversal is shared between the bounding volume types, which only need
+	// to supply the 'Intersects' and 'Envelops' tests against a sphere.
+	template <typename T>
+	void CullSubTree( Node3D* node, std::vector< Entity3D* >& set, const T& bounds, CullingStats* pStats )
+	{
+		if ( node->IsEmpty() )
+			return;
+
+		if ( node->IsBounded() )
+		{
+			if ( pStats ) pStats->NodesTested++;
+
+			if ( !bounds.Intersects( node->GetWorldBounds() ) )
+				return;
+
+			if ( bounds.Envelops( node->GetWorldBounds() ) ) {
+				AcceptSubTree( node, set, pStats );
+				return;
+			}
+		}
+
+		for ( auto entity : node->Leafs() )
+		{
+			if ( !entity ) continue;
+
+			if ( entity->IsBounded() )
+			{
+				if ( pStats ) pStats->EntitiesTested++;
+
+				if ( !bounds.Intersects( entity->GetWorldBounds() ) )
+					continue;
+			}
+
+			set.push_back( entity );
+			if ( pStats ) pStats->EntitiesVisible++;
+		}
+
+		for ( auto n : node->Nodes() ) {
+			if ( n ) CullSubTree( n, set, bounds, pStats );
+		}
+	}
+};
+//--------------------------------------------------------------------------------
+void Glyph3::GetIntersectingEntities( Node3D* node, std::vector< Entity3D* >& set, const Frustum3f& bounds, CullingStats* pStats )
 {
-	// TODO: THis has to be fixed!
-	//if ( bounds.Intersects( GetWorldBoundingSphere() ) )
-	//	set.push_back( this );
+	CullSubTree( node, set, bounds, pStats );
 }
 //--------------------------------------------------------------------------------
-void Glyph3::GetIntersectingEntities( Node3D* node, std::vector< Entity3D* >& set, Sphere3f& bounds )
+void Glyph3::GetIntersectingEntities( Node3D* node, std::vector< Entity3D* >& set, const Sphere3f& bounds, CullingStats* pStats )
 {
-	// TODO: THis has to be fixed!
-	//if ( bounds.Intersects( GetWorldBoundingSphere() ) )
-	//	set.push_back( this );
+	CullSubTree( node, set, bounds, pStats );
 }
 //--------------------------------------------------------------------------------
 void Glyph3::BuildPickRecord( Node3D* node, const Ray3f& ray, std::vector<PickRecord>& record )
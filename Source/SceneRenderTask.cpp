@@ -16,6 +16,10 @@
 #include "Node3D.h"
 #include "Log.h"
 #include "BoundsVisualizerActor.h"
+#include "Scene.h"
+#include "SceneGraph.h"
+#include "RenderQueue.h"
+#include "CommandListDX11.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
@@ -32,7 +36,18 @@ SceneRenderTask::SceneRenderTask( ) :
 	m_fDepthClearValue( 1.0f ),
 	m_uiStencilClearValue( 0 ),
 	m_bEnableColorClear( true ),
-	m_bEnableDepthClear( true )
+	m_bEnableDepthClear( true ),
+	m_bFrustumCullingEnabled( true ),
+	m_CullingStats(),
+	m_bStateSortingEnabled( true ),
+	m_pRenderQueue( new RenderQueue() ),
+	m_VisibleEntities(),
+	m_VisibleLODs(),
+	m_fLODScale( 1.0f ),
+	m_bParallelRecordingEnabled( false ),
+	m_uiRecordingChunkSize( 128 ),
+	m_RecordingPayloads(),
+	m_RecordingLists()
 {
 	ViewMatrix.MakeIdentity();
 	ProjMatrix.MakeIdentity();
@@ -41,6 +56,10 @@ SceneRenderTask::SceneRenderTask( ) :
 SceneRenderTask::~SceneRenderTask( )
 {
 	SAFE_DELETE( m_pDebugVisualizer );
+	SAFE_DELETE( m_pRenderQueue );
+
+	for ( auto pList : m_RecordingLists )
+		delete pList;
 }
 //--------------------------------------------------------------------------------
 void SceneRenderTask::SetRenderParams( IParameterManager* pParamManager )
@@ -150,4 +169,233 @@ bool SceneRenderTask::IsDebugViewEnabled()
 {
 	return( m_bDebugViewEnabled );
 }
+//--------------------------------------------------------------------------------
+void SceneRenderTask::SetFrustumCullingEnabled( bool enable )
+{
+	m_bFrustumCullingEnabled = enable;
+}
+//--------------------------------------------------------------------------------
+bool SceneRenderTask::IsFrustumCullingEnabled()
+{
+	return( m_bFrustumCullingEnabled );
+}
+//--------------------------------------------------------------------------------
+const CullingStats& SceneRenderTask::GetCullingStats() const
+{
+	return( m_CullingStats );
+}
+//--------------------------------------------------------------------------------
+void SceneRenderTask::GetVisibleEntities( std::vector<Entity3D*>& set )
+{
+	m_CullingStats = CullingStats();
+
+	if ( m_bFrustumCullingEnabled )
+	{
+		Frustum3f frustum( ViewMatrix * ProjMatrix );
+		GetIntersectingEntities( m_pScene->GetRoot(), set, frustum, &m_CullingStats );
+	}
+	else
+	{
+		GetAllEntities( m_pScene->GetRoot(), set );
+		m_CullingStats.EntitiesVisible = static_cast<unsigned int>( set.size() );
+	}
+}
+//--------------------------------------------------------------------------------
+void SceneRenderTask::SetStateSortingEnabled( bool enable )
+{
+	m_bStateSortingEnabled = enable;
+}
+//--------------------------------------------------------------------------------
+bool SceneRenderTask::IsStateSortingEnabled()
+{
+	return( m_bStateSortingEnabled );
+}
+//--------------------------------------------------------------------------------
+void SceneRenderTask::SetParallelRecordingEnabled( bool enable )
+{
+	m_bParallelRecordingEnabled = enable;
+}
+//--------------------------------------------------------------------------------
+bool SceneRenderTask::IsParallelRecordingEnabled()
+{
+	return( m_bParallelRecordingEnabled );
+}
+//--------------------------------------------------------------------------------
+void SceneRenderTask::SetParallelRecordingChunkSize( unsigned int size )
+{
+	m_uiRecordingChunkSize = size > 0 ? size : 1;
+}
+//--------------------------------------------------------------------------------
+unsigned int SceneRenderTask::GetParallelRecordingChunkSize()
+{
+	return( m_uiRecordingChunkSize );
+}
+//--------------------------------------------------------------------------------
+void SceneRenderTask::SetLODScale( float scale )
+{
+	m_fLODScale = scale;
+}
+//--------------------------------------------------------------------------------
+float SceneRenderTask::GetLODScale()
+{
+	return( m_fLODScale );
+}
+//--------------------------------------------------------------------------------
+void SceneRenderTask::RenderVisibleEntities( PipelineManagerDX11* pPipelineManager, IParameterManager* pParamManager, VIEWTYPE view )
+{
+	// The entity list is kept as a member so that its storage is reused from
+	// frame to frame.
+
+	m_VisibleEntities.clear();
+	GetVisibleEntities( m_VisibleEntities );
+
+	if ( m_bStateSortingEnabled )
+	{
+		m_pRenderQueue->Build( m_VisibleEntities, view, ViewMatrix, ProjMatrix, m_fLODScale );
+	}
+	else
+	{
+		auto const transparent_check = []( Entity3D* entity ) { 
+			return entity->Visual.iPass != Renderable::ALPHA;
+		};
+
+		// We use stable partition to sort, so the transparent entities are
+		// rendered after all of the opaque ones.
+		std::stable_partition( begin( m_VisibleEntities ), end( m_VisibleEntities ), transparent_check );
+
+		m_VisibleLODs.resize( m_VisibleEntities.size() );
+
+		for ( unsigned int i = 0; i < m_VisibleEntities.size(); i++ ) {
+			m_VisibleLODs[i] = m_VisibleEntities[i]->SelectLOD( ViewMatrix, ProjMatrix, m_fLODScale );
+		}
+	}
+
+	unsigned int count = m_bStateSortingEnabled ? m_pRenderQueue->GetCount() 
+		: static_cast<unsigned int>( m_VisibleEntities.size() );
+
+	if ( m_bParallelRecordingEnabled && count >= 2 * m_uiRecordingChunkSize ) {
+		RecordEntitiesInParallel( pPipelineManager, pParamManager, view, count );
+	} else {
+		RenderEntityRange( pPipelineManager, pParamManager, view, 0, count );
+	}
+}
+//--------------------------------------------------------------------------------
+void SceneRenderTask::SetRecordingParams( IParameterManager* pParamManager )
+{
+	SetRenderParams( pParamManager );
+
+	if ( m_pScene->GetLightCount() > 0 ) {
+		m_pScene->GetLight( 0 )->Parameters.SetRenderParams( pParamManager );
+	}
+}
+//--------------------------------------------------------------------------------
+void SceneRenderTask::RenderEntityRange( PipelineManagerDX11* pPipelineManager, IParameterManager* pParamManager, VIEWTYPE view, unsigned int begin, unsigned int end )
+{
+	if ( m_bStateSortingEnabled )
+	{
+		m_pRenderQueue->Render( pPipelineManager, pParamManager, view, begin, end );
+	}
+	else
+	{
+		for ( unsigned int i = begin; i < end; i++ ) {
+			m_VisibleEntities[i]->Render( pPipelineManager, pParamManager, view, m_VisibleLODs[i] );
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+void SceneRenderTask::RecordEntitiesInParallel( PipelineManagerDX11* pPipelineManager, IParameterManager* pParamManager, VIEWTYPE view, unsigned int count )
+{
+	RendererDX11* pRenderer = RendererDX11::Get();
+	JobScheduler* pScheduler = pRenderer->GetJobScheduler();
+
+	// The calling thread records the first chunk directly into its own pipeline,
+	// and a thread payload is borrowed for each of the other chunks.  Borrowing
+	// never waits, so the view falls back to fewer chunks when the payloads are
+	// in use by other tasks.
+
+	unsigned int chunks = min( count / m_uiRecordingChunkSize, pScheduler->GetThreadCount() );
+
+	while ( m_RecordingPayloads.size() + 1 < chunks )
+	{
+		ThreadPayLoad* pPayload = pRenderer->TryAcquireThreadPayload();
+
+		if ( pPayload == nullptr ) {
+			break;
+		}
+
+		m_RecordingPayloads.push_back( pPayload );
+	}
+
+	chunks = static_cast<unsigned int>( m_RecordingPayloads.size() ) + 1;
+
+	if ( chunks == 1 ) {
+		RenderEntityRange( pPipelineManager, pParamManager, view, 0, count );
+		return;
+	}
+
+	while ( m_RecordingLists.size() < m_RecordingPayloads.size() ) {
+		m_RecordingLists.push_back( new CommandListDX11() );
+	}
+
+	// The chunks are drawn into the same output targets as the rest of the view.
+
+	int RenderTargets[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT];
+	int DepthTarget = pPipelineManager->OutputMergerStage.DesiredState.DepthTargetViews.GetState();
+
+	for ( int i = 0; i < D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT; i++ ) {
+		RenderTargets[i] = pPipelineManager->OutputMergerStage.DesiredState.RenderTargetViews.GetState( i );
+	}
+
+	auto const set_targets = [&]( PipelineManagerDX11* pPipeline ) {
+		pPipeline->ClearRenderTargets();
+		for ( int i = 0; i < D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT; i++ ) {
+			pPipeline->OutputMergerStage.DesiredState.RenderTargetViews.SetState( i, RenderTargets[i] );
+		}
+		pPipeline->OutputMergerStage.DesiredState.DepthTargetViews.SetState( DepthTarget );
+		pPipeline->ApplyRenderTargets();
+		ConfigureViewports( pPipeline );
+	};
+
+	JobCounter counter;
+	unsigned int worker = pScheduler->GetWorkerIndex();
+
+	for ( unsigned int c = 1; c < chunks; c++ )
+	{
+		ThreadPayLoad* pPayload = m_RecordingPayloads[c-1];
+		CommandListDX11* pList = m_RecordingLists[c-1];
+		unsigned int begin = static_cast<unsigned int>( static_cast<unsigned long long>( count ) * c / chunks );
+		unsigned int end = static_cast<unsigned int>( static_cast<unsigned long long>( count ) * ( c+1 ) / chunks );
+
+		pScheduler->Submit( [&,pPayload,pList,begin,end]( unsigned int thread ) {
+			PipelineManagerDX11* pPipeline = pPayload->pPipeline;
+
+			pPipeline->m_pContext->ClearState();
+			set_targets( pPipeline );
+			SetRecordingParams( pPayload->pParamManager );
+			pPipeline->ClearPipelineResources();
+
+			RenderEntityRange( pPipeline, pPayload->pParamManager, view, begin, end );
+
+			pPipeline->GenerateCommandList( pList );
+		}, counter, worker );
+	}
+
+	RenderEntityRange( pPipelineManager, pParamManager, view, 0, count / chunks );
+
+	pScheduler->Wait( counter, worker );
+
+	// Executing the chunks' command lists resets the context state afterwards,
+	// so the output targets are restored for anything the view renders later.
+
+	for ( unsigned int c = 1; c < chunks; c++ )
+	{
+		pPipelineManager->ExecuteCommandList( m_RecordingLists[c-1] );
+		m_RecordingLists[c-1]->ReleaseList();
+		pRenderer->ReleaseThreadPayload( m_RecordingPayloads[c-1] );
+	}
+
+	m_RecordingPayloads.clear();
+
+	set_targets( pPipelineManager );
+}
 //--------------------------------------------------------------------------------
\ No newline at end of file
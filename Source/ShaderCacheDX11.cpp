@@ -0,0 +1,369 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "ShaderCacheDX11.h"
+#include "GlyphHash.h"
+#include "JobScheduler.h"
+#include "FileSystem.h"
+#include "Log.h"
+#include <iomanip>
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	// The file holds a header followed by the bytecode.  The checksum covers
+	// the bytecode, which catches files that were only partially written.
+
+	const unsigned int CACHE_MAGIC = 0x43534748;	// 'HGSC'
+	const unsigned int CACHE_VERSION = 1;
+
+	struct CacheHeader
+	{
+		unsigned int		magic;
+		unsigned int		version;
+		unsigned long long	key;
+		unsigned long long	checksum;
+		unsigned int		size;
+		unsigned int		reserved;
+	};
+
+	unsigned long long HashString( const std::string& value, unsigned long long seed )
+	{
+		return( GlyphHash::HashData( value.data(), value.size(), seed ) );
+	}
+
+	unsigned long long HashString( const std::wstring& value, unsigned long long seed )
+	{
+		return( GlyphHash::HashData( value.data(), value.size() * sizeof( wchar_t ), seed ) );
+	}
+
+	unsigned long long HashDefines( const std::vector<ShaderMacroDX11>& defines, unsigned long long seed )
+	{
+		// The defines are hashed in order, since a later definition of the same
+		// name replaces an earlier one.
+
+		const unsigned int count = static_cast<unsigned int>( defines.size() );
+
+		unsigned long long hash = GlyphHash::HashData( &count, sizeof( count ), seed );
+
+		for ( auto& define : defines ) {
+			hash = HashString( define.Name, hash );
+			hash = HashString( define.Definition, hash );
+		}
+
+		return( hash );
+	}
+};
+//--------------------------------------------------------------------------------
+ShaderCompileRequestDX11::ShaderCompileRequestDX11() :
+	Flags( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+ShaderCacheDX11::ShaderCacheDX11() :
+	m_pCompiler( nullptr ),
+	m_bDiskCacheEnabled( true )
+{
+	ResetStatistics();
+}
+//--------------------------------------------------------------------------------
+ShaderCacheDX11::~ShaderCacheDX11()
+{
+}
+//--------------------------------------------------------------------------------
+void ShaderCacheDX11::SetCompiler( std::shared_ptr<IShaderCompiler> pCompiler )
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	// Bytecode from a different compiler doesn't belong in the memory cache,
+	// and the disk cache is keyed on the compiler identifier anyways.
+
+	m_pCompiler = pCompiler;
+	m_MemoryCache.clear();
+}
+//--------------------------------------------------------------------------------
+std::shared_ptr<IShaderCompiler> ShaderCacheDX11::GetCompiler()
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	return( m_pCompiler );
+}
+//--------------------------------------------------------------------------------
+ShaderBytecodePtr ShaderCacheDX11::GetBytecode( const ShaderCompileRequestDX11& request, std::string* pErrors )
+{
+	const unsigned long long requestKey = GetRequestKey( request );
+
+	std::shared_ptr<IShaderCompiler> pCompiler;
+	bool diskCacheEnabled;
+
+	{
+		std::lock_guard<std::mutex> lock( m_Lock );
+
+		auto entry = m_MemoryCache.find( requestKey );
+
+		if ( entry != m_MemoryCache.end() ) {
+			m_Statistics.memoryHits++;
+			return( entry->second );
+		}
+
+		pCompiler = m_pCompiler;
+		diskCacheEnabled = m_bDiskCacheEnabled;
+	}
+
+	std::string errors;
+	ShaderBytecodePtr pBytecode = nullptr;
+	bool compiled = false;
+
+	if ( pCompiler == nullptr ) {
+
+		errors = "No shader compiler has been set.";
+
+	} else {
+
+		std::string source;
+		std::vector<std::wstring> includes;
+
+		if ( pCompiler->Preprocess( request.FileName, request.Defines, source, includes, errors ) ) {
+
+			const unsigned long long key = GetCacheKey( pCompiler->GetIdentifier(), request, source, includes );
+			const std::wstring cacheFile = GetCacheFilename( key );
+
+			if ( diskCacheEnabled ) {
+				pBytecode = ReadCacheFile( cacheFile, key );
+			}
+
+			if ( pBytecode == nullptr ) {
+
+				std::shared_ptr<std::vector<char>> pCompiled( new std::vector<char>() );
+
+				if ( pCompiler->Compile( source, request.FileName, request.Function, request.ShaderModel, request.Flags, *pCompiled, errors ) ) {
+
+					pBytecode = pCompiled;
+					compiled = true;
+
+					if ( diskCacheEnabled ) {
+
+						FileSystem fs;
+						fs.CreateFolder( fs.GetCacheFolder() );
+
+						if ( !WriteCacheFile( cacheFile, key, *pCompiled ) ) {
+							std::wstring message = L"Could not write the shader cache file " + cacheFile;
+							Log::Get().Write( message );
+						}
+					}
+				}
+			}
+		}
+	}
+
+	if ( pErrors != nullptr ) {
+		*pErrors = errors;
+	}
+
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	if ( pBytecode == nullptr ) {
+
+		// Failures aren't cached, so a shader that has been fixed can be loaded
+		// again without restarting.
+
+		m_Statistics.failures++;
+		return( nullptr );
+	}
+
+	if ( compiled ) {
+		m_Statistics.compilations++;
+	} else {
+		m_Statistics.diskHits++;
+	}
+
+	// If another thread finished the same request in the meantime, its result
+	// is kept so that all of the callers share the same bytecode.
+
+	return( m_MemoryCache.emplace( requestKey, pBytecode ).first->second );
+}
+//--------------------------------------------------------------------------------
+void ShaderCacheDX11::GetBytecode( const std::vector<ShaderCompileRequestDX11>& requests, std::vector<ShaderBytecodePtr>& results,
+	JobScheduler* pScheduler )
+{
+	results.assign( requests.size(), nullptr );
+
+	// Duplicate requests are only loaded once, and then share the result of the
+	// first one.
+
+	std::vector<unsigned int> unique;
+	std::vector<unsigned int> first( requests.size() );
+	std::unordered_map<unsigned long long,unsigned int> keys;
+
+	for ( unsigned int i = 0; i < requests.size(); i++ ) {
+
+		auto entry = keys.emplace( GetRequestKey( requests[i] ), i );
+		first[i] = entry.first->second;
+
+		if ( entry.second ) {
+			unique.push_back( i );
+		}
+	}
+
+	// Each request is a job of its own, since the compile times of different
+	// shaders vary a lot.
+
+	if ( pScheduler != nullptr && pScheduler->GetThreadCount() > 1 && unique.size() > 1 ) {
+
+		pScheduler->ParallelFor( static_cast<unsigned int>( unique.size() ), 1, [&]( unsigned int begin, unsigned int end, unsigned int ) {
+			for ( unsigned int i = begin; i < end; i++ ) {
+				results[unique[i]] = GetBytecode( requests[unique[i]] );
+			}
+		}, pScheduler->GetWorkerIndex() );
+
+	} else {
+
+		for ( auto i : unique ) {
+			results[i] = GetBytecode( requests[i] );
+		}
+	}
+
+	for ( unsigned int i = 0; i < requests.size(); i++ ) {
+		results[i] = results[first[i]];
+	}
+}
+//--------------------------------------------------------------------------------
+void ShaderCacheDX11::SetDiskCacheEnabled( bool enabled )
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	m_bDiskCacheEnabled = enabled;
+}
+//--------------------------------------------------------------------------------
+bool ShaderCacheDX11::IsDiskCacheEnabled()
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	return( m_bDiskCacheEnabled );
+}
+//--------------------------------------------------------------------------------
+void ShaderCacheDX11::ClearMemoryCache()
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	m_MemoryCache.clear();
+}
+//--------------------------------------------------------------------------------
+ShaderCacheStatistics ShaderCacheDX11::GetStatistics()
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	return( m_Statistics );
+}
+//--------------------------------------------------------------------------------
+void ShaderCacheDX11::ResetStatistics()
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	memset( &m_Statistics, 0, sizeof( m_Statistics ) );
+}
+//--------------------------------------------------------------------------------
+unsigned long long ShaderCacheDX11::GetRequestKey( const ShaderCompileRequestDX11& request )
+{
+	unsigned long long key = HashString( request.FileName, 0 );
+	key = HashString( request.Function, key );
+	key = HashString( request.ShaderModel, key );
+	key = GlyphHash::HashData( &request.Flags, sizeof( request.Flags ), key );
+
+	return( HashDefines( request.Defines, key ) );
+}
+//--------------------------------------------------------------------------------
+unsigned long long ShaderCacheDX11::GetCacheKey( const std::string& compiler, const ShaderCompileRequestDX11& request,
+	const std::string& source, const std::vector<std::wstring>& includes )
+{
+	// The preprocessed source already contains the contents of all of the
+	// includes, and the remaining parts of the key cover everything else that
+	// affects the output of the compiler.
+
+	unsigned long long key = HashString( compiler, 0 );
+	key = HashString( request.Function, key );
+	key = HashString( request.ShaderModel, key );
+	key = GlyphHash::HashData( &request.Flags, sizeof( request.Flags ), key );
+	key = HashDefines( request.Defines, key );
+
+	for ( auto& include : includes ) {
+		key = HashString( include, key );
+	}
+
+	return( HashString( source, key ) );
+}
+//--------------------------------------------------------------------------------
+std::wstring ShaderCacheDX11::GetCacheFilename( unsigned long long key )
+{
+	FileSystem fs;
+
+	std::wstringstream name;
+	name << fs.GetCacheFolder() << std::hex << std::setw( 16 ) << std::setfill( L'0' ) << key << L".dxbc";
+
+	return( name.str() );
+}
+//--------------------------------------------------------------------------------
+ShaderBytecodePtr ShaderCacheDX11::ReadCacheFile( const std::wstring& cacheFile, unsigned long long key )
+{
+	std::ifstream file( cacheFile, std::ios::in | std::ios::binary | std::ios::ate );
+
+	if ( !file.is_open() )
+		return( nullptr );
+
+	const std::streamoff size = file.tellg();
+	file.seekg( 0, std::ios::beg );
+
+	CacheHeader header;
+
+	if ( size < static_cast<std::streamoff>( sizeof( header ) ) || !file.read( reinterpret_cast<char*>( &header ), sizeof( header ) ) )
+		return( nullptr );
+
+	// The size is checked before anything is allocated for the bytecode, so a
+	// damaged header can't cause a huge allocation.
+
+	if ( header.magic != CACHE_MAGIC || header.version != CACHE_VERSION || header.key != key
+		|| size != static_cast<std::streamoff>( sizeof( header ) + header.size ) )
+		return( nullptr );
+
+	std::shared_ptr<std::vector<char>> pBytecode( new std::vector<char>( header.size ) );
+
+	if ( header.size > 0 && !file.read( pBytecode->data(), header.size ) )
+		return( nullptr );
+
+	if ( GlyphHash::HashData( pBytecode->data(), pBytecode->size() ) != header.checksum )
+		return( nullptr );
+
+	return( pBytecode );
+}
+//--------------------------------------------------------------------------------
+bool ShaderCacheDX11::WriteCacheFile( const std::wstring& cacheFile, unsigned long long key, const std::vector<char>& bytecode )
+{
+	CacheHeader header;
+	memset( &header, 0, sizeof( header ) );
+	header.magic = CACHE_MAGIC;
+	header.version = CACHE_VERSION;
+	header.key = key;
+	header.checksum = GlyphHash::HashData( bytecode.data(), bytecode.size() );
+	header.size = static_cast<unsigned int>( bytecode.size() );
+
+	std::ofstream file( cacheFile, std::ios::out | std::ios::binary | std::ios::trunc );
+
+	if ( !file.is_open() )
+		return( false );
+
+	file.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+	file.write( bytecode.data(), bytecode.size() );
+
+	return( file.good() );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
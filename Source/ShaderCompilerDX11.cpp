@@ -0,0 +1,195 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "ShaderCompilerDX11.h"
+#include "FileSystem.h"
+#include "FileLoader.h"
+#include "GlyphString.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	// The include handler loads the included files from the shader folder, and
+	// keeps a list of the files that it has opened.  The data of each file is
+	// copied into its own buffer, which is released again in Close.
+
+	class IncludeHandler : public ID3DInclude
+	{
+	public:
+		IncludeHandler( std::vector<std::wstring>& includes ) :
+			m_Includes( includes )
+		{
+		}
+
+		HRESULT __stdcall Open( D3D_INCLUDE_TYPE IncludeType, LPCSTR pFileName, LPCVOID pParentData, LPCVOID* ppData, UINT* pBytes )
+		{
+			std::wstring filename = GlyphString::ToUnicode( std::string( pFileName ) );
+
+			FileSystem fs;
+			FileLoader file;
+
+			if ( !file.Open( fs.GetShaderFolder() + filename ) ) {
+				return( E_FAIL );
+			}
+
+			if ( std::find( m_Includes.begin(), m_Includes.end(), filename ) == m_Includes.end() ) {
+				m_Includes.push_back( filename );
+			}
+
+			char* pData = new char[file.GetDataSize()];
+			memcpy( pData, file.GetDataPtr(), file.GetDataSize() );
+
+			*ppData = pData;
+			*pBytes = file.GetDataSize();
+
+			return( S_OK );
+		}
+
+		HRESULT __stdcall Close( LPCVOID pData )
+		{
+			delete[] static_cast<const char*>( pData );
+
+			return( S_OK );
+		}
+
+	private:
+		std::vector<std::wstring>& m_Includes;
+	};
+
+	std::string GetErrors( ID3DBlob* pErrorMessages )
+	{
+		if ( pErrorMessages == nullptr ) {
+			return( std::string() );
+		}
+
+		const char* pMessage = static_cast<const char*>( pErrorMessages->GetBufferPointer() );
+
+		return( std::string( pMessage, pMessage + pErrorMessages->GetBufferSize() ).c_str() );
+	}
+};
+//--------------------------------------------------------------------------------
+ShaderCompilerDX11::ShaderCompilerDX11()
+{
+}
+//--------------------------------------------------------------------------------
+ShaderCompilerDX11::~ShaderCompilerDX11()
+{
+}
+//--------------------------------------------------------------------------------
+bool ShaderCompilerDX11::Preprocess( const std::wstring& filename, const std::vector<ShaderMacroDX11>& defines,
+	std::string& source, std::vector<std::wstring>& includes, std::string& errors )
+{
+	source.clear();
+	includes.clear();
+
+	FileSystem fs;
+	std::wstring filepath = fs.GetShaderFolder() + filename;
+
+	FileLoader SourceFile;
+	if ( !SourceFile.Open( filepath ) ) {
+		errors = "Unable to load shader from file: " + GlyphString::ToAscii( filepath );
+		return( false );
+	}
+
+	// The macro array of the compiler is terminated by an empty entry.
+
+	std::vector<D3D_SHADER_MACRO> macros;
+
+	for ( auto& define : defines ) {
+		D3D_SHADER_MACRO macro = { define.Name.c_str(), define.Definition.c_str() };
+		macros.push_back( macro );
+	}
+
+	D3D_SHADER_MACRO terminator = { nullptr, nullptr };
+	macros.push_back( terminator );
+
+	std::string sourceName = GlyphString::ToAscii( filepath );
+	IncludeHandler handler( includes );
+
+	ID3DBlob* pPreprocessed = nullptr;
+	ID3DBlob* pErrorMessages = nullptr;
+
+	HRESULT hr = D3DPreprocess(
+		SourceFile.GetDataPtr(),
+		SourceFile.GetDataSize(),
+		sourceName.c_str(),
+		macros.data(),
+		&handler,
+		&pPreprocessed,
+		&pErrorMessages );
+
+	errors = GetErrors( pErrorMessages );
+	SAFE_RELEASE( pErrorMessages );
+
+	if ( FAILED( hr ) ) {
+		SAFE_RELEASE( pPreprocessed );
+		return( false );
+	}
+
+	const char* pText = static_cast<const char*>( pPreprocessed->GetBufferPointer() );
+	source.assign( pText, pText + pPreprocessed->GetBufferSize() );
+
+	SAFE_RELEASE( pPreprocessed );
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+bool ShaderCompilerDX11::Compile( const std::string& source, const std::wstring& filename, const std::string& function,
+	const std::string& model, unsigned int flags, std::vector<char>& bytecode, std::string& errors )
+{
+	// The source has already been preprocessed, so the compiler doesn't need
+	// any defines or includes anymore.
+
+	FileSystem fs;
+	std::string sourceName = GlyphString::ToAscii( fs.GetShaderFolder() + filename );
+
+	ID3DBlob* pCompiledShader = nullptr;
+	ID3DBlob* pErrorMessages = nullptr;
+
+	HRESULT hr = D3DCompile(
+		source.data(),
+		source.size(),
+		sourceName.c_str(),
+		nullptr,
+		nullptr,
+		function.c_str(),
+		model.c_str(),
+		flags,
+		0,
+		&pCompiledShader,
+		&pErrorMessages );
+
+	errors = GetErrors( pErrorMessages );
+	SAFE_RELEASE( pErrorMessages );
+
+	if ( FAILED( hr ) ) {
+		SAFE_RELEASE( pCompiledShader );
+		return( false );
+	}
+
+	const char* pCode = static_cast<const char*>( pCompiledShader->GetBufferPointer() );
+	bytecode.assign( pCode, pCode + pCompiledShader->GetBufferSize() );
+
+	SAFE_RELEASE( pCompiledShader );
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+std::string ShaderCompilerDX11::GetIdentifier()
+{
+	std::stringstream identifier;
+	identifier << "D3DCompiler " << D3D_COMPILER_VERSION;
+
+	return( identifier.str() );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
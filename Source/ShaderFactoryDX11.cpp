@@ -17,6 +17,7 @@
 #include "EventManager.h"
 #include "EvtErrorMessage.h"
 #include "FileLoader.h"
+#include "RendererDX11.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
@@ -31,89 +32,49 @@ ShaderFactoryDX11::~ShaderFactoryDX11()
 ID3DBlob* ShaderFactoryDX11::GenerateShader( ShaderType type, std::wstring& filename, std::wstring& function,
             std::wstring& model, const D3D_SHADER_MACRO* pDefines, bool enablelogging )
 {
-	HRESULT hr = S_OK;
-
 	std::wstringstream message;
 
-	ID3DBlob* pCompiledShader = nullptr;
-	ID3DBlob* pErrorMessages = nullptr;
-
-	char AsciiFunction[1024];
-	char AsciiModel[1024];
-	WideCharToMultiByte(CP_ACP, 0, function.c_str(), -1, AsciiFunction, 1024, NULL, NULL);
-	WideCharToMultiByte(CP_ACP, 0, model.c_str(), -1, AsciiModel, 1024, NULL, NULL);
+	// The shader cache returns the bytecode from memory or from the disk cache
+	// when the shader and its includes haven't changed, and only compiles it
+	// otherwise.
 
-	// TODO: The compilation of shaders has to skip the warnings as errors 
-	//       for the moment, since the new FXC.exe compiler in VS2012 is
-	//       apparently more strict than before.
+	ShaderCompileRequestDX11 request = CreateRequest( filename, function, model, pDefines );
 
-    UINT flags = D3DCOMPILE_PACK_MATRIX_ROW_MAJOR;
-#ifdef _DEBUG
-    flags |= D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION; // | D3DCOMPILE_WARNINGS_ARE_ERRORS;
-#endif
-
-	// Get the current path to the shader folders, and add the filename to it.
-
-	FileSystem fs;
-	std::wstring filepath = fs.GetShaderFolder() + filename;
+	std::string errors;
+	ShaderBytecodePtr pBytecode = RendererDX11::Get()->GetShaderCache()->GetBytecode( request, &errors );
 
-	// Load the file into memory
-
-	FileLoader SourceFile;
-	if ( !SourceFile.Open( filepath ) ) {
-		message << "Unable to load shader from file: " << filepath;
-		EventManager::Get()->ProcessEvent( EvtErrorMessagePtr( new EvtErrorMessage( message.str() ) ) );
-		return( nullptr );
-	}
-
-
-	if ( FAILED( hr = D3DCompile( 
-		SourceFile.GetDataPtr(),
-		SourceFile.GetDataSize(),
-		nullptr,
-		pDefines,
-		nullptr,
-		AsciiFunction,
-		AsciiModel,
-		flags,
-		0,
-		&pCompiledShader,
-		&pErrorMessages ) ) )
-
-	//if ( FAILED( hr = D3DX11CompileFromFile(
-	//	filename.c_str(),
-	//	pDefines,
-	//	0,
-	//	AsciiFunction,
-	//	AsciiModel,
-	//	flags,
-	//	0,//UINT Flags2,
-	//	0,
-	//	&pCompiledShader,
-	//	&pErrorMessages,
-	//	&hr
-	//	) ) )
+	if ( pBytecode == nullptr )
 	{
+		FileSystem fs;
+		std::wstring filepath = fs.GetShaderFolder() + filename;
+
 		message << L"Error compiling shader program: " << filepath << std::endl << std::endl;
 		message << L"The following error was reported:" << std::endl;
 
-		if ( ( enablelogging ) && ( pErrorMessages != nullptr ) )
+		if ( enablelogging )
 		{
-			LPVOID pCompileErrors = pErrorMessages->GetBufferPointer();
-			const char* pMessage = (const char*)pCompileErrors;
-			message << GlyphString::ToUnicode( std::string( pMessage ) );
+			message << GlyphString::ToUnicode( errors );
 			Log::Get().Write( message.str() );
 		}
 
 		EventManager::Get()->ProcessEvent( EvtErrorMessagePtr( new EvtErrorMessage( message.str() ) ) );
 
-		SAFE_RELEASE( pCompiledShader );
-		SAFE_RELEASE( pErrorMessages );
+		return( nullptr );
+	}
+
+	// Copy the bytecode into a blob, which is kept by the shader for creating
+	// the input layouts and for the reflection.
+
+	ID3DBlob* pCompiledShader = nullptr;
+	HRESULT hr = D3DCreateBlob( pBytecode->size(), &pCompiledShader );
 
+	if ( FAILED( hr ) ) {
+		message << "Unable to create a D3DBlob of size: " << pBytecode->size() << L" while compiling shader: " << filename;
+		EventManager::Get()->ProcessEvent( EvtErrorMessagePtr( new EvtErrorMessage( message.str() ) ) );
 		return( nullptr );
 	}
 
-	SAFE_RELEASE( pErrorMessages );
+	memcpy( pCompiledShader->GetBufferPointer(), pBytecode->data(), pBytecode->size() );
 
 	return( pCompiledShader );
 }
@@ -157,4 +118,34 @@ ID3DBlob* ShaderFactoryDX11::GeneratePrecompiledShader( std::wstring& filename,
 
 	return( pBlob );
 }
+//--------------------------------------------------------------------------------
+ShaderCompileRequestDX11 ShaderFactoryDX11::CreateRequest( const std::wstring& filename, const std::wstring& function,
+	const std::wstring& model, const D3D_SHADER_MACRO* pDefines )
+{
+	ShaderCompileRequestDX11 request;
+
+	request.FileName = filename;
+	request.Function = GlyphString::ToAscii( function );
+	request.ShaderModel = GlyphString::ToAscii( model );
+
+	// TODO: The compilation of shaders has to skip the warnings as errors 
+	//       for the moment, since the new FXC.exe compiler in VS2012 is
+	//       apparently more strict than before.
+
+	request.Flags = D3DCOMPILE_PACK_MATRIX_ROW_MAJOR;
+#ifdef _DEBUG
+	request.Flags |= D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION; // | D3DCOMPILE_WARNINGS_ARE_ERRORS;
+#endif
+
+	if ( pDefines != nullptr ) {
+		for ( const D3D_SHADER_MACRO* pDefine = pDefines; pDefine->Name != nullptr; pDefine++ ) {
+			ShaderMacroDX11 define;
+			define.Name = pDefine->Name;
+			define.Definition = pDefine->Definition != nullptr ? pDefine->Definition : "";
+			request.Defines.push_back( define );
+		}
+	}
+
+	return( request );
+}
 //--------------------------------------------------------------------------------
\ No newline at end of file
@@ -94,6 +94,7 @@ void ShaderReflectionDX11::InitializeConstantBuffers( IParameterManager* pParamM
 						mapping.size = ConstantBuffers[i].Variables[j].Size;
 						mapping.elements = ConstantBuffers[i].Types[j].Elements;
 						mapping.varclass = ConstantBuffers[i].Types[j].Class;
+						mapping.vartype = ConstantBuffers[i].Types[j].Type;
 						mapping.valueID = -1;
 
 						ConstantBufferDX11* constBuffer = RendererDX11::Get()->GetConstantBufferByIndex( resource->m_iResource );
@@ -129,6 +130,7 @@ void ShaderReflectionDX11::InitializeConstantBuffers( IParameterManager* pParamM
 						mapping.size = ConstantBuffers[i].Variables[j].Size;
 						mapping.elements = ConstantBuffers[i].Types[j].Elements;
 						mapping.varclass = ConstantBuffers[i].Types[j].Class;
+						mapping.vartype = ConstantBuffers[i].Types[j].Type;
 						mapping.valueID = -1;
 
 						if ( !pConstBuffer->ContainsMapping( j, mapping ) ) {
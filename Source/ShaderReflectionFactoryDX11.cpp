@@ -112,7 +112,10 @@ ShaderReflectionDX11* ShaderReflectionFactoryDX11::GenerateReflection( ShaderDX1
 
 				// Get references to the parameters for binding to these variables.
 				RenderParameterDX11* pParam = 0;
-				if ( type_desc.Class == D3D_SVC_VECTOR )
+
+				// Scalars are set with vector parameters, and use their first component.
+				if ( ( type_desc.Class == D3D_SVC_VECTOR ) ||
+					( type_desc.Class == D3D_SVC_SCALAR ) )
 				{
 					pParam = pParamMgr->GetVectorParameterRef( GlyphString::ToUnicode( std::string( var_desc.Name ) ) );
 				}
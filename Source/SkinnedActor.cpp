@@ -16,6 +16,7 @@
 #include "GeometryGeneratorDX11.h"
 #include "MaterialGeneratorDX11.h"
 #include "MatrixArrayParameterWriterDX11.h"
+#include "SkinnedAnimationController.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
@@ -25,6 +26,16 @@ SkinnedActor::SkinnedActor()
 	m_pNormalMatrices = 0;
 
 	m_pGeometryEntity = new Entity3D();
+
+	m_bBatchedAnimation = false;
+	m_bBatchedPlaying = false;
+	m_fAnimationTime = 0.0f;
+	m_fAnimationEndTime = 0.0f;
+
+	// The batched animation is advanced along with the update of the actor's
+	// node, before any of the bones are updated.
+
+	GetNode()->Controllers.Attach( new SkinnedAnimationController<Node3D>( this ) );
 }
 //--------------------------------------------------------------------------------
 SkinnedActor::~SkinnedActor()
@@ -115,10 +126,37 @@ void SkinnedActor::SetBindPose( )
 	GetBody()->Parameters.SetMatrixArrayParameter( L"SkinMatrices", m_pMatrices, m_Bones.size() );
 	GetBody()->Parameters.SetMatrixArrayParameter( L"SkinNormalMatrices", m_pNormalMatrices, m_Bones.size() );
 
+	BuildAnimationClip();
 }
 //--------------------------------------------------------------------------------
 void SkinnedActor::SetSkinningMatrices( RendererDX11& Renderer )
 {
+	if ( m_bBatchedAnimation && m_LocalMatrices.size() == m_Bones.size() )
+	{
+		// Concatenate the sampled local matrices down the skeleton.  The root
+		// bones are attached to the world matrix of their parent node, which is
+		// up to date after the scene graph update.
+
+		for ( auto i : m_BoneOrder )
+		{
+			Matrix4f parent;
+
+			if ( m_BoneParents[i] >= 0 ) {
+				parent = m_WorldMatrices[m_BoneParents[i]];
+			} else if ( m_Bones[i]->GetEntity()->GetParent() ) {
+				parent = m_Bones[i]->GetEntity()->GetParent()->Transform.WorldMatrix();
+			} else {
+				parent.MakeIdentity();
+			}
+
+			Matrix4f::Multiply( m_LocalMatrices[i], parent, m_WorldMatrices[i] );
+			Matrix4f::Multiply( m_Bones[i]->GetInverseBindPose(), m_WorldMatrices[i], m_pMatrices[i] );
+			m_pNormalMatrices[i] = m_pMatrices[i].Inverse().Transpose();
+		}
+
+		return;
+	}
+
 	// Update the CPU side animation matrices.
 	for ( unsigned int i = 0; i < m_Bones.size(); i++ )
 	{
@@ -141,6 +179,9 @@ void SkinnedActor::PlayAnimation( int index )
 		if ( pStream )
 			pStream->PlayAnimation( index );
 	}
+
+	if ( index >= 0 && static_cast<unsigned int>( index ) < m_Animations.size() )
+		PlayBatched( m_Animations[index].m_fStartTime, m_Animations[index].m_fEndTime );
 }
 //--------------------------------------------------------------------------------
 void SkinnedActor::PlayAnimation( std::wstring& name )
@@ -157,6 +198,15 @@ void SkinnedActor::PlayAnimation( std::wstring& name )
 		if ( pStream )
 			pStream->PlayAnimation( name );
 	}
+
+	for ( auto& animation : m_Animations )
+	{
+		if ( name == animation.m_Name )
+		{
+			PlayBatched( animation.m_fStartTime, animation.m_fEndTime );
+			break;
+		}
+	}
 }
 //--------------------------------------------------------------------------------
 void SkinnedActor::PlayAllAnimations( )
@@ -173,10 +223,150 @@ void SkinnedActor::PlayAllAnimations( )
 		if ( pStream )
 			pStream->PlayAllAnimations();
 	}
+
+	if ( m_Clip.GetTrackCount() > 0 )
+		PlayBatched( m_Clip.GetStartTime(), m_Clip.GetEndTime() );
 }
 //--------------------------------------------------------------------------------
 Entity3D* SkinnedActor::GetGeometryEntity()
 {
 	return( m_pGeometryEntity );
 }
+//--------------------------------------------------------------------------------
+void SkinnedActor::SetBatchedAnimationEnabled( bool enabled )
+{
+	m_bBatchedAnimation = enabled;
+
+	// The bone controllers are switched off while the batch is used, since
+	// otherwise each bone would be animated twice.
+
+	for ( auto pController : m_Bones )
+	{
+		pController->SetEnabled( !enabled );
+	}
+}
+//--------------------------------------------------------------------------------
+bool SkinnedActor::IsBatchedAnimationEnabled( ) const
+{
+	return( m_bBatchedAnimation );
+}
+//--------------------------------------------------------------------------------
+void SkinnedActor::UpdateAnimation( float fTime )
+{
+	// Nothing can be sampled until the bind pose has been set.
+
+	if ( m_LocalMatrices.size() != m_Bones.size() || m_Bones.empty() )
+		return;
+
+	if ( m_bBatchedPlaying )
+	{
+		m_fAnimationTime += fTime;
+
+		if ( m_fAnimationTime >= m_fAnimationEndTime )
+		{
+			m_fAnimationTime = m_fAnimationEndTime;
+			m_bBatchedPlaying = false;
+		}
+	}
+
+	m_Clip.Sample( m_fAnimationTime, m_Cursors.data(), m_Samples.data() );
+
+	// Build the local matrix of each bone from the bind pose plus the sampled
+	// animation values, in the same way as the bone nodes' transforms.
+
+	for ( unsigned int i = 0; i < m_Bones.size(); i++ )
+	{
+		Vector3f rotation = m_Bones[i]->GetBindRotation() + m_Samples[2*i+1];
+
+		Matrix3f kRotation;
+		kRotation.Rotation( rotation );
+
+		Matrix4f& local = m_LocalMatrices[i];
+		local.MakeIdentity();
+		local.SetRotation( kRotation );
+		local.SetTranslation( m_Bones[i]->GetBindPosition() + m_Samples[2*i] );
+	}
+}
+//--------------------------------------------------------------------------------
+void SkinnedActor::BuildAnimationClip( )
+{
+	const unsigned int count = static_cast<unsigned int>( m_Bones.size() );
+
+	m_Clip.Clear();
+	m_Animations.clear();
+	m_BoneParents.assign( count, -1 );
+	m_BoneOrder.clear();
+
+	// Each bone adds its position track followed by its rotation track.  Bones
+	// without a stream get an empty track, which samples to zero.  The named
+	// animations are shared by all of the streams, so they are taken from the
+	// first stream that has any.
+
+	const std::vector<AnimationState<Vector3f>> empty;
+
+	for ( auto pController : m_Bones )
+	{
+		AnimationStream<Vector3f>* pStreams[2] = { pController->GetPositionStream(), pController->GetRotationStream() };
+
+		for ( auto pStream : pStreams )
+		{
+			m_Clip.AddTrack( pStream ? pStream->GetStates() : empty );
+
+			if ( pStream && m_Animations.empty() )
+				m_Animations = pStream->GetAnimations();
+		}
+	}
+
+	// Find the parent bone of each bone, and the depth of each bone below its
+	// root bone.  Sorting by depth puts every parent ahead of its children.
+
+	std::vector<unsigned int> depths( count, 0 );
+
+	for ( unsigned int i = 0; i < count; i++ )
+	{
+		Node3D* pParent = m_Bones[i]->GetEntity()->GetParent();
+
+		for ( unsigned int j = 0; j < count; j++ )
+		{
+			if ( m_Bones[j]->GetEntity() == pParent )
+			{
+				m_BoneParents[i] = j;
+				break;
+			}
+		}
+	}
+
+	for ( unsigned int i = 0; i < count; i++ )
+	{
+		for ( int parent = m_BoneParents[i]; parent >= 0 && depths[i] < count; parent = m_BoneParents[parent] )
+			depths[i]++;
+
+		m_BoneOrder.push_back( i );
+	}
+
+	std::stable_sort( m_BoneOrder.begin(), m_BoneOrder.end(), [&depths]( unsigned int a, unsigned int b ) {
+		return( depths[a] < depths[b] );
+	} );
+
+	m_Cursors.assign( m_Clip.GetTrackCount(), 0 );
+	m_Samples.resize( m_Clip.GetTrackCount() );
+	m_LocalMatrices.resize( count );
+	m_WorldMatrices.resize( count );
+
+	// Start out at the beginning of the clip, which matches the state of the
+	// streams before an animation is played.
+
+	m_bBatchedPlaying = false;
+	m_fAnimationTime = m_Clip.GetStartTime();
+	m_fAnimationEndTime = m_Clip.GetEndTime();
+
+	UpdateAnimation( 0.0f );
+}
+//--------------------------------------------------------------------------------
+void SkinnedActor::PlayBatched( float fStartTime, float fEndTime )
+{
+	m_bBatchedPlaying = true;
+	m_fAnimationTime = fStartTime;
+	m_fAnimationEndTime = fEndTime;
+}
 //--------------------------------------------------------------------------------
\ No newline at end of file
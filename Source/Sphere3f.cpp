@@ -46,6 +46,30 @@ bool Sphere3f::Envelops( const Sphere3f& test ) const
 	return( radius > test.radius + Dist.Magnitude( ) );
 }
 //--------------------------------------------------------------------------------
+void Sphere3f::Merge( const Sphere3f& other )
+{
+	Vector3f Dist = other.center - center;
+	float fDist = Dist.Magnitude();
+
+	// If either sphere already contains the other, then no need to compute a 
+	// new center - just take the larger one.
+
+	if ( radius >= fDist + other.radius )
+		return;
+
+	if ( other.radius >= fDist + radius ) {
+		*this = other;
+		return;
+	}
+
+	// Otherwise the new sphere spans from the far side of this sphere to the 
+	// far side of the other one, with the center moved along the connecting line.
+
+	float fRadius = ( fDist + radius + other.radius ) * 0.5f;
+	center += Dist * ( ( fRadius - radius ) / fDist );
+	radius = fRadius;
+}
+//--------------------------------------------------------------------------------
 void Sphere3f::SamplePosition( Vector3f& position, float theta, float phi ) const
 {
 	position.x = radius * sinf( phi ) * cosf( theta ) + center.x;
@@ -0,0 +1,178 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "StubShaderCompiler.h"
+#include <chrono>
+#include <thread>
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+namespace
+{
+	// Include cycles are reported as an error once the nesting gets this deep.
+	const unsigned int MAX_INCLUDE_DEPTH = 32;
+
+	bool ParseInclude( const std::string& line, std::string& name )
+	{
+		size_t start = line.find_first_not_of( " \t" );
+
+		if ( start == std::string::npos || line.compare( start, 8, "#include" ) != 0 )
+			return( false );
+
+		size_t open = line.find( '"', start + 8 );
+		size_t close = open != std::string::npos ? line.find( '"', open + 1 ) : std::string::npos;
+
+		if ( close == std::string::npos )
+			return( false );
+
+		name = line.substr( open + 1, close - open - 1 );
+
+		return( true );
+	}
+};
+//--------------------------------------------------------------------------------
+StubShaderCompiler::StubShaderCompiler() :
+	m_Identifier( "StubShaderCompiler 1" ),
+	m_uiCompileTime( 0 ),
+	m_uiCompileCount( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+StubShaderCompiler::~StubShaderCompiler()
+{
+}
+//--------------------------------------------------------------------------------
+void StubShaderCompiler::SetFile( const std::wstring& filename, const std::string& contents )
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	m_Files[filename] = contents;
+}
+//--------------------------------------------------------------------------------
+void StubShaderCompiler::SetIdentifier( const std::string& identifier )
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	m_Identifier = identifier;
+}
+//--------------------------------------------------------------------------------
+void StubShaderCompiler::SetCompileTime( unsigned int milliseconds )
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	m_uiCompileTime = milliseconds;
+}
+//--------------------------------------------------------------------------------
+unsigned int StubShaderCompiler::GetCompileCount()
+{
+	return( m_uiCompileCount );
+}
+//--------------------------------------------------------------------------------
+bool StubShaderCompiler::Preprocess( const std::wstring& filename, const std::vector<ShaderMacroDX11>& defines,
+	std::string& source, std::vector<std::wstring>& includes, std::string& errors )
+{
+	source.clear();
+	includes.clear();
+
+	for ( auto& define : defines ) {
+		source += "#define " + define.Name + " " + define.Definition + "\n";
+	}
+
+	return( Expand( filename, source, includes, errors, 0 ) );
+}
+//--------------------------------------------------------------------------------
+bool StubShaderCompiler::Expand( const std::wstring& filename, std::string& source, std::vector<std::wstring>& includes,
+	std::string& errors, unsigned int depth )
+{
+	if ( depth > MAX_INCLUDE_DEPTH ) {
+		errors = "Includes are nested too deeply.";
+		return( false );
+	}
+
+	std::string contents;
+
+	{
+		std::lock_guard<std::mutex> lock( m_Lock );
+
+		auto file = m_Files.find( filename );
+
+		if ( file == m_Files.end() ) {
+			errors = "Unable to open file: " + std::string( filename.begin(), filename.end() );
+			return( false );
+		}
+
+		contents = file->second;
+	}
+
+	std::istringstream stream( contents );
+	std::string line;
+	std::string name;
+
+	while ( std::getline( stream, line ) ) {
+
+		if ( ParseInclude( line, name ) ) {
+
+			std::wstring include( name.begin(), name.end() );
+
+			if ( std::find( includes.begin(), includes.end(), include ) == includes.end() ) {
+				includes.push_back( include );
+			}
+
+			if ( !Expand( include, source, includes, errors, depth + 1 ) ) {
+				return( false );
+			}
+
+		} else {
+
+			source += line + "\n";
+		}
+	}
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+bool StubShaderCompiler::Compile( const std::string& source, const std::wstring& filename, const std::string& function,
+	const std::string& model, unsigned int flags, std::vector<char>& bytecode, std::string& errors )
+{
+	unsigned int milliseconds;
+
+	{
+		std::lock_guard<std::mutex> lock( m_Lock );
+		milliseconds = m_uiCompileTime;
+	}
+
+	if ( milliseconds > 0 ) {
+		std::this_thread::sleep_for( std::chrono::milliseconds( milliseconds ) );
+	}
+
+	m_uiCompileCount++;
+
+	if ( source.find( "#error" ) != std::string::npos ) {
+		errors = std::string( filename.begin(), filename.end() ) + ": error in " + function + " (" + model + ")";
+		return( false );
+	}
+
+	std::string header = function + " " + model + " " + std::to_string( flags ) + "\n";
+
+	bytecode.assign( header.begin(), header.end() );
+	bytecode.insert( bytecode.end(), source.begin(), source.end() );
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+std::string StubShaderCompiler::GetIdentifier()
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	return( m_Identifier );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
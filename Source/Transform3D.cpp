@@ -11,10 +11,20 @@
 //--------------------------------------------------------------------------------
 #include "PCH.h"
 #include "Transform3D.h"
+#include "TransformHierarchy.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
-Transform3D::Transform3D()
+Transform3D::Transform3D() :
+	m_uiWorldVersion( 0 ),
+	m_uiParentVersion( 0 ),
+	m_bInvalid( true ),
+	m_bLocalChanged( true ),
+	m_bWorldChanged( true ),
+	m_pLocal( &m_mLocal ),
+	m_pWorld( &m_mWorld ),
+	m_pHierarchy( nullptr ),
+	m_uiSlot( 0 )
 {
 	m_vTranslation.MakeZero();
 	m_mRotation.MakeIdentity();
@@ -22,10 +32,52 @@ Transform3D::Transform3D()
 
 	m_mWorld.MakeIdentity();
 	m_mLocal.MakeIdentity();
+
+	m_vLastTranslation = m_vTranslation;
+	m_mLastRotation = m_mRotation;
+	m_vLastScale = m_vScale;
+}
+//--------------------------------------------------------------------------------
+Transform3D::Transform3D( const Transform3D& other ) :
+	m_pLocal( &m_mLocal ),
+	m_pWorld( &m_mWorld ),
+	m_pHierarchy( nullptr ),
+	m_uiSlot( 0 )
+{
+	*this = other;
 }
 //--------------------------------------------------------------------------------
 Transform3D::~Transform3D()
 {
+	// Let the hierarchy know that this slot is no longer valid.
+	if ( m_pHierarchy )
+		m_pHierarchy->Remove( m_uiSlot );
+}
+//--------------------------------------------------------------------------------
+Transform3D& Transform3D::operator= ( const Transform3D& other )
+{
+	// Only the values are copied - the binding to a hierarchy stays with the
+	// original object, and this object keeps its own storage.
+
+	m_vTranslation = other.m_vTranslation;
+	m_mRotation = other.m_mRotation;
+	m_vScale = other.m_vScale;
+
+	*m_pLocal = *other.m_pLocal;
+	*m_pWorld = *other.m_pWorld;
+
+	m_vLastTranslation = other.m_vLastTranslation;
+	m_mLastRotation = other.m_mLastRotation;
+	m_vLastScale = other.m_vLastScale;
+
+	m_uiWorldVersion = other.m_uiWorldVersion;
+	m_uiParentVersion = other.m_uiParentVersion;
+	m_bLocalChanged = other.m_bLocalChanged;
+	m_bWorldChanged = other.m_bWorldChanged;
+
+	Invalidate();
+
+	return( *this );
 }
 //--------------------------------------------------------------------------------
 Vector3f& Transform3D::Position()
@@ -45,44 +97,181 @@ Vector3f& Transform3D::Scale( )
 //--------------------------------------------------------------------------------
 void Transform3D::UpdateLocal( )
 {
+	// The components are exposed through references, so we can't see when they
+	// are written.  Instead we compare them to the values that the local matrix
+	// was last built from, which is much cheaper than rebuilding the matrix.
+
+	m_bLocalChanged = m_bInvalid 
+		|| m_vTranslation != m_vLastTranslation
+		|| m_mRotation != m_mLastRotation
+		|| m_vScale != m_vLastScale;
+
+	if ( !m_bLocalChanged )
+		return;
+
 	// Load the local space matrix with the rotation and translation components.
+	// The scale is applied directly to the rotation rows, which is equivalent to
+	// pre-multiplying with a scale matrix.
 
-	m_mLocal.MakeIdentity();
-	m_mLocal.SetRotation( m_mRotation );
-	m_mLocal.SetTranslation( m_vTranslation );
-	m_mLocal = Matrix4f::ScaleMatrix( m_vScale ) * m_mLocal;
+	Matrix4f& local = *m_pLocal;
+
+	local.MakeIdentity();
+	local.SetRotation( m_mRotation );
+	local.SetTranslation( m_vTranslation );
+	local.SetRow( 0, local.GetBasisX() * m_vScale.x );
+	local.SetRow( 1, local.GetBasisY() * m_vScale.y );
+	local.SetRow( 2, local.GetBasisZ() * m_vScale.z );
+
+	m_vLastTranslation = m_vTranslation;
+	m_mLastRotation = m_mRotation;
+	m_vLastScale = m_vScale;
+}
+//--------------------------------------------------------------------------------
+void Transform3D::UpdateWorld( const Transform3D& parent )
+{
+	// Only rebuild the world matrix if either the local matrix or the parent's
+	// world matrix has changed since the last time it was built.
+
+	m_bWorldChanged = m_bInvalid || m_bLocalChanged 
+		|| ( m_uiParentVersion != parent.WorldVersion() );
+
+	if ( m_bWorldChanged ) {
+		
+		// When both transforms are bound to the same hierarchy, the multiply is
+		// left to its batched update.  It will be done before the world matrix is
+		// needed again, since the parent's slot always precedes this one.
+
+		if ( m_pHierarchy == nullptr || m_pHierarchy != parent.m_pHierarchy )
+			*m_pWorld = *m_pLocal * *parent.m_pWorld;
+
+		m_uiParentVersion = parent.WorldVersion();
+		m_uiWorldVersion++;
+	}
+
+	if ( m_pHierarchy ) 
+		m_pHierarchy->SetChanged( m_uiSlot, m_bWorldChanged );
+
+	m_bInvalid = false;
 }
 //--------------------------------------------------------------------------------
 void Transform3D::UpdateWorld( const Matrix4f& parent )
 {
-    m_mWorld = m_mLocal * parent;
+	// An arbitrary parent matrix can't be tracked, so the world matrix is always
+	// rebuilt in this case.
+
+	*m_pWorld = *m_pLocal * parent;
+	m_uiWorldVersion++;
+
+	if ( m_pHierarchy ) 
+		m_pHierarchy->SetChanged( m_uiSlot, false );
+
+	m_bWorldChanged = true;
+	m_bInvalid = false;
 }
 //--------------------------------------------------------------------------------
 void Transform3D::UpdateWorld( )
 {
 	// If no parent matrix is available, then simply make the world matrix the
 	// local matrix.
-    m_mWorld = m_mLocal;
+
+	m_bWorldChanged = m_bInvalid || m_bLocalChanged;
+
+	if ( m_bWorldChanged ) {
+		*m_pWorld = *m_pLocal;
+		m_uiWorldVersion++;
+	}
+
+	if ( m_pHierarchy ) 
+		m_pHierarchy->SetChanged( m_uiSlot, false );
+
+	m_bInvalid = false;
+}
+//--------------------------------------------------------------------------------
+void Transform3D::Invalidate( )
+{
+	m_bInvalid = true;
+
+	// An invalidation is caused by a change in the graph structure, so the 
+	// flattened ordering of the hierarchy has to be rebuilt too.
+	if ( m_pHierarchy )
+		m_pHierarchy->MarkStale();
+}
+//--------------------------------------------------------------------------------
+void Transform3D::Bind( TransformHierarchy* pHierarchy, unsigned int slot, Matrix4f* pLocal, Matrix4f* pWorld )
+{
+	Unbind();
+
+	// Move the current matrices into the external storage, and then use it from
+	// now on.
+
+	*pLocal = *m_pLocal;
+	*pWorld = *m_pWorld;
+
+	m_pLocal = pLocal;
+	m_pWorld = pWorld;
+	m_pHierarchy = pHierarchy;
+	m_uiSlot = slot;
+	m_bInvalid = true;
+}
+//--------------------------------------------------------------------------------
+void Transform3D::Unbind( )
+{
+	if ( m_pHierarchy == nullptr )
+		return;
+
+	m_mLocal = *m_pLocal;
+	m_mWorld = *m_pWorld;
+
+	m_pLocal = &m_mLocal;
+	m_pWorld = &m_mWorld;
+	m_pHierarchy = nullptr;
+	m_uiSlot = 0;
+	m_bInvalid = true;
+}
+//--------------------------------------------------------------------------------
+bool Transform3D::IsBound( ) const
+{
+	return( m_pHierarchy != nullptr );
+}
+//--------------------------------------------------------------------------------
+TransformHierarchy* Transform3D::GetHierarchy( ) const
+{
+	return( m_pHierarchy );
+}
+//--------------------------------------------------------------------------------
+bool Transform3D::LocalChanged( ) const
+{
+	return( m_bLocalChanged );
+}
+//--------------------------------------------------------------------------------
+bool Transform3D::WorldChanged( ) const
+{
+	return( m_bWorldChanged );
+}
+//--------------------------------------------------------------------------------
+unsigned int Transform3D::WorldVersion( ) const
+{
+	return( m_uiWorldVersion );
 }
 //--------------------------------------------------------------------------------
 const Matrix4f& Transform3D::WorldMatrix() const
 {
-	return( m_mWorld );
+	return( *m_pWorld );
 }
 //--------------------------------------------------------------------------------
 const Matrix4f& Transform3D::LocalMatrix() const
 {
-	return( m_mLocal );
+	return( *m_pLocal );
 }
 //--------------------------------------------------------------------------------
 Matrix4f& Transform3D::WorldMatrix()
 {
-	return( m_mWorld );
+	return( *m_pWorld );
 }
 //--------------------------------------------------------------------------------
 Matrix4f& Transform3D::LocalMatrix()
 {
-	return( m_mLocal );
+	return( *m_pLocal );
 }
 //--------------------------------------------------------------------------------
 Matrix4f Transform3D::GetView() const
@@ -91,9 +280,9 @@ Matrix4f Transform3D::GetView() const
 	Vector3f At;
 	Vector3f Up;
 
-	Eye = m_mWorld.GetTranslation();
-	At = m_mWorld.GetTranslation() + m_mWorld.GetBasisZ();
-	Up = m_mWorld.GetBasisY();
+	Eye = m_pWorld->GetTranslation();
+	At = m_pWorld->GetTranslation() + m_pWorld->GetBasisZ();
+	Up = m_pWorld->GetBasisY();
 
 	return( Matrix4f::LookAtLHMatrix( Eye, At, Up ) );
 }
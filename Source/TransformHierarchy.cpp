@@ -0,0 +1,148 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TransformHierarchy.h"
+#include "Transform3D.h"
+#include "Node3D.h"
+#include "Entity3D.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+TransformHierarchy::TransformHierarchy( ) :
+	m_bStale( true )
+{
+}
+//--------------------------------------------------------------------------------
+TransformHierarchy::~TransformHierarchy( )
+{
+	Clear();
+}
+//--------------------------------------------------------------------------------
+void TransformHierarchy::Build( Node3D* pRoot )
+{
+	Clear();
+
+	// Gather the transforms in breadth first order, which guarantees that each
+	// parent is placed before all of its children.  The nodes are visited from
+	// a queue of (node, slot) pairs.
+
+	std::vector<std::pair<Node3D*,int>> queue;
+	queue.push_back( std::make_pair( pRoot, -1 ) );
+
+	for ( size_t i = 0; i < queue.size(); i++ )
+	{
+		Node3D* pNode = queue[i].first;
+		int slot = static_cast<int>( m_Transforms.size() );
+
+		AddSlot( &pNode->Transform, queue[i].second );
+
+		for ( auto pEntity : pNode->Leafs() ) {
+			if ( pEntity ) AddSlot( &pEntity->Transform, slot );
+		}
+
+		for ( auto pChild : pNode->Nodes() ) {
+			if ( pChild ) queue.push_back( std::make_pair( pChild, slot ) );
+		}
+	}
+
+	// The storage can only be bound once it has reached its final size, since
+	// the transforms keep pointers into it.
+
+	m_Locals.resize( m_Transforms.size() );
+	m_Worlds.resize( m_Transforms.size() );
+	m_Changed.assign( m_Transforms.size(), 1 );
+
+	for ( unsigned int i = 0; i < m_Transforms.size(); i++ ) {
+		m_Transforms[i]->Bind( this, i, &m_Locals[i], &m_Worlds[i] );
+	}
+
+	m_bStale = false;
+}
+//--------------------------------------------------------------------------------
+void TransformHierarchy::Clear( )
+{
+	for ( auto pTransform : m_Transforms ) {
+		if ( pTransform ) pTransform->Unbind();
+	}
+
+	m_Transforms.clear();
+	m_Parents.clear();
+	m_Changed.clear();
+	m_Locals.clear();
+	m_Worlds.clear();
+
+	m_bStale = true;
+}
+//--------------------------------------------------------------------------------
+void TransformHierarchy::AddSlot( Transform3D* pTransform, int parent )
+{
+	m_Transforms.push_back( pTransform );
+	m_Parents.push_back( parent );
+}
+//--------------------------------------------------------------------------------
+void TransformHierarchy::UpdateWorld( )
+{
+	// A single linear sweep is enough to update the whole hierarchy, since the
+	// parent of each slot has already been finished when we reach it.  Roots
+	// and transforms with an explicit parent matrix are handled immediately by
+	// the transforms themselves, and are never flagged here.
+	//
+	// When the graph changed after the last build, the flags can't be trusted
+	// to cover every slot that depends on a moved transform, so none of the
+	// slots are skipped until the hierarchy has been rebuilt.
+
+	const int count = static_cast<int>( m_Transforms.size() );
+	const int* pParents = m_Parents.data();
+	const unsigned char* pChanged = m_Changed.data();
+	const Matrix4f* pLocals = m_Locals.data();
+	Matrix4f* pWorlds = m_Worlds.data();
+
+	for ( int i = 0; i < count; i++ )
+	{
+		if ( ( pChanged[i] || m_bStale ) && pParents[i] >= 0 ) {
+			Matrix4f::Multiply( pLocals[i], pWorlds[pParents[i]], pWorlds[i] );
+		}
+	}
+
+	m_Changed.assign( m_Changed.size(), 0 );
+}
+//--------------------------------------------------------------------------------
+void TransformHierarchy::SetChanged( unsigned int slot, bool changed )
+{
+	m_Changed[slot] = changed ? 1 : 0;
+}
+//--------------------------------------------------------------------------------
+void TransformHierarchy::Remove( unsigned int slot )
+{
+	// The transform is being destroyed, so it must not be referenced again.  Its
+	// slot stays in place (and is never flagged) until the next rebuild.
+
+	m_Transforms[slot] = nullptr;
+	m_Changed[slot] = 0;
+	m_bStale = true;
+}
+//--------------------------------------------------------------------------------
+void TransformHierarchy::MarkStale( )
+{
+	m_bStale = true;
+}
+//--------------------------------------------------------------------------------
+bool TransformHierarchy::IsStale( ) const
+{
+	return( m_bStale );
+}
+//--------------------------------------------------------------------------------
+unsigned int TransformHierarchy::GetCount( ) const
+{
+	return( static_cast<unsigned int>( m_Transforms.size() ) );
+}
+//--------------------------------------------------------------------------------
\ No newline at end of file
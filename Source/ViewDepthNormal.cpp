@@ -74,8 +74,8 @@ void ViewDepthNormal::ExecuteTask( PipelineManagerDX11* pPipelineManager, IParam
 		// Set this view's render parameters
 		SetRenderParams( pParamManager );
 
-		// Run through the graph and render each of the entities
-		m_pScene->GetRoot()->Render( pPipelineManager, pParamManager, VT_LINEAR_DEPTH_NORMAL );
+		// Render the visible entities, sorted by their pipeline state
+		RenderVisibleEntities( pPipelineManager, pParamManager, VT_LINEAR_DEPTH_NORMAL );
 	}
 }
 //--------------------------------------------------------------------------------